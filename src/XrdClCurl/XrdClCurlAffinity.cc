@@ -0,0 +1,421 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlAffinity.hh"
+#include "XrdClCurlUtil.hh"
+
+#include <XrdCl/XrdClLog.hh>
+
+#include <dirent.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <thread>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Read the first line of a (sysfs) file; returns false if it cannot be read.
+bool ReadLine(const std::string &path, std::string &line) {
+    std::ifstream fh(path);
+    if (!fh.is_open()) {
+        return false;
+    }
+    return static_cast<bool>(std::getline(fh, line));
+}
+
+// Returns the names of the entries in the directory, sorted.
+std::vector<std::string> ListDir(const std::string &path) {
+    std::vector<std::string> result;
+    auto closer = [](DIR *dir) {closedir(dir);};
+    std::unique_ptr<DIR, decltype(closer)> dir(opendir(path.c_str()), closer);
+    if (!dir) {
+        return result;
+    }
+    struct dirent *ent;
+    while ((ent = readdir(dir.get()))) {
+        if (ent->d_name[0] == '.') continue;
+        result.emplace_back(ent->d_name);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Inverse of CpuTopology::ParseCpuList; collapses runs into ranges.
+std::string FormatCpuList(const std::vector<unsigned> &cpus) {
+    std::string result;
+    for (size_t idx = 0; idx < cpus.size();) {
+        auto end = idx;
+        while (end + 1 < cpus.size() && cpus[end + 1] == cpus[end] + 1) end++;
+        if (!result.empty()) result += ",";
+        result += std::to_string(cpus[idx]);
+        if (end != idx) result += "-" + std::to_string(cpus[end]);
+        idx = end + 1;
+    }
+    return result;
+}
+
+// Returns the CPUs the process is allowed to run on; empty if unknown.
+std::vector<unsigned> GetAllowedCpus() {
+    std::vector<unsigned> result;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) result.push_back(cpu);
+        }
+    }
+#endif
+    return result;
+}
+
+} // namespace
+
+bool
+CpuTopology::ParseCpuList(const std::string &list, std::vector<unsigned> &cpus)
+{
+    cpus.clear();
+    size_t pos = 0;
+    while (pos < list.size()) {
+        auto next = list.find(',', pos);
+        if (next == std::string::npos) next = list.size();
+        auto entry = list.substr(pos, next - pos);
+        pos = next + 1;
+        while (!entry.empty() && isspace(entry.back())) entry.pop_back();
+        if (entry.empty()) continue;
+
+        char *end = nullptr;
+        errno = 0;
+        auto first = strtoul(entry.c_str(), &end, 10);
+        if (errno || end == entry.c_str() || first > UINT_MAX) return false;
+        auto last = first;
+        if (*end == '-') {
+            auto start = end + 1;
+            last = strtoul(start, &end, 10);
+            if (errno || end == start || last < first || last > UINT_MAX) return false;
+        }
+        if (*end != '\0') return false;
+        for (auto cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+}
+
+CpuTopology
+CpuTopology::Load(const std::string &sysfs, const std::vector<unsigned> &allowed)
+{
+    auto is_allowed = [&](unsigned cpu) {
+        return allowed.empty() || std::binary_search(allowed.begin(), allowed.end(), cpu);
+    };
+
+    CpuTopology topology;
+    auto node_dir = sysfs + "/devices/system/node";
+    for (const auto &name : ListDir(node_dir)) {
+        if (name.size() <= 4 || name.compare(0, 4, "node") || !std::all_of(name.begin() + 4, name.end(), isdigit)) {
+            continue;
+        }
+        std::string line;
+        Node node;
+        if (!ReadLine(node_dir + "/" + name + "/cpulist", line) || !ParseCpuList(line, node.m_cpus)) {
+            continue;
+        }
+        node.m_id = std::stoi(name.substr(4));
+        node.m_cpus.erase(std::remove_if(node.m_cpus.begin(), node.m_cpus.end(),
+            [&](unsigned cpu) {return !is_allowed(cpu);}), node.m_cpus.end());
+        if (!node.m_cpus.empty()) {
+            topology.m_nodes.emplace_back(std::move(node));
+        }
+    }
+    std::sort(topology.m_nodes.begin(), topology.m_nodes.end(),
+        [](const Node &left, const Node &right) {return left.m_id < right.m_id;});
+
+    // Without NUMA information, treat the host as a single node.
+    if (topology.m_nodes.empty()) {
+        Node node;
+        std::string line;
+        if (!allowed.empty()) {
+            node.m_cpus = allowed;
+        } else if (!ReadLine(sysfs + "/devices/system/cpu/online", line) || !ParseCpuList(line, node.m_cpus)) {
+            node.m_cpus.clear();
+            for (unsigned cpu = 0; cpu < std::thread::hardware_concurrency(); cpu++) {
+                node.m_cpus.push_back(cpu);
+            }
+        }
+        if (!node.m_cpus.empty()) {
+            topology.m_nodes.emplace_back(std::move(node));
+        }
+    }
+    return topology;
+}
+
+int
+CpuTopology::GetNicNode(const std::string &sysfs, std::string &nic)
+{
+    auto net_dir = sysfs + "/class/net";
+    auto read_node = [&](const std::string &name) {
+        std::string line;
+        // Virtual interfaces (loopback, bridges, veth) have no backing device.
+        if (!ReadLine(net_dir + "/" + name + "/device/numa_node", line)) {
+            return -1;
+        }
+        try {
+            return std::stoi(line);
+        } catch (...) {
+            return -1;
+        }
+    };
+
+    if (!nic.empty()) {
+        return read_node(nic);
+    }
+    for (const auto &name : ListDir(net_dir)) {
+        auto node = read_node(name);
+        if (node >= 0) {
+            nic = name;
+            return node;
+        }
+    }
+    return -1;
+}
+
+int
+CpuTopology::GetNodeOfCpu(unsigned cpu) const
+{
+    for (const auto &node : m_nodes) {
+        if (std::binary_search(node.m_cpus.begin(), node.m_cpus.end(), cpu)) {
+            return node.m_id;
+        }
+    }
+    return -1;
+}
+
+size_t
+CpuTopology::GetCpuCount() const
+{
+    size_t count = 0;
+    for (const auto &node : m_nodes) {
+        count += node.m_cpus.size();
+    }
+    return count;
+}
+
+WorkerAffinity &
+WorkerAffinity::Instance()
+{
+    static WorkerAffinity instance;
+    return instance;
+}
+
+bool
+WorkerAffinity::ParsePolicy(const std::string &name, Policy &policy)
+{
+    if (name == "none") {
+        policy = Policy::None;
+    } else if (name == "compact") {
+        policy = Policy::Compact;
+    } else if (name == "spread") {
+        policy = Policy::Spread;
+    } else if (name == "nic-local") {
+        policy = Policy::NicLocal;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char *
+WorkerAffinity::GetPolicyName(Policy policy)
+{
+    switch (policy) {
+        case Policy::None:
+            return "none";
+        case Policy::Compact:
+            return "compact";
+        case Policy::Spread:
+            return "spread";
+        case Policy::NicLocal:
+            return "nic-local";
+    }
+    return "unknown";
+}
+
+void
+WorkerAffinity::Configure(Policy policy, const std::string &nic, XrdCl::Log &log, const std::string &sysfs)
+{
+    std::unique_lock lock(m_mutex);
+    m_policy = policy;
+    m_topology = CpuTopology::Load(sysfs, GetAllowedCpus());
+    m_nic = nic;
+    m_nic_node = CpuTopology::GetNicNode(sysfs, m_nic);
+    m_placements.clear();
+
+    log.Debug(kLogXrdClCurl, "Detected %zu NUMA node(s) with %zu usable CPUs; worker affinity policy is %s",
+        m_topology.GetNodes().size(), m_topology.GetCpuCount(), GetPolicyName(policy));
+    if (policy == Policy::NicLocal) {
+        if (m_nic_node < 0) {
+            log.Warning(kLogXrdClCurl, "Unable to determine the NUMA node of network interface '%s'; curl workers will not be pinned",
+                m_nic.empty() ? "(auto)" : m_nic.c_str());
+        } else {
+            log.Debug(kLogXrdClCurl, "Network interface %s is attached to NUMA node %d", m_nic.c_str(), m_nic_node);
+        }
+    }
+}
+
+WorkerAffinity::Placement
+WorkerAffinity::ComputePlacement(Policy policy, const CpuTopology &topology, int nic_node, unsigned idx)
+{
+    Placement placement;
+    const auto &nodes = topology.GetNodes();
+    if (nodes.empty()) {
+        return placement;
+    }
+    switch (policy) {
+        case Policy::None:
+            break;
+        case Policy::Compact: {
+            auto offset = idx % topology.GetCpuCount();
+            for (const auto &node : nodes) {
+                if (offset < node.m_cpus.size()) {
+                    placement.m_cpus.push_back(node.m_cpus[offset]);
+                    placement.m_node = node.m_id;
+                    break;
+                }
+                offset -= node.m_cpus.size();
+            }
+            break;
+        }
+        case Policy::Spread: {
+            const auto &node = nodes[idx % nodes.size()];
+            placement.m_cpus.push_back(node.m_cpus[(idx / nodes.size()) % node.m_cpus.size()]);
+            placement.m_node = node.m_id;
+            break;
+        }
+        case Policy::NicLocal:
+            for (const auto &node : nodes) {
+                if (node.m_id == nic_node) {
+                    placement.m_cpus = node.m_cpus;
+                    placement.m_node = node.m_id;
+                    break;
+                }
+            }
+            break;
+    }
+    return placement;
+}
+
+bool
+WorkerAffinity::Apply(unsigned idx, XrdCl::Log &log)
+{
+    Placement placement;
+    bool multi_node;
+    {
+        std::unique_lock lock(m_mutex);
+        placement = ComputePlacement(m_policy, m_topology, m_nic_node, idx);
+        multi_node = m_topology.GetNodes().size() > 1;
+        if (m_placements.size() <= idx) {
+            m_placements.resize(idx + 1);
+        }
+        m_placements[idx] = placement;
+    }
+    if (placement.m_cpus.empty()) {
+        return true;
+    }
+
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : placement.m_cpus) {
+        if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    auto rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc) {
+        log.Warning(kLogXrdClCurl, "Failed to pin curl worker %u to CPUs %s: %s", idx,
+            FormatCpuList(placement.m_cpus).c_str(), strerror(rc));
+        std::unique_lock lock(m_mutex);
+        m_placements[idx] = Placement();
+        return false;
+    }
+    log.Debug(kLogXrdClCurl, "Pinned curl worker %u to CPUs %s (NUMA node %d)", idx,
+        FormatCpuList(placement.m_cpus).c_str(), placement.m_node);
+
+#ifdef SYS_set_mempolicy
+    // Prefer the local node for the worker's allocations (curl handles, receive buffers,
+    // and the per-thread handle pool).  The constant matches MPOL_PREFERRED from <numaif.h>;
+    // we avoid a dependency on libnuma for this single call.
+    if (multi_node && placement.m_node >= 0) {
+        static const int mpol_preferred = 1;
+        static const size_t bits = 8 * sizeof(unsigned long);
+        std::vector<unsigned long> mask(placement.m_node / bits + 1, 0);
+        mask[placement.m_node / bits] |= 1UL << (placement.m_node % bits);
+        if (syscall(SYS_set_mempolicy, mpol_preferred, mask.data(), mask.size() * bits + 1) == -1) {
+            log.Debug(kLogXrdClCurl, "Failed to set the memory policy of curl worker %u: %s", idx, strerror(errno));
+        }
+    }
+#else
+    (void)multi_node;
+#endif
+    return true;
+#else
+    (void)multi_node;
+    log.Warning(kLogXrdClCurl, "Curl worker affinity is not supported on this platform");
+    std::unique_lock lock(m_mutex);
+    m_placements[idx] = Placement();
+    return false;
+#endif
+}
+
+std::string
+WorkerAffinity::GetMonitoringJson() const
+{
+    std::unique_lock lock(m_mutex);
+    std::string nodes;
+    for (const auto &node : m_topology.GetNodes()) {
+        if (!nodes.empty()) nodes += ",";
+        nodes += "{\"id\":" + std::to_string(node.m_id) + ","
+            "\"cpus\":\"" + FormatCpuList(node.m_cpus) + "\"}";
+    }
+    std::string workers;
+    for (const auto &placement : m_placements) {
+        if (!workers.empty()) workers += ",";
+        workers += "{\"cpus\":\"" + FormatCpuList(placement.m_cpus) + "\","
+            "\"node\":" + std::to_string(placement.m_node) + "}";
+    }
+    return "{"
+            "\"policy\":\"" + std::string(GetPolicyName(m_policy)) + "\","
+            "\"nic\":\"" + m_nic + "\","
+            "\"nic_node\":" + std::to_string(m_nic_node) + ","
+            "\"nodes\":[" + nodes + "],"
+            "\"workers\":[" + workers + "]"
+        "}";
+}
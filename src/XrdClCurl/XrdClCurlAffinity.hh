@@ -0,0 +1,134 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_AFFINITY_HH
+#define XRDCLCURL_AFFINITY_HH
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace XrdCl {
+    class Log;
+}
+
+namespace XrdClCurl {
+
+// The CPU and NUMA topology of the host, as read from sysfs.
+//
+// If the topology is unavailable (non-Linux hosts, containers without sysfs),
+// all CPUs usable by the process are treated as a single node.
+class CpuTopology {
+public:
+    struct Node {
+        int m_id{0};
+        std::vector<unsigned> m_cpus; // CPUs of the node usable by this process, in ascending order.
+    };
+
+    // Load the topology from the sysfs tree rooted at `sysfs` (normally "/sys").
+    // CPUs outside `allowed` are ignored; an empty `allowed` permits every CPU.
+    static CpuTopology Load(const std::string &sysfs, const std::vector<unsigned> &allowed);
+
+    // Returns the NUMA node of the network interface `nic` or -1 if unknown.
+    //
+    // If `nic` is empty, the first physical (non-virtual) interface with a known
+    // node is used and its name is returned through `nic`.
+    static int GetNicNode(const std::string &sysfs, std::string &nic);
+
+    // Parse a sysfs CPU list (e.g., "0-3,8,10-11") into `cpus`.
+    static bool ParseCpuList(const std::string &list, std::vector<unsigned> &cpus);
+
+    const std::vector<Node> &GetNodes() const {return m_nodes;}
+
+    // Returns the node containing `cpu` or -1 if unknown.
+    int GetNodeOfCpu(unsigned cpu) const;
+
+    // Returns the total number of CPUs in the topology.
+    size_t GetCpuCount() const;
+
+private:
+    std::vector<Node> m_nodes;
+};
+
+// Placement of the curl worker threads onto CPUs.
+//
+// Policies:
+// - `none`: Threads are left to the OS scheduler (the default).
+// - `compact`: Each worker is pinned to a single CPU, filling one node before
+//   moving to the next.
+// - `spread`: Each worker is pinned to a single CPU, round-robin across the nodes.
+// - `nic-local`: Workers may run on any CPU of the node the network interface
+//   is attached to.
+//
+// Pinning is done by the worker thread itself before it allocates its curl
+// handles and buffers; on multi-node hosts, the thread's memory policy is
+// additionally set to prefer its node so the pools land in local memory.
+class WorkerAffinity {
+public:
+    enum class Policy {
+        None,
+        Compact,
+        Spread,
+        NicLocal
+    };
+
+    // The placement of a single worker.
+    struct Placement {
+        std::vector<unsigned> m_cpus; // CPUs the worker may run on; empty means unrestricted.
+        int m_node{-1}; // NUMA node of the worker or -1 if it spans nodes.
+    };
+
+    // Return the global instance of the affinity configuration.
+    static WorkerAffinity &Instance();
+
+    // Parse a policy name; returns false if the name is not recognized.
+    static bool ParsePolicy(const std::string &name, Policy &policy);
+
+    // Returns the name of the policy.
+    static const char *GetPolicyName(Policy policy);
+
+    // Configure the placement policy; `nic` is the interface for `nic-local` (empty to detect).
+    void Configure(Policy policy, const std::string &nic, XrdCl::Log &log, const std::string &sysfs="/sys");
+
+    // Compute the placement of worker `idx` under the given policy and topology.
+    static Placement ComputePlacement(Policy policy, const CpuTopology &topology, int nic_node, unsigned idx);
+
+    // Apply the placement for worker `idx` to the calling thread.
+    //
+    // Returns false if the thread could not be pinned; failures are logged but not fatal.
+    bool Apply(unsigned idx, XrdCl::Log &log);
+
+    // Returns the topology and the worker placements as a JSON object.
+    std::string GetMonitoringJson() const;
+
+private:
+    WorkerAffinity() = default;
+    WorkerAffinity(const WorkerAffinity &) = delete;
+
+    mutable std::mutex m_mutex;
+    Policy m_policy{Policy::None};
+    CpuTopology m_topology;
+    std::string m_nic;
+    int m_nic_node{-1};
+    // Placement of each worker that has called Apply, indexed by worker.
+    std::vector<Placement> m_placements;
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_AFFINITY_HH
@@ -0,0 +1,228 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlCompletionExecutor.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+using namespace XrdClCurl;
+
+CompletionExecutor::TaskQueue::TaskQueue() :
+    m_head(&m_stub),
+    m_tail(&m_stub)
+{}
+
+CompletionExecutor::TaskQueue::~TaskQueue()
+{
+    Task *task;
+    while ((task = Pop())) {
+        delete task;
+    }
+}
+
+void
+CompletionExecutor::TaskQueue::PushNode(Task *task)
+{
+    task->m_next.store(nullptr, std::memory_order_relaxed);
+    auto prev = m_head.exchange(task, std::memory_order_acq_rel);
+    prev->m_next.store(task, std::memory_order_release);
+}
+
+void
+CompletionExecutor::TaskQueue::Push(Task *task)
+{
+    PushNode(task);
+    Notify();
+}
+
+void
+CompletionExecutor::TaskQueue::Notify()
+{
+    m_seq.fetch_add(1, std::memory_order_release);
+    m_seq.notify_one();
+}
+
+CompletionExecutor::Task *
+CompletionExecutor::TaskQueue::Pop()
+{
+    auto tail = m_tail;
+    auto next = tail->m_next.load(std::memory_order_acquire);
+    if (tail == &m_stub) {
+        if (!next) {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->m_next.load(std::memory_order_acquire);
+    }
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    // `tail` is the last task in the list; re-insert the stub behind it so it
+    // can be detached.  If a producer has swapped the head but not yet linked
+    // its task, report empty; its Notify will wake us up.
+    if (tail != m_head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    PushNode(&m_stub);
+    next = tail->m_next.load(std::memory_order_acquire);
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+CompletionExecutor &
+CompletionExecutor::Instance()
+{
+    // Purposely leaked: completions may be dispatched during static destruction.
+    static auto executor = new CompletionExecutor();
+    return *executor;
+}
+
+void
+CompletionExecutor::Start(unsigned threads)
+{
+    if (!threads) {
+        return;
+    }
+    std::call_once(m_start_once, [&] {
+        for (unsigned idx = 0; idx < threads; idx++) {
+            m_queues.emplace_back(new TaskQueue());
+        }
+        for (unsigned idx = 0; idx < threads; idx++) {
+            m_threads.emplace_back(&CompletionExecutor::Run, this, std::ref(*m_queues[idx]));
+        }
+        m_enabled.store(true, std::memory_order_release);
+    });
+}
+
+void
+CompletionExecutor::Dispatch(size_t key, XrdCl::ResponseHandler *handler, XrdCl::XRootDStatus *status,
+    XrdCl::AnyObject *response, std::shared_ptr<XrdCl::ResponseHandler> handler_ref)
+{
+    if (!handler) {
+        delete status;
+        delete response;
+        return;
+    }
+    // Sequentially-consistent ordering pairs with Shutdown: either it sees this
+    // dispatch in progress or we see the executor disabled.
+    m_dispatching.fetch_add(1);
+    if (!m_enabled.load()) {
+        m_dispatching.fetch_sub(1);
+        m_inline.fetch_add(1, std::memory_order_relaxed);
+        handler->HandleResponse(status, response);
+        return;
+    }
+
+    auto task = new Task();
+    task->m_handler = handler;
+    task->m_handler_ref = std::move(handler_ref);
+    task->m_status = status;
+    task->m_response = response;
+    task->m_enqueued = std::chrono::steady_clock::now();
+    m_queues[key % m_queues.size()]->Push(task);
+    m_dispatching.fetch_sub(1);
+    m_dispatched.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+CompletionExecutor::Execute(Task &task)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto handoff = (start - task.m_enqueued).count();
+    m_handoff_duration.fetch_add(handoff, std::memory_order_relaxed);
+    auto max = m_handoff_max.load(std::memory_order_relaxed);
+    while (handoff > max && !m_handoff_max.compare_exchange_weak(max, handoff, std::memory_order_relaxed)) {}
+
+    task.m_handler->HandleResponse(task.m_status, task.m_response);
+
+    m_callback_duration.fetch_add((std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+    m_completed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+CompletionExecutor::Run(TaskQueue &queue)
+{
+    while (true) {
+        auto seq = queue.GetSequence();
+        auto task = queue.Pop();
+        if (task) {
+            try {
+                Execute(*task);
+            } catch (...) {
+                // Response handlers are not supposed to throw; avoid taking down the thread.
+            }
+            delete task;
+            continue;
+        }
+        if (m_shutdown.load(std::memory_order_acquire)) {
+            break;
+        }
+        queue.Wait(seq);
+    }
+}
+
+void
+CompletionExecutor::Shutdown()
+{
+    auto &me = Instance();
+    if (!me.m_enabled.exchange(false)) {
+        return;
+    }
+    // Wait for any in-progress dispatches to finish pushing; afterward, all new
+    // completions are invoked inline.
+    while (me.m_dispatching.load()) {
+        std::this_thread::yield();
+    }
+    me.m_shutdown.store(true, std::memory_order_release);
+    for (auto &queue : me.m_queues) {
+        queue->Notify();
+    }
+    for (auto &thread : me.m_threads) {
+        // The last reference to a file may be dropped by a callback on the executor
+        // thread, triggering a shutdown from that thread.
+        if (thread.get_id() == std::this_thread::get_id()) {
+            thread.detach();
+        } else if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+std::string
+CompletionExecutor::GetMonitoringJson() const
+{
+    auto completed = m_completed.load(std::memory_order_relaxed);
+    auto handoff = std::chrono::duration<double>(std::chrono::steady_clock::duration(m_handoff_duration.load(std::memory_order_relaxed))).count();
+    auto handoff_max = std::chrono::duration<double>(std::chrono::steady_clock::duration(m_handoff_max.load(std::memory_order_relaxed))).count();
+    auto callback = std::chrono::duration<double>(std::chrono::steady_clock::duration(m_callback_duration.load(std::memory_order_relaxed))).count();
+    return "{"
+        "\"threads\":" + std::to_string(m_threads.size()) + ","
+        "\"dispatched\":" + std::to_string(m_dispatched.load(std::memory_order_relaxed)) + ","
+        "\"inline\":" + std::to_string(m_inline.load(std::memory_order_relaxed)) + ","
+        "\"completed\":" + std::to_string(completed) + ","
+        "\"handoff_time\":" + std::to_string(handoff) + ","
+        "\"handoff_max\":" + std::to_string(handoff_max) + ","
+        "\"handoff_avg\":" + std::to_string(completed ? handoff / completed : 0.0) + ","
+        "\"callback_time\":" + std::to_string(callback) +
+        "}";
+}
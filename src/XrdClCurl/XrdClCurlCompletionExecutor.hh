@@ -0,0 +1,148 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_COMPLETIONEXECUTOR_HH
+#define XRDCLCURL_COMPLETIONEXECUTOR_HH
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace XrdCl {
+    class AnyObject;
+    class ResponseHandler;
+    class XRootDStatus;
+}
+
+namespace XrdClCurl {
+
+// A small thread pool that invokes the XrdCl response handlers on behalf of
+// the curl worker threads.
+//
+// Response handlers may do real work (decompression, deserialization, writing
+// to disk); invoked directly from the worker, they stall every other transfer
+// on that worker.  When enabled, the worker instead pushes the completion onto
+// a lock-free queue serviced by one of the executor threads.
+//
+// Completions with the same ordering key are always serviced by the same
+// thread in the order they were dispatched; operations on a single file share
+// a key, so their callbacks are not reordered.
+//
+// When the executor is disabled (the default) or shut down, completions are
+// invoked inline on the calling thread.
+class CompletionExecutor {
+public:
+    // Return the global instance of the executor.
+    static CompletionExecutor &Instance();
+
+    // Start the executor with the given number of threads.  Zero threads leaves
+    // the executor disabled.  Only the first call with a non-zero count has an effect.
+    void Start(unsigned threads);
+
+    // Returns true if completions are being offloaded to the executor threads.
+    bool IsEnabled() const {return m_enabled.load(std::memory_order_acquire);}
+
+    // Invoke `handler->HandleResponse(status, response)`, possibly on an executor thread.
+    //
+    // `handler_ref`, if set, is kept alive until the handler has been invoked.
+    void Dispatch(size_t key, XrdCl::ResponseHandler *handler, XrdCl::XRootDStatus *status,
+        XrdCl::AnyObject *response, std::shared_ptr<XrdCl::ResponseHandler> handler_ref = {});
+
+    // Returns the executor statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+private:
+    CompletionExecutor() = default;
+    CompletionExecutor(const CompletionExecutor &) = delete;
+
+    // Drain and stop the executor threads when the plugin is unloaded.
+    static void Shutdown() __attribute__((destructor));
+
+    struct Task {
+        std::atomic<Task*> m_next{nullptr};
+        XrdCl::ResponseHandler *m_handler{nullptr};
+        std::shared_ptr<XrdCl::ResponseHandler> m_handler_ref;
+        XrdCl::XRootDStatus *m_status{nullptr};
+        XrdCl::AnyObject *m_response{nullptr};
+        std::chrono::steady_clock::time_point m_enqueued;
+    };
+
+    // An intrusive multi-producer, single-consumer queue (after D. Vyukov).
+    //
+    // Producers only perform an atomic exchange and a store; the consumer
+    // never blocks producers.
+    class TaskQueue {
+    public:
+        TaskQueue();
+        ~TaskQueue();
+
+        // Add a task to the queue and wake the consumer; safe to call from any thread.
+        void Push(Task *task);
+
+        // Remove the oldest task; returns nullptr if the queue is empty (or a producer
+        // is midway through a push, in which case the producer will wake the consumer).
+        // Must only be called by the single consumer.
+        Task *Pop();
+
+        // Block until the queue may have changed since `seq` was read from GetSequence().
+        void Wait(uint32_t seq) {m_seq.wait(seq, std::memory_order_acquire);}
+        uint32_t GetSequence() const {return m_seq.load(std::memory_order_acquire);}
+
+        // Wake the consumer without adding a task.
+        void Notify();
+
+    private:
+        void PushNode(Task *task);
+
+        std::atomic<Task*> m_head;
+        Task *m_tail;
+        Task m_stub;
+        std::atomic<uint32_t> m_seq{0};
+    };
+
+    // Main loop of an executor thread.
+    void Run(TaskQueue &queue);
+
+    // Invoke the task's handler and record the statistics.
+    void Execute(Task &task);
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<bool> m_shutdown{false};
+    // Count of threads inside Dispatch that may be pushing to a queue; shutdown
+    // waits for this to drain so no completion is stranded.
+    std::atomic<unsigned> m_dispatching{0};
+    std::once_flag m_start_once;
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    // Statistics for the monitoring output.
+    std::atomic<uint64_t> m_dispatched{0}; // Count of completions handed to the executor threads.
+    std::atomic<uint64_t> m_inline{0}; // Count of completions invoked inline (executor disabled).
+    std::atomic<uint64_t> m_completed{0}; // Count of completions invoked by the executor threads.
+    std::atomic<std::chrono::steady_clock::duration::rep> m_handoff_duration{0}; // Total time completions waited in the queues.
+    std::atomic<std::chrono::steady_clock::duration::rep> m_handoff_max{0}; // Longest time a completion waited in a queue.
+    std::atomic<std::chrono::steady_clock::duration::rep> m_callback_duration{0}; // Total time spent in the response handlers.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_COMPLETIONEXECUTOR_HH
@@ -16,12 +16,23 @@
  *
  ***************************************************************/
 
+#include "../common/XrdClCurlCAStore.hh"
+#include "../common/XrdClCurlDnsCache.hh"
+#include "../common/XrdClCurlScoreboard.hh"
+#include "XrdClCurlAffinity.hh"
+#include "XrdClCurlCompletionExecutor.hh"
 #include "XrdClCurlFactory.hh"
 #include "XrdClCurlFile.hh"
 #include "XrdClCurlFilesystem.hh"
 #include "XrdClCurlUtil.hh"
 #include "XrdClCurlOps.hh"
+#include "XrdClCurlOptionsCache.hh"
 #include "XrdClCurlParseTimeout.hh"
+#include "XrdClCurlRateLimiter.hh"
+#include "XrdClCurlObjectCache.hh"
+#include "XrdClCurlReadCoalescer.hh"
+#include "XrdClCurlReadWindow.hh"
+#include "XrdClCurlSocketTuning.hh"
 #include "XrdClCurlWorker.hh"
 
 #include "XrdCl/XrdClConstants.hh"
@@ -33,6 +44,8 @@
 #include <stdio.h>
 #include <unistd.h>
 
+#include <algorithm>
+
 XrdVERSIONINFO(XrdClGetPlugIn, XrdClGetPlugIn)
 
 using namespace XrdClCurl;
@@ -51,19 +64,35 @@ Factory::GetHeaderTimeoutWithDefault(time_t oper_timeout)
     return {oper_timeout, 0};
 }
 
+namespace {
+
+void SetIfEmpty(XrdCl::Env *env, XrdCl::Log &log, const std::string &optName, const std::string &envName) {
+    if (!env) return;
+
+    std::string val;
+    if (!env->GetString(optName, val) || val.empty()) {
+        env->PutString(optName, "");
+        env->ImportString(optName, envName);
+    }
+    if (env->GetString(optName, val) && !val.empty()) {
+        log.Info(kLogXrdClCurl, "Setting %s to value '%s'", optName.c_str(), val.c_str());
+    }
+}
+
+} // namespace
+
 bool Factory::m_initialized = false;
 std::shared_ptr<XrdClCurl::HandlerQueue> Factory::m_queue;
 std::vector<std::unique_ptr<XrdClCurl::CurlWorker>> Factory::m_workers;
+std::mutex Factory::m_workers_mutex;
+std::atomic<unsigned> Factory::m_worker_count{0};
+unsigned Factory::m_max_workers{Factory::m_poll_threads};
 XrdCl::Log *Factory::m_log = nullptr;
 std::once_flag Factory::m_init_once;
 std::string Factory::m_stats_location;
 std::chrono::system_clock::time_point Factory::m_start{};
 
-std::mutex Factory::m_shutdown_lock;
-std::condition_variable Factory::m_shutdown_requested_cv;
-bool Factory::m_shutdown_requested = false;
-std::condition_variable Factory::m_shutdown_complete_cv;
-bool Factory::m_shutdown_complete = true; // Starts in "true" state as the thread hasn't started
+Scheduler::TaskId Factory::m_monitor_task{0};
 
 void
 Factory::Initialize()
@@ -120,6 +149,23 @@ Factory::Initialize()
         }
         m_queue.reset(new XrdClCurl::HandlerQueue(max_pending));
 
+        // Behavior when the global work queue is full: "block" (default) blocks the calling
+        // thread until there is space, "overflow" keeps the operations in order on an
+        // unbounded overflow list, and "reject" immediately fails them with a retryable error.
+        SetIfEmpty(env, *m_log, "CurlQueueAdmission", "XRD_CURLQUEUEADMISSION");
+        std::string admission = "block";
+        if (env->GetString("CurlQueueAdmission", admission) && admission.empty()) {
+            admission = "block";
+        }
+        auto admission_mode = XrdClCurl::HandlerQueue::AdmissionMode::Block;
+        if (!XrdClCurl::HandlerQueue::ParseAdmissionMode(admission, admission_mode)) {
+            m_log->Error(kLogXrdClCurl, "Invalid value for the work queue admission mode (%s); using default value of block", admission.c_str());
+            admission_mode = XrdClCurl::HandlerQueue::AdmissionMode::Block;
+            admission = "block";
+        }
+        m_queue->SetAdmissionMode(admission_mode);
+        m_log->Debug(kLogXrdClCurl, "Using the %s admission mode for the global work queue", admission.c_str());
+
         // The number of threads to use for curl operations.
         env->PutInt("CurlNumThreads", m_poll_threads);
         env->ImportInt("CurlNumThreads", "XRD_CURLNUMTHREADS");
@@ -132,6 +178,48 @@ Factory::Initialize()
             }
             m_log->Debug(kLogXrdClCurl, "Using %d threads for curl operations", num_threads);
         }
+        m_max_workers = num_threads;
+
+        // Start the curl workers on demand -- the first with the first operation, then more
+        // as the backlog of operations grows, up to CurlNumThreads -- instead of all at startup.
+        // Useful for short-lived clients that perform only a few operations.
+        env->PutInt("CurlLazyWorkers", 0);
+        env->ImportInt("CurlLazyWorkers", "XRD_CURLLAZYWORKERS");
+        int lazy_workers = 0;
+        env->GetInt("CurlLazyWorkers", lazy_workers);
+
+        // Placement of the curl worker threads onto CPUs: "none" (default), "compact", "spread",
+        // or "nic-local" (the NUMA node of CurlAffinityNic, auto-detected if unset).
+        SetIfEmpty(env, *m_log, "CurlWorkerAffinity", "XRD_CURLWORKERAFFINITY");
+        SetIfEmpty(env, *m_log, "CurlAffinityNic", "XRD_CURLAFFINITYNIC");
+        std::string affinity = "none", affinity_nic;
+        if (env->GetString("CurlWorkerAffinity", affinity) && affinity.empty()) {
+            affinity = "none";
+        }
+        env->GetString("CurlAffinityNic", affinity_nic);
+        XrdClCurl::WorkerAffinity::Policy affinity_policy;
+        if (!XrdClCurl::WorkerAffinity::ParsePolicy(affinity, affinity_policy)) {
+            m_log->Error(kLogXrdClCurl, "Invalid value for the curl worker affinity (%s); using default value of none", affinity.c_str());
+            affinity_policy = XrdClCurl::WorkerAffinity::Policy::None;
+        }
+        XrdClCurl::WorkerAffinity::Instance().Configure(affinity_policy, affinity_nic, *m_log);
+
+        // The number of threads used to invoke the response handlers; zero means the handlers
+        // are invoked directly from the curl worker threads.
+        env->PutInt("CurlCompletionThreads", 0);
+        env->ImportInt("CurlCompletionThreads", "XRD_CURLCOMPLETIONTHREADS");
+        int completion_threads = 0;
+        if (env->GetInt("CurlCompletionThreads", completion_threads)) {
+            if (completion_threads < 0 || completion_threads > 1'000) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the number of completion threads (%d); using default value of %d", completion_threads, 0);
+                completion_threads = 0;
+                env->PutInt("CurlCompletionThreads", completion_threads);
+            }
+            if (completion_threads) {
+                m_log->Debug(kLogXrdClCurl, "Using %d threads to invoke response handlers", completion_threads);
+            }
+        }
+        XrdClCurl::CompletionExecutor::Instance().Start(completion_threads);
 
         // The stall timeout to use for transfer operations.
         env->PutInt("CurlStallTimeout", XrdClCurl::CurlOperation::GetDefaultStallTimeout());
@@ -161,6 +249,244 @@ Factory::Initialize()
         }
         XrdClCurl::CurlOperation::SetSlowRateBytesSec(slow_xfer_rate);
 
+        // The number of times a full-download GET is resumed (with a Range request from the
+        // last byte delivered) after a stall or other transient failure; 0 disables resuming.
+        env->PutInt("CurlResumeAttempts", 3);
+        env->ImportInt("CurlResumeAttempts", "XRD_CURLRESUMEATTEMPTS");
+        int resume_attempts = 3;
+        if (env->GetInt("CurlResumeAttempts", resume_attempts)) {
+            if (resume_attempts < 0 || resume_attempts > 100) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the number of download resume attempts (%d); using default value of %d", resume_attempts, 3);
+                resume_attempts = 3;
+                env->PutInt("CurlResumeAttempts", resume_attempts);
+            }
+        }
+        XrdClCurl::File::SetMaxResumeAttempts(resume_attempts);
+
+        // Coalesce identical reads of the same object issued concurrently through different
+        // file handles into a single transfer.
+        env->PutInt("CurlReadCoalescing", 0);
+        env->ImportInt("CurlReadCoalescing", "XRD_CURLREADCOALESCING");
+        int read_coalescing = 0;
+        env->GetInt("CurlReadCoalescing", read_coalescing);
+        XrdClCurl::ReadCoalescer::Instance().SetEnabled(read_coalescing != 0);
+        if (read_coalescing) {
+            m_log->Debug(kLogXrdClCurl, "Coalescing identical concurrent reads");
+        }
+
+        // Time, in microseconds, a small read on a file handle may wait to be merged with
+        // nearby reads into a single request; zero disables merging.
+        env->PutInt("CurlReadWindow", 0);
+        env->ImportInt("CurlReadWindow", "XRD_CURLREADWINDOW");
+        int read_window = 0;
+        env->GetInt("CurlReadWindow", read_window);
+        XrdClCurl::ReadWindow::SetWindow(std::chrono::microseconds(std::max(read_window, 0)));
+
+        // Largest gap, in bytes, between two reads merged into one request.
+        env->PutInt("CurlReadWindowGap", 64 * 1024);
+        env->ImportInt("CurlReadWindowGap", "XRD_CURLREADWINDOWGAP");
+        int read_window_gap = 64 * 1024;
+        env->GetInt("CurlReadWindowGap", read_window_gap);
+        XrdClCurl::ReadWindow::SetMaxGap(std::max(read_window_gap, 0));
+        if (read_window > 0) {
+            m_log->Debug(kLogXrdClCurl, "Merging small reads within %d microseconds and %d bytes of each other", read_window, read_window_gap);
+        }
+
+        // Request compressed (gzip, zstd, ...) responses for PROPFIND and listing operations;
+        // data transfers are never compressed so byte ranges stay exact.
+        env->PutInt("CurlCompressMetadata", 1);
+        env->ImportInt("CurlCompressMetadata", "XRD_CURLCOMPRESSMETADATA");
+        int compress_metadata = 1;
+        env->GetInt("CurlCompressMetadata", compress_metadata);
+        XrdClCurl::CurlOperation::SetMetadataCompression(compress_metadata != 0);
+
+        // Start an open of an endpoint with unknown verbs with HEAD while probing OPTIONS in
+        // parallel, instead of waiting for the OPTIONS response first.  A stat always waits
+        // for the OPTIONS response, as HEAD can't reliably tell a directory from a file.
+        env->PutInt("CurlSpeculativeOptions", 1);
+        env->ImportInt("CurlSpeculativeOptions", "XRD_CURLSPECULATIVEOPTIONS");
+        int speculative_options = 1;
+        env->GetInt("CurlSpeculativeOptions", speculative_options);
+        XrdClCurl::CurlWorker::SetSpeculativeOptions(speculative_options != 0);
+
+        // File where the HTTP verbs learned from OPTIONS responses are saved so other processes
+        // don't probe the same endpoints again; empty disables it.
+        env->PutString("CurlVerbsCacheFile", "");
+        env->ImportString("CurlVerbsCacheFile", "XRD_CURLVERBSCACHEFILE");
+        std::string verbs_cache_file;
+        env->GetString("CurlVerbsCacheFile", verbs_cache_file);
+        XrdClCurl::VerbsCache::Instance().SetPersistFile(verbs_cache_file);
+        if (!verbs_cache_file.empty()) {
+            m_log->Debug(kLogXrdClCurl, "Sharing the known HTTP verbs through %s", verbs_cache_file.c_str());
+        }
+
+        // Checksum computed while uploading and sent to the server with the PUT ("crc32c",
+        // "adler32", or "md5"); empty disables it.  When the first write is the whole
+        // object, the checksum is sent as a header.  Uploads of unknown size send it as
+        // a trailer.  Uploads of known size only do so if trailers are enabled below,
+        // as that replaces their Content-Length with a chunked body.
+        env->PutString("CurlUploadChecksum", "");
+        env->ImportString("CurlUploadChecksum", "XRD_CURLUPLOADCHECKSUM");
+        std::string upload_checksum;
+        env->GetString("CurlUploadChecksum", upload_checksum);
+        if (!upload_checksum.empty() && XrdClCurl::UploadChecksum::ParseAlgorithm(upload_checksum) == XrdClCurl::UploadChecksum::Algorithm::kNone) {
+            m_log->Error(kLogXrdClCurl, "Invalid value for the upload checksum (%s); not computing upload checksums", upload_checksum.c_str());
+            upload_checksum = "";
+        }
+        XrdClCurl::File::SetDefaultUploadChecksum(upload_checksum);
+
+        // Send the checksum of an upload of known size as a trailer when the first write
+        // isn't the whole object; the per-handle property `XrdClCurlUploadChecksumTrailer`
+        // overrides it.
+        env->PutInt("CurlUploadChecksumTrailer", 0);
+        env->ImportInt("CurlUploadChecksumTrailer", "XRD_CURLUPLOADCHECKSUMTRAILER");
+        int upload_checksum_trailer = 0;
+        env->GetInt("CurlUploadChecksumTrailer", upload_checksum_trailer);
+        XrdClCurl::File::SetDefaultUploadChecksumTrailer(upload_checksum_trailer != 0);
+
+        // In-memory cache of small objects shared by all file handles: the total size in MB
+        // (0 disables the cache), the largest object cached in KB, and the number of seconds
+        // an object is used before it is revalidated against the server's ETag.
+        env->PutInt("CurlObjectCacheSize", 0);
+        env->ImportInt("CurlObjectCacheSize", "XRD_CURLOBJECTCACHESIZE");
+        int object_cache_size = 0;
+        if (env->GetInt("CurlObjectCacheSize", object_cache_size)) {
+            if (object_cache_size < 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the object cache size (%d); using default value of %d", object_cache_size, 0);
+                object_cache_size = 0;
+                env->PutInt("CurlObjectCacheSize", object_cache_size);
+            }
+        }
+        env->PutInt("CurlObjectCacheMaxObject", 1024);
+        env->ImportInt("CurlObjectCacheMaxObject", "XRD_CURLOBJECTCACHEMAXOBJECT");
+        int object_cache_max_object = 1024;
+        if (env->GetInt("CurlObjectCacheMaxObject", object_cache_max_object)) {
+            if (object_cache_max_object <= 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the object cache maximum object size (%d); using default value of %d", object_cache_max_object, 1024);
+                object_cache_max_object = 1024;
+                env->PutInt("CurlObjectCacheMaxObject", object_cache_max_object);
+            }
+        }
+        env->PutInt("CurlObjectCacheTTL", 60);
+        env->ImportInt("CurlObjectCacheTTL", "XRD_CURLOBJECTCACHETTL");
+        int object_cache_ttl = 60;
+        if (env->GetInt("CurlObjectCacheTTL", object_cache_ttl)) {
+            if (object_cache_ttl < 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the object cache TTL (%d); using default value of %d", object_cache_ttl, 60);
+                object_cache_ttl = 60;
+                env->PutInt("CurlObjectCacheTTL", object_cache_ttl);
+            }
+        }
+        XrdClCurl::ObjectCache::Instance().Configure(static_cast<size_t>(object_cache_size) * 1024 * 1024,
+            static_cast<size_t>(object_cache_max_object) * 1024, std::chrono::seconds(object_cache_ttl));
+        if (object_cache_size) {
+            m_log->Debug(kLogXrdClCurl, "Caching objects up to %d KB in a %d MB object cache", object_cache_max_object, object_cache_size);
+        }
+
+        // Token-bucket limits on the transfer rate (bytes/sec) and the request rate (requests/sec),
+        // both for the whole process and for each destination endpoint; 0 means unlimited.
+        auto get_rate_limit = [&](const char *name, const char *env_name, const char *desc) {
+            env->PutInt(name, 0);
+            env->ImportInt(name, env_name);
+            int limit = 0;
+            if (env->GetInt(name, limit)) {
+                if (limit < 0) {
+                    m_log->Error(kLogXrdClCurl, "Invalid value for the %s limit (%d); using default value of %d", desc, limit, 0);
+                    limit = 0;
+                    env->PutInt(name, limit);
+                }
+                if (limit) {
+                    m_log->Debug(kLogXrdClCurl, "Limiting the %s to %d", desc, limit);
+                }
+            }
+            return static_cast<uint64_t>(limit);
+        };
+        auto max_bytes_per_sec = get_rate_limit("CurlMaxBytesPerSec", "XRD_CURLMAXBYTESPERSEC", "bytes/sec");
+        auto max_requests_per_sec = get_rate_limit("CurlMaxRequestsPerSec", "XRD_CURLMAXREQUESTSPERSEC", "requests/sec");
+        auto host_bytes_per_sec = get_rate_limit("CurlHostMaxBytesPerSec", "XRD_CURLHOSTMAXBYTESPERSEC", "per-host bytes/sec");
+        auto host_requests_per_sec = get_rate_limit("CurlHostMaxRequestsPerSec", "XRD_CURLHOSTMAXREQUESTSPERSEC", "per-host requests/sec");
+        XrdClCurl::RateLimiter::Instance().Configure(max_bytes_per_sec, max_requests_per_sec, host_bytes_per_sec, host_requests_per_sec);
+
+        // Per-endpoint circuit breaker: the number of consecutive failures after which
+        // requests to the endpoint fail immediately (0 disables) and the number of
+        // seconds before a probe request is allowed through.
+        env->PutInt("CurlCircuitFailures", 5);
+        env->ImportInt("CurlCircuitFailures", "XRD_CURLCIRCUITFAILURES");
+        int circuit_failures = 5;
+        if (env->GetInt("CurlCircuitFailures", circuit_failures)) {
+            if (circuit_failures < 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the circuit breaker failure count (%d); using default value of %d", circuit_failures, 5);
+                circuit_failures = 5;
+                env->PutInt("CurlCircuitFailures", circuit_failures);
+            }
+        }
+        env->PutInt("CurlCircuitCooldown", 30);
+        env->ImportInt("CurlCircuitCooldown", "XRD_CURLCIRCUITCOOLDOWN");
+        int circuit_cooldown = 30;
+        if (env->GetInt("CurlCircuitCooldown", circuit_cooldown)) {
+            if (circuit_cooldown <= 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the circuit breaker cooldown (%d); using default value of %d", circuit_cooldown, 30);
+                circuit_cooldown = 30;
+                env->PutInt("CurlCircuitCooldown", circuit_cooldown);
+            }
+        }
+        XrdClCurl::Scoreboard::Instance().SetCircuitParams(circuit_failures, std::chrono::seconds(circuit_cooldown));
+
+        // Interval, in seconds, at which the hosts in use are re-resolved in the background
+        // and injected into curl; 0 leaves all name resolution to curl.
+        env->PutInt("CurlDnsRefresh", 60);
+        env->ImportInt("CurlDnsRefresh", "XRD_CURLDNSREFRESH");
+        int dns_refresh = 60;
+        if (env->GetInt("CurlDnsRefresh", dns_refresh)) {
+            if (dns_refresh < 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the DNS refresh interval (%d); using default value of %d", dns_refresh, 60);
+                dns_refresh = 60;
+                env->PutInt("CurlDnsRefresh", dns_refresh);
+            }
+        }
+        XrdClCurl::DnsCache::Instance().Configure(std::chrono::seconds(dns_refresh));
+
+        // Adaptive tuning of the curl receive buffer and the socket buffers based on the
+        // measured bandwidth-delay product of each endpoint.
+        env->PutInt("CurlSocketTuning", 1);
+        env->ImportInt("CurlSocketTuning", "XRD_CURLSOCKETTUNING");
+        int socket_tuning = 1;
+        env->GetInt("CurlSocketTuning", socket_tuning);
+
+        // The smallest socket buffer size we will explicitly set; below this, the kernel's
+        // autotuning is used.
+        env->PutInt("CurlMinSocketBuffer", XrdClCurl::SocketTuning::m_default_min_socket_buffer);
+        env->ImportInt("CurlMinSocketBuffer", "XRD_CURLMINSOCKETBUFFER");
+        int min_socket_buffer = XrdClCurl::SocketTuning::m_default_min_socket_buffer;
+        if (env->GetInt("CurlMinSocketBuffer", min_socket_buffer)) {
+            if (min_socket_buffer < 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the minimum socket buffer size (%d); using default value of %d", min_socket_buffer, XrdClCurl::SocketTuning::m_default_min_socket_buffer);
+                min_socket_buffer = XrdClCurl::SocketTuning::m_default_min_socket_buffer;
+                env->PutInt("CurlMinSocketBuffer", min_socket_buffer);
+            }
+        }
+
+        // The largest socket buffer size we will request.
+        env->PutInt("CurlMaxSocketBuffer", XrdClCurl::SocketTuning::m_default_max_socket_buffer);
+        env->ImportInt("CurlMaxSocketBuffer", "XRD_CURLMAXSOCKETBUFFER");
+        int max_socket_buffer = XrdClCurl::SocketTuning::m_default_max_socket_buffer;
+        if (env->GetInt("CurlMaxSocketBuffer", max_socket_buffer)) {
+            if (max_socket_buffer <= 0) {
+                m_log->Error(kLogXrdClCurl, "Invalid value for the maximum socket buffer size (%d); using default value of %d", max_socket_buffer, XrdClCurl::SocketTuning::m_default_max_socket_buffer);
+                max_socket_buffer = XrdClCurl::SocketTuning::m_default_max_socket_buffer;
+                env->PutInt("CurlMaxSocketBuffer", max_socket_buffer);
+            }
+        }
+
+        // The TCP congestion control algorithm (e.g., "bbr") to use for new connections.
+        SetIfEmpty(env, *m_log, "CurlCongestionControl", "XRD_CURLCONGESTIONCONTROL");
+        std::string congestion;
+        env->GetString("CurlCongestionControl", congestion);
+
+        XrdClCurl::SocketTuning::Instance().Configure(socket_tuning, min_socket_buffer, max_socket_buffer, congestion);
+        m_log->Debug(kLogXrdClCurl, "Socket tuning is %s (socket buffer range %d-%d bytes, congestion control '%s')",
+            socket_tuning ? "enabled" : "disabled", min_socket_buffer, max_socket_buffer, congestion.c_str());
+
         // Determine the minimum header timeout.  It's somewhat arbitrarily defaulted to 2s; below
         // that and timeouts could be caused by OS scheduling noise.  If the client has unreasonable
         // expectations of the origin, we don't want to cause it to generate lots of origin-side load.
@@ -183,33 +509,61 @@ Factory::Initialize()
         }
         XrdClCurl::File::SetDefaultHeaderTimeout(dht);
 
-        // Start up the cache for the OPTIONS response
-        auto &cache = XrdClCurl::VerbsCache::Instance();
-
         // Startup curl workers after we've set the configs to avoid race conditions
-        for (unsigned idx=0; idx<m_poll_threads; idx++) {
-            m_workers.emplace_back(new XrdClCurl::CurlWorker(m_queue, cache, m_log));
-            std::thread t(XrdClCurl::CurlWorker::RunStatic, m_workers.back().get());
-            t.detach();
-        }
-
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_complete = false;
+        if (lazy_workers) {
+            m_log->Debug(kLogXrdClCurl, "Starting curl workers on demand");
+            m_queue->SetDemandCallback(Factory::OnDemand);
+        } else {
+            for (unsigned idx=0; idx<m_max_workers; idx++) {
+                StartWorker();
+            }
         }
-        std::thread t([this]{Monitor();});
-        t.detach();
 
         m_initialized = true;
     });
 }
 
+void
+Factory::StartWorker()
+{
+    std::unique_lock lock(m_workers_mutex);
+    if (m_workers.size() >= m_max_workers) {
+        return;
+    }
+    // Start up the cache for the OPTIONS response
+    auto &cache = XrdClCurl::VerbsCache::Instance();
+
+    m_workers.emplace_back(new XrdClCurl::CurlWorker(m_queue, cache, m_log));
+    std::thread t(XrdClCurl::CurlWorker::RunStatic, m_workers.back().get());
+    t.detach();
+    m_worker_count.store(m_workers.size(), std::memory_order_relaxed);
+
+    if (m_workers.size() == 1) {
+        m_monitor_task = Scheduler::Instance().Schedule("monitor", std::chrono::seconds(5), Factory::Monitor);
+    }
+}
+
+void
+Factory::OnDemand(size_t backlog)
+{
+    auto count = m_worker_count.load(std::memory_order_relaxed);
+    if (count >= m_max_workers) {
+        return;
+    }
+    // Each worker drives many transfers at once, so the backlog only grows past the
+    // number of workers when they cannot keep up with the rate of new operations.
+    if (count && backlog <= count) {
+        return;
+    }
+    m_log->Debug(kLogXrdClCurl, "Starting curl worker %u on demand (%zu operations waiting)", count + 1, backlog);
+    StartWorker();
+}
+
 void
 Factory::Monitor()
 {
-    // This function is run in a separate thread to monitor the XrdClCurl statistics.
-    // It periodically logs the statistics to the log file (and to the g-stream monitoring
-    // if available).
+    // This function is run periodically by the background scheduler to report the
+    // XrdClCurl statistics to the log file (and to the g-stream monitoring if available).
 
     XrdXrootdGStream *gstream = nullptr;
 #if XrdMajorVNUM(x) > 5
@@ -219,78 +573,56 @@ Factory::Monitor()
     gstream = gstream_void;
 #endif
 
-    while (true) {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_requested_cv.wait_for(
-                lock,
-                std::chrono::seconds(5),
-                []{return m_shutdown_requested;}
-            );
-            if (m_shutdown_requested) {
-                break;
-            }
+    auto now = std::chrono::system_clock::now();
+
+    std::string monitoring = "{\"event\": \"xrdclcurl\", "
+        "\"start\": " + std::to_string(std::chrono::duration<double>(m_start.time_since_epoch()).count()) + ","
+        "\"now\": " + std::to_string(std::chrono::duration<double>(now.time_since_epoch()).count()) + ","
+        "\"file\": " + File::GetMonitoringJson() + ","
+        "\"workers\": " + CurlWorker::GetMonitoringJson() + ","
+        "\"queues\": " + HandlerQueue::GetMonitoringJson() + ","
+        "\"completion\": " + CompletionExecutor::Instance().GetMonitoringJson() + ","
+        "\"tuning\": " + SocketTuning::Instance().GetMonitoringJson() + ","
+        "\"affinity\": " + WorkerAffinity::Instance().GetMonitoringJson() + ","
+        "\"ratelimit\": " + RateLimiter::Instance().GetMonitoringJson() + ","
+        "\"ca_store\": " + CAStore::Instance().GetMonitoringJson() + ","
+        "\"scheduler\": " + Scheduler::Instance().GetMonitoringJson() + ","
+        "\"scoreboard\": " + Scoreboard::Instance().GetMonitoringJson() + ","
+        "\"dns\": " + DnsCache::Instance().GetMonitoringJson() + ","
+        "\"coalescing\": " + ReadCoalescer::Instance().GetMonitoringJson() + ","
+        "\"read_window\": " + ReadWindow::GetMonitoringJson() + ","
+        "\"object_cache\": " + ObjectCache::Instance().GetMonitoringJson() + ","
+        "\"compression\": " + CurlOperation::GetCompressionMonitoringJson() +
+        " }";
+    m_log->Info(kLogXrdClCurl, "Client monitoring statistics: %s", monitoring.c_str());
+    if (gstream) {
+        gstream->Insert(monitoring.data(), monitoring.size() + 1);
+    }
+    if (!m_stats_location.empty())
+    {
+        auto stats_tmp = m_stats_location + ".XXXXXX";
+        std::vector<char> stats_vector(stats_tmp.size() + 1, '\0');
+        memcpy(&stats_vector[0], stats_tmp.data(), stats_tmp.size() + 1);
+        auto fd = mkstemp(&stats_vector[0]);
+        if (fd == -1) {
+            m_log->Warning(kLogXrdClCurl, "Failed to create temporary stats file %s: %s", m_stats_location.c_str(), strerror(errno));
+            return;
         }
-
-        auto now = std::chrono::system_clock::now();
-
-        std::string monitoring = "{\"event\": \"xrdclcurl\", "
-            "\"start\": " + std::to_string(std::chrono::duration<double>(m_start.time_since_epoch()).count()) + ","
-            "\"now\": " + std::to_string(std::chrono::duration<double>(now.time_since_epoch()).count()) + ","
-            "\"file\": " + File::GetMonitoringJson() + ","
-            "\"workers\": " + CurlWorker::GetMonitoringJson() + ","
-            "\"queues\": " + HandlerQueue::GetMonitoringJson() +
-            " }";
-        m_log->Info(kLogXrdClCurl, "Client monitoring statistics: %s", monitoring.c_str());
-        if (gstream) {
-            gstream->Insert(monitoring.data(), monitoring.size() + 1);
-        }
-        if (!m_stats_location.empty())
-        {
-            auto stats_tmp = m_stats_location + ".XXXXXX";
-            std::vector<char> stats_vector(stats_tmp.size() + 1, '\0');
-            memcpy(&stats_vector[0], stats_tmp.data(), stats_tmp.size() + 1);
-            auto fd = mkstemp(&stats_vector[0]);
-            if (fd == -1) {
-                m_log->Warning(kLogXrdClCurl, "Failed to create temporary stats file %s: %s", m_stats_location.c_str(), strerror(errno));
-                continue;
-            }
-            auto nb = write(fd, monitoring.data(), monitoring.size());
-            if (nb != static_cast<ssize_t>(monitoring.size())) {
-                if (nb == -1) m_log->Warning(kLogXrdClCurl, "Failed to write statistics into temporary file %s: %s", &stats_vector[0], strerror(errno));
-                else m_log->Warning(kLogXrdClCurl, "Failed to write statistics into temporary file %s: short write", &stats_vector[0]);
-                close(fd);
-                continue;
-            }
+        auto nb = write(fd, monitoring.data(), monitoring.size());
+        if (nb != static_cast<ssize_t>(monitoring.size())) {
+            if (nb == -1) m_log->Warning(kLogXrdClCurl, "Failed to write statistics into temporary file %s: %s", &stats_vector[0], strerror(errno));
+            else m_log->Warning(kLogXrdClCurl, "Failed to write statistics into temporary file %s: short write", &stats_vector[0]);
             close(fd);
-            auto rv = rename(&stats_vector[0], m_stats_location.c_str());
-            if (rv) {
-                m_log->Warning(kLogXrdClCurl, "Failed to atomically rename stats file to final destination %s: %s", m_stats_location.c_str(), strerror(errno));
-            }
+            return;
+        }
+        close(fd);
+        auto rv = rename(&stats_vector[0], m_stats_location.c_str());
+        if (rv) {
+            m_log->Warning(kLogXrdClCurl, "Failed to atomically rename stats file to final destination %s: %s", m_stats_location.c_str(), strerror(errno));
         }
-    }
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_complete = true;
-    m_shutdown_complete_cv.notify_one();
-}
-
-namespace {
-
-void SetIfEmpty(XrdCl::Env *env, XrdCl::Log &log, const std::string &optName, const std::string &envName) {
-    if (!env) return;
-
-    std::string val;
-    if (!env->GetString(optName, val) || val.empty()) {
-        env->PutString(optName, "");
-        env->ImportString(optName, envName);
-    }
-    if (env->GetString(optName, val) && !val.empty()) {
-        log.Info(kLogXrdClCurl, "Setting %s to value '%s'", optName.c_str(), val.c_str());
     }
 }
 
-} // namespace
-
 void
 Factory::SetupX509() {
 
@@ -327,11 +659,7 @@ Factory::SetupX509() {
 void
 Factory::Shutdown()
 {
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_requested = true;
-    m_shutdown_requested_cv.notify_one();
-
-    m_shutdown_complete_cv.wait(lock, []{return m_shutdown_complete;});
+    Scheduler::Instance().Cancel(m_monitor_task);
 }
 
 void
@@ -19,9 +19,11 @@
 #ifndef XRDCLCURL_FACTORY_HH
 #define XRDCLCURL_FACTORY_HH
 
+#include "../common/XrdClCurlScheduler.hh"
+
 #include "XrdCl/XrdClPlugInInterface.hh"
 
-#include <condition_variable>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -59,8 +61,16 @@ private:
     // Set the various X509 credential variables in the default environment.
     void SetupX509();
 
-    // Monitoring loop for XrdClCurl statistics
-    void Monitor();
+    // Periodic task reporting the XrdClCurl statistics
+    static void Monitor();
+
+    // Start another curl worker thread, unless the configured maximum is already running.
+    // The first worker started also starts the periodic monitoring.
+    static void StartWorker();
+
+    // Invoked by the work queue as operations are produced when the workers are started
+    // lazily; starts a worker if the backlog exceeds the number running.
+    static void OnDemand(size_t backlog);
 
     // Invoked by libc when the library is shutting down or is unloaded from the process.
     static void Shutdown() __attribute__((destructor));
@@ -69,6 +79,12 @@ private:
     static std::shared_ptr<XrdClCurl::HandlerQueue> m_queue;
     static XrdCl::Log *m_log;
     static std::vector<std::unique_ptr<XrdClCurl::CurlWorker>> m_workers;
+    // Protects m_workers
+    static std::mutex m_workers_mutex;
+    // Number of entries in m_workers; read without the lock on the produce path.
+    static std::atomic<unsigned> m_worker_count;
+    // Maximum number of curl workers (CurlNumThreads).
+    static unsigned m_max_workers;
     const static unsigned m_poll_threads{8};
     static std::once_flag m_init_once;
     // Location for the client to dump its runtime statistics.
@@ -77,16 +93,8 @@ private:
     // Start time of the factory
     static std::chrono::system_clock::time_point m_start;
 
-    // Mutex for managing the shutdown of the background thread
-    static std::mutex m_shutdown_lock;
-    // Condition variable managing the requested shutdown of the background thread.
-    static std::condition_variable m_shutdown_requested_cv;
-    // Flag indicating that a shutdown was requested.
-    static bool m_shutdown_requested;
-    // Condition variable for the background thread to indicate it has completed.
-    static std::condition_variable m_shutdown_complete_cv;
-    // Flag indicating that the shutdown has completed.
-    static bool m_shutdown_complete;
+    // Scheduler task for the periodic monitoring report.
+    static Scheduler::TaskId m_monitor_task;
 };
 
 }
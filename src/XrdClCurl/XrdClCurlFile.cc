@@ -16,10 +16,13 @@
  *
  ***************************************************************/
 
+#include "../common/XrdClCurlDnsCache.hh"
 #include "XrdClCurlFile.hh"
 #include "XrdClCurlFilesystem.hh"
+#include "XrdClCurlObjectCache.hh"
 #include "XrdClCurlOps.hh"
 #include "XrdClCurlParseTimeout.hh"
+#include "XrdClCurlReadCoalescer.hh"
 #include "XrdClCurlResponses.hh"
 #include "XrdClCurlUtil.hh"
 #include "XrdClCurlWorker.hh"
@@ -33,7 +36,13 @@
 #include <XrdSys/XrdSysPageSize.hh>
 #include <nlohmann/json.hpp>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <charconv>
+#include <cstring>
 #include <iostream>
 
 using namespace XrdClCurl;
@@ -44,6 +53,8 @@ std::atomic<uint64_t> File::m_prefetch_failed_count = 0;
 std::atomic<uint64_t> File::m_prefetch_reads_hit = 0;
 std::atomic<uint64_t> File::m_prefetch_reads_miss = 0;
 std::atomic<uint64_t> File::m_prefetch_bytes_used = 0;
+std::atomic<uint64_t> File::m_prefetch_resumed_count = 0;
+std::atomic<unsigned> File::m_max_resume_attempts = 3;
 
 namespace {
 
@@ -124,10 +135,54 @@ private:
     XrdCl::ResponseHandler *m_handler;  // The handler to call with the final result
 };
 
+// A response handler for the GET filling the object cache with the full contents
+// of a small object.  Completes the fill, waking up the readers waiting on it.
+class ObjectCacheFillHandler : public XrdCl::ResponseHandler {
+public:
+    ObjectCacheFillHandler(const std::string &key, std::shared_ptr<XrdClCurl::ObjectCache::Object> object)
+        : m_key(key), m_object(object)
+    {}
+
+    virtual void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) {
+        std::unique_ptr<ObjectCacheFillHandler> holder(this);
+        std::unique_ptr<XrdCl::AnyObject> response_holder(response);
+        std::unique_ptr<XrdCl::XRootDStatus> status_holder(status);
+
+        XrdCl::ChunkInfo *ci = nullptr;
+        if (status && status->IsOK() && response) {
+            response->Get(ci);
+        }
+        // A short read means the object changed size since it was opened; don't cache it.
+        if (!ci || ci->length != m_object->m_data.size()) {
+            XrdClCurl::ObjectCache::Instance().FinishFill(m_key, nullptr);
+            return;
+        }
+        XrdClCurl::ObjectCache::Instance().FinishFill(m_key, std::move(m_object));
+    }
+
+private:
+    const std::string m_key; // The URL identifying the object in the cache.
+    std::shared_ptr<XrdClCurl::ObjectCache::Object> m_object; // The object being filled; the GET writes into its data.
+};
+
+// Copy a read out of a cached object and invoke the handler.
+void ServeFromObject(const XrdClCurl::ObjectCache::Object &object, uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler)
+{
+    uint32_t length = 0;
+    if (offset < object.m_data.size()) {
+        length = std::min<uint64_t>(size, object.m_data.size() - offset);
+        memcpy(buffer, object.m_data.data() + offset, length);
+    }
+    XrdClCurl::ObjectCache::Instance().RecordBytesSaved(length);
+    auto obj = new XrdCl::AnyObject();
+    obj->Set(new XrdCl::ChunkInfo(offset, length, buffer));
+    handler->HandleResponse(new XrdCl::XRootDStatus(), obj);
+}
+
 // A response handler that transforms the read result into a PageInfo object.
 // This is used for page reads which require a checksum of each page; note
 // this is computed client-side whereas for the xroot protocol the checksum is computed server-side.
-class PgReadResponseHandler : public XrdCl::ResponseHandler {
+class PgReadResponseHandler : public XrdCl::ResponseHandler, public XrdClCurl::Pooled {
 public:
     PgReadResponseHandler(XrdCl::ResponseHandler *handler)
         : m_handler(handler)
@@ -182,8 +237,8 @@ private:
     XrdCl::ResponseHandler *m_handler;
 };
 
-// A response handler for close operations that require creating a zero-length
-// object.
+// A response handler for close operations that upload the object themselves (a
+// zero-length object or the contents of a local file).
 class CloseCreateHandler : public XrdCl::ResponseHandler {
 public:
     CloseCreateHandler(XrdCl::ResponseHandler *handler)
@@ -209,6 +264,8 @@ private:
 struct timespec XrdClCurl::File::m_min_client_timeout = {2, 0};
 struct timespec XrdClCurl::File::m_default_header_timeout = {9, 5};
 struct timespec XrdClCurl::File::m_fed_timeout = {5, 0};
+std::string XrdClCurl::File::m_default_upload_checksum;
+bool XrdClCurl::File::m_default_upload_checksum_trailer{false};
 
 CreateConnCalloutType
 File::GetConnCallout() const {
@@ -291,7 +348,8 @@ File::GetMonitoringJson()
         "\"failed\": " + std::to_string(m_prefetch_failed_count) + ","
         "\"reads_hit\": " + std::to_string(m_prefetch_reads_hit) + ","
         "\"reads_miss\": " + std::to_string(m_prefetch_reads_miss) + ","
-        "\"bytes_used\": " + std::to_string(m_prefetch_bytes_used) +
+        "\"bytes_used\": " + std::to_string(m_prefetch_bytes_used) + ","
+        "\"resumed\": " + std::to_string(m_prefetch_resumed_count) +
     "}}";
 }
 
@@ -360,14 +418,50 @@ File::Open(const std::string      &url,
     m_last_url = "";
     m_url_current = "";
 
+    if (!m_read_window && !(flags & XrdCl::OpenFlags::Write) && ReadWindow::GetWindow().count() > 0) {
+        m_read_window = std::make_shared<ReadWindow>(
+            [this](uint64_t offset, uint32_t size, char *buffer, XrdCl::ResponseHandler *handler, time_t timeout) {
+                return ReadRange(offset, size, buffer, handler, static_cast<timeout_t>(timeout));
+            });
+    }
+
     auto ts = GetHeaderTimeout(timeout);
 
     bool full_download = m_full_download.load(std::memory_order_relaxed);
+
+    // Created before any early return below; reads, writes, and property lookups on an
+    // open handle all expect the default prefetch handler to exist.
     m_default_prefetch_handler.reset(new PrefetchDefaultHandler(*this));
     if (full_download) {
         m_default_prefetch_handler->m_prefetch_enabled.store(true, std::memory_order_relaxed);
     }
 
+    {
+        std::unique_lock lock(m_cached_mutex);
+        m_cache_key = url;
+        m_cached_object.reset();
+        m_cache_bypass = full_download || (flags & XrdCl::OpenFlags::Write) || !ObjectCache::Instance().IsEnabled();
+    }
+    // A small object read recently through another handle is served from memory
+    // without contacting the server.  Callers expecting response info get it from
+    // the server instead.
+    if (handler && !full_download && !(flags & XrdCl::OpenFlags::Write) && !SendResponseInfo()) {
+        if (auto object = ObjectCache::Instance().Get(url)) {
+            m_logger->Debug(kLogXrdClCurl, "Opening %s from the object cache", m_url.c_str());
+            SetProperty("ContentLength", std::to_string(object->m_data.size()));
+            if (!object->m_etag.empty()) {
+                SetProperty("ETag", object->m_etag);
+            }
+            {
+                std::unique_lock lock(m_cached_mutex);
+                m_cached_object = object;
+            }
+            m_is_opened = true;
+            handler->HandleResponse(new XrdCl::XRootDStatus(), nullptr);
+            return XrdCl::XRootDStatus();
+        }
+    }
+
     if (full_download && !(flags & XrdCl::OpenFlags::Write)) {
         m_logger->Debug(kLogXrdClCurl, "Opening %s in full download mode", m_url.c_str());
 
@@ -413,10 +507,14 @@ File::Close(XrdCl::ResponseHandler *handler,
         return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp);
     }
     m_is_opened = false;
+    if (m_read_window) {
+        m_read_window->Flush();
+    }
 
     std::unique_ptr<XrdCl::XRootDStatus> status(new XrdCl::XRootDStatus{});
     if (m_put_op && !m_put_op->HasFailed()) {
-        if (m_asize >= 0 && m_offset == m_asize) {
+        // A checksum trailer is only sent after the final (empty) buffer.
+        if (m_asize >= 0 && m_offset == m_asize && !m_put_op->HasChecksumTrailer()) {
             if (m_offset == m_asize) {
                 m_logger->Debug(kLogXrdClCurl, "Closing a finished file %s", m_url.c_str());
             } else {
@@ -435,6 +533,58 @@ File::Close(XrdCl::ResponseHandler *handler,
                 return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError);
             }
         }
+    } else if (!m_put_op && (m_open_flags & XrdCl::OpenFlags::Write) && m_upload_source.load(std::memory_order_relaxed)) {
+        int fd;
+        bool owned;
+        off_t size;
+        auto st = OpenUploadSource(fd, owned, size);
+        if (!st.IsOK()) {
+            return st;
+        }
+        m_asize = size;
+        m_put_op.reset(new XrdClCurl::CurlPutOp(
+            new CloseCreateHandler(handler), m_default_put_handler, GetCurrentURL(), fd, owned, size,
+            GetHeaderTimeout(timeout), m_logger, GetConnCallout(), &m_default_header_callout
+        ));
+        ConfigureUploadChecksum(*m_put_op, 0);
+        try {
+            m_queue->Produce(m_put_op);
+        } catch (...) {
+            m_logger->Warning(kLogXrdClCurl, "Failed to add put op to queue");
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError);
+        }
+        m_logger->Debug(kLogXrdClCurl, "Uploading %lld bytes from a local file to %s for close", static_cast<long long>(size), m_url.c_str());
+        m_url_current = "";
+        m_last_url = "";
+        return {};
+    } else if (!(m_open_flags & XrdCl::OpenFlags::Write) && m_download_destination.load(std::memory_order_relaxed)) {
+        if (m_full_download.load(std::memory_order_relaxed)) {
+            // The object is already streaming to the caller's reads.
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "Downloads to a local file are not supported in full-download mode");
+        }
+        int fd;
+        bool owned;
+        auto st = OpenDownloadDestination(fd, owned);
+        if (!st.IsOK()) {
+            return st;
+        }
+        std::shared_ptr<XrdClCurl::CurlDownloadOp> download_op(new XrdClCurl::CurlDownloadOp(
+            new CloseCreateHandler(handler), GetCurrentURL(), GetHeaderTimeout(timeout), fd, owned,
+            m_logger, GetConnCallout(), &m_default_header_callout
+        ));
+        std::string value;
+        download_op->SetPreallocate(!GetProperty("XrdClCurlDownloadPreallocate", value) || value != "false");
+        download_op->SetSync(GetProperty("XrdClCurlDownloadSync", value) && value == "true");
+        try {
+            m_queue->Produce(download_op);
+        } catch (...) {
+            m_logger->Warning(kLogXrdClCurl, "Failed to add download op to queue");
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError);
+        }
+        m_logger->Debug(kLogXrdClCurl, "Downloading %s to a local file for close", m_url.c_str());
+        m_url_current = "";
+        m_last_url = "";
+        return {};
     } else if (!m_put_op && m_open_flags & XrdCl::OpenFlags::Write) {
         timespec ts;
         timespec_get(&ts, TIME_UTC);
@@ -444,6 +594,7 @@ File::Close(XrdCl::ResponseHandler *handler,
             new CloseCreateHandler(handler), m_default_put_handler, m_url, nullptr, 0, ts, m_logger,
             GetConnCallout(), &m_default_header_callout
         ));
+        ConfigureUploadChecksum(*m_put_op, 0);
         try {
             m_queue->Produce(m_put_op);
         } catch (...) {
@@ -615,6 +766,9 @@ File::Read(uint64_t                offset,
         m_logger->Error(kLogXrdClCurl, "Cannot read.  URL isn't open");
         return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp);
     }
+    if (ReadCached(offset, size, buffer, handler, timeout)) {
+        return XrdCl::XRootDStatus();
+    }
     auto [status, ok] = ReadPrefetch(offset, size, buffer, handler, timeout, false);
     if (ok) {
         m_logger->Debug(kLogXrdClCurl, "Read %s (%d bytes at offset %lld) will be served from prefetch handler", m_url.c_str(), size, static_cast<long long>(offset));
@@ -622,6 +776,31 @@ File::Read(uint64_t                offset,
     } else if (m_full_download.load(std::memory_order_relaxed)) {
         std::unique_lock lock(m_default_prefetch_handler->m_prefetch_mutex);
         if (m_prefetch_op && m_prefetch_op->IsDone() && (static_cast<off_t>(offset) == m_prefetch_offset.load(std::memory_order_acquire))) {
+            if (m_prefetch_op->HasFailed() && !m_last_prefetch_handler) {
+                // The GET failed while no read was outstanding (typically a stall because the
+                // caller was slow to read); resume it starting with this read.
+                auto &default_handler = *m_default_prefetch_handler;
+                auto failure = default_handler.m_failure;
+                // If the default handler has not recorded the failure yet, it is about to; the
+                // failures it sees without a read outstanding are stalls or network errors.
+                auto pending = failure.IsOK();
+                if (pending) {
+                    failure = XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOperationExpired, 0, "Prefetch operation failed");
+                }
+                std::string etag;
+                if (!CanResumePrefetch(failure, etag)) {
+                    return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errDataError, 0, "Full download of the object failed: " + failure.ToStr());
+                }
+                if (pending) {
+                    default_handler.m_skip_failures++;
+                }
+                default_handler.m_failure = XrdCl::XRootDStatus();
+                m_prefetch_op.reset();
+                auto prefetch_handler = new PrefetchResponseHandler(*this, offset, size, &m_prefetch_offset, static_cast<char *>(buffer), handler, timeout);
+                ResumePrefetch(prefetch_handler, offset, static_cast<char *>(buffer), size, etag, timeout);
+                m_prefetch_offset.store(offset + size, std::memory_order_release);
+                return XrdCl::XRootDStatus{};
+            }
             if (handler) {
                 auto ci = new XrdCl::ChunkInfo(offset, 0, buffer);
                 auto obj = new XrdCl::AnyObject();
@@ -633,27 +812,158 @@ File::Read(uint64_t                offset,
         return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "Non-sequential read detected when in full-download mode");
     }
 
+    // Small reads issued while others are outstanding may be held briefly to merge them with nearby reads.
+    if (m_read_window && m_read_window->Submit(offset, size, buffer, handler, timeout)) {
+        return XrdCl::XRootDStatus();
+    }
+
+    return ReadRange(offset, size, buffer, handler, timeout);
+}
+
+XrdCl::XRootDStatus
+File::ReadRange(uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler, timeout_t timeout)
+{
     auto ts = GetHeaderTimeout(timeout);
     auto url = GetCurrentURL();
+
+    // Identical reads of the same object through other file handles may already be
+    // in flight; if so, share their transfer.
+    auto &coalescer = ReadCoalescer::Instance();
+    bool coalesced = handler && coalescer.IsEnabled();
+    if (coalesced) {
+        std::string etag;
+        GetProperty("ETag", etag);
+        handler = coalescer.Submit(ReadCoalescer::GetKey(url, etag), offset, size, buffer, handler);
+        if (!handler) {
+            m_logger->Debug(kLogXrdClCurl, "Read %s (%d bytes at offset %lld) attached to an in-flight read", url.c_str(), size, static_cast<long long>(offset));
+            return XrdCl::XRootDStatus();
+        }
+    }
     m_logger->Debug(kLogXrdClCurl, "Read %s (%d bytes at offset %lld with timeout %lld)", url.c_str(), size, static_cast<long long>(offset), static_cast<long long>(ts.tv_sec));
 
-    std::shared_ptr<XrdClCurl::CurlReadOp> readOp(
-        new XrdClCurl::CurlReadOp(
-            handler, m_default_prefetch_handler, url, ts, std::make_pair(offset, size),
-            static_cast<char*>(buffer), size, m_logger,
-           GetConnCallout(), &m_default_header_callout
-        )
+    auto readOp = XrdClCurl::MakePooled<XrdClCurl::CurlReadOp>(
+        handler, m_default_prefetch_handler, url, ts, std::make_pair(offset, size),
+        static_cast<char*>(buffer), size, m_logger,
+        GetConnCallout(), &m_default_header_callout
     );
     try {
         m_queue->Produce(std::move(readOp));
     } catch (...) {
         m_logger->Warning(kLogXrdClCurl, "Failed to add read op to queue");
+        if (coalesced) {
+            coalescer.Abandon(handler);
+        }
         return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError);
     }
 
     return XrdCl::XRootDStatus();
 }
 
+bool
+File::ReadCached(uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler, timeout_t timeout)
+{
+    if (!handler) {
+        return false;
+    }
+    std::shared_ptr<const ObjectCache::Object> object;
+    std::string key;
+    {
+        std::unique_lock lock(m_cached_mutex);
+        if (m_cache_bypass) {
+            return false;
+        }
+        object = m_cached_object;
+        key = m_cache_key;
+    }
+    auto &cache = ObjectCache::Instance();
+    std::string etag;
+    GetProperty("ETag", etag);
+    if (!object) {
+        // The server may have confirmed the ETag of a copy that outlived its TTL.
+        object = cache.Revalidate(key, etag);
+    }
+    if (object) {
+        {
+            std::unique_lock lock(m_cached_mutex);
+            m_cached_object = object;
+        }
+        m_logger->Debug(kLogXrdClCurl, "Read %s (%d bytes at offset %lld) will be served from the object cache", m_url.c_str(), size, static_cast<long long>(offset));
+        ServeFromObject(*object, offset, size, buffer, handler);
+        return true;
+    }
+
+    std::string content_length_str;
+    int64_t content_length = -1;
+    if (GetProperty("ContentLength", content_length_str)) {
+        auto ec = std::from_chars(content_length_str.c_str(), content_length_str.c_str() + content_length_str.size(), content_length);
+        if (ec.ec != std::errc()) {
+            content_length = -1;
+        }
+    }
+    if (content_length <= 0 || !cache.IsCacheable(content_length)) {
+        std::unique_lock lock(m_cached_mutex);
+        m_cache_bypass = true;
+        return false;
+    }
+
+    // Fetch the whole object once; this read (and any other read of the object
+    // issued meanwhile) is served when the fill completes.
+    auto on_fill = [token=m_fill_token, offset, size, buffer, handler, timeout, etag](std::shared_ptr<const ObjectCache::Object> object) {
+        // The handle may be destroyed once its handler is invoked; hold the token
+        // only while touching the handle itself.
+        std::unique_lock token_lock(token->m_mutex);
+        auto file = token->m_file;
+        if (object && (etag.empty() || object->m_etag.empty() || object->m_etag == etag)) {
+            if (file) {
+                std::unique_lock lock(file->m_cached_mutex);
+                file->m_cached_object = object;
+            }
+            token_lock.unlock();
+            ServeFromObject(*object, offset, size, buffer, handler);
+            return;
+        }
+        if (!file) {
+            token_lock.unlock();
+            handler->HandleResponse(new XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "File was destroyed while waiting on the object cache"), nullptr);
+            return;
+        }
+        {
+            std::unique_lock lock(file->m_cached_mutex);
+            file->m_cache_bypass = true;
+        }
+        auto status = file->ReadRange(offset, size, buffer, handler, timeout);
+        token_lock.unlock();
+        if (!status.IsOK()) {
+            handler->HandleResponse(new XrdCl::XRootDStatus(status), nullptr);
+        }
+    };
+    if (!cache.StartFill(key, std::move(on_fill))) {
+        m_logger->Debug(kLogXrdClCurl, "Read %s (%d bytes at offset %lld) waiting on an in-progress object cache fill", m_url.c_str(), size, static_cast<long long>(offset));
+        return true;
+    }
+
+    m_logger->Debug(kLogXrdClCurl, "Filling the object cache with %s (%lld bytes)", m_url.c_str(), static_cast<long long>(content_length));
+    auto fill = std::make_shared<ObjectCache::Object>();
+    fill->m_etag = etag;
+    fill->m_data.resize(content_length);
+    auto fill_handler = new ObjectCacheFillHandler(key, fill);
+    std::shared_ptr<XrdClCurl::CurlReadOp> readOp(
+        new XrdClCurl::CurlReadOp(
+            fill_handler, m_default_prefetch_handler, GetCurrentURL(), GetHeaderTimeout(timeout),
+            std::pair<uint64_t, uint64_t>(0, content_length), fill->m_data.data(), content_length, m_logger,
+            GetConnCallout(), &m_default_header_callout
+        )
+    );
+    try {
+        m_queue->Produce(std::move(readOp));
+    } catch (...) {
+        m_logger->Warning(kLogXrdClCurl, "Failed to add object cache fill op to queue");
+        // Completes the fill as failed; the waiting reads fall back to regular reads.
+        fill_handler->HandleResponse(new XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError), nullptr);
+    }
+    return true;
+}
+
 std::tuple<XrdCl::XRootDStatus, bool>
 File::ReadPrefetch(uint64_t offset, uint64_t size, void *buffer, XrdCl::ResponseHandler *handler, timeout_t timeout, bool isPgRead)
 {
@@ -706,6 +1016,9 @@ File::ReadPrefetch(uint64_t offset, uint64_t size, void *buffer, XrdCl::Response
                 GetConnCallout(), &m_default_header_callout
             )
         );
+        if (!m_is_opened && m_accept_encoding.load(std::memory_order_relaxed)) {
+            m_prefetch_op->SetAcceptEncoding();
+        }
         lock.unlock();
         try {
             m_queue->Produce(m_prefetch_op);
@@ -746,6 +1059,89 @@ File::ReadPrefetch(uint64_t offset, uint64_t size, void *buffer, XrdCl::Response
     return std::make_tuple(XrdCl::XRootDStatus{}, true);
 }
 
+bool
+File::CanResumePrefetch(const XrdCl::XRootDStatus &status, std::string &etag)
+{
+    if (!m_full_download.load(std::memory_order_relaxed) || status.IsOK()) {
+        return false;
+    }
+    // Offsets into a compressed response can't be used to resume it.
+    if (m_accept_encoding.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    bool transient = false;
+    switch (status.code) {
+        case XrdCl::errOperationExpired:
+        case XrdCl::errSocketError:
+        case XrdCl::errConnectionError:
+        case XrdCl::errDataError:
+            transient = true;
+            break;
+        case XrdCl::errErrorResponse:
+            transient = status.errNo == kXR_ServerError || status.errNo == kXR_ReqTimedOut || status.errNo == kXR_Overloaded;
+#ifdef HAVE_XPROTOCOL_TIMEREXPIRED
+            transient = transient || status.errNo == kXR_TimerExpired;
+#endif
+            break;
+    }
+    if (!transient) {
+        return false;
+    }
+    auto max_attempts = m_max_resume_attempts.load(std::memory_order_relaxed);
+    if (m_resume_attempts >= max_attempts) {
+        if (max_attempts) {
+            m_logger->Warning(kLogXrdClCurl, "Not resuming the download of %s; it has already been resumed %u times", m_url.c_str(), m_resume_attempts);
+        }
+        return false;
+    }
+    // Weak ETags (W/...) cannot be used with If-Match; without a strong validator,
+    // we cannot guarantee the remaining bytes belong to the same object.
+    std::string value;
+    if (!GetProperty("ETag", value) || value.empty() || !value.compare(0, 2, "W/")) {
+        m_logger->Debug(kLogXrdClCurl, "Not resuming the download of %s; the object has no strong ETag", m_url.c_str());
+        return false;
+    }
+    etag = "\"" + value + "\"";
+    return true;
+}
+
+void
+File::ResumePrefetch(PrefetchResponseHandler *handler, off_t offset, char *buffer, size_t size,
+    const std::string &etag, timeout_t timeout)
+{
+    m_resume_attempts++;
+    auto backoff = std::min(m_resume_max_backoff, m_resume_backoff * (1 << std::min(m_resume_attempts - 1, 5u)));
+
+    // The first attempt goes back to the server we were reading from.  Later attempts
+    // restart from the URL given to Open() so a redirector may select another mirror.
+    if (m_resume_attempts > 1) {
+        std::unique_lock lock(m_properties_mutex);
+        m_last_url = "";
+        m_url_current = "";
+    }
+    auto url = GetCurrentURL();
+
+    // The header timeout starts when the operation is created; extend it to cover the backoff.
+    auto ts = GetHeaderTimeout(timeout);
+    ts.tv_sec += std::chrono::duration_cast<std::chrono::seconds>(backoff).count();
+
+    std::shared_ptr<XrdClCurl::CurlReadOp> op(
+        new XrdClCurl::CurlReadOp(
+            handler, m_default_prefetch_handler, url, ts, std::make_pair(offset, m_prefetch_size),
+            buffer, size, m_logger, GetConnCallout(), &m_default_header_callout
+        )
+    );
+    op->SetIfMatch(etag);
+    m_prefetch_op = op;
+    m_default_prefetch_handler->m_prefetch_enabled = true;
+    m_prefetch_resumed_count.fetch_add(1, std::memory_order_relaxed);
+
+    m_logger->Warning(kLogXrdClCurl, "Resuming the download of %s at offset %lld in %.1f seconds (attempt %u of %u)",
+        url.c_str(), static_cast<long long>(offset), std::chrono::duration<double>(backoff).count(),
+        m_resume_attempts, m_max_resume_attempts.load(std::memory_order_relaxed));
+    m_queue->ProduceAfter(std::move(op), std::chrono::steady_clock::now() + backoff);
+}
+
 XrdCl::XRootDStatus
 File::VectorRead(const XrdCl::ChunkList &chunks,
                  void                   *buffer,
@@ -774,10 +1170,8 @@ File::VectorRead(const XrdCl::ChunkList &chunks,
     auto url = GetCurrentURL();
     m_logger->Debug(kLogXrdClCurl, "Read %s (%lld chunks; first chunk is %u bytes at offset %lld with timeout %lld)", url.c_str(), static_cast<long long>(chunks.size()), static_cast<unsigned>(chunks[0].GetLength()), static_cast<long long>(chunks[0].GetOffset()), static_cast<long long>(ts.tv_sec));
 
-    std::shared_ptr<XrdClCurl::CurlVectorReadOp> readOp(
-        new XrdClCurl::CurlVectorReadOp(
-            handler, url, ts, chunks, m_logger, GetConnCallout(), &m_default_header_callout
-        )
+    auto readOp = XrdClCurl::MakePooled<XrdClCurl::CurlVectorReadOp>(
+        handler, url, ts, chunks, m_logger, GetConnCallout(), &m_default_header_callout
     );
     try {
         m_queue->Produce(std::move(readOp));
@@ -801,6 +1195,8 @@ File::Write(uint64_t                offset,
         return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp);
     } else if (m_full_download.load(std::memory_order_relaxed)) {
         return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "Only sequential reads are supported when in full-download mode");
+    } else if (m_upload_source.load(std::memory_order_relaxed)) {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "Writes are not supported when uploading from a local file");
     }
     m_default_prefetch_handler->DisablePrefetch();
 
@@ -817,6 +1213,7 @@ File::Write(uint64_t                offset,
             handler, m_default_put_handler, url, static_cast<const char*>(buffer), size, ts, m_logger,
             GetConnCallout(), &m_default_header_callout
         ));
+        ConfigureUploadChecksum(*m_put_op, size);
         try {
             m_queue->Produce(m_put_op);
         } catch (...) {
@@ -855,6 +1252,8 @@ File::Write(uint64_t                offset,
     if (!m_is_opened) {
         m_logger->Error(kLogXrdClCurl, "Cannot write: URL isn't open");
         return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp);
+    } else if (m_upload_source.load(std::memory_order_relaxed)) {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidOp, 0, "Writes are not supported when uploading from a local file");
     }
     m_default_prefetch_handler->DisablePrefetch();
 
@@ -866,10 +1265,12 @@ File::Write(uint64_t                offset,
         if (offset != 0) {
             return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "HTTP uploads must start at offset 0");
         }
+        auto size = buffer.GetSize();
         m_put_op.reset(new XrdClCurl::CurlPutOp(
             handler, m_default_put_handler, url, std::move(buffer), ts, m_logger,
             GetConnCallout(), &m_default_header_callout
         ));
+        ConfigureUploadChecksum(*m_put_op, size);
 
         try {
             m_queue->Produce(m_put_op);
@@ -900,6 +1301,104 @@ File::Write(uint64_t                offset,
     return XrdCl::XRootDStatus();
 }
 
+XrdCl::XRootDStatus
+File::OpenUploadSource(int &fd, bool &owned, off_t &size)
+{
+    std::string value;
+    if (GetProperty("XrdClCurlUploadPath", value) && !value.empty()) {
+        fd = open(value.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            auto err = errno;
+            m_logger->Error(kLogXrdClCurl, "Failed to open upload source %s: %s", value.c_str(), strerror(err));
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError, err, "Failed to open upload source " + value);
+        }
+        owned = true;
+    } else if (GetProperty("XrdClCurlUploadFd", value) && !value.empty()) {
+        auto ec = std::from_chars(value.c_str(), value.c_str() + value.size(), fd);
+        if (ec.ec != std::errc() || ec.ptr != value.c_str() + value.size() || fd < 0) {
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "Invalid upload file descriptor: " + value);
+        }
+        owned = false;
+    } else {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "No upload source set");
+    }
+    struct stat buf;
+    int err = 0;
+    if (fstat(fd, &buf) == -1) {
+        err = errno;
+    } else if (!S_ISREG(buf.st_mode)) {
+        err = EINVAL;
+    }
+    if (err) {
+        if (owned) close(fd);
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError, err, "Upload source is not a regular file");
+    }
+    size = buf.st_size;
+    return {};
+}
+
+XrdCl::XRootDStatus
+File::OpenDownloadDestination(int &fd, bool &owned)
+{
+    std::string value;
+    if (GetProperty("XrdClCurlDownloadPath", value) && !value.empty()) {
+        int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        std::string direct;
+#ifdef O_DIRECT
+        if (GetProperty("XrdClCurlDownloadDirect", direct) && direct == "true") {
+            flags |= O_DIRECT;
+        }
+#endif
+        fd = open(value.c_str(), flags, 0644);
+        if (fd < 0) {
+            auto err = errno;
+            m_logger->Error(kLogXrdClCurl, "Failed to open download destination %s: %s", value.c_str(), strerror(err));
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError, err, "Failed to open download destination " + value);
+        }
+        owned = true;
+    } else if (GetProperty("XrdClCurlDownloadFd", value) && !value.empty()) {
+        auto ec = std::from_chars(value.c_str(), value.c_str() + value.size(), fd);
+        if (ec.ec != std::errc() || ec.ptr != value.c_str() + value.size() || fd < 0) {
+            return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "Invalid download file descriptor: " + value);
+        }
+        // The object replaces the file's contents: it's written with pwrite from offset 0
+        // and the file is truncated to its size.
+        owned = false;
+    } else {
+        return XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidArgs, 0, "No download destination set");
+    }
+    return {};
+}
+
+void
+File::ConfigureUploadChecksum(CurlPutOp &op, uint64_t first_write)
+{
+    std::string name;
+    if (!GetProperty("XrdClCurlUploadChecksum", name)) {
+        name = m_default_upload_checksum;
+    }
+    auto algorithm = UploadChecksum::ParseAlgorithm(name);
+    if (algorithm == UploadChecksum::Algorithm::kNone) {
+        if (!name.empty()) {
+            m_logger->Warning(kLogXrdClCurl, "Unknown upload checksum type '%s'; not computing a checksum", name.c_str());
+        }
+        return;
+    }
+    std::string style;
+    GetProperty("XrdClCurlUploadChecksumStyle", style);
+    // When the first write is the whole object, the checksum goes out with the headers.
+    bool complete = m_asize >= 0 && first_write == static_cast<uint64_t>(m_asize);
+    // An upload of unknown size is chunked anyway; one of known size keeps its
+    // Content-Length unless trailers were requested.
+    bool trailer = m_asize < 0;
+    std::string trailer_value;
+    if (!trailer) {
+        trailer = GetProperty("XrdClCurlUploadChecksumTrailer", trailer_value) ? trailer_value == "true" : m_default_upload_checksum_trailer;
+    }
+    op.SetUploadChecksum(algorithm, style == "s3" ? UploadChecksum::Style::kS3 : UploadChecksum::Style::kDigest,
+        complete, trailer);
+}
+
 XrdCl::XRootDStatus
 File::PgRead(uint64_t                offset,
              uint32_t                size,
@@ -923,12 +1422,10 @@ File::PgRead(uint64_t                offset,
     auto url = GetCurrentURL();
     m_logger->Debug(kLogXrdClCurl, "PgRead %s (%d bytes at offset %lld)", url.c_str(), size, static_cast<long long>(offset));
 
-    std::shared_ptr<XrdClCurl::CurlPgReadOp> readOp(
-        new XrdClCurl::CurlPgReadOp(
-            handler, m_default_prefetch_handler, url, ts, std::make_pair(offset, size),
-            static_cast<char*>(buffer), size, m_logger,
-            GetConnCallout(), &m_default_header_callout
-        )
+    auto readOp = XrdClCurl::MakePooled<XrdClCurl::CurlPgReadOp>(
+        handler, m_default_prefetch_handler, url, ts, std::make_pair(offset, size),
+        static_cast<char*>(buffer), size, m_logger,
+        GetConnCallout(), &m_default_header_callout
     );
 
     try {
@@ -961,6 +1458,43 @@ File::GetProperty(const std::string &name,
         return true;
     }
 
+    // Checksum ("<algorithm> <hex value>") of the bytes uploaded through this handle,
+    // available once the upload completed.
+    if (name == "XrdClCurlUploadChecksumValue") {
+        if (!m_put_op || !m_put_op->IsDone() || m_put_op->HasFailed()) {
+            return false;
+        }
+        value = m_put_op->GetUploadChecksum();
+        return !value.empty();
+    }
+
+    // Address (in hex) of this library's endpoint scoreboard, allowing other plugins
+    // layered on top of this one to rank servers with it.
+    if (name == "XrdClCurlScoreboard") {
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), reinterpret_cast<uintptr_t>(&Scoreboard::Instance()), 16);
+        value = std::string(buf, result.ptr - buf);
+        return true;
+    }
+
+    // Address (in hex) of this library's DNS cache, allowing other plugins to register
+    // hosts they expect to contact.
+    if (name == "XrdClCurlDnsCache") {
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), reinterpret_cast<uintptr_t>(&DnsCache::Instance()), 16);
+        value = std::string(buf, result.ptr - buf);
+        return true;
+    }
+
+    // Address (in hex) of this file as an XrdCl::FilePlugIn, allowing a plugin that
+    // wraps this handle to issue data operations without the XrdCl::File layer.
+    if (name == "XrdClCurlFilePlugIn") {
+        char buf[32];
+        auto result = std::to_chars(buf, buf + sizeof(buf), reinterpret_cast<uintptr_t>(static_cast<const XrdCl::FilePlugIn *>(this)), 16);
+        value = std::string(buf, result.ptr - buf);
+        return true;
+    }
+
     std::shared_lock lock(m_properties_mutex);
     if (name == "LastURL") {
         value = m_last_url;
@@ -1002,6 +1536,12 @@ File::SetProperty(const std::string &name,
             }
             m_full_download.store(true, std::memory_order_relaxed);
         }
+    } else if (name == "XrdClCurlAcceptEncoding") {
+        m_accept_encoding.store(value == "true", std::memory_order_relaxed);
+    } else if (name == "XrdClCurlUploadPath" || name == "XrdClCurlUploadFd") {
+        m_upload_source.store(!value.empty(), std::memory_order_relaxed);
+    } else if (name == "XrdClCurlDownloadPath" || name == "XrdClCurlDownloadFd") {
+        m_download_destination.store(!value.empty(), std::memory_order_relaxed);
     }
 
     std::unique_lock lock(m_properties_mutex);
@@ -1119,6 +1659,20 @@ File::PrefetchResponseHandler::PrefetchResponseHandler(
 
 void
 File::PrefetchResponseHandler::HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) {
+    // In full-download mode, a transient failure restarts the GET at this read's offset;
+    // the new operation then feeds this handler and any queued behind it.
+    if (status && !status->IsOK()) {
+        std::unique_lock lock(m_parent.m_default_prefetch_handler->m_prefetch_mutex);
+        std::string etag;
+        if (m_parent.m_prefetch_op && m_parent.CanResumePrefetch(*status, etag)) {
+            m_parent.ResumePrefetch(this, m_offset, m_buffer, m_size, etag, m_timeout);
+            lock.unlock();
+            delete status;
+            delete response;
+            return;
+        }
+    }
+
     // Ensure that we are deleted once the callback is done.
     std::unique_ptr<PrefetchResponseHandler> owner(this);
 
@@ -1197,6 +1751,17 @@ void
 File::PrefetchDefaultHandler::HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) {
     std::unique_ptr<XrdCl::AnyObject> response(response_raw);
     std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+    {
+        std::unique_lock lock(m_prefetch_mutex);
+        // A read already resumed the full download after this failure.
+        if (m_skip_failures) {
+            m_skip_failures--;
+            return;
+        }
+        if (status && !status->IsOK()) {
+            m_failure = *status;
+        }
+    }
     if (status && !status->IsOK()) {
         if ((status->code == XrdCl::errOperationExpired) && (status->GetErrorMessage().find("Transfer stalled for too long") != std::string::npos)) {
             m_prefetch_expired_count.fetch_add(1, std::memory_order_relaxed);
@@ -1233,7 +1798,8 @@ File::HeaderCallout::GetHeaders(const std::string &verb,
             result_headers->emplace_back(info.first, info.second);
         }
     }
-    if (m_parent.m_asize >= 0 && verb == "PUT") {
+    // A checksum trailer requires a chunked upload, which can't have a Content-Length.
+    if (m_parent.m_asize >= 0 && verb == "PUT" && !(m_parent.m_put_op && m_parent.m_put_op->HasChecksumTrailer())) {
         if (!result_headers) {
             result_headers.reset(new std::vector<std::pair<std::string, std::string>>{});
         }
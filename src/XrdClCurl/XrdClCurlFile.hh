@@ -19,13 +19,17 @@
 #ifndef XRDCLCURL_CURLFILE_HH
 #define XRDCLCURL_CURLFILE_HH
 
+#include "../common/XrdClCurlPool.hh"
 #include "XrdClCurlConnectionCallout.hh"
 #include "XrdClCurlHeaderCallout.hh"
+#include "XrdClCurlObjectCache.hh"
+#include "XrdClCurlReadWindow.hh"
 
 #include <XrdCl/XrdClFile.hh>
 #include <XrdCl/XrdClPlugInInterface.hh>
 
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
@@ -54,7 +58,8 @@ public:
     File(std::shared_ptr<XrdClCurl::HandlerQueue> queue, XrdCl::Log *log) :
         m_queue(queue),
         m_logger(log),
-        m_default_put_handler(new PutDefaultHandler(*this))
+        m_default_put_handler(new PutDefaultHandler(*this)),
+        m_fill_token(std::make_shared<FillToken>(this))
     {}
 
 #if HAVE_XRDCL_IFACE6
@@ -63,7 +68,13 @@ public:
     using timeout_t = uint16_t;
 #endif
 
-    virtual ~File() noexcept {}
+    virtual ~File() noexcept {
+        {
+            std::unique_lock lock(m_fill_token->m_mutex);
+            m_fill_token->m_file = nullptr;
+        }
+        if (m_read_window) m_read_window->Shutdown();
+    }
 
     virtual XrdCl::XRootDStatus Open(const std::string      &url,
                                     XrdCl::OpenFlags::Flags flags,
@@ -145,12 +156,24 @@ public:
     // Get the header timeout value, taking into consideration the provided command timeout, a default timeout, and XrdCl's default values
     static struct timespec GetHeaderTimeoutWithDefault(time_t oper_timeout, const struct timespec &header_timeout);
 
+    // Set the number of times a full-download GET is resumed after a transient failure
+    static void SetMaxResumeAttempts(unsigned attempts) {m_max_resume_attempts.store(attempts, std::memory_order_relaxed);}
+
     // Set the federation metadata timeout
     static void SetFederationMetadataTimeout(const struct timespec &ts) {m_fed_timeout.tv_sec = ts.tv_sec; m_fed_timeout.tv_nsec = ts.tv_nsec;}
 
     // Get the federation metadata timeout
     static struct timespec GetFederationMetadataTimeout() {return m_fed_timeout;}
 
+    // Set the checksum computed for uploads ("crc32c", "adler32", "md5") when the
+    // handle has no `XrdClCurlUploadChecksum` property; empty disables it.
+    static void SetDefaultUploadChecksum(const std::string &name) {m_default_upload_checksum = name;}
+
+    // Set whether an upload of known size may drop its Content-Length to send the
+    // checksum as a trailer when the handle has no `XrdClCurlUploadChecksumTrailer`
+    // property.
+    static void SetDefaultUploadChecksumTrailer(bool enabled) {m_default_upload_checksum_trailer = enabled;}
+
     // Get the global monitoring statistics data
     static std::string GetMonitoringJson();
 
@@ -163,6 +186,49 @@ private:
     // be ignored.
     std::tuple<XrdCl::XRootDStatus, bool> ReadPrefetch(uint64_t offset, uint64_t size, void *buffer, XrdCl::ResponseHandler *handler, timeout_t timeout, bool isPgRead);
 
+    class PrefetchResponseHandler;
+
+    // Issue a read of the byte range to the server, coalescing it with identical
+    // in-flight reads from other file handles when enabled.
+    XrdCl::XRootDStatus ReadRange(uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler, timeout_t timeout);
+
+    // Try to serve a read from the shared object cache, filling the cache with the
+    // whole object if it is small enough.  Returns true if the read was taken over
+    // (the handler will be invoked); false if it must be done as a regular read.
+    bool ReadCached(uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler, timeout_t timeout);
+
+    // Open the local file given by the `XrdClCurlUploadPath` or `XrdClCurlUploadFd`
+    // property for an upload, returning its descriptor, whether it must be closed
+    // after the upload, and its size.
+    XrdCl::XRootDStatus OpenUploadSource(int &fd, bool &owned, off_t &size);
+
+    // Open the local file given by the `XrdClCurlDownloadPath` or `XrdClCurlDownloadFd`
+    // property for a download, returning its descriptor and whether it must be closed
+    // after the download.  A caller-provided descriptor is written from offset 0
+    // (regardless of its current offset) and truncated to the object's size; its file
+    // status flags are unchanged once the download completes.
+    XrdCl::XRootDStatus OpenDownloadDestination(int &fd, bool &owned);
+
+    // Set up the checksum of a new upload; `first_write` is the size of the write
+    // that created it.
+    void ConfigureUploadChecksum(CurlPutOp &op, uint64_t first_write);
+
+    // Determine whether a full-download GET that failed with `status` can be resumed.
+    //
+    // Only transient failures (stalls, timeouts, connection errors, 5xx responses) are
+    // resumed, the object must have a strong ETag so the remainder is guaranteed to come
+    // from the same object, and the retry budget must not be exhausted.  On success, the
+    // quoted ETag is returned through `etag`.  Must be called with m_prefetch_mutex held.
+    bool CanResumePrefetch(const XrdCl::XRootDStatus &status, std::string &etag);
+
+    // Restart the full-download GET at `offset`, after a backoff, with a
+    // `Range: bytes=<offset>-` request conditional on `etag`.  The new operation feeds
+    // `handler` (and any handlers queued behind it) starting with the `size` bytes at `buffer`.
+    //
+    // Must be called with m_prefetch_mutex held, after CanResumePrefetch succeeded.
+    void ResumePrefetch(PrefetchResponseHandler *handler, off_t offset, char *buffer, size_t size,
+        const std::string &etag, timeout_t timeout);
+
     // The "*Response" variant of the callback response objects defined in DirectorCacheResponse.hh
     // are opt-in; if the caller isn't expecting them, then they will leak memory.  This
     // function determines whether the opt-in is enabled.
@@ -186,6 +252,9 @@ private:
 
     bool m_is_opened{false};
     std::atomic<bool> m_full_download{false}; // Whether the file was in "full download mode" when opened.
+    std::atomic<bool> m_accept_encoding{false}; // Whether a full download may be transferred compressed.
+    std::atomic<bool> m_upload_source{false}; // Whether the upload reads from a local file instead of writes.
+    std::atomic<bool> m_download_destination{false}; // Whether Close downloads the object into a local file.
 
     // The flags used to open the file
     XrdCl::OpenFlags::Flags m_open_flags{XrdCl::OpenFlags::None};
@@ -197,6 +266,25 @@ private:
     XrdCl::Log *m_logger{nullptr};
     std::unordered_map<std::string, std::string> m_properties;
 
+    // Protects the object cache state below.
+    std::mutex m_cached_mutex;
+    std::string m_cache_key; // The URL given to Open(); identifies the object in the ObjectCache.
+    std::shared_ptr<const ObjectCache::Object> m_cached_object; // The cached contents, once known to be current.
+    bool m_cache_bypass{true}; // Set if reads must not use the object cache.
+
+    // Reads waiting on an object cache fill refer back to the handle through this
+    // token; the destructor clears it so a fill completing later doesn't touch a
+    // destroyed handle.
+    struct FillToken {
+        FillToken(File *file) : m_file(file) {}
+
+        std::mutex m_mutex;
+        File *m_file{nullptr};
+    };
+
+    // Holds small reads briefly so nearby ones are merged into one request; unset if disabled.
+    std::shared_ptr<ReadWindow> m_read_window;
+
     // Protects the contents of m_properties
     mutable std::shared_mutex m_properties_mutex;
 
@@ -215,6 +303,12 @@ private:
     // The federation metadata timeout.
     static struct timespec m_fed_timeout;
 
+    // The default checksum algorithm for uploads.
+    static std::string m_default_upload_checksum;
+
+    // Whether uploads of known size send their checksum as a trailer by default.
+    static bool m_default_upload_checksum_trailer;
+
     // An in-progress put operation.
     //
     // This shared pointer is also copied to the queue and kept
@@ -240,6 +334,9 @@ private:
     // The default object for all put failures
     std::shared_ptr<PutDefaultHandler> m_default_put_handler;
 
+    // Token handed to reads waiting on an object cache fill; see FillToken.
+    std::shared_ptr<FillToken> m_fill_token;
+
     // An in-progress GET operation
     //
     // For the first read from the file, we will issue a GET for
@@ -252,12 +349,24 @@ private:
     // Protected by m_prefetch_mutex
     std::atomic<off_t> m_prefetch_offset{0};
 
+    // Number of times the full-download GET has been resumed; protected by m_prefetch_mutex.
+    unsigned m_resume_attempts{0};
+
+    // Maximum number of times a full-download GET is resumed.
+    static std::atomic<unsigned> m_max_resume_attempts;
+
+    // Backoff before the first resume attempt; doubled on each subsequent attempt.
+    static constexpr std::chrono::steady_clock::duration m_resume_backoff{std::chrono::seconds(1)};
+
+    // Upper bound on the backoff between resume attempts.
+    static constexpr std::chrono::steady_clock::duration m_resume_max_backoff{std::chrono::seconds(30)};
+
     // Prefetch callback handler class
     //
     // Objects form a linked list of pending prefetch handlers.
     // Once the first entry in the list is completed, it will pass the prefetch
     // operation to the subsequent entry.
-    class PrefetchResponseHandler : public XrdCl::ResponseHandler {
+    class PrefetchResponseHandler : public XrdCl::ResponseHandler, public XrdClCurl::Pooled {
     public:
         PrefetchResponseHandler(File &parent,
             off_t offset, size_t size, std::atomic<off_t> *prefetch_offset, char *buffer, XrdCl::ResponseHandler *handler, timeout_t timeout);
@@ -339,6 +448,13 @@ private:
         XrdCl::Log *m_logger{nullptr};
         std::string m_url;
 
+        // The error of the last prefetch failure with no read outstanding; protected by m_prefetch_mutex.
+        XrdCl::XRootDStatus m_failure;
+
+        // Number of upcoming failures to ignore because a read already resumed the
+        // download before this handler saw them; protected by m_prefetch_mutex.
+        unsigned m_skip_failures{0};
+
         // Mutex protecting the state of the in-progress GET operation
         // and relevant callback handlers and state
         mutable std::mutex m_prefetch_mutex;
@@ -385,6 +501,7 @@ private:
     static std::atomic<uint64_t> m_prefetch_reads_hit; // Count of read operations served from prefetch data.
     static std::atomic<uint64_t> m_prefetch_reads_miss; // Count of read operations that were not served from prefetch data.
     static std::atomic<uint64_t> m_prefetch_bytes_used; // Count of prefetch operations that have succeeded.
+    static std::atomic<uint64_t> m_prefetch_resumed_count; // Count of full-download GETs resumed after a failure.
 };
 
 }
@@ -0,0 +1,181 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlObjectCache.hh"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace XrdClCurl;
+
+ObjectCache &
+ObjectCache::Instance()
+{
+    static ObjectCache instance;
+    return instance;
+}
+
+void
+ObjectCache::Configure(size_t capacity, size_t max_object, Clock::duration ttl)
+{
+    m_capacity.store(capacity, std::memory_order_relaxed);
+    m_max_object.store(max_object, std::memory_order_relaxed);
+    m_ttl.store(ttl.count(), std::memory_order_relaxed);
+}
+
+bool
+ObjectCache::IsCacheable(int64_t size) const
+{
+    if (size < 0) return false;
+    auto capacity = m_capacity.load(std::memory_order_relaxed);
+    auto max_object = std::min(m_max_object.load(std::memory_order_relaxed), capacity / m_shard_count);
+    return static_cast<uint64_t>(size) <= max_object;
+}
+
+ObjectCache::Shard &
+ObjectCache::GetShard(const std::string &url)
+{
+    return m_shards[std::hash<std::string>{}(url) % m_shard_count];
+}
+
+void
+ObjectCache::Erase(Shard &shard, std::list<Entry>::iterator iter)
+{
+    shard.m_bytes -= iter->m_object->m_data.size();
+    shard.m_index.erase(iter->m_url);
+    shard.m_lru.erase(iter);
+}
+
+std::shared_ptr<const ObjectCache::Object>
+ObjectCache::Get(const std::string &url, Clock::time_point now)
+{
+    if (!IsEnabled()) return {};
+    Clock::duration ttl(m_ttl.load(std::memory_order_relaxed));
+
+    auto &shard = GetShard(url);
+    std::unique_lock lock(shard.m_mutex);
+    auto iter = shard.m_index.find(url);
+    if (iter == shard.m_index.end() || now - iter->second->m_validated >= ttl) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, iter->second);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return iter->second->m_object;
+}
+
+std::shared_ptr<const ObjectCache::Object>
+ObjectCache::Revalidate(const std::string &url, const std::string &etag, Clock::time_point now)
+{
+    if (!IsEnabled() || etag.empty()) return {};
+
+    auto &shard = GetShard(url);
+    std::unique_lock lock(shard.m_mutex);
+    auto iter = shard.m_index.find(url);
+    if (iter == shard.m_index.end()) {
+        return {};
+    }
+    auto entry = iter->second;
+    if (entry->m_object->m_etag != etag) {
+        // The object changed on the server; the cached contents are useless.
+        Erase(shard, entry);
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    entry->m_validated = now;
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, entry);
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return entry->m_object;
+}
+
+void
+ObjectCache::Put(const std::string &url, std::shared_ptr<const Object> object, Clock::time_point now)
+{
+    if (!object || !IsCacheable(object->m_data.size())) return;
+    auto shard_capacity = m_capacity.load(std::memory_order_relaxed) / m_shard_count;
+
+    auto &shard = GetShard(url);
+    std::unique_lock lock(shard.m_mutex);
+    auto iter = shard.m_index.find(url);
+    if (iter != shard.m_index.end()) {
+        Erase(shard, iter->second);
+    }
+    while (!shard.m_lru.empty() && shard.m_bytes + object->m_data.size() > shard_capacity) {
+        Erase(shard, std::prev(shard.m_lru.end()));
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.m_bytes += object->m_data.size();
+    shard.m_lru.push_front({url, std::move(object), now});
+    shard.m_index[url] = shard.m_lru.begin();
+}
+
+bool
+ObjectCache::StartFill(const std::string &url, FillCallback callback)
+{
+    auto &shard = GetShard(url);
+    std::unique_lock lock(shard.m_mutex);
+    auto [iter, inserted] = shard.m_fills.try_emplace(url);
+    iter->second.emplace_back(std::move(callback));
+    if (inserted) {
+        m_fills.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        m_fill_waits.fetch_add(1, std::memory_order_relaxed);
+    }
+    return inserted;
+}
+
+void
+ObjectCache::FinishFill(const std::string &url, std::shared_ptr<const Object> object)
+{
+    Put(url, object);
+
+    std::vector<FillCallback> callbacks;
+    {
+        auto &shard = GetShard(url);
+        std::unique_lock lock(shard.m_mutex);
+        auto iter = shard.m_fills.find(url);
+        if (iter == shard.m_fills.end()) return;
+        callbacks.swap(iter->second);
+        shard.m_fills.erase(iter);
+    }
+    for (auto &callback : callbacks) {
+        callback(object);
+    }
+}
+
+std::string
+ObjectCache::GetMonitoringJson() const
+{
+    size_t bytes = 0, objects = 0;
+    for (auto &shard : m_shards) {
+        std::unique_lock lock(shard.m_mutex);
+        bytes += shard.m_bytes;
+        objects += shard.m_lru.size();
+    }
+    return "{"
+        "\"capacity\":" + std::to_string(m_capacity.load(std::memory_order_relaxed)) + ","
+        "\"bytes\":" + std::to_string(bytes) + ","
+        "\"objects\":" + std::to_string(objects) + ","
+        "\"hits\":" + std::to_string(m_hits.load(std::memory_order_relaxed)) + ","
+        "\"misses\":" + std::to_string(m_misses.load(std::memory_order_relaxed)) + ","
+        "\"fills\":" + std::to_string(m_fills.load(std::memory_order_relaxed)) + ","
+        "\"fill_waits\":" + std::to_string(m_fill_waits.load(std::memory_order_relaxed)) + ","
+        "\"evictions\":" + std::to_string(m_evictions.load(std::memory_order_relaxed)) + ","
+        "\"bytes_saved\":" + std::to_string(m_bytes_saved.load(std::memory_order_relaxed)) +
+        "}";
+}
@@ -0,0 +1,139 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_OBJECTCACHE_HH
+#define XRDCLCURL_OBJECTCACHE_HH
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace XrdClCurl {
+
+// Process-wide, size-bounded cache of the contents of small objects.
+//
+// Workloads that repeatedly open and read the same small files (configuration,
+// calibration, or software files) otherwise pay for a HEAD and a GET per open.
+// When enabled, the first read of an object no larger than the maximum object
+// size fetches the whole object once and stores it here; later opens of the
+// same URL within the TTL are answered from memory without any network I/O,
+// and opens after the TTL reuse the contents if the server's ETag is unchanged.
+//
+// Concurrent fills of the same object are coalesced: the first reader performs
+// the fill and the others wait for it.  The cache is split into shards, each
+// with its own lock and LRU list, so that lookups from many threads don't
+// contend on a single mutex.
+class ObjectCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The cached contents of an object; immutable once in the cache.
+    struct Object {
+        std::string m_etag; // The ETag reported by the server; may be empty.
+        std::string m_data; // The full contents of the object.
+    };
+
+    // Invoked when a fill completes with the new object, or nullptr if it failed.
+    using FillCallback = std::function<void(std::shared_ptr<const Object>)>;
+
+    static ObjectCache &Instance();
+
+    // Set the total capacity in bytes (zero disables the cache), the largest object
+    // that is cached, and how long an object is used without revalidation.
+    void Configure(size_t capacity, size_t max_object, Clock::duration ttl);
+
+    bool IsEnabled() const {return m_capacity.load(std::memory_order_relaxed) != 0;}
+
+    // Returns whether an object of `size` bytes is eligible for caching.
+    bool IsCacheable(int64_t size) const;
+
+    // Returns the object cached for `url` if it was validated within the TTL.
+    std::shared_ptr<const Object> Get(const std::string &url, Clock::time_point now = Clock::now());
+
+    // Returns the object cached for `url` if its ETag matches `etag`, resetting its
+    // TTL; an object with a different ETag is dropped.
+    std::shared_ptr<const Object> Revalidate(const std::string &url, const std::string &etag, Clock::time_point now = Clock::now());
+
+    // Insert an object, evicting the least-recently-used objects of the shard as needed.
+    void Put(const std::string &url, std::shared_ptr<const Object> object, Clock::time_point now = Clock::now());
+
+    // Register interest in a fill of `url`.  Returns true if the caller must perform
+    // the fill and then call `FinishFill`; otherwise, a fill is already in progress.
+    // In both cases, `callback` is invoked when the fill completes.
+    bool StartFill(const std::string &url, FillCallback callback);
+
+    // Complete a fill started by `StartFill`; `object` is nullptr on failure.  On
+    // success, the object is cached before the waiting callbacks are invoked.
+    void FinishFill(const std::string &url, std::shared_ptr<const Object> object);
+
+    // Record bytes returned to a reader from the cache.
+    void RecordBytesSaved(uint64_t bytes) {m_bytes_saved.fetch_add(bytes, std::memory_order_relaxed);}
+
+    // Returns the cache statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+private:
+    ObjectCache() = default;
+    ObjectCache(const ObjectCache &) = delete;
+
+    struct Entry {
+        std::string m_url;
+        std::shared_ptr<const Object> m_object;
+        Clock::time_point m_validated; // When the contents were last known to be current.
+    };
+
+    struct Shard {
+        mutable std::mutex m_mutex;
+        std::list<Entry> m_lru; // Most-recently-used first.
+        std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+        std::unordered_map<std::string, std::vector<FillCallback>> m_fills;
+        size_t m_bytes{0};
+    };
+
+    static constexpr size_t m_shard_count{16};
+
+    Shard &GetShard(const std::string &url);
+
+    // Remove an entry from its shard; the shard's mutex must be held.
+    void Erase(Shard &shard, std::list<Entry>::iterator iter);
+
+    std::array<Shard, m_shard_count> m_shards;
+
+    std::atomic<size_t> m_capacity{0};
+    std::atomic<size_t> m_max_object{1024 * 1024};
+    std::atomic<Clock::duration::rep> m_ttl{std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(60)).count()};
+
+    std::atomic<uint64_t> m_hits{0};        // Count of opens and reads served from the cache.
+    std::atomic<uint64_t> m_misses{0};      // Count of lookups that found no usable object.
+    std::atomic<uint64_t> m_fills{0};       // Count of objects fetched to fill the cache.
+    std::atomic<uint64_t> m_fill_waits{0};  // Count of readers that waited on another's fill.
+    std::atomic<uint64_t> m_evictions{0};   // Count of objects evicted to make room.
+    std::atomic<uint64_t> m_bytes_saved{0}; // Bytes returned from the cache instead of transferred.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_OBJECTCACHE_HH
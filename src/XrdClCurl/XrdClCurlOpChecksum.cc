@@ -91,7 +91,7 @@ CurlChecksumOp::Success()
             m_logger->Error(kLogXrdClCurl, "Checksums not found in response for %s", m_url.c_str());
             auto handle = m_handler;
             m_handler = nullptr;
-            handle->HandleResponse(new XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errCheckSumError), nullptr);
+            InvokeHandler(handle, new XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errCheckSumError), nullptr);
             return; 
         }
     }
@@ -110,6 +110,6 @@ CurlChecksumOp::Success()
 
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(new XrdCl::XRootDStatus(), obj);
+    InvokeHandler(handle, new XrdCl::XRootDStatus(), obj);
     // Does not call CurlStatOp::Success() as we don't need to invoke a stat info callback
 }
@@ -59,7 +59,7 @@ CurlCopyOp::CurlCopyOp(XrdCl::ResponseHandler *handler, const std::string &sourc
         auto obj = new XrdCl::AnyObject();
         auto handle = m_handler;
         m_handler = nullptr;
-        handle->HandleResponse(status, obj);
+        InvokeHandler(handle, status, obj);
     }
     
     void
@@ -63,5 +63,5 @@ CurlDeleteOp::Success() {
 
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(new XrdCl::XRootDStatus(), obj);
+    InvokeHandler(handle, new XrdCl::XRootDStatus(), obj);
 }
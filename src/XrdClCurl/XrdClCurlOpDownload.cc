@@ -0,0 +1,202 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlOps.hh"
+
+#include <XrdCl/XrdClLog.hh>
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+using namespace XrdClCurl;
+
+CurlDownloadOp::CurlDownloadOp(XrdCl::ResponseHandler *handler, const std::string &url, struct timespec timeout,
+    int fd, bool owned, XrdCl::Log *logger, CreateConnCalloutType callout, HeaderCallout *header_callout)
+    : CurlReadOp(handler, nullptr, url, timeout, {0, UINT64_MAX}, nullptr, 0, logger, callout, header_callout),
+    m_fd(fd),
+    m_owned(owned)
+{
+#ifdef O_DIRECT
+    auto flags = fcntl(m_fd, F_GETFL);
+    m_direct = flags != -1 && (flags & O_DIRECT);
+#endif
+}
+
+CurlDownloadOp::~CurlDownloadOp()
+{
+    if (m_owned && m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+bool
+CurlDownloadOp::Setup(CURL *curl, CurlWorker &worker)
+{
+    if (!CurlReadOp::Setup(curl, worker)) {return false;}
+
+    curl_easy_setopt(m_curl.get(), CURLOPT_WRITEFUNCTION, CurlDownloadOp::WriteCallback);
+    curl_easy_setopt(m_curl.get(), CURLOPT_WRITEDATA, this);
+    return true;
+}
+
+size_t
+CurlDownloadOp::WriteCallback(char *buffer, size_t size, size_t nitems, void *this_ptr)
+{
+    return static_cast<CurlDownloadOp*>(this_ptr)->Write(buffer, size * nitems);
+}
+
+size_t
+CurlDownloadOp::Write(char *buffer, size_t length)
+{
+    if (m_headers.IsMultipartByterange()) {
+        return FailCallback(kXR_ServerError, "Server responded with a multipart byterange which is not supported");
+    }
+    if (m_headers.GetStatusCode() > 299) {
+        if (m_err_msg.size() < 4*1024) {
+            m_err_msg.append(buffer, length);
+        }
+        UpdateBytes(length);
+        return length;
+    }
+    if (TransferThrottled()) {
+        return CURL_WRITEFUNC_PAUSE;
+    }
+    if (!m_started) {
+        m_started = true;
+        auto content_length = m_headers.GetContentLength();
+        if (m_preallocate && content_length > 0) {
+            // Failure only loses the layout benefit (e.g., the filesystem has no fallocate).
+            auto rc = posix_fallocate(m_fd, 0, content_length);
+            if (rc) {
+                m_logger->Debug(kLogXrdClCurl, "Failed to preallocate %lld bytes for download of %s: %s",
+                    static_cast<long long>(content_length), m_url.c_str(), strerror(rc));
+                m_preallocate = false;
+            }
+        }
+        if (m_direct) {
+            void *stage;
+            if (posix_memalign(&stage, m_direct_alignment, m_stage_size)) {
+                return FailCallback(kXR_NoMemory, "Failed to allocate the download staging buffer");
+            }
+            m_stage.reset(static_cast<char *>(stage));
+        }
+    }
+    UpdateBytes(length);
+    ChargeTransfer(length);
+
+    if (!m_direct) {
+        if (!WriteFile(buffer, length)) {
+            return FailCallback(kXR_IOError, std::string("Failed to write download to local file: ") + strerror(errno));
+        }
+        return length;
+    }
+    auto remaining = length;
+    while (remaining) {
+        auto to_copy = std::min(remaining, m_stage_size - m_stage_used);
+        memcpy(m_stage.get() + m_stage_used, buffer, to_copy);
+        m_stage_used += to_copy;
+        buffer += to_copy;
+        remaining -= to_copy;
+        if (m_stage_used == m_stage_size && !FlushStage(false)) {
+            return FailCallback(kXR_IOError, std::string("Failed to write download to local file: ") + strerror(errno));
+        }
+    }
+    return length;
+}
+
+bool
+CurlDownloadOp::WriteFile(const char *buffer, size_t length)
+{
+    while (length) {
+        auto rc = pwrite(m_fd, buffer, length, m_file_offset);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        buffer += rc;
+        length -= rc;
+        m_file_offset += rc;
+    }
+    return true;
+}
+
+bool
+CurlDownloadOp::FlushStage(bool final)
+{
+    auto aligned = m_stage_used - (m_stage_used % m_direct_alignment);
+    if (aligned && !WriteFile(m_stage.get(), aligned)) {
+        return false;
+    }
+    auto tail = m_stage_used - aligned;
+    if (tail && final) {
+        // O_DIRECT can't write a partial block; the end of the file goes through the page cache.
+#ifdef O_DIRECT
+        auto flags = fcntl(m_fd, F_GETFL);
+        if (flags == -1 || fcntl(m_fd, F_SETFL, flags & ~O_DIRECT) == -1) {
+            return false;
+        }
+#endif
+        auto written = WriteFile(m_stage.get() + aligned, tail);
+#ifdef O_DIRECT
+        // The descriptor may be the caller's; leave its flags as we found them.
+        auto saved_errno = errno;
+        fcntl(m_fd, F_SETFL, flags);
+        errno = saved_errno;
+#endif
+        if (!written) {
+            return false;
+        }
+        tail = 0;
+    } else if (tail) {
+        memmove(m_stage.get(), m_stage.get() + aligned, tail);
+    }
+    m_stage_used = tail;
+    return true;
+}
+
+void
+CurlDownloadOp::Success()
+{
+    if (m_stage_used && !FlushStage(true)) {
+        Fail(XrdCl::errOSError, errno, std::string("Failed to write download to local file: ") + strerror(errno));
+        return;
+    }
+    // Neither a preallocation from a Content-Length that overstated the body nor the
+    // previous contents of a caller-provided file may be left past the end of the object.
+    if (ftruncate(m_fd, m_file_offset) == -1) {
+        Fail(XrdCl::errOSError, errno, std::string("Failed to truncate downloaded file: ") + strerror(errno));
+        return;
+    }
+    if (m_sync && fdatasync(m_fd) == -1) {
+        Fail(XrdCl::errOSError, errno, std::string("Failed to sync downloaded file: ") + strerror(errno));
+        return;
+    }
+    m_logger->Debug(kLogXrdClCurl, "Downloaded %lld bytes from %s to a local file", static_cast<long long>(m_file_offset), m_url.c_str());
+
+    SetDone(false);
+    if (m_handler == nullptr) {return;}
+    auto status = new XrdCl::XRootDStatus();
+    auto handle = m_handler;
+    m_handler = nullptr;
+    InvokeHandler(handle, status, nullptr);
+}
@@ -45,6 +45,8 @@ CurlListdirOp::Setup(CURL *curl, CurlWorker &worker)
     curl_easy_setopt(m_curl.get(), CURLOPT_WRITEDATA, this);
     curl_easy_setopt(m_curl.get(), CURLOPT_CUSTOMREQUEST, "PROPFIND");
     m_headers_list.emplace_back("Depth", "1");
+    // Multistatus XML is verbose and compresses well.
+    EnableCompression();
 
     return true;
 }
@@ -215,5 +217,5 @@ CurlListdirOp::Success()
 
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(new XrdCl::XRootDStatus(), obj);
+    InvokeHandler(handle, new XrdCl::XRootDStatus(), obj);
 }
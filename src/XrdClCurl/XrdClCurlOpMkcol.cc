@@ -77,5 +77,5 @@ CurlMkcolOp::Success() {
 
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(new XrdCl::XRootDStatus(), obj);
+    InvokeHandler(handle, new XrdCl::XRootDStatus(), obj);
 }
@@ -20,6 +20,13 @@
 
 #include <XrdCl/XrdClLog.hh>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
 using namespace XrdClCurl;
 
 CurlPutOp::CurlPutOp(XrdCl::ResponseHandler *handler, std::shared_ptr<XrdCl::ResponseHandler> default_handler,
@@ -42,6 +49,28 @@ CurlPutOp::CurlPutOp(XrdCl::ResponseHandler *handler, std::shared_ptr<XrdCl::Res
 
 }
 
+CurlPutOp::CurlPutOp(XrdCl::ResponseHandler *handler, std::shared_ptr<XrdCl::ResponseHandler> default_handler,
+    const std::string &url, int fd, bool owned, off_t size, struct timespec timeout,
+    XrdCl::Log *logger, CreateConnCalloutType callout, HeaderCallout *header_callout)
+    : CurlOperation(handler, url, timeout, logger, callout, header_callout),
+    m_default_handler(default_handler),
+    m_object_size(size),
+    m_final(true),
+    m_source_fd(fd),
+    m_source_owned(owned)
+{
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(m_source_fd, 0, size, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+CurlPutOp::~CurlPutOp()
+{
+    if (m_source_owned && m_source_fd >= 0) {
+        close(m_source_fd);
+    }
+}
+
 void
 CurlPutOp::Fail(uint16_t errCode, uint32_t errNum, const std::string &msg)
 {
@@ -57,8 +86,8 @@ CurlPutOp::Fail(uint16_t errCode, uint32_t errNum, const std::string &msg)
     auto status = new XrdCl::XRootDStatus(XrdCl::stError, errCode, errNum, custom_msg);
     auto handle = m_handler;
     m_handler = nullptr;
-    if (handle) handle->HandleResponse(status, nullptr);
-    else m_default_handler->HandleResponse(status, nullptr);
+    if (handle) InvokeHandler(handle, status, nullptr);
+    else InvokeHandler(m_default_handler.get(), status, nullptr, m_default_handler);
 }
 
 bool
@@ -70,18 +99,109 @@ CurlPutOp::Setup(CURL *curl, CurlWorker &worker)
     curl_easy_setopt(m_curl.get(), CURLOPT_UPLOAD, 1);
     curl_easy_setopt(m_curl.get(), CURLOPT_READDATA, this);
     curl_easy_setopt(m_curl.get(), CURLOPT_READFUNCTION, CurlPutOp::ReadCallback);
-    if (m_object_size >= 0) {
-        curl_easy_setopt(m_curl.get(), CURLOPT_INFILESIZE_LARGE, m_object_size);
+    // A checksum trailer needs a chunked body, so the size is not announced.
+    if (m_object_size >= 0 && !m_checksum_trailer) {
+        curl_easy_setopt(m_curl.get(), CURLOPT_INFILESIZE_LARGE, static_cast<curl_off_t>(m_object_size));
+    }
+    if (m_source_fd >= 0) {
+        curl_easy_setopt(m_curl.get(), CURLOPT_SEEKDATA, this);
+        curl_easy_setopt(m_curl.get(), CURLOPT_SEEKFUNCTION, CurlPutOp::SeekCallback);
+#if LIBCURL_VERSION_NUM >= 0x073E00
+        curl_easy_setopt(m_curl.get(), CURLOPT_UPLOAD_BUFFERSIZE, m_source_buffer_size);
+#endif
     }
+    if (m_checksum && m_checksum_complete) {
+        // The whole object is in hand; checksum it before sending the headers.
+        if (!m_checksum->IsFinal()) {
+            m_checksum->Update(m_data.data(), m_data.size());
+            FinishChecksum();
+        }
+        auto [name, value] = m_checksum->GetHeader(m_checksum_style);
+        if (!name.empty()) {
+            m_headers_list.emplace_back(name, value);
+        }
+    }
+#if LIBCURL_VERSION_NUM >= 0x074000
+    if (m_checksum_trailer) {
+        m_headers_list.emplace_back("Trailer", "Digest");
+        curl_easy_setopt(m_curl.get(), CURLOPT_TRAILERFUNCTION, CurlPutOp::TrailerCallback);
+        curl_easy_setopt(m_curl.get(), CURLOPT_TRAILERDATA, this);
+    }
+#endif
     return true;
 }
 
+void
+CurlPutOp::SetUploadChecksum(UploadChecksum::Algorithm algorithm, UploadChecksum::Style style, bool complete, bool trailer)
+{
+    if (algorithm == UploadChecksum::Algorithm::kNone) {
+        return;
+    }
+    // Without the whole object in hand, the checksum can only follow the body as a
+    // trailer, which requires a chunked upload even if the size is known.  S3 only
+    // accepts trailers with its own aws-chunked encoding, so there is nothing to send
+    // the checksum in and it is not computed.
+    if (!complete) {
+#if LIBCURL_VERSION_NUM >= 0x074000
+        if (!trailer || style != UploadChecksum::Style::kDigest) {
+            return;
+        }
+        m_checksum_trailer = true;
+#else
+        (void)trailer;
+        return;
+#endif
+    }
+    m_checksum.reset(new UploadChecksum(algorithm));
+    m_checksum_style = style;
+    m_checksum_complete = complete;
+}
+
+void
+CurlPutOp::FinishChecksum()
+{
+    m_checksum->Final();
+    m_checksum_value = m_checksum->GetValue();
+    m_logger->Debug(kLogXrdClCurl, "Checksum of upload to %s: %s", m_url.c_str(), m_checksum_value.c_str());
+}
+
+int
+CurlPutOp::TrailerCallback(struct curl_slist **list, void *v)
+{
+    auto op = static_cast<CurlPutOp*>(v);
+    if (!op->m_checksum->IsFinal()) {
+        op->FinishChecksum();
+    }
+    auto [name, value] = op->m_checksum->GetHeader(UploadChecksum::Style::kDigest);
+    if (!name.empty()) {
+        *list = curl_slist_append(*list, (name + ": " + value).c_str());
+    }
+#if LIBCURL_VERSION_NUM >= 0x074000
+    return CURL_TRAILERFUNC_OK;
+#else
+    return 0;
+#endif
+}
+
 void
 CurlPutOp::ReleaseHandle()
 {
     curl_easy_setopt(m_curl.get(), CURLOPT_READFUNCTION, nullptr);
     curl_easy_setopt(m_curl.get(), CURLOPT_READDATA, nullptr);
     curl_easy_setopt(m_curl.get(), CURLOPT_UPLOAD, 0);
+    if (m_source_fd >= 0) {
+        curl_easy_setopt(m_curl.get(), CURLOPT_SEEKFUNCTION, nullptr);
+        curl_easy_setopt(m_curl.get(), CURLOPT_SEEKDATA, nullptr);
+#if LIBCURL_VERSION_NUM >= 0x073E00
+        curl_easy_setopt(m_curl.get(), CURLOPT_UPLOAD_BUFFERSIZE, 64L * 1024);
+#endif
+    }
+#if LIBCURL_VERSION_NUM >= 0x074000
+    if (m_checksum_trailer) {
+        curl_easy_setopt(m_curl.get(), CURLOPT_TRAILERFUNCTION, nullptr);
+        curl_easy_setopt(m_curl.get(), CURLOPT_TRAILERDATA, nullptr);
+    }
+#endif
     // If one uses just `-1` here -- instead of casting it to `curl_off_t`, then on Linux
     // we have observed compilers casting the `-1` to an unsigned, resulting in the file
     // size being set to 4294967295 instead of "unknown".  This causes the second use of the
@@ -106,14 +226,19 @@ CurlPutOp::Pause()
     // Note: As soon as this is invoked, another thread may continue and start to manipulate
     // the CurlPutOp object.  To avoid race conditions, all reads/writes to member data must
     // be done *before* the callback is invoked.
-    if (handle) handle->HandleResponse(status, nullptr);
-    else m_default_handler->HandleResponse(status, nullptr);
+    if (handle) InvokeHandler(handle, status, nullptr);
+    else InvokeHandler(m_default_handler.get(), status, nullptr, m_default_handler);
 }
 
 void
 CurlPutOp::Success()
 {
     SetDone(false);
+    // When the size came from a Content-Length header, the server may respond before
+    // libcurl asks for more data; every byte was still handed over.
+    if (m_checksum && !m_checksum->IsFinal()) {
+        FinishChecksum();
+    }
     if (m_handler == nullptr) {
         m_logger->Warning(kLogXrdClCurl, "Put operation succeeded with no callback handler");
         return;
@@ -121,7 +246,7 @@ CurlPutOp::Success()
     auto status = new XrdCl::XRootDStatus();
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(status, nullptr);
+    InvokeHandler(handle, status, nullptr);
 }
 
 bool
@@ -192,6 +317,9 @@ size_t CurlPutOp::ReadCallback(char *buffer, size_t size, size_t n, void *v) {
 	// the data to be sent, along with the offset of the data that has already
 	// been sent.
 	auto op = static_cast<CurlPutOp*>(v);
+	if (op->m_source_fd >= 0) {
+		return op->ReadSource(buffer, size * n);
+	}
     //op->m_logger->Debug(kLogXrdClCurl, "Read callback with buffer %ld and avail data %ld", size*n, op->m_data.size());
 
     // TODO: Check for timeouts.  If there was one, abort the callback function
@@ -199,6 +327,9 @@ size_t CurlPutOp::ReadCallback(char *buffer, size_t size, size_t n, void *v) {
 
 	if (op->m_data.empty()) {
 		if (op->m_final) {
+			if (op->m_checksum && !op->m_checksum->IsFinal()) {
+				op->FinishChecksum();
+			}
 			return 0;
 		} else {
 			op->Pause();
@@ -206,14 +337,79 @@ size_t CurlPutOp::ReadCallback(char *buffer, size_t size, size_t n, void *v) {
 		}
 	}
 
+	if (op->TransferThrottled()) {
+		return CURL_READFUNC_PAUSE;
+	}
+
 	size_t request = size * n;
 	op->UpdateBytes(request);
 	if (request > op->m_data.size()) {
 		request = op->m_data.size();
 	}
+	op->ChargeTransfer(request);
 
 	memcpy(buffer, op->m_data.data(), request);
+	if (op->m_checksum) {
+		op->m_checksum->Update(op->m_data.data(), request);
+		// With a known size, libcurl stops reading after the last byte instead of waiting for EOF.
+		op->m_checksum_bytes += request;
+		if (op->m_object_size >= 0 && op->m_checksum_bytes >= static_cast<uint64_t>(op->m_object_size) &&
+			!op->m_checksum->IsFinal())
+		{
+			op->FinishChecksum();
+		}
+	}
 	op->m_data = op->m_data.substr(request);
 
 	return request;
 }
+
+size_t
+CurlPutOp::ReadSource(char *buffer, size_t size)
+{
+    if (m_source_offset >= m_object_size) {
+        if (m_checksum && !m_checksum->IsFinal()) {
+            FinishChecksum();
+        }
+        return 0;
+    }
+    if (TransferThrottled()) {
+        return CURL_READFUNC_PAUSE;
+    }
+    size_t request = std::min(size, static_cast<size_t>(m_object_size - m_source_offset));
+    ssize_t result;
+    do {
+        result = pread(m_source_fd, buffer, request, m_source_offset);
+    } while (result < 0 && errno == EINTR);
+    if (result <= 0) {
+        m_logger->Error(kLogXrdClCurl, "Failed to read upload source for %s at offset %lld: %s", m_url.c_str(),
+            static_cast<long long>(m_source_offset), result ? strerror(errno) : "file is shorter than expected");
+        return CURL_READFUNC_ABORT;
+    }
+    UpdateBytes(result);
+    ChargeTransfer(result);
+    if (m_checksum) {
+        m_checksum->Update(buffer, result);
+    }
+    m_source_offset += result;
+    m_offset = m_source_offset;
+    return result;
+}
+
+int
+CurlPutOp::SeekCallback(void *v, curl_off_t offset, int origin)
+{
+    auto op = static_cast<CurlPutOp*>(v);
+    if (origin != SEEK_SET || offset < 0 || offset > op->m_object_size) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    // A checksum cannot be rewound; start it over if the body is resent from the beginning.
+    if (op->m_checksum && offset != op->m_source_offset) {
+        if (offset) return CURL_SEEKFUNC_CANTSEEK;
+        op->m_checksum.reset(new UploadChecksum(op->m_checksum->GetAlgorithm()));
+        op->m_checksum_value.clear();
+        op->m_checksum_bytes = 0;
+    }
+    op->m_source_offset = offset;
+    return CURL_SEEKFUNC_OK;
+}
@@ -34,8 +34,9 @@ void CurlQueryOp::Success()
         auto obj = new XrdCl::AnyObject();
         obj->Set(qInfo);
 
-        m_handler->HandleResponse(new XrdCl::XRootDStatus(), obj);
+        auto handle = m_handler;
         m_handler = nullptr;
+        InvokeHandler(handle, new XrdCl::XRootDStatus(), obj);
     }
     else {
         m_logger->Error(kLogXrdClCurl, "Invalid information query type code");
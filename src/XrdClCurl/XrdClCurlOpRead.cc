@@ -23,6 +23,8 @@
 #include <XrdOuc/XrdOucCRC.hh>
 #include <XrdSys/XrdSysPageSize.hh>
 
+#include <algorithm>
+
 using namespace XrdClCurl;
 
 CurlReadOp::CurlReadOp(XrdCl::ResponseHandler *handler, std::shared_ptr<XrdCl::ResponseHandler> default_handler,
@@ -89,6 +91,17 @@ CurlReadOp::ContinueHandle()
     return m_curl.get();
     }
 
+long
+CurlReadOp::GetCurlBufferSize() const
+{
+    if (m_op.second >= 1024*1024) {
+        return static_cast<long>(std::max<uint64_t>(128*1024, std::min<uint64_t>(GetTunedCurlBuffer(), m_op.second)));
+    } else if (m_op.second >= 256*1024) {
+        return 64*1024;
+    }
+    return 32*1024;
+}
+
 bool
 CurlReadOp::Setup(CURL *curl, CurlWorker &worker)
 {
@@ -103,21 +116,20 @@ CurlReadOp::Setup(CURL *curl, CurlWorker &worker)
         Success();
         return true;
     }
-    if (m_op.second >= 1024*1024) {
-        curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 128*1024);
-    }
-    else if (m_op.second >= 256*1024) {
-        curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 64*1024);
-    }
-    else if (m_op.second >= 128*1024) {
-        curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 32*1024);
+    // A listing read whole may be compressed; it is then requested without a Range
+    // header since a range of a compressed body is not a range of the object.
+    if (m_accept_encoding && m_op.first == 0) {
+        EnableCompression();
     }
     // If the requested read size is UINT64_MAX, it means read the entire object;
     // in this case, we do not set the Range header.
-    if (m_op.second != UINT64_MAX) {
+    if (m_op.second != UINT64_MAX && !IsCompressed()) {
         auto range_req = "bytes=" + std::to_string(m_op.first) + "-" + std::to_string(m_op.first + m_op.second - 1);
         m_headers_list.emplace_back("Range", range_req);
     }
+    if (!m_if_match.empty()) {
+        m_headers_list.emplace_back("If-Match", m_if_match);
+    }
 
     return true;
 }
@@ -137,8 +149,8 @@ CurlReadOp::Fail(uint16_t errCode, uint32_t errNum, const std::string &msg)
     auto status = new XrdCl::XRootDStatus(XrdCl::stError, errCode, errNum, custom_msg);
     auto handle = m_handler;
     m_handler = nullptr;
-    if (handle) handle->HandleResponse(status, nullptr);
-    else m_default_handler->HandleResponse(status, nullptr);
+    if (handle) InvokeHandler(handle, status, nullptr);
+    else InvokeHandler(m_default_handler.get(), status, nullptr, m_default_handler);
 }
 
 void
@@ -165,7 +177,7 @@ CurlReadOp::Pause()
     // Note: As soon as this is invoked, another thread may continue and start to manipulate
     // the CurlPutOp object.  To avoid race conditions, all reads/writes to member data must
     // be done *before* the callback is invoked.
-    handle->HandleResponse(status, obj);
+    InvokeHandler(handle, status, obj);
 }
 
 void
@@ -180,7 +192,7 @@ CurlReadOp::Success()
     obj->Set(chunk_info);
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(status, obj);
+    InvokeHandler(handle, status, obj);
 }
 
 void
@@ -236,7 +248,13 @@ CurlReadOp::Write(char *buffer, size_t length)
         Pause();
         return CURL_WRITEFUNC_PAUSE;
     }
+    // Pausing for the rate limits does not involve the client; the worker resumes the
+    // handle and libcurl redelivers this same data.
+    if (TransferThrottled()) {
+        return CURL_WRITEFUNC_PAUSE;
+    }
     UpdateBytes(length);
+    ChargeTransfer(length);
     auto output_remaining = m_buffer_size - m_written;
     auto larger_than_result_buffer = length > output_remaining;
     auto to_copy = larger_than_result_buffer ? output_remaining : length;
@@ -282,5 +300,5 @@ CurlPgReadOp::Success()
     obj->Set(page_info);
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(status, obj);
+    InvokeHandler(handle, status, obj);
 }
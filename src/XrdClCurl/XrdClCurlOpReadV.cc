@@ -76,7 +76,7 @@ CurlVectorReadOp::Fail(uint16_t errCode, uint32_t errNum, const std::string &msg
     auto status = new XrdCl::XRootDStatus(XrdCl::stError, errCode, errNum, custom_msg);
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(status, nullptr);
+    InvokeHandler(handle, status, nullptr);
 }
 
 void
@@ -98,7 +98,7 @@ CurlVectorReadOp::Success()
     obj->Set(m_vr.release());
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(status, obj);
+    InvokeHandler(handle, status, obj);
 }
 
 void
@@ -125,7 +125,11 @@ CurlVectorReadOp::WriteCallback(char *buffer, size_t size, size_t nitems, void *
 size_t
 CurlVectorReadOp::Write(char *orig_buffer, size_t orig_length)
 {
+    if (TransferThrottled()) {
+        return CURL_WRITEFUNC_PAUSE;
+    }
     UpdateBytes(orig_length);
+    ChargeTransfer(orig_length);
     //m_logger->Debug(kLogXrdClCurl, "Received a write of size %ld with contents:\n%s", static_cast<long>(orig_length), std::string(orig_buffer, orig_length).c_str());
 
     // Handle the (hopefully uncommon) cases where the server responds to a vector read op
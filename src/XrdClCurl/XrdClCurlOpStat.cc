@@ -33,14 +33,19 @@ CurlStatOp::OptionsDone()
 {
     auto &instance = VerbsCache::Instance();
     auto target = m_headers.GetLocation();
-    auto verbs = instance.Get(target.empty() ? m_url : target);
+    if (target.empty()) {
+        target = m_verbs_url.empty() ? m_url : m_verbs_url;
+    }
+    auto verbs = instance.Get(target);
     if (verbs.IsSet(VerbsCache::HttpVerb::kPROPFIND)) {
         curl_easy_setopt(m_curl.get(), CURLOPT_CUSTOMREQUEST, "PROPFIND");
         curl_easy_setopt(m_curl.get(), CURLOPT_NOBODY, 0L);
         m_is_propfind = true;
+        EnableCompression();
     } else {
         m_is_propfind = false;
         curl_easy_setopt(m_curl.get(), CURLOPT_NOBODY, 1L);
+        DisableCompression();
     }
 }
 
@@ -63,13 +68,52 @@ CurlStatOp::Redirect(std::string &target)
         curl_easy_setopt(m_curl.get(), CURLOPT_CUSTOMREQUEST, "PROPFIND");
         curl_easy_setopt(m_curl.get(), CURLOPT_NOBODY, 0L);
         m_is_propfind = true;
+        EnableCompression();
     } else {
         m_is_propfind = false;
         curl_easy_setopt(m_curl.get(), CURLOPT_NOBODY, 1L);
+        DisableCompression();
     }
     return CurlOperation::RedirectAction::Reinvoke;
 }
 
+// The HEAD request of an open was sent without waiting for the OPTIONS response.
+//
+// A HEAD response without an object size (e.g., for a directory) is the one case
+// where PROPFIND provides something HEAD doesn't; retry once with PROPFIND if the
+// server supports it.  Operations that can't tolerate this (a plain stat) are not
+// started speculatively.
+CurlOperation::VerbRetry
+CurlStatOp::RetryWithVerbs(std::string &target)
+{
+    if (m_is_propfind || m_verbs_retried || m_headers.GetContentLength() >= 0) {
+        return VerbRetry::None;
+    }
+    m_verbs_retried = true;
+
+    char *effective_url = nullptr;
+    curl_easy_getinfo(m_curl.get(), CURLINFO_EFFECTIVE_URL, &effective_url);
+    target = (effective_url && *effective_url) ? effective_url : m_url;
+    auto &instance = VerbsCache::Instance();
+    auto verbs = instance.Get(target);
+    if (verbs.IsSet(VerbsCache::HttpVerb::kUnset)) {
+        m_logger->Debug(kLogXrdClCurl, "HEAD response for %s has no object size; checking if PROPFIND is supported", m_url.c_str());
+        m_verbs_url = target;
+        m_headers = HeaderParser();
+        return VerbRetry::ReinvokeAfterAllow;
+    }
+    if (!verbs.IsSet(VerbsCache::HttpVerb::kPROPFIND)) {
+        return VerbRetry::None;
+    }
+    m_logger->Debug(kLogXrdClCurl, "HEAD response for %s has no object size; retrying with PROPFIND", m_url.c_str());
+    m_headers = HeaderParser();
+    curl_easy_setopt(m_curl.get(), CURLOPT_CUSTOMREQUEST, "PROPFIND");
+    curl_easy_setopt(m_curl.get(), CURLOPT_NOBODY, 0L);
+    m_is_propfind = true;
+    EnableCompression();
+    return VerbRetry::Reinvoke;
+}
+
 bool
 CurlStatOp::Setup(CURL *curl, CurlWorker &worker)
 {
@@ -83,6 +127,7 @@ CurlStatOp::Setup(CURL *curl, CurlWorker &worker)
         curl_easy_setopt(m_curl.get(), CURLOPT_CUSTOMREQUEST, "PROPFIND");
         curl_easy_setopt(m_curl.get(), CURLOPT_NOBODY, 0L);
         m_is_propfind = true;
+        EnableCompression();
     } else {
         curl_easy_setopt(m_curl.get(), CURLOPT_NOBODY, 1L);
     }
@@ -236,5 +281,5 @@ CurlStatOp::SuccessImpl(bool returnObj)
 
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(new XrdCl::XRootDStatus(), obj);
+    InvokeHandler(handle, new XrdCl::XRootDStatus(), obj);
 }
@@ -16,6 +16,8 @@
  *
  ***************************************************************/
 
+#include "../common/XrdClCurlDnsCache.hh"
+#include "XrdClCurlCompletionExecutor.hh"
 #include "XrdClCurlOps.hh"
 #include "XrdClCurlResponses.hh"
 #include "XrdClCurlUtil.hh"
@@ -26,6 +28,7 @@
 #include <XrdCl/XrdClXRootDResponses.hh>
 
 #include <unistd.h>
+#include <cerrno>
 #include <cmath>
 #include <utility>
 
@@ -33,6 +36,11 @@ using namespace XrdClCurl;
 
 std::chrono::steady_clock::duration CurlOperation::m_stall_interval{CurlOperation::m_default_stall_interval};
 int CurlOperation::m_minimum_transfer_rate{CurlOperation::m_default_minimum_rate};
+std::atomic<bool> CurlOperation::m_metadata_compression{true};
+std::atomic<uint64_t> CurlOperation::m_compressed_ops{0};
+std::atomic<uint64_t> CurlOperation::m_compressed_wire_bytes{0};
+std::atomic<uint64_t> CurlOperation::m_compressed_decoded_bytes{0};
+std::atomic<uint64_t> CurlOperation::m_compressed_duration_us{0};
 
 std::chrono::steady_clock::time_point CalculateExpiry(struct timespec timeout) {
     if (timeout.tv_sec == 0 && timeout.tv_nsec == 0) {
@@ -58,6 +66,7 @@ CurlOperation::CurlOperation(XrdCl::ResponseHandler *handler, const std::string
     m_header_start(m_last_reset),
     m_conn_callout(callout),
     m_url(url),
+    m_completion_key(std::hash<std::string>{}(url)),
     m_handler(handler),
     m_curl(nullptr, &curl_easy_cleanup),
     m_logger(logger)
@@ -78,7 +87,14 @@ CurlOperation::Fail(uint16_t errCode, uint32_t errNum, const std::string &msg)
     auto status = new XrdCl::XRootDStatus(XrdCl::stError, errCode, errNum, msg);
     auto handle = m_handler;
     m_handler = nullptr;
-    handle->HandleResponse(status, nullptr);
+    InvokeHandler(handle, status, nullptr);
+}
+
+void
+CurlOperation::InvokeHandler(XrdCl::ResponseHandler *handler, XrdCl::XRootDStatus *status, XrdCl::AnyObject *response,
+    std::shared_ptr<XrdCl::ResponseHandler> handler_ref)
+{
+    CompletionExecutor::Instance().Dispatch(m_completion_key, handler, status, response, std::move(handler_ref));
 }
 
 int
@@ -208,6 +224,17 @@ CurlOperation::Redirect(std::string &target)
             curl_easy_setopt(m_curl.get(), CURLOPT_SSLKEY, key.c_str());
     }
     m_headers = HeaderParser();
+    ConfigureSocketTuning(location);
+    ConfigureResolve(location);
+    m_score_host = Scoreboard::Instance().GetHost(location);
+    m_ttfb_reported = false;
+    if (!Scoreboard::Instance().Admit(m_score_host)) {
+        m_logger->Debug(kLogXrdClCurl, "Not following redirect to %s; the endpoint is failing", location.c_str());
+        // The rejected request says nothing new about the endpoint; don't record it.
+        m_score_host = nullptr;
+        Fail(XrdCl::errRetry, EHOSTUNREACH, "Redirect target is failing; retry the operation later");
+        return RedirectAction::Fail;
+    }
 
     if (m_conn_callout) {
         auto conn_callout = m_conn_callout(location, *m_response_info);
@@ -339,6 +366,11 @@ CurlOperation::TransferStalled(uint64_t xfer, const std::chrono::steady_clock::t
         // Curl updated us with new timing but the byte count hasn't changed; no need to update the EMA.
         return false;
     }
+    // A transfer we throttled ourselves is not judged against the minimum rate.
+    if (m_throttled_recently) {
+        m_throttled_recently = false;
+        return false;
+    }
 
     // If the transfer is not stalled, then we check to see if the exponentially-weighted
     // moving average of the transfer rate is below the minimum.
@@ -374,6 +406,17 @@ CurlOperation::Setup(CURL *curl, CurlWorker &worker)
     }
 
     m_pause_start = {};
+    m_worker = &worker;
+    m_rate_limit_bytes = RateLimiter::Instance().IsBytesLimited();
+    if (m_rate_limit_bytes && !m_rate_host) {
+        m_rate_host = RateLimiter::Instance().GetHost(m_url);
+    }
+    m_throttled = m_throttled_recently = false;
+    m_throttled_until = {};
+    if (!m_score_host) {
+        m_score_host = Scoreboard::Instance().GetHost(m_url);
+    }
+    m_ttfb_reported = false;
     m_last_header_reset = m_last_reset = m_start_op = m_header_start = m_header_lastop = std::chrono::steady_clock::now();
 
     m_curl.reset(curl);
@@ -405,6 +448,9 @@ CurlOperation::Setup(CURL *curl, CurlWorker &worker)
         }
     }
 
+    ConfigureSocketTuning(m_url);
+    ConfigureResolve(m_url);
+
     if (m_conn_callout) {
         ResponseInfo info;
         auto callout = m_conn_callout(m_url, info);
@@ -432,6 +478,19 @@ CurlOperation::ReleaseHandle()
     m_callout.reset();
 
     if (m_curl == nullptr) return;
+    if (m_compressed) {
+        // Compare what crossed the network against what the operation consumed.
+        curl_off_t wire_bytes = 0;
+        if (curl_easy_getinfo(m_curl.get(), CURLINFO_SIZE_DOWNLOAD_T, &wire_bytes) == CURLE_OK && wire_bytes > 0) {
+            m_compressed_wire_bytes.fetch_add(wire_bytes, std::memory_order_relaxed);
+        }
+        m_compressed_decoded_bytes.fetch_add(m_body_bytes, std::memory_order_relaxed);
+        m_compressed_ops.fetch_add(1, std::memory_order_relaxed);
+        auto duration = std::chrono::steady_clock::now() - m_start_op;
+        m_compressed_duration_us.fetch_add(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), std::memory_order_relaxed);
+        curl_easy_setopt(m_curl.get(), CURLOPT_ACCEPT_ENCODING, nullptr);
+        m_compressed = false;
+    }
     curl_easy_setopt(m_curl.get(), CURLOPT_OPENSOCKETFUNCTION, nullptr);
     curl_easy_setopt(m_curl.get(), CURLOPT_OPENSOCKETDATA, nullptr);
     curl_easy_setopt(m_curl.get(), CURLOPT_SOCKOPTFUNCTION, nullptr);
@@ -440,9 +499,40 @@ CurlOperation::ReleaseHandle()
     curl_easy_setopt(m_curl.get(), CURLOPT_SSLKEY, nullptr);
     curl_easy_setopt(m_curl.get(), CURLOPT_HTTPHEADER, nullptr);
     m_header_slist.reset();
+    curl_easy_setopt(m_curl.get(), CURLOPT_RESOLVE, nullptr);
+    m_resolve_slist.reset();
     m_curl.release();
 }
 
+void
+CurlOperation::EnableCompression()
+{
+    if (m_compressed || !m_metadata_compression.load(std::memory_order_relaxed)) return;
+    // An empty string lets libcurl advertise exactly the encodings it was built with.
+    curl_easy_setopt(m_curl.get(), CURLOPT_ACCEPT_ENCODING, "");
+    m_compressed = true;
+}
+
+void
+CurlOperation::DisableCompression()
+{
+    if (!m_compressed) return;
+    curl_easy_setopt(m_curl.get(), CURLOPT_ACCEPT_ENCODING, nullptr);
+    m_compressed = false;
+}
+
+std::string
+CurlOperation::GetCompressionMonitoringJson()
+{
+    return "{"
+        "\"enabled\":" + std::string(m_metadata_compression.load(std::memory_order_relaxed) ? "true" : "false") + ","
+        "\"ops\":" + std::to_string(m_compressed_ops.load(std::memory_order_relaxed)) + ","
+        "\"wire_bytes\":" + std::to_string(m_compressed_wire_bytes.load(std::memory_order_relaxed)) + ","
+        "\"decoded_bytes\":" + std::to_string(m_compressed_decoded_bytes.load(std::memory_order_relaxed)) + ","
+        "\"duration_us\":" + std::to_string(m_compressed_duration_us.load(std::memory_order_relaxed)) +
+        "}";
+}
+
 curl_socket_t
 CurlOperation::OpenSocketCallback(void *clientp, curlsocktype purpose, struct curl_sockaddr *address)
 {
@@ -466,6 +556,133 @@ CurlOperation::SockOptCallback(void *clientp, curl_socket_t curlfd, curlsocktype
     return CURL_SOCKOPT_ALREADY_CONNECTED;
 }
 
+int
+CurlOperation::TuneSockOptCallback(void *clientp, curl_socket_t curlfd, curlsocktype purpose)
+{
+    if (purpose != CURLSOCKTYPE_IPCXN) {
+        return CURL_SOCKOPT_OK;
+    }
+    auto me = reinterpret_cast<CurlOperation*>(clientp);
+    SocketTuning::Instance().ApplySocketOptions(curlfd, me->m_tuning.m_socket_buffer, me->m_logger);
+    return CURL_SOCKOPT_OK;
+}
+
+void
+CurlOperation::ConfigureSocketTuning(const std::string &url)
+{
+    auto &tuning = SocketTuning::Instance();
+    m_tuning = tuning.Get(url);
+    curl_easy_setopt(m_curl.get(), CURLOPT_BUFFERSIZE, GetCurlBufferSize());
+    if (m_tuning.m_socket_buffer > 0 || !tuning.GetCongestionControl().empty()) {
+        curl_easy_setopt(m_curl.get(), CURLOPT_SOCKOPTFUNCTION, CurlOperation::TuneSockOptCallback);
+        curl_easy_setopt(m_curl.get(), CURLOPT_SOCKOPTDATA, this);
+    } else {
+        curl_easy_setopt(m_curl.get(), CURLOPT_SOCKOPTFUNCTION, nullptr);
+        curl_easy_setopt(m_curl.get(), CURLOPT_SOCKOPTDATA, nullptr);
+    }
+}
+
+void
+CurlOperation::ConfigureResolve(const std::string &url)
+{
+    std::string entry;
+    if (!DnsCache::Instance().GetResolveEntry(url, entry)) {
+        if (m_resolve_slist) {
+            curl_easy_setopt(m_curl.get(), CURLOPT_RESOLVE, nullptr);
+            m_resolve_slist.reset();
+        }
+        return;
+    }
+#if LIBCURL_VERSION_NUM >= 0x074b00
+    // Let the injected addresses expire from curl's DNS cache like resolved ones.
+    if (entry[0] != '-') {
+        entry = "+" + entry;
+    }
+#endif
+    std::unique_ptr<struct curl_slist, void(*)(struct curl_slist *)> resolve{curl_slist_append(nullptr, entry.c_str()), &curl_slist_free_all};
+    if (resolve && curl_easy_setopt(m_curl.get(), CURLOPT_RESOLVE, resolve.get()) == CURLE_OK) {
+        m_resolve_slist = std::move(resolve);
+    }
+}
+
+std::chrono::steady_clock::time_point
+CurlOperation::GetNextDeadline() const
+{
+    if (!m_received_header) {
+        return m_header_expiry;
+    }
+    auto last_xfer = m_last_xfer == std::chrono::steady_clock::time_point() ? m_header_lastop : m_last_xfer;
+    auto deadline = last_xfer + m_stall_interval;
+    if (m_operation_expiry != std::chrono::steady_clock::time_point{} && m_operation_expiry < deadline) {
+        deadline = m_operation_expiry;
+    }
+    if (m_throttled && m_throttled_until < deadline) {
+        deadline = m_throttled_until;
+    }
+    return deadline;
+}
+
+std::chrono::steady_clock::duration
+CurlOperation::AdmitRequest(std::chrono::steady_clock::time_point now)
+{
+    if (m_request_admitted) {
+        return std::chrono::steady_clock::duration::zero();
+    }
+    m_request_admitted = true;
+    auto &limiter = RateLimiter::Instance();
+    m_rate_host = limiter.GetHost(m_url);
+    return limiter.AcquireRequest(m_rate_host, now);
+}
+
+bool
+CurlOperation::ThrottleTransfer()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now >= m_throttled_until) {
+        m_throttled_until = {};
+        return false;
+    }
+    // Returning the pause code from the callback pauses the handle inside libcurl;
+    // the worker's deadline timer resumes it when the pause ends.
+    m_throttled = m_throttled_recently = true;
+    if (m_worker) {
+        m_worker->ScheduleDeadline(m_curl.get(), GetNextDeadline());
+    }
+    return true;
+}
+
+void
+CurlOperation::ChargeTransferSlow(uint64_t bytes)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto wait = RateLimiter::Instance().ChargeBytes(m_rate_host, bytes, now);
+    if (wait > std::chrono::steady_clock::duration::zero()) {
+        m_throttled_until = now + wait;
+    }
+}
+
+bool
+CurlOperation::ResumeThrottled(std::chrono::steady_clock::time_point now, bool force)
+{
+    if (!m_throttled || (!force && now < m_throttled_until)) {
+        return false;
+    }
+    m_throttled = false;
+    m_throttled_until = {};
+    CURLcode rc;
+    if ((rc = curl_easy_pause(m_curl.get(), CURLPAUSE_CONT)) != CURLE_OK) {
+        m_logger->Error(kLogXrdClCurl, "Failed to continue a rate-limited handle: %s", curl_easy_strerror(rc));
+        return false;
+    }
+    return true;
+}
+
+bool
+CurlOperation::DeadlineExpired(const std::chrono::steady_clock::time_point &now)
+{
+    return HeaderTimeoutExpired(now) || OperationTimeoutExpired(now) || TransferStalled(m_last_xfer_count, now);
+}
+
 int
 CurlOperation::XferInfoCallback(void *clientp, curl_off_t /*dltotal*/, curl_off_t dlnow, curl_off_t /*ultotal*/, curl_off_t ulnow)
 {
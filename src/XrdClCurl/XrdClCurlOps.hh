@@ -19,9 +19,13 @@
 #ifndef XRDCLCURL_CURLOPS_HH
 #define XRDCLCURL_CURLOPS_HH
 
+#include "../common/XrdClCurlScoreboard.hh"
 #include "XrdClCurlConnectionCallout.hh"
 #include "XrdClCurlHeaderCallout.hh"
+#include "XrdClCurlRateLimiter.hh"
 #include "XrdClCurlResponseInfo.hh"
+#include "XrdClCurlSocketTuning.hh"
+#include "XrdClCurlUploadChecksum.hh"
 #include "XrdClCurlUtil.hh"
 
 #include <XrdCl/XrdClBuffer.hh>
@@ -170,6 +174,21 @@ public:
     // Invoked after the OPTIONS request is done and results are available
     void virtual OptionsDone() {}
 
+    // The action to take after an operation started without waiting for the OPTIONS
+    // response succeeds with a response that would have been better served by another verb.
+    enum class VerbRetry {
+        None,              // The response is sufficient; complete the operation.
+        Reinvoke,          // The handle was reconfigured; send the request again.
+        ReinvokeAfterAllow // Send OPTIONS to the returned target, then the request again.
+    };
+
+    // Invoked when the operation succeeds, before `Success`.
+    VerbRetry virtual RetryWithVerbs(std::string &) {return VerbRetry::None;}
+
+    // Returns whether the operation may be started before the OPTIONS response is
+    // known, relying on `RetryWithVerbs` to correct the verb afterward.
+    bool virtual CanSpeculateOptions() const {return false;}
+
     // Returns the URL that was used for the operation.
     const std::string &GetUrl() const {return m_url;}
 
@@ -200,6 +219,34 @@ public:
     // the m_error will be set
     bool TransferStalled(uint64_t xfer_bytes, const std::chrono::steady_clock::time_point &now);
 
+    // Returns the earliest time at which one of the header, operation, or
+    // stall timeouts may fire given the progress seen so far.
+    //
+    // Used by the worker's timer wheel to schedule the next deadline check.
+    std::chrono::steady_clock::time_point GetNextDeadline() const;
+
+    // Returns the time the operation must wait before starting in order to honor the
+    // request rate limits.
+    //
+    // Only the first call reserves a request slot; subsequent calls (e.g., once the
+    // delayed operation is dequeued again) return zero.
+    std::chrono::steady_clock::duration AdmitRequest(std::chrono::steady_clock::time_point now);
+
+    // Returns true if the transfer is paused in libcurl by the byte rate limits.
+    bool IsThrottled() const {return m_throttled;}
+
+    // Resume a transfer paused by the byte rate limits if its pause has ended (or
+    // unconditionally if `force` is set, such as when a deadline has expired).
+    //
+    // Returns true if the transfer was resumed.
+    bool ResumeThrottled(std::chrono::steady_clock::time_point now, bool force=false);
+
+    // Returns true if any of the header, operation, or stall timeouts have expired.
+    //
+    // Performs the same checks as the libcurl progress callback, using the last
+    // byte count it observed; if a timeout has expired, the m_error will be set.
+    bool DeadlineExpired(const std::chrono::steady_clock::time_point &now);
+
     enum OpError {
         ErrNone,                // No error
         ErrHeaderTimeout,       // Header was not sent back in time
@@ -245,6 +292,17 @@ public:
     // These numbers are reset to zero each time the `StatisticsReset` function is called.
     std::tuple<uint64_t, std::chrono::steady_clock::duration, std::chrono::steady_clock::duration, std::chrono::steady_clock::duration> StatisticsReset();
 
+    // Returns the scoreboard entry for the endpoint currently serving the operation.
+    const std::shared_ptr<Scoreboard::Host> &GetScoreboardHost() const {return m_score_host;}
+
+    // Returns the time from the start of the request to its first header on the first
+    // call after the header was received; zero otherwise.
+    std::chrono::steady_clock::duration TakeTimeToFirstHeader() {
+        if (!m_received_header || m_ttfb_reported) return std::chrono::steady_clock::duration::zero();
+        m_ttfb_reported = true;
+        return m_header_start - m_start_op;
+    }
+
     // Sets the stall timeout for the operation in seconds.
     static void SetStallTimeout(int stall_interval)
     {
@@ -276,10 +334,40 @@ public:
         m_minimum_transfer_rate = rate;
     }
 
+    // Sets whether listing and metadata responses are requested with a compressed encoding.
+    static void SetMetadataCompression(bool enabled) {m_metadata_compression.store(enabled, std::memory_order_relaxed);}
+
+    // Returns the statistics of the transfers that requested compression as a JSON object.
+    static std::string GetCompressionMonitoringJson();
+
+    // Returns whether the request advertises compressed encodings.
+    bool IsCompressed() const {return m_compressed;}
+
 protected:
 
     // Update the count of bytes transferred
-    void UpdateBytes(uint64_t bytes) {m_bytes += bytes;}
+    void UpdateBytes(uint64_t bytes) {m_bytes += bytes; m_body_bytes += bytes;}
+
+    // Advertise every content encoding libcurl can decode (gzip, zstd, ...); the body is
+    // decompressed as it streams in.  Only for responses consumed as a whole, such as
+    // listings: byte offsets in a compressed body don't correspond to the object's.
+    // No-op if disabled by the configuration.
+    void EnableCompression();
+
+    // Stop advertising compressed encodings; used when an operation falls back from a
+    // listing-style request (PROPFIND) to one that isn't, such as HEAD.
+    void DisableCompression();
+
+    // Returns true if a body callback must pause the transfer to honor the byte
+    // rate limits; the worker resumes it once the limits allow.
+    bool TransferThrottled() {
+        return m_throttled_until != std::chrono::steady_clock::time_point{} && ThrottleTransfer();
+    }
+
+    // Charge the bytes accepted by a body callback against the byte rate limits.
+    void ChargeTransfer(uint64_t bytes) {
+        if (m_rate_limit_bytes) ChargeTransferSlow(bytes);
+    }
 
     // Set failure from a callback function.
     // The Fail() function may invoke libcurl functions and hence cannot be invoked from a
@@ -310,6 +398,13 @@ protected:
     // Any additional headers to send with the request.
     HeaderCallout *m_header_callout;
 
+    // Returns the libcurl buffer size selected for this operation's endpoint.
+    long GetTunedCurlBuffer() const {return m_tuning.m_curl_buffer;}
+
+    // Returns the CURLOPT_BUFFERSIZE for the operation.  Only data GETs benefit from
+    // the endpoint's tuned buffer; everything else keeps the small default.
+    virtual long GetCurlBufferSize() const {return SocketTuning::m_default_curl_buffer;}
+
 private:
     bool Header(const std::string &header);
     static size_t HeaderCallback(char *buffer, size_t size, size_t nitems, void *data);
@@ -325,6 +420,15 @@ private:
     static constexpr std::chrono::steady_clock::duration m_default_stall_interval{std::chrono::seconds(60)};
     static std::chrono::steady_clock::duration m_stall_interval;
 
+    // Whether listing and metadata operations request compressed responses.
+    static std::atomic<bool> m_metadata_compression;
+
+    // Statistics of the operations that requested compressed responses.
+    static std::atomic<uint64_t> m_compressed_ops; // Count of operations.
+    static std::atomic<uint64_t> m_compressed_wire_bytes; // Body bytes received from the network.
+    static std::atomic<uint64_t> m_compressed_decoded_bytes; // Body bytes after decompression.
+    static std::atomic<uint64_t> m_compressed_duration_us; // Total operation latency, in microseconds.
+
     OpError m_error{ErrNone};
     XErrorCode m_callback_error_code{kXR_noErrorYet}; // Stored error that occurred in a callback.
     std::string m_callback_error_str; // Stored error message that occurred in a callback.
@@ -336,6 +440,8 @@ private:
     int m_conn_callout_result{-1}; // The result of the connection callout
     int m_conn_callout_listener{-1}; // The listener socket for the connection callout
     uint64_t m_bytes{0}; // Count of bytes transferred by operation since last StatisticsReset()
+    uint64_t m_body_bytes{0}; // Count of (decoded) body bytes received by the operation.
+    bool m_compressed{false}; // Whether the request advertised compressed encodings.
     std::chrono::steady_clock::time_point m_last_reset{}; // Time of last StatisticsReset()
     std::chrono::steady_clock::time_point m_last_header_reset{}; // Time of last StatisticsReset() for header statistics
     std::chrono::steady_clock::time_point m_start_op{}; // Time when the entire operation was started.
@@ -346,6 +452,9 @@ private:
     // List of custom headers for the operation.
     std::unique_ptr<struct curl_slist, void(*)(struct curl_slist *)> m_header_slist{nullptr, &curl_slist_free_all};
 
+    // CURLOPT_RESOLVE entry for the current endpoint of the operation.
+    std::unique_ptr<struct curl_slist, void(*)(struct curl_slist *)> m_resolve_slist{nullptr, &curl_slist_free_all};
+
     // The callout class for connection creation.
     CreateConnCalloutType m_conn_callout{nullptr};
 
@@ -368,12 +477,54 @@ private:
     static curl_socket_t OpenSocketCallback(void *clientp, curlsocktype purpose, struct curl_sockaddr *address);
     static int SockOptCallback(void *clientp, curl_socket_t curlfd, curlsocktype purpose);
 
+    // Socket option callback for sockets created by libcurl; applies the socket buffer
+    // and congestion control tuning.
+    static int TuneSockOptCallback(void *clientp, curl_socket_t curlfd, curlsocktype purpose);
+
+    // Look up the buffer tuning for the given URL and configure the curl handle accordingly.
+    void ConfigureSocketTuning(const std::string &url);
+
+    // Inject the cached addresses of the URL's host into the curl handle, if available.
+    void ConfigureResolve(const std::string &url);
+
+    // Buffer sizes selected for the current endpoint of the operation.
+    SocketTuning::Params m_tuning;
+
+    // Slow paths of TransferThrottled and ChargeTransfer, taken only when byte limits are active.
+    bool ThrottleTransfer();
+    void ChargeTransferSlow(uint64_t bytes);
+
+    // The worker thread running the operation; set in Setup.
+    CurlWorker *m_worker{nullptr};
+
+    // The per-endpoint rate limit buckets (nullptr if there are no per-host limits).
+    std::shared_ptr<RateLimiter::Host> m_rate_host;
+    bool m_rate_limit_bytes{false}; // Set if the byte rate limits apply to this operation.
+
+    // The performance scores of the endpoint serving the request; updated on redirect.
+    std::shared_ptr<Scoreboard::Host> m_score_host;
+    bool m_ttfb_reported{false}; // Set once the time to first header was given to the scoreboard.
+    bool m_request_admitted{false}; // Set once a request slot has been reserved.
+    bool m_throttled{false}; // Set while the transfer is paused by the byte rate limits.
+    bool m_throttled_recently{false}; // Set if the transfer was throttled since the last slow-rate check.
+    std::chrono::steady_clock::time_point m_throttled_until{}; // End of the current byte rate limit pause.
+
     // Periodic transfer info callback function invoked by curl; used for more fine-grained timeouts.
     static int XferInfoCallback(void *clientp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
 
 protected:
     void SetDone(bool has_failed) {m_done = true; m_has_failed.store(has_failed, std::memory_order_release);}
+
+    // Invoke the response handler for the operation; if the completion executor is
+    // enabled, the handler runs on one of its threads instead of the curl worker.
+    //
+    // Completions for operations on the same URL are delivered in order.
+    void InvokeHandler(XrdCl::ResponseHandler *handler, XrdCl::XRootDStatus *status, XrdCl::AnyObject *response,
+        std::shared_ptr<XrdCl::ResponseHandler> handler_ref = {});
+
     const std::string m_url;
+    // Ordering key for the completion executor; derived from the URL.
+    const size_t m_completion_key;
     XrdCl::ResponseHandler *m_handler{nullptr};
     std::unique_ptr<CURL, void(*)(CURL *)> m_curl;
     HeaderParser m_headers;
@@ -399,6 +550,15 @@ public:
         m_operation_expiry = m_header_expiry;
     }
 
+    // A probe run alongside an operation that was started without waiting for it;
+    // its only effect is to populate the verbs cache.
+    CurlOptionsOp(const std::string &url, std::chrono::steady_clock::time_point expiry, XrdCl::Log *log,
+        CreateConnCalloutType callout) :
+        CurlOperation(nullptr, url, expiry, log, callout, {})
+    {
+        m_operation_expiry = m_header_expiry;
+    }
+
     virtual ~CurlOptionsOp() {}
 
     bool Setup(CURL *curl, CurlWorker &) override;
@@ -407,9 +567,12 @@ public:
     void ReleaseHandle() override;
 
     // Returns the parent operation that has been paused while waiting for the
-    // OPTIONS response.
+    // OPTIONS response; nullptr for a detached probe.
     std::shared_ptr<CurlOperation> GetOperation() const {return m_parent;}
 
+    // Returns true if no operation is waiting on the OPTIONS response.
+    bool IsDetached() const {return m_parent == nullptr;}
+
     // Returns the parent operation's curl handle that has been paused while
     // waiting for the OPTIONS response.
     CURL *GetParentCurlHandle() const {return m_parent_curl;}
@@ -444,6 +607,7 @@ public:
 
     bool virtual RequiresOptions() const override;
     void virtual OptionsDone() override;
+    VerbRetry virtual RetryWithVerbs(std::string &target) override;
 
     std::pair<int64_t, bool> GetStatInfo();
 
@@ -470,6 +634,10 @@ private:
     bool m_is_propfind{false};
     // Whether the stat response indicated that the object is a directory.
     bool m_is_dir{false};
+    // Whether a HEAD without an object size was already retried as PROPFIND.
+    bool m_verbs_retried{false};
+    // URL whose verbs are used once a retry's OPTIONS response is available.
+    std::string m_verbs_url;
     std::string m_response; // Body of the response (if using PROPFIND)
     int64_t m_length{-1}; // Length of the object from the response
 };
@@ -485,6 +653,10 @@ public:
     void ReleaseHandle() override;
     void Success() override;
 
+    // An open only needs to know whether the object exists and its size, which HEAD
+    // provides; a stat may need PROPFIND to tell a directory from a file.
+    bool virtual CanSpeculateOptions() const override {return true;}
+
     // Invoked to handle a failure-to-open (HEAD returns non-200)
     //
     // If the open operation is invoked for a file with the `New` flag set, this
@@ -620,6 +792,17 @@ public:
 
     virtual HttpVerb GetVerb() const override {return HttpVerb::GET;}
 
+    // Large reads may use the endpoint's tuned buffer size (sized from the bandwidth-delay
+    // product) but never more than the request itself; small reads keep small buffers.
+    long GetCurlBufferSize() const override;
+
+    // Request the object with a compressed encoding if it is read whole from the start;
+    // used for listings fetched with a plain GET.
+    void SetAcceptEncoding() {m_accept_encoding = true;}
+
+    // Make the GET conditional on the object's entity tag (a quoted strong ETag);
+    // used when resuming a download so the remaining bytes come from the same object.
+    void SetIfMatch(const std::string &etag) {m_if_match = etag;}
 
 private:
     static size_t WriteCallback(char *buffer, size_t size, size_t nitems, void *this_ptr);
@@ -643,6 +826,12 @@ private:
     // is no ongoing CurlFile read operation.
     std::shared_ptr<XrdCl::ResponseHandler> m_default_handler;
 
+    // Value of the If-Match header; empty if the request is unconditional.
+    std::string m_if_match;
+
+    // Whether a compressed encoding may be requested for the object.
+    bool m_accept_encoding{false};
+
 protected:
     std::pair<uint64_t, uint64_t> m_op;
     uint64_t m_written{0}; // Bytes written into the current client-provided buffer
@@ -675,6 +864,56 @@ private:
     XrdClCurl::File &m_file;
 };
 
+// A whole-object GET written directly into a local file.
+//
+// The body is written with pwrite from the libcurl write callback instead of
+// being handed to the caller one Read buffer at a time, removing the per-chunk
+// round trips between the caller and the worker thread.  If the file was opened
+// with O_DIRECT, the body is staged in an aligned buffer so every write is aligned.
+// On success, the handler is invoked without a response object.
+class CurlDownloadOp final : public CurlReadOp {
+public:
+    // If `owned` is set, the descriptor is closed when the operation is destroyed.
+    CurlDownloadOp(XrdCl::ResponseHandler *handler, const std::string &url, struct timespec timeout,
+        int fd, bool owned, XrdCl::Log *logger, CreateConnCalloutType callout, HeaderCallout *header_callout);
+
+    virtual ~CurlDownloadOp();
+
+    // Reserve the space for the object from the response's Content-Length before the first write.
+    void SetPreallocate(bool preallocate) {m_preallocate = preallocate;}
+
+    // Flush the file to stable storage before reporting success.
+    void SetSync(bool sync) {m_sync = sync;}
+
+    bool Setup(CURL *curl, CurlWorker &) override;
+    void Success() override;
+
+private:
+    static size_t WriteCallback(char *buffer, size_t size, size_t nitems, void *this_ptr);
+    size_t Write(char *buffer, size_t length);
+
+    // Write `length` bytes at the current file offset; returns false (with errno set) on failure.
+    bool WriteFile(const char *buffer, size_t length);
+
+    // Write out the staged bytes; when `final` is set, the unaligned tail is written
+    // with O_DIRECT cleared.  Returns false (with errno set) on failure.
+    bool FlushStage(bool final);
+
+    // Alignment and size of the staging buffer used for O_DIRECT files.
+    static constexpr size_t m_direct_alignment{4096};
+    static constexpr size_t m_stage_size{4 * 1024 * 1024};
+
+    int m_fd{-1};
+    bool m_owned{false};
+    bool m_direct{false}; // Whether the file was opened with O_DIRECT.
+    bool m_preallocate{false};
+    bool m_sync{false};
+    bool m_started{false}; // Set once the first byte of the body arrived.
+    off_t m_file_offset{0}; // Bytes of the body written to the file so far.
+    std::unique_ptr<char, void(*)(void *)> m_stage{nullptr, free};
+    size_t m_stage_used{0};
+};
+
 class CurlVectorReadOp : public CurlOperation {
     public:
 
@@ -855,8 +1094,18 @@ public:
         const std::string &url, XrdCl::Buffer &&buffer,
         struct timespec timeout, XrdCl::Log *logger, CreateConnCalloutType callout,
         HeaderCallout *header_callout);
+    // Upload the first `size` bytes of the local file `fd` in a single request.
+    //
+    // libcurl reads the file directly into its upload buffer, avoiding the copy
+    // through a caller buffer and the per-write handoff between the caller and
+    // the worker thread.  If `owned` is set, the descriptor is closed when the
+    // operation is destroyed.
+    CurlPutOp(XrdCl::ResponseHandler *handler, std::shared_ptr<XrdCl::ResponseHandler> default_handler,
+        const std::string &url, int fd, bool owned, off_t size,
+        struct timespec timeout, XrdCl::Log *logger, CreateConnCalloutType callout,
+        HeaderCallout *header_callout);
 
-    virtual ~CurlPutOp() {}
+    virtual ~CurlPutOp();
 
     void Fail(uint16_t errCode, uint32_t errNum, const std::string &msg) override;
     bool Setup(CURL *curl, CurlWorker &) override;
@@ -882,12 +1131,49 @@ public:
 
     virtual HttpVerb GetVerb() const override {return HttpVerb::PUT;}
 
+    // Checksum the uploaded bytes with `algorithm`.  If `complete` is set, the initial
+    // buffer is the whole object and the checksum is sent as a header; otherwise, if
+    // `trailer` is set, the upload is sent chunked and the checksum follows it as a
+    // trailer in the Digest style.  Without either (or in the S3 style, or with a
+    // libcurl too old for trailers) the checksum can't be sent, so none is computed.
+    // Must be called before the operation is queued.
+    void SetUploadChecksum(UploadChecksum::Algorithm algorithm, UploadChecksum::Style style, bool complete, bool trailer);
+
+    // Returns true if the checksum is sent as a trailer; the upload is then chunked and
+    // must be finished with an empty buffer even if its size is known.
+    bool HasChecksumTrailer() const {return m_checksum_trailer;}
+
+    // Returns the checksum of the uploaded bytes ("<algorithm> <hex value>") once the
+    // last byte was sent; empty otherwise.
+    const std::string &GetUploadChecksum() const {return m_checksum_value;}
+
 private:
 
     // Callback function for libcurl when it would like to read data from m_data
     // (and write it to the remote socket).
     static size_t ReadCallback(char *buffer, size_t size, size_t n, void *v);
 
+    // Fill libcurl's upload buffer from the local source file.
+    size_t ReadSource(char *buffer, size_t size);
+
+    // Callback function for libcurl to rewind the local source file (e.g., to
+    // resend the body after a redirect).
+    static int SeekCallback(void *v, curl_off_t offset, int origin);
+
+    // Callback function for libcurl to append the checksum trailer to a chunked upload.
+    static int TrailerCallback(struct curl_slist **list, void *v);
+
+    // Finalize the upload checksum after the last byte was handed to libcurl.
+    void FinishChecksum();
+
+    // Checksum of the bytes uploaded so far; nullptr if not requested.
+    std::unique_ptr<UploadChecksum> m_checksum;
+    UploadChecksum::Style m_checksum_style{UploadChecksum::Style::kDigest};
+    bool m_checksum_complete{false}; // The initial buffer is the whole object.
+    bool m_checksum_trailer{false}; // The checksum is sent as a trailer.
+    uint64_t m_checksum_bytes{0}; // Bytes added to the checksum so far.
+    std::string m_checksum_value; // The final checksum; set once the last byte was sent.
+
     // Handle that represents the current operation to libcurl
     CURL *m_curl_handle{nullptr};
 
@@ -913,6 +1199,15 @@ private:
     off_t m_object_size{-1};
 
     bool m_final{false};
+
+    // Local file to upload from; -1 if the data comes from File::Write calls.
+    int m_source_fd{-1};
+    bool m_source_owned{false}; // Whether m_source_fd is closed on destruction.
+    off_t m_source_offset{0}; // Offset of the next byte to read from the source.
+
+    // Size of libcurl's upload buffer when uploading from a local file; each
+    // buffer is filled by a single pread.
+    static constexpr long m_source_buffer_size{2 * 1024 * 1024};
 };
 
 } // namespace XrdClCurl
@@ -20,48 +20,41 @@
 
 #include <curl/curl.h>
 
-#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
 
 XrdClCurl::VerbsCache XrdClCurl::VerbsCache::g_cache;
 std::once_flag XrdClCurl::VerbsCache::m_expiry_launch;
-std::mutex XrdClCurl::VerbsCache::m_shutdown_lock;
-std::condition_variable XrdClCurl::VerbsCache::m_shutdown_requested_cv;
-bool XrdClCurl::VerbsCache::m_shutdown_requested = false;
-std::condition_variable XrdClCurl::VerbsCache::m_shutdown_complete_cv;
-bool XrdClCurl::VerbsCache::m_shutdown_complete = true; // Starts in "true" state as the thread hasn't started
+XrdClCurl::Scheduler::TaskId XrdClCurl::VerbsCache::m_expiry_task{0};
 
 XrdClCurl::VerbsCache & XrdClCurl::VerbsCache::Instance() {
     std::call_once(m_expiry_launch, [] {
-        {
-            std::unique_lock lk(m_shutdown_lock);
-            m_shutdown_complete = false;
-        }
-        std::thread t(VerbsCache::ExpireThread);
-        t.detach();
+        m_expiry_task = Scheduler::Instance().Schedule("verbs_cache", std::chrono::seconds(30), VerbsCache::ExpireTask);
     });
     return g_cache;
 }
 
-void XrdClCurl::VerbsCache::ExpireThread()
+void XrdClCurl::VerbsCache::ExpireTask()
 {
-    while (true) {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_requested_cv.wait_for(
-                lock,
-                std::chrono::seconds(30),
-                []{return m_shutdown_requested;}
-            );
-            if (m_shutdown_requested) {
-                break;
-            }
-        }
-        auto now = std::chrono::steady_clock::now();
-        g_cache.Expire(now);
+    g_cache.Expire(std::chrono::steady_clock::now());
+
+    if (!g_cache.m_dirty) return;
+    std::string path;
+    {
+        std::unique_lock lock(g_cache.m_persist_mutex);
+        path = g_cache.m_persist_file;
+    }
+    if (!path.empty()) {
+        g_cache.Save(path);
     }
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_complete = true;
-    m_shutdown_complete_cv.notify_one();
 }
 
 void XrdClCurl::VerbsCache::Expire(std::chrono::steady_clock::time_point now)
@@ -74,14 +67,114 @@ void XrdClCurl::VerbsCache::Expire(std::chrono::steady_clock::time_point now)
             ++iter;
         }
     }
+    for (auto iter = m_probes.begin(); iter != m_probes.end();) {
+        if (iter->second < now) {
+            iter = m_probes.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+// The file holds one line per endpoint: the cache key, the verbs bitmask, and the
+// expiration as seconds since the Unix epoch (the steady clock doesn't survive the process).
+bool
+XrdClCurl::VerbsCache::Load(const std::string &path)
+{
+    std::ifstream fh(path);
+    if (!fh) return false;
+
+    auto steady_now = std::chrono::steady_clock::now();
+    auto system_now = std::chrono::system_clock::now();
+    std::string line;
+    const std::unique_lock sentry(m_mutex);
+    while (std::getline(fh, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        unsigned verbs_value;
+        long long expiry;
+        if (!(iss >> key >> verbs_value >> expiry)) continue;
+        HttpVerbs verbs;
+        if (verbs_value & static_cast<unsigned>(HttpVerb::kPROPFIND)) {
+            verbs |= HttpVerb::kPROPFIND;
+        }
+        if (verbs.IsSet(HttpVerb::kUnset)) continue;
+        auto remaining = std::chrono::system_clock::time_point(std::chrono::seconds(expiry)) - system_now;
+        if (remaining <= std::chrono::system_clock::duration::zero()) continue;
+        auto lifetime = std::min(std::chrono::duration_cast<std::chrono::steady_clock::duration>(remaining), g_expiry_duration);
+
+        auto iter = m_verbs_map.find(key);
+        if (iter == m_verbs_map.end()) {
+            m_verbs_map.emplace(key, VerbEntry{steady_now + lifetime, verbs});
+        } else if (iter->second.m_verbs.IsSet(HttpVerb::kUnknown) || iter->second.m_expiry < steady_now) {
+            iter->second = {steady_now + lifetime, verbs};
+        }
+    }
+    return true;
+}
+
+bool
+XrdClCurl::VerbsCache::Save(const std::string &path)
+{
+    m_dirty = false;
+    Load(path);
+
+    auto steady_now = std::chrono::steady_clock::now();
+    auto system_now = std::chrono::system_clock::now();
+    std::ostringstream oss;
+    {
+        const std::shared_lock sentry(m_mutex);
+        for (const auto &entry : m_verbs_map) {
+            if (entry.second.m_verbs.IsSet(HttpVerb::kUnknown) || entry.second.m_expiry < steady_now) continue;
+            auto expiry = system_now + std::chrono::duration_cast<std::chrono::system_clock::duration>(entry.second.m_expiry - steady_now);
+            oss << entry.first << " " << entry.second.m_verbs.GetValue() << " "
+                << std::chrono::duration_cast<std::chrono::seconds>(expiry.time_since_epoch()).count() << "\n";
+        }
+    }
+
+    // Write to a temporary file and rename it so concurrent readers never see a partial file.
+    std::vector<char> tmp_path(path.begin(), path.end());
+    for (auto c : std::string(".XXXXXX")) tmp_path.push_back(c);
+    tmp_path.push_back('\0');
+    auto fd = mkstemp(tmp_path.data());
+    if (fd == -1) return false;
+    auto contents = oss.str();
+    const char *buffer = contents.data();
+    auto remaining = contents.size();
+    while (remaining) {
+        auto rc = write(fd, buffer, remaining);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            close(fd);
+            unlink(tmp_path.data());
+            return false;
+        }
+        buffer += rc;
+        remaining -= rc;
+    }
+    fchmod(fd, 0644);
+    close(fd);
+    if (rename(tmp_path.data(), path.c_str()) == -1) {
+        unlink(tmp_path.data());
+        return false;
+    }
+    return true;
 }
 
 void
-XrdClCurl::VerbsCache::Shutdown()
+XrdClCurl::VerbsCache::SetPersistFile(const std::string &path)
 {
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_requested = true;
-    m_shutdown_requested_cv.notify_one();
+    {
+        std::unique_lock lock(m_persist_mutex);
+        m_persist_file = path;
+    }
+    if (!path.empty()) {
+        Load(path);
+    }
+}
 
-    m_shutdown_complete_cv.wait(lock, []{return m_shutdown_complete;});
+void
+XrdClCurl::VerbsCache::Shutdown()
+{
+    Scheduler::Instance().Cancel(m_expiry_task);
 }
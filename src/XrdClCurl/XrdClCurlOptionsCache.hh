@@ -19,14 +19,14 @@
 #ifndef _XRDCLCURL__OPTIONSCACHE_HH__
 #define _XRDCLCURL__OPTIONSCACHE_HH__
 
+#include "../common/XrdClCurlScheduler.hh"
+
 #include <array>
 #include <atomic>
 #include <chrono>
-#include <condition_variable>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
-#include <thread>
 #include <unordered_map>
  
  namespace XrdClCurl {
@@ -84,12 +84,49 @@
 #endif
         if (iter == m_verbs_map.end()) {
             m_verbs_map.emplace(key, VerbEntry{now + lifetime, verbs});
+            if (isKnown) m_dirty = true;
         } else if (isKnown || iter->second.m_verbs.IsSet(HttpVerb::kUnknown)) {
             // Previous entry didn't know the verbs, but now we do
             iter->second = {now + lifetime, verbs};
+            if (isKnown) m_dirty = true;
+        }
+#if __cplusplus >= 202002L
+        auto probe_iter = m_probes.find(key);
+#else
+        auto probe_iter = m_probes.find(std::string(key));
+#endif
+        if (probe_iter != m_probes.end()) {
+            m_probes.erase(probe_iter);
         }
     }
 
+    // Returns true if the caller should send an OPTIONS probe to the endpoint of `url`.
+    //
+    // Operations that don't wait for the verbs start their request while a probe runs
+    // in the background; this keeps concurrent operations to a new endpoint from each
+    // sending their own probe.  A probe without a result after `g_probe_duration` is
+    // assumed lost and another one may be started.
+    bool StartProbe(const std::string &url, const std::chrono::steady_clock::time_point &now=std::chrono::steady_clock::now()) const {
+        std::string modified_url;
+        auto key = GetUrlKey(url, modified_url);
+
+        const std::unique_lock sentry(m_mutex);
+#if __cplusplus >= 202002L
+        auto iter = m_probes.find(key);
+#else
+        auto iter = m_probes.find(std::string(key));
+#endif
+        if (iter == m_probes.end()) {
+            m_probes.emplace(key, now + g_probe_duration);
+            return true;
+        }
+        if (iter->second < now) {
+            iter->second = now + g_probe_duration;
+            return true;
+        }
+        return false;
+    }
+
     HttpVerbs Get(const std::string &url, const std::chrono::steady_clock::time_point &now=std::chrono::steady_clock::now()) const {
         std::string modified_url;
         auto key = GetUrlKey(url, modified_url);
@@ -141,6 +178,22 @@
     // Expire all entries in the cache whose expiration is older than `now`.
     void Expire(std::chrono::steady_clock::time_point now);
 
+    // Load the verbs previously saved to `path`; entries already in the cache are kept.
+    //
+    // Returns false if the file could not be read.
+    bool Load(const std::string &path);
+
+    // Save the known verbs to `path`, merging in the entries another process may have
+    // saved since they were last loaded.  The file is replaced atomically.
+    //
+    // Returns false if the file could not be written.
+    bool Save(const std::string &path);
+
+    // Set the file used to share the known verbs between processes; its contents are
+    // loaded immediately and the file is updated periodically as new endpoints are
+    // probed.  An empty path disables the persistence.
+    void SetPersistFile(const std::string &path);
+
     // Return the global instance of the verbs cache.
     static VerbsCache &Instance();
 
@@ -149,8 +202,8 @@ private:
     VerbsCache(const VerbsCache &) = delete;
     VerbsCache(VerbsCache &&) = delete;
 
-    // Background thread periodically invoking `Expire` on the cache.
-    static void ExpireThread();
+    // Periodic task invoking `Expire` on the cache.
+    static void ExpireTask();
 
     // Invoked by libc when the library is shutting down or is unloaded from the process.
     static void Shutdown() __attribute__((destructor));
@@ -176,22 +229,24 @@ private:
 
     mutable std::shared_mutex m_mutex;
     mutable std::unordered_map<std::string, VerbEntry, VerbsCache::transparent_string_hash, std::equal_to<>> m_verbs_map;
+    // Endpoints with an OPTIONS probe in progress and the time the probe is considered lost.
+    mutable std::unordered_map<std::string, std::chrono::steady_clock::time_point, VerbsCache::transparent_string_hash, std::equal_to<>> m_probes;
+
+    // Set when known verbs were added since the cache was last saved.
+    mutable std::atomic<bool> m_dirty{false};
+    // Protects m_persist_file.
+    std::mutex m_persist_mutex;
+    // File where the known verbs are saved; empty if not persisted.
+    std::string m_persist_file;
 
     static std::once_flag m_expiry_launch;
     static VerbsCache g_cache;
     static constexpr std::chrono::steady_clock::duration g_expiry_duration = std::chrono::hours(6);
     static constexpr std::chrono::steady_clock::duration g_negative_expiry_duration = std::chrono::minutes(15);
+    static constexpr std::chrono::steady_clock::duration g_probe_duration = std::chrono::minutes(1);
 
-    // Mutex for managing the shutdown of the background thread
-    static std::mutex m_shutdown_lock;
-    // Condition variable managing the requested shutdown of the background thread.
-    static std::condition_variable m_shutdown_requested_cv;
-    // Flag indicating that a shutdown was requested.
-    static bool m_shutdown_requested;
-    // Condition variable for the background thread to indicate it has completed.
-    static std::condition_variable m_shutdown_complete_cv;
-    // Flag indicating that the shutdown has completed.
-    static bool m_shutdown_complete;
+    // Scheduler task periodically invoking `Expire` on the cache.
+    static Scheduler::TaskId m_expiry_task;
 };
  
  } // namespace XrdClCurl
@@ -0,0 +1,176 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlOptionsCache.hh"
+#include "XrdClCurlRateLimiter.hh"
+
+#include <algorithm>
+#include <mutex>
+
+using namespace XrdClCurl;
+
+TokenBucket::TokenBucket(uint64_t rate, uint64_t burst) :
+    m_rate(rate ? rate : 1),
+    m_unit_ticks(static_cast<double>(std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)).count()) / m_rate),
+    m_burst_ticks(static_cast<Clock::rep>(m_unit_ticks * std::max<uint64_t>(burst, 1)))
+{}
+
+TokenBucket::Clock::duration
+TokenBucket::Reserve(uint64_t amount, Clock::time_point now)
+{
+    auto now_ticks = now.time_since_epoch().count();
+    auto increment = static_cast<Clock::rep>(m_unit_ticks * amount);
+    auto tat = m_tat.load(std::memory_order_relaxed);
+    Clock::rep new_tat;
+    do {
+        new_tat = std::max(tat, now_ticks) + increment;
+    } while (!m_tat.compare_exchange_weak(tat, new_tat, std::memory_order_relaxed));
+
+    auto wait = new_tat - now_ticks - m_burst_ticks;
+    return Clock::duration(wait > 0 ? wait : 0);
+}
+
+RateLimiter &
+RateLimiter::Instance()
+{
+    static RateLimiter instance;
+    return instance;
+}
+
+void
+RateLimiter::Configure(uint64_t bytes_per_sec, uint64_t requests_per_sec, uint64_t host_bytes_per_sec, uint64_t host_requests_per_sec)
+{
+    std::unique_lock lock(m_mutex);
+    m_bytes.reset(bytes_per_sec ? new TokenBucket(bytes_per_sec, bytes_per_sec) : nullptr);
+    m_requests.reset(requests_per_sec ? new TokenBucket(requests_per_sec, requests_per_sec) : nullptr);
+    m_host_bytes_per_sec = host_bytes_per_sec;
+    m_host_requests_per_sec = host_requests_per_sec;
+    m_hosts.clear();
+    m_last_prune = {};
+    m_bytes_limited = bytes_per_sec || host_bytes_per_sec;
+    m_requests_limited = requests_per_sec || host_requests_per_sec;
+}
+
+std::shared_ptr<RateLimiter::Host>
+RateLimiter::GetHost(const std::string &url, Clock::time_point now)
+{
+    if (!m_host_bytes_per_sec && !m_host_requests_per_sec) {
+        return nullptr;
+    }
+    std::string modified_url;
+    auto key = VerbsCache::GetUrlKey(url, modified_url);
+    {
+        std::shared_lock lock(m_mutex);
+        auto iter = m_hosts.find(key);
+        if (iter != m_hosts.end()) {
+            return iter->second;
+        }
+    }
+    std::unique_lock lock(m_mutex);
+    auto iter = m_hosts.find(key);
+    if (iter != m_hosts.end()) {
+        return iter->second;
+    }
+    if (now - m_last_prune >= m_prune_interval) {
+        Prune(now);
+    }
+    auto host = std::make_shared<Host>();
+    if (m_host_bytes_per_sec) {
+        host->m_bytes.reset(new TokenBucket(m_host_bytes_per_sec, m_host_bytes_per_sec));
+    }
+    if (m_host_requests_per_sec) {
+        host->m_requests.reset(new TokenBucket(m_host_requests_per_sec, m_host_requests_per_sec));
+    }
+    m_hosts.emplace(std::string(key), host);
+    return host;
+}
+
+void
+RateLimiter::Prune(Clock::time_point now)
+{
+    m_last_prune = now;
+    for (auto iter = m_hosts.begin(); iter != m_hosts.end();) {
+        // A referenced host may still be charged; dropping it would let a new
+        // operation start with a fresh bucket alongside the indebted one.
+        auto &host = *iter->second;
+        if (iter->second.use_count() == 1 &&
+            (!host.m_bytes || host.m_bytes->IsFull(now)) &&
+            (!host.m_requests || host.m_requests->IsFull(now)))
+        {
+            iter = m_hosts.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+RateLimiter::Clock::duration
+RateLimiter::AcquireRequest(const std::shared_ptr<Host> &host, Clock::time_point now)
+{
+    Clock::duration wait{};
+    if (m_requests) {
+        wait = m_requests->Reserve(1, now);
+    }
+    if (host && host->m_requests) {
+        wait = std::max(wait, host->m_requests->Reserve(1, now));
+    }
+    if (wait > Clock::duration::zero()) {
+        m_requests_delayed.fetch_add(1, std::memory_order_relaxed);
+        m_request_delay.fetch_add(wait.count(), std::memory_order_relaxed);
+    }
+    return wait;
+}
+
+RateLimiter::Clock::duration
+RateLimiter::ChargeBytes(const std::shared_ptr<Host> &host, uint64_t bytes, Clock::time_point now)
+{
+    Clock::duration wait{};
+    if (m_bytes) {
+        wait = m_bytes->Reserve(bytes, now);
+    }
+    if (host && host->m_bytes) {
+        wait = std::max(wait, host->m_bytes->Reserve(bytes, now));
+    }
+    m_bytes_charged.fetch_add(bytes, std::memory_order_relaxed);
+    if (wait > Clock::duration::zero()) {
+        m_transfer_pauses.fetch_add(1, std::memory_order_relaxed);
+        m_transfer_delay.fetch_add(wait.count(), std::memory_order_relaxed);
+    }
+    return wait;
+}
+
+std::string
+RateLimiter::GetMonitoringJson() const
+{
+    auto to_seconds = [](Clock::rep ticks) {
+        return std::to_string(std::chrono::duration<double>(Clock::duration(ticks)).count());
+    };
+    std::shared_lock lock(m_mutex);
+    return "{"
+        "\"bytes_per_sec\":" + std::to_string(m_bytes ? m_bytes->GetRate() : 0) + ","
+        "\"requests_per_sec\":" + std::to_string(m_requests ? m_requests->GetRate() : 0) + ","
+        "\"host_bytes_per_sec\":" + std::to_string(m_host_bytes_per_sec) + ","
+        "\"host_requests_per_sec\":" + std::to_string(m_host_requests_per_sec) + ","
+        "\"hosts\":" + std::to_string(m_hosts.size()) + ","
+        "\"requests_delayed\":" + std::to_string(m_requests_delayed.load(std::memory_order_relaxed)) + ","
+        "\"request_delay\":" + to_seconds(m_request_delay.load(std::memory_order_relaxed)) + ","
+        "\"bytes\":" + std::to_string(m_bytes_charged.load(std::memory_order_relaxed)) + ","
+        "\"transfer_pauses\":" + std::to_string(m_transfer_pauses.load(std::memory_order_relaxed)) + ","
+        "\"transfer_delay\":" + to_seconds(m_transfer_delay.load(std::memory_order_relaxed)) +
+        "}";
+}
@@ -0,0 +1,161 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_RATELIMITER_HH
+#define XRDCLCURL_RATELIMITER_HH
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace XrdClCurl {
+
+// A token bucket implemented as a generic cell rate algorithm (GCRA).
+//
+// Rather than tracking a token count, the bucket tracks the "theoretical
+// arrival time" (TAT) at which it will be empty again; each reservation
+// pushes the TAT forward by `amount / rate`.  A reservation never fails: if
+// the TAT is further in the future than the burst allows, the caller is
+// told how long to wait and the bucket goes into debt for the reservation.
+// This keeps the bucket a single atomic and lock-free to update.
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // A bucket refilling at `rate` units per second, holding up to `burst` units.
+    TokenBucket(uint64_t rate, uint64_t burst);
+
+    TokenBucket(const TokenBucket &) = delete;
+
+    // Reserve `amount` units; returns the time the caller must wait before using them
+    // (zero if they are available now).
+    Clock::duration Reserve(uint64_t amount, Clock::time_point now);
+
+    uint64_t GetRate() const {return m_rate;}
+
+    // Returns true if the bucket is full at `now` (no reservation is outstanding),
+    // so it is indistinguishable from a new bucket.
+    bool IsFull(Clock::time_point now) const {return m_tat.load(std::memory_order_relaxed) <= now.time_since_epoch().count();}
+
+private:
+    const uint64_t m_rate;
+    // Time to refill a single unit, in steady clock ticks (fractional for high rates).
+    const double m_unit_ticks;
+    // Maximum amount the TAT may be ahead of now without waiting, in steady clock ticks.
+    const Clock::rep m_burst_ticks;
+    std::atomic<Clock::rep> m_tat{0};
+};
+
+// Process-wide limits on the transfer rate and the request rate.
+//
+// Limits apply both across the whole process and to each destination
+// endpoint (scheme://host:port); a rate of zero disables the corresponding
+// limit.  Each bucket allows a burst of one second's worth of its rate.
+//
+// Request limits are enforced when the curl worker dequeues a new operation:
+// an operation over the limit is put back into the queue to be admitted once
+// its reservation comes due.  Byte limits are enforced in the body callbacks
+// of the GET and PUT operations: the data is accepted and charged against the
+// buckets, and the next callback pauses the transfer in libcurl until the
+// debt is paid off.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The per-endpoint buckets.  An endpoint whose buckets have refilled is dropped
+    // from the limiter once no operation holds a reference to it.
+    struct Host {
+        std::unique_ptr<TokenBucket> m_bytes;
+        std::unique_ptr<TokenBucket> m_requests;
+    };
+
+    // Return the global instance of the rate limiter.
+    static RateLimiter &Instance();
+
+    // Configure the limits, in bytes/sec and requests/sec; zero means unlimited.
+    //
+    // Must be called before any transfers start.
+    void Configure(uint64_t bytes_per_sec, uint64_t requests_per_sec, uint64_t host_bytes_per_sec, uint64_t host_requests_per_sec);
+
+    // Returns true if any byte limit is configured.
+    bool IsBytesLimited() const {return m_bytes_limited;}
+
+    // Returns true if any request limit is configured.
+    bool IsRequestLimited() const {return m_requests_limited;}
+
+    // Returns the buckets for the endpoint serving `url` or nullptr if there are no per-host limits.
+    std::shared_ptr<Host> GetHost(const std::string &url, Clock::time_point now=Clock::now());
+
+    // Reserve a request slot; returns the time to wait before starting the request.
+    Clock::duration AcquireRequest(const std::shared_ptr<Host> &host, Clock::time_point now);
+
+    // Charge `bytes` transferred; returns the time the transfer should pause.
+    Clock::duration ChargeBytes(const std::shared_ptr<Host> &host, uint64_t bytes, Clock::time_point now);
+
+    // Returns the rate limiting statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+    // Minimum time between scans for idle endpoints to drop.
+    static constexpr Clock::duration m_prune_interval{std::chrono::minutes(1)};
+
+private:
+    RateLimiter() = default;
+    RateLimiter(const RateLimiter &) = delete;
+
+    // Drop the idle endpoints no operation references; m_mutex must be held exclusively.
+    void Prune(Clock::time_point now);
+
+    template<typename ... Bases>
+    struct overload : Bases ...
+    {
+        using is_transparent = void;
+        using Bases::operator() ... ;
+    };
+    using transparent_string_hash = overload<
+        std::hash<std::string>,
+        std::hash<std::string_view>
+    >;
+
+    bool m_bytes_limited{false};
+    bool m_requests_limited{false};
+    uint64_t m_host_bytes_per_sec{0};
+    uint64_t m_host_requests_per_sec{0};
+
+    std::unique_ptr<TokenBucket> m_bytes;
+    std::unique_ptr<TokenBucket> m_requests;
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string, std::shared_ptr<Host>, transparent_string_hash, std::equal_to<>> m_hosts;
+    Clock::time_point m_last_prune{}; // Time of the last scan for idle endpoints; protected by m_mutex.
+
+    // Statistics for the monitoring output.
+    std::atomic<uint64_t> m_requests_delayed{0}; // Count of requests delayed by the request limits.
+    std::atomic<Clock::rep> m_request_delay{0}; // Total time requests were delayed.
+    std::atomic<uint64_t> m_bytes_charged{0}; // Count of bytes charged against the byte limits.
+    std::atomic<uint64_t> m_transfer_pauses{0}; // Count of transfer pauses due to the byte limits.
+    std::atomic<Clock::rep> m_transfer_delay{0}; // Total time transfers were paused.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_RATELIMITER_HH
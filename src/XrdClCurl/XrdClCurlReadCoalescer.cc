@@ -0,0 +1,180 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlReadCoalescer.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace XrdClCurl;
+
+// Wraps the handler of the leading read; distributes its bytes to the followers.
+class ReadCoalescer::LeaderHandler : public XrdCl::ResponseHandler {
+public:
+    LeaderHandler(ReadCoalescer &parent, const std::string &key, uint64_t offset, uint32_t size, XrdCl::ResponseHandler *handler)
+        : m_parent(parent), m_key(key), m_offset(offset), m_size(size), m_handler(handler)
+    {}
+
+    void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) override;
+
+    // Fail the followers without invoking the wrapped handler.
+    void Abandon();
+
+    // A read attached to the leader.
+    struct Follower {
+        uint64_t m_offset;
+        uint32_t m_size;
+        char *m_buffer;
+        XrdCl::ResponseHandler *m_handler;
+    };
+
+    ReadCoalescer &m_parent;
+    const std::string m_key;
+    const uint64_t m_offset;
+    const uint32_t m_size;
+    XrdCl::ResponseHandler *m_handler;
+
+    // Protected by the parent's m_mutex.
+    std::vector<Follower> m_followers;
+};
+
+void
+ReadCoalescer::LeaderHandler::HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw)
+{
+    std::unique_ptr<LeaderHandler> owner(this);
+    std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+    std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+
+    // Once out of the table, no more followers can attach.
+    std::vector<Follower> followers;
+    {
+        std::unique_lock lock(m_parent.m_mutex);
+        m_parent.Remove(this);
+        followers.swap(m_followers);
+    }
+
+    XrdCl::ChunkInfo *chunk = nullptr;
+    if (status && status->IsOK() && response) {
+        response->Get(chunk);
+    }
+    // The followers must be served before the leader's handler, which may release
+    // the buffer the bytes are copied from.
+    for (const auto &follower : followers) {
+        if (!chunk || !chunk->buffer) {
+            XrdCl::XRootDStatus follower_status(XrdCl::stError, XrdCl::errDataError, 0, "Coalesced read completed without data");
+            if (status && !status->IsOK()) {
+                follower_status = *status;
+            }
+            follower.m_handler->HandleResponse(new XrdCl::XRootDStatus(follower_status), nullptr);
+            continue;
+        }
+        // The leader may have returned fewer bytes than requested (end of file).
+        uint32_t length = 0;
+        auto start = follower.m_offset - chunk->offset;
+        if (follower.m_offset >= chunk->offset && start < chunk->length) {
+            length = std::min<uint64_t>(follower.m_size, chunk->length - start);
+            memcpy(follower.m_buffer, static_cast<char *>(chunk->buffer) + start, length);
+        }
+        m_parent.m_bytes_saved.fetch_add(length, std::memory_order_relaxed);
+        auto obj = new XrdCl::AnyObject();
+        obj->Set(new XrdCl::ChunkInfo(follower.m_offset, length, follower.m_buffer));
+        follower.m_handler->HandleResponse(new XrdCl::XRootDStatus(*status), obj);
+    }
+
+    m_handler->HandleResponse(status.release(), response.release());
+}
+
+void
+ReadCoalescer::LeaderHandler::Abandon()
+{
+    std::unique_ptr<LeaderHandler> owner(this);
+    std::vector<Follower> followers;
+    {
+        std::unique_lock lock(m_parent.m_mutex);
+        m_parent.Remove(this);
+        followers.swap(m_followers);
+    }
+    for (const auto &follower : followers) {
+        follower.m_handler->HandleResponse(new XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errOSError, 0, "Coalesced read could not be started"), nullptr);
+    }
+}
+
+ReadCoalescer &
+ReadCoalescer::Instance()
+{
+    static ReadCoalescer instance;
+    return instance;
+}
+
+std::string
+ReadCoalescer::GetKey(const std::string &url, const std::string &etag)
+{
+    return url + "\n" + etag;
+}
+
+void
+ReadCoalescer::Remove(LeaderHandler *leader)
+{
+    auto [begin, end] = m_inflight.equal_range(leader->m_key);
+    for (auto iter = begin; iter != end; ++iter) {
+        if (iter->second == leader) {
+            m_inflight.erase(iter);
+            return;
+        }
+    }
+}
+
+XrdCl::ResponseHandler *
+ReadCoalescer::Submit(const std::string &key, uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler)
+{
+    std::unique_lock lock(m_mutex);
+    auto [begin, end] = m_inflight.equal_range(key);
+    for (auto iter = begin; iter != end; ++iter) {
+        auto leader = iter->second;
+        if (leader->m_offset <= offset && offset + size <= leader->m_offset + leader->m_size) {
+            leader->m_followers.push_back({offset, size, static_cast<char *>(buffer), handler});
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+    auto leader = new LeaderHandler(*this, key, offset, size, handler);
+    m_inflight.emplace(key, leader);
+    m_leaders.fetch_add(1, std::memory_order_relaxed);
+    return leader;
+}
+
+void
+ReadCoalescer::Abandon(XrdCl::ResponseHandler *leader)
+{
+    static_cast<LeaderHandler *>(leader)->Abandon();
+}
+
+std::string
+ReadCoalescer::GetMonitoringJson() const
+{
+    return "{"
+        "\"enabled\":" + std::string(IsEnabled() ? "true" : "false") + ","
+        "\"leaders\":" + std::to_string(m_leaders.load(std::memory_order_relaxed)) + ","
+        "\"hits\":" + std::to_string(m_hits.load(std::memory_order_relaxed)) + ","
+        "\"bytes_saved\":" + std::to_string(m_bytes_saved.load(std::memory_order_relaxed)) +
+        "}";
+}
@@ -0,0 +1,93 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_READCOALESCER_HH
+#define XRDCLCURL_READCOALESCER_HH
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace XrdCl {
+    class ResponseHandler;
+}
+
+namespace XrdClCurl {
+
+// Process-wide table of in-flight reads, used to coalesce identical reads
+// issued concurrently through different file handles.
+//
+// Frameworks often open the same conditions or calibration file from many
+// threads at once and read the same byte ranges.  When enabled, the first read
+// of a range becomes the "leader" and goes to the network; a read of the same
+// object (URL and ETag) whose range lies within an in-flight leader's range
+// attaches to it instead.  When the leader completes, its bytes are copied
+// into each follower's buffer and the followers' handlers are invoked before
+// the leader's.
+class ReadCoalescer {
+public:
+    // Return the global instance of the coalescer.
+    static ReadCoalescer &Instance();
+
+    // Enable or disable coalescing; disabled by default.
+    void SetEnabled(bool enabled) {m_enabled.store(enabled, std::memory_order_relaxed);}
+    bool IsEnabled() const {return m_enabled.load(std::memory_order_relaxed);}
+
+    // Returns the key identifying an object: the URL (including any authorization
+    // in its query string) and the ETag, if known.
+    static std::string GetKey(const std::string &url, const std::string &etag);
+
+    // Submit a read of `size` bytes at `offset` into `buffer`.
+    //
+    // If an in-flight read of the same object covers the range, the read is
+    // attached to it and nullptr is returned; `handler` will be invoked when the
+    // leader completes.  Otherwise, the read becomes a leader and the returned
+    // handler (which wraps `handler`) must be given to the read operation.
+    XrdCl::ResponseHandler *Submit(const std::string &key, uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler);
+
+    // Abandon a leader returned by `Submit` whose operation could not be started.
+    // The followers are failed; the wrapped handler is not invoked.
+    void Abandon(XrdCl::ResponseHandler *leader);
+
+    // Returns the coalescing statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+private:
+    class LeaderHandler;
+
+    ReadCoalescer() = default;
+    ReadCoalescer(const ReadCoalescer &) = delete;
+
+    // Remove a leader from the in-flight table; m_mutex must be held.
+    void Remove(LeaderHandler *leader);
+
+    std::atomic<bool> m_enabled{false};
+
+    std::mutex m_mutex;
+    std::unordered_multimap<std::string, LeaderHandler *> m_inflight;
+
+    std::atomic<uint64_t> m_leaders{0};     // Count of reads sent to the network.
+    std::atomic<uint64_t> m_hits{0};        // Count of reads attached to an in-flight read.
+    std::atomic<uint64_t> m_bytes_saved{0}; // Bytes copied to followers instead of transferred.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_READCOALESCER_HH
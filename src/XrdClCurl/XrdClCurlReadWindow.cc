@@ -0,0 +1,406 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlReadWindow.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <thread>
+
+using namespace XrdClCurl;
+
+std::atomic<int64_t> ReadWindow::m_window_us{0};
+std::atomic<uint32_t> ReadWindow::m_max_gap{64 * 1024};
+std::atomic<uint64_t> ReadWindow::m_reads_held{0};
+std::atomic<uint64_t> ReadWindow::m_reads_direct{0};
+std::atomic<uint64_t> ReadWindow::m_requests{0};
+std::atomic<uint64_t> ReadWindow::m_reads_merged{0};
+std::atomic<uint64_t> ReadWindow::m_gap_bytes{0};
+
+namespace {
+
+// Windows the calling thread is currently flushing; a handler invoked during a
+// flush may shut down the window it was invoked from.
+thread_local std::vector<const ReadWindow *> g_flushing;
+
+}
+
+// Handler of a merged read; copies each read's bytes out of the shared buffer.
+class ReadWindow::ScatterHandler : public XrdCl::ResponseHandler {
+public:
+    ScatterHandler(std::shared_ptr<ReadWindow> window, uint64_t size, const PendingRead *reads, size_t count)
+        : m_window(std::move(window)), m_buffer(new char[size]), m_reads(reads, reads + count)
+    {}
+
+    char *GetBuffer() {return m_buffer.get();}
+
+    void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) override;
+
+private:
+    std::shared_ptr<ReadWindow> m_window;
+    std::unique_ptr<char[]> m_buffer;
+    std::vector<PendingRead> m_reads;
+};
+
+// Handler of a read sent on its own; notes its completion in the window.
+class ReadWindow::TrackingHandler : public XrdCl::ResponseHandler {
+public:
+    TrackingHandler(std::shared_ptr<ReadWindow> window, XrdCl::ResponseHandler *handler)
+        : m_window(std::move(window)), m_handler(handler)
+    {}
+
+    void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) override {
+        std::unique_ptr<TrackingHandler> owner(this);
+        m_window->ReadsDone(1);
+        m_handler->HandleResponse(status, response);
+    }
+
+private:
+    std::shared_ptr<ReadWindow> m_window;
+    XrdCl::ResponseHandler *m_handler;
+};
+
+void
+ReadWindow::ScatterHandler::HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw)
+{
+    std::unique_ptr<ScatterHandler> owner(this);
+    std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+    std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+    m_window->ReadsDone(m_reads.size());
+
+    XrdCl::ChunkInfo *chunk = nullptr;
+    if (status && status->IsOK() && response) {
+        response->Get(chunk);
+    }
+    for (const auto &read : m_reads) {
+        if (!chunk || !chunk->buffer) {
+            XrdCl::XRootDStatus read_status(XrdCl::stError, XrdCl::errDataError, 0, "Merged read completed without data");
+            if (status && !status->IsOK()) {
+                read_status = *status;
+            }
+            read.m_handler->HandleResponse(new XrdCl::XRootDStatus(read_status), nullptr);
+            continue;
+        }
+        // The merged read may have returned fewer bytes than requested (end of file).
+        uint32_t length = 0;
+        auto start = read.m_offset - chunk->offset;
+        if (read.m_offset >= chunk->offset && start < chunk->length) {
+            length = std::min<uint64_t>(read.m_size, chunk->length - start);
+            memcpy(read.m_buffer, static_cast<char *>(chunk->buffer) + start, length);
+        }
+        auto obj = new XrdCl::AnyObject();
+        obj->Set(new XrdCl::ChunkInfo(read.m_offset, length, read.m_buffer));
+        read.m_handler->HandleResponse(new XrdCl::XRootDStatus(*status), obj);
+    }
+}
+
+// A single background thread flushing windows as their deadlines pass.
+class ReadWindow::Timer {
+public:
+    static Timer &Instance() {
+        // Intentionally leaked; windows may be flushed from other library destructors.
+        static Timer *instance = new Timer();
+        return *instance;
+    }
+
+    // Flush `window`, if it still exists, at `when`.
+    void Add(Clock::time_point when, std::weak_ptr<ReadWindow> window);
+
+private:
+    Timer() = default;
+
+    void Run();
+
+    // Invoked when the library is unloaded; stops the timer thread.
+    static void Shutdown() __attribute__((destructor));
+
+    // Longest time unloading waits on the timer thread; a flush may be blocked
+    // starting a read (e.g., on a full queue).
+    static constexpr std::chrono::seconds m_shutdown_wait{2};
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::multimap<Clock::time_point, std::weak_ptr<ReadWindow>> m_deadlines;
+    bool m_shutdown{false};
+    bool m_running{false}; // Set while the timer thread is running.
+    std::thread m_thread;
+};
+
+void
+ReadWindow::Timer::Add(Clock::time_point when, std::weak_ptr<ReadWindow> window)
+{
+    std::unique_lock lock(m_mutex);
+    if (m_shutdown) {
+        return;
+    }
+    auto earliest = m_deadlines.empty() || when < m_deadlines.begin()->first;
+    m_deadlines.emplace(when, std::move(window));
+    if (!m_thread.joinable()) {
+        m_running = true;
+        m_thread = std::thread([this]{Run();});
+    }
+    lock.unlock();
+    if (earliest) {
+        m_cv.notify_one();
+    }
+}
+
+void
+ReadWindow::Timer::Run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_shutdown) {
+        if (m_deadlines.empty()) {
+            m_cv.wait(lock, [&]{return m_shutdown || !m_deadlines.empty();});
+            continue;
+        }
+        auto next = m_deadlines.begin()->first;
+        if (Clock::now() < next) {
+            m_cv.wait_until(lock, next);
+            continue;
+        }
+        auto window = m_deadlines.begin()->second.lock();
+        m_deadlines.erase(m_deadlines.begin());
+        lock.unlock();
+
+        if (window) {
+            window->Flush();
+            // Drop the reference outside the lock; it may be the last one.
+            window.reset();
+        }
+
+        lock.lock();
+    }
+    m_running = false;
+    lock.unlock();
+    m_cv.notify_all();
+}
+
+void
+ReadWindow::Timer::Shutdown()
+{
+    auto &me = Instance();
+    std::unique_lock lock(me.m_mutex);
+    me.m_shutdown = true;
+    lock.unlock();
+    me.m_cv.notify_all();
+    if (!me.m_thread.joinable()) {
+        return;
+    }
+    lock.lock();
+    if (me.m_thread.get_id() == std::this_thread::get_id() ||
+        !me.m_cv.wait_for(lock, m_shutdown_wait, [&]{return !me.m_running;}))
+    {
+        // The timer is never destroyed, so the thread may safely finish on its own.
+        me.m_thread.detach();
+        return;
+    }
+    lock.unlock();
+    me.m_thread.join();
+}
+
+bool
+ReadWindow::Submit(uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler, time_t timeout)
+{
+    if (!handler || size >= m_max_read_size) {
+        return false;
+    }
+    auto window = GetWindow();
+    if (window.count() <= 0) {
+        return false;
+    }
+
+    std::vector<PendingRead> reads;
+    bool first, direct;
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_shutdown) {
+            return false;
+        }
+        first = m_pending.empty();
+        direct = first && !m_in_flight;
+        if (direct) {
+            // Nothing to merge with (e.g., a synchronous read); don't add latency.
+            m_in_flight++;
+            reads.push_back({offset, size, static_cast<char *>(buffer), handler, timeout});
+            m_flushing++;
+            g_flushing.push_back(this);
+        } else {
+            m_pending.push_back({offset, size, static_cast<char *>(buffer), handler, timeout});
+            m_pending_bytes += size;
+            // A full window is sent without waiting for its deadline.
+            if (m_pending.size() >= m_max_pending || m_pending_bytes >= m_max_request_size) {
+                reads.swap(m_pending);
+                m_pending_bytes = 0;
+                m_in_flight += reads.size();
+                m_flushing++;
+                g_flushing.push_back(this);
+            }
+        }
+    }
+    (direct ? m_reads_direct : m_reads_held).fetch_add(1, std::memory_order_relaxed);
+
+    if (!reads.empty()) {
+        Issue(reads);
+        EndFlush();
+    } else if (first) {
+        Timer::Instance().Add(Clock::now() + window, weak_from_this());
+    }
+    return true;
+}
+
+void
+ReadWindow::Flush()
+{
+    std::vector<PendingRead> reads;
+    {
+        std::unique_lock lock(m_mutex);
+        if (m_pending.empty()) {
+            return;
+        }
+        reads.swap(m_pending);
+        m_pending_bytes = 0;
+        m_in_flight += reads.size();
+        m_flushing++;
+        g_flushing.push_back(this);
+    }
+    Issue(reads);
+    EndFlush();
+}
+
+void
+ReadWindow::Shutdown()
+{
+    std::vector<PendingRead> reads;
+    {
+        std::unique_lock lock(m_mutex);
+        m_shutdown = true;
+        reads.swap(m_pending);
+        m_pending_bytes = 0;
+        // Wait for flushes on other threads; those further up this thread's stack can't finish first.
+        unsigned own = std::count(g_flushing.begin(), g_flushing.end(), this);
+        m_cv.wait(lock, [&]{return m_flushing == own;});
+        if (reads.empty()) {
+            return;
+        }
+        m_in_flight += reads.size();
+        m_flushing++;
+        g_flushing.push_back(this);
+    }
+    Issue(reads);
+    EndFlush();
+}
+
+void
+ReadWindow::EndFlush()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_flushing--;
+        auto iter = std::find(g_flushing.rbegin(), g_flushing.rend(), this);
+        if (iter != g_flushing.rend()) {
+            g_flushing.erase(std::next(iter).base());
+        }
+    }
+    m_cv.notify_all();
+}
+
+void
+ReadWindow::ReadsDone(size_t count)
+{
+    std::unique_lock lock(m_mutex);
+    m_in_flight -= std::min(count, m_in_flight);
+}
+
+void
+ReadWindow::Issue(std::vector<PendingRead> &reads)
+{
+    std::stable_sort(reads.begin(), reads.end(), [](const PendingRead &left, const PendingRead &right) {
+        return left.m_offset < right.m_offset;
+    });
+
+    auto max_gap = GetMaxGap();
+    size_t begin = 0;
+    uint64_t end = reads[0].m_offset + reads[0].m_size;
+    for (size_t idx = 1; idx < reads.size(); idx++) {
+        const auto &read = reads[idx];
+        auto read_end = read.m_offset + read.m_size;
+        if (read.m_offset <= end + max_gap && std::max(end, read_end) - reads[begin].m_offset <= m_max_request_size) {
+            end = std::max(end, read_end);
+            continue;
+        }
+        IssueRequest(&reads[begin], idx - begin);
+        begin = idx;
+        end = read_end;
+    }
+    IssueRequest(&reads[begin], reads.size() - begin);
+}
+
+void
+ReadWindow::IssueRequest(const PendingRead *reads, size_t count)
+{
+    m_requests.fetch_add(1, std::memory_order_relaxed);
+    if (count == 1) {
+        auto tracking = new TrackingHandler(shared_from_this(), reads[0].m_handler);
+        auto st = m_issue(reads[0].m_offset, reads[0].m_size, reads[0].m_buffer, tracking, reads[0].m_timeout);
+        if (!st.IsOK()) {
+            tracking->HandleResponse(new XrdCl::XRootDStatus(st), nullptr);
+        }
+        return;
+    }
+
+    // Use the shortest timeout requested; zero means the default.
+    auto offset = reads[0].m_offset;
+    uint64_t end = offset;
+    uint64_t gap_bytes = 0;
+    time_t timeout = 0;
+    for (size_t idx = 0; idx < count; idx++) {
+        const auto &read = reads[idx];
+        if (read.m_offset > end) {
+            gap_bytes += read.m_offset - end;
+        }
+        end = std::max(end, read.m_offset + read.m_size);
+        if (read.m_timeout && (!timeout || read.m_timeout < timeout)) {
+            timeout = read.m_timeout;
+        }
+    }
+    m_reads_merged.fetch_add(count, std::memory_order_relaxed);
+    m_gap_bytes.fetch_add(gap_bytes, std::memory_order_relaxed);
+
+    auto scatter = new ScatterHandler(shared_from_this(), end - offset, reads, count);
+    auto st = m_issue(offset, end - offset, scatter->GetBuffer(), scatter, timeout);
+    if (!st.IsOK()) {
+        scatter->HandleResponse(new XrdCl::XRootDStatus(st), nullptr);
+    }
+}
+
+std::string
+ReadWindow::GetMonitoringJson()
+{
+    return "{"
+        "\"window_us\":" + std::to_string(m_window_us.load(std::memory_order_relaxed)) + ","
+        "\"reads_held\":" + std::to_string(m_reads_held.load(std::memory_order_relaxed)) + ","
+        "\"reads_direct\":" + std::to_string(m_reads_direct.load(std::memory_order_relaxed)) + ","
+        "\"requests\":" + std::to_string(m_requests.load(std::memory_order_relaxed)) + ","
+        "\"reads_merged\":" + std::to_string(m_reads_merged.load(std::memory_order_relaxed)) + ","
+        "\"gap_bytes\":" + std::to_string(m_gap_bytes.load(std::memory_order_relaxed)) +
+        "}";
+}
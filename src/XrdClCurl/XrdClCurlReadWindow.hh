@@ -0,0 +1,145 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_READWINDOW_HH
+#define XRDCLCURL_READWINDOW_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace XrdCl {
+    class ResponseHandler;
+    class XRootDStatus;
+}
+
+namespace XrdClCurl {
+
+// Merges small reads issued close together on the same file handle.
+//
+// Applications reading many small, nearby ranges asynchronously (for example,
+// ROOT basket reads) would otherwise send one GET per read.  When a window is
+// configured, a small read issued while another read on the handle is held or
+// in flight is held for up to the window's duration; the reads
+// collected in that time are sorted and those separated by no more than the
+// gap threshold are sent as a single ranged GET.  When it completes, each
+// read's bytes are copied to its buffer and its handler is invoked.  A read
+// with nothing to merge with (such as a synchronous read) is issued immediately.
+//
+// Errors starting the merged read are reported through the reads' handlers
+// rather than returned from the original call.
+class ReadWindow : public std::enable_shared_from_this<ReadWindow> {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Starts a read of `size` bytes at `offset` into `buffer`, as File::Read would.
+    using IssueFunc = std::function<XrdCl::XRootDStatus(uint64_t offset, uint32_t size, char *buffer, XrdCl::ResponseHandler *handler, time_t timeout)>;
+
+    ReadWindow(IssueFunc issue) : m_issue(std::move(issue)) {}
+
+    // Set the time a read may be held waiting for neighbors; zero disables the window.
+    static void SetWindow(std::chrono::microseconds window) {m_window_us.store(window.count(), std::memory_order_relaxed);}
+    static std::chrono::microseconds GetWindow() {return std::chrono::microseconds(m_window_us.load(std::memory_order_relaxed));}
+
+    // Set the largest gap, in bytes, between two reads merged into one request.
+    static void SetMaxGap(uint32_t gap) {m_max_gap.store(gap, std::memory_order_relaxed);}
+    static uint32_t GetMaxGap() {return m_max_gap.load(std::memory_order_relaxed);}
+
+    // Submit a read to the window.
+    //
+    // Returns false if the read should be issued directly (the window is disabled,
+    // the read is too large, or the window was shut down); otherwise, `handler`
+    // is invoked once the read completes.  The read is only held if another read
+    // submitted to the window is pending or in flight.
+    bool Submit(uint64_t offset, uint32_t size, void *buffer, XrdCl::ResponseHandler *handler, time_t timeout);
+
+    // Issue any reads held in the window immediately.
+    void Flush();
+
+    // Flush the window and stop accepting reads.  Once this returns, the issue
+    // function is no longer invoked.
+    void Shutdown();
+
+    // Returns the merge statistics as a JSON object.
+    static std::string GetMonitoringJson();
+
+    // Reads at least this large are never held.
+    static constexpr uint32_t m_max_read_size{256 * 1024};
+    // Largest request created by merging reads.
+    static constexpr uint64_t m_max_request_size{8 * 1024 * 1024};
+    // Number of held reads at which the window is flushed early.
+    static constexpr size_t m_max_pending{64};
+
+private:
+    class ScatterHandler;
+    class Timer;
+    class TrackingHandler;
+
+    struct PendingRead {
+        uint64_t m_offset;
+        uint32_t m_size;
+        char *m_buffer;
+        XrdCl::ResponseHandler *m_handler;
+        time_t m_timeout;
+    };
+
+    // Merge and start the given reads; m_mutex must not be held.
+    void Issue(std::vector<PendingRead> &reads);
+
+    // Start a single request covering `reads`, which are sorted by offset.
+    void IssueRequest(const PendingRead *reads, size_t count);
+
+    // Mark the end of a flush started by the calling thread.
+    void EndFlush();
+
+    // Record the completion of `count` reads started by the window.
+    void ReadsDone(size_t count);
+
+    const IssueFunc m_issue;
+
+    std::mutex m_mutex;
+    // Signaled when a flush in progress finishes.
+    std::condition_variable m_cv;
+    std::vector<PendingRead> m_pending;
+    uint64_t m_pending_bytes{0};
+    // Number of reads started by the window that have not completed.
+    size_t m_in_flight{0};
+    // Number of flushes currently invoking the issue function.
+    unsigned m_flushing{0};
+    bool m_shutdown{false};
+
+    static std::atomic<int64_t> m_window_us;
+    static std::atomic<uint32_t> m_max_gap;
+
+    static std::atomic<uint64_t> m_reads_held;   // Count of reads held in a window.
+    static std::atomic<uint64_t> m_reads_direct; // Count of reads issued immediately as nothing else was outstanding.
+    static std::atomic<uint64_t> m_requests;     // Count of requests issued for held reads.
+    static std::atomic<uint64_t> m_reads_merged; // Count of reads served by a request shared with another read.
+    static std::atomic<uint64_t> m_gap_bytes;    // Bytes transferred between merged reads but not requested.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_READWINDOW_HH
@@ -0,0 +1,273 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlOptionsCache.hh"
+#include "XrdClCurlSocketTuning.hh"
+#include "XrdClCurlUtil.hh"
+
+#include <XrdCl/XrdClLog.hh>
+
+#include <curl/curl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Round up to the next power of two (for values >= 1).
+uint64_t RoundUpPow2(uint64_t val) {
+    uint64_t result = 1;
+    while (result < val) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}
+
+SocketTuning &
+SocketTuning::Instance()
+{
+    static SocketTuning instance;
+    return instance;
+}
+
+void
+SocketTuning::Configure(bool enabled, int min_socket_buffer, int max_socket_buffer, const std::string &congestion)
+{
+    std::unique_lock lock(m_mutex);
+    m_enabled = enabled;
+    m_min_socket_buffer = min_socket_buffer;
+    m_max_socket_buffer = std::max(min_socket_buffer, max_socket_buffer);
+    m_congestion = congestion;
+    m_entries.clear();
+}
+
+long
+SocketTuning::GetMaxCurlBuffer()
+{
+#ifdef CURL_MAX_READ_SIZE
+    return CURL_MAX_READ_SIZE;
+#else
+    // Prior to libcurl 7.53.0, the receive buffer was capped at 512KB.
+    return 512 * 1024;
+#endif
+}
+
+SocketTuning::Params
+SocketTuning::ComputeParams(double rtt, double rate, int min_socket_buffer, int max_socket_buffer)
+{
+    Params params;
+    if (rtt <= 0 || rate <= 0) {
+        return params;
+    }
+    auto bdp = rtt * rate;
+
+    // Give the socket buffers 2x headroom over the BDP.  As the transfer rate
+    // of a window-limited stream is roughly window / RTT, this allows the
+    // window to grow on each subsequent measurement until the path, not the
+    // buffer, becomes the limit.
+    auto socket_target = 2.0 * bdp;
+    if (socket_target >= static_cast<double>(min_socket_buffer)) {
+        auto socket_buffer = std::min(RoundUpPow2(static_cast<uint64_t>(socket_target)), static_cast<uint64_t>(max_socket_buffer));
+        params.m_socket_buffer = static_cast<int>(socket_buffer);
+    }
+
+    // The curl buffer determines the granularity of the write callbacks; size it
+    // to a fraction of the BDP so each callback moves a meaningful amount of data
+    // without holding more than a sliver of the window in userspace.
+    auto curl_target = RoundUpPow2(static_cast<uint64_t>(bdp / 16));
+    params.m_curl_buffer = static_cast<long>(std::clamp<uint64_t>(curl_target, m_default_curl_buffer, GetMaxCurlBuffer()));
+
+    return params;
+}
+
+SocketTuning::Params
+SocketTuning::Get(const std::string &url, std::chrono::steady_clock::time_point now) const
+{
+    if (!m_enabled) {
+        return Params{};
+    }
+    std::string modified_url;
+    auto key = VerbsCache::GetUrlKey(url, modified_url);
+
+    std::shared_lock lock(m_mutex);
+    auto iter = m_entries.find(key);
+    if (iter == m_entries.end() || now - iter->second.m_last_update > m_entry_lifetime) {
+        return Params{};
+    }
+    return iter->second.m_params;
+}
+
+void
+SocketTuning::RecordTransfer(CURL *curl)
+{
+    if (!m_enabled || !curl) {
+        return;
+    }
+
+    char *url = nullptr;
+    if (curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &url) != CURLE_OK || !url) {
+        return;
+    }
+    double lookup_time = 0, connect_time = 0, pretransfer_time = 0, start_time = 0, total_time = 0;
+    curl_off_t download_size = 0, upload_size = 0;
+    long num_connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME, &lookup_time);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connect_time);
+    curl_easy_getinfo(curl, CURLINFO_PRETRANSFER_TIME, &pretransfer_time);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &start_time);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &total_time);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &download_size);
+    curl_easy_getinfo(curl, CURLINFO_SIZE_UPLOAD_T, &upload_size);
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &num_connects);
+
+    // The TCP handshake takes one round trip; this is only meaningful if the
+    // transfer opened a new connection.
+    double rtt = (num_connects > 0 && connect_time > lookup_time) ? connect_time - lookup_time : -1;
+
+    bool is_upload = upload_size > download_size;
+    uint64_t bytes = static_cast<uint64_t>(is_upload ? upload_size : download_size);
+    double xfer_time = total_time - (is_upload ? pretransfer_time : start_time);
+
+    std::string url_str(url);
+    std::string modified_url;
+    auto key = VerbsCache::GetUrlKey(url_str, modified_url);
+    if (key.empty()) {
+        return;
+    }
+    Update(key, rtt, bytes, xfer_time);
+}
+
+void
+SocketTuning::Update(const std::string_view &key, double rtt, uint64_t bytes, double xfer_time,
+    std::chrono::steady_clock::time_point now)
+{
+    bool has_rate = bytes >= m_min_sample_bytes && xfer_time > 0;
+    if (rtt <= 0 && !has_rate) {
+        return;
+    }
+    m_samples.fetch_add(1, std::memory_order_relaxed);
+
+    std::unique_lock lock(m_mutex);
+    auto iter = m_entries.find(key);
+    if (iter == m_entries.end()) {
+        if (m_entries.size() >= m_max_entries) {
+            auto oldest = m_entries.end();
+            for (auto it = m_entries.begin(); it != m_entries.end();) {
+                if (now - it->second.m_last_update > m_entry_lifetime) {
+                    it = m_entries.erase(it);
+                } else {
+                    if (oldest == m_entries.end() || it->second.m_last_update < oldest->second.m_last_update) {
+                        oldest = it;
+                    }
+                    ++it;
+                }
+            }
+            // Erasing other elements leaves `oldest` valid.
+            if (m_entries.size() >= m_max_entries && oldest != m_entries.end()) {
+                m_entries.erase(oldest);
+            }
+        }
+        iter = m_entries.emplace(std::string(key), Entry{}).first;
+    }
+    auto &entry = iter->second;
+    if (rtt > 0) {
+        entry.m_rtt = entry.m_rtt < 0 ? rtt : (1.0 - m_rtt_alpha) * entry.m_rtt + m_rtt_alpha * rtt;
+    }
+    if (has_rate) {
+        auto rate = static_cast<double>(bytes) / xfer_time;
+        entry.m_rate = entry.m_rate < 0 ? rate : (1.0 - m_rate_alpha) * entry.m_rate + m_rate_alpha * rate;
+    }
+    entry.m_last_update = now;
+    entry.m_params = ComputeParams(entry.m_rtt, entry.m_rate, m_min_socket_buffer, m_max_socket_buffer);
+}
+
+bool
+SocketTuning::ApplySocketOptions(int fd, int socket_buffer, XrdCl::Log *log)
+{
+    bool success = true;
+    if (socket_buffer > 0) {
+        if (setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &socket_buffer, sizeof(socket_buffer)) == -1 ||
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &socket_buffer, sizeof(socket_buffer)) == -1)
+        {
+            if (log) log->Debug(kLogXrdClCurl, "Failed to set socket buffer size to %d: %s", socket_buffer, strerror(errno));
+            m_sockopt_errors.fetch_add(1, std::memory_order_relaxed);
+            success = false;
+        } else {
+            m_sockets_tuned.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (!m_congestion.empty()) {
+#ifdef TCP_CONGESTION
+        if (setsockopt(fd, IPPROTO_TCP, TCP_CONGESTION, m_congestion.c_str(), m_congestion.size()) == -1) {
+            // Typically the algorithm's module isn't loaded or isn't in net.ipv4.tcp_allowed_congestion_control;
+            // only warn once to avoid flooding the logs.
+            if (log && !m_congestion_warned.exchange(true, std::memory_order_relaxed)) {
+                log->Warning(kLogXrdClCurl, "Failed to set TCP congestion control algorithm to %s: %s", m_congestion.c_str(), strerror(errno));
+            }
+            m_congestion_errors.fetch_add(1, std::memory_order_relaxed);
+            success = false;
+        } else {
+            m_congestion_set.fetch_add(1, std::memory_order_relaxed);
+        }
+#else
+        if (log && !m_congestion_warned.exchange(true, std::memory_order_relaxed)) {
+            log->Warning(kLogXrdClCurl, "TCP congestion control selection is not supported on this platform");
+        }
+        m_congestion_errors.fetch_add(1, std::memory_order_relaxed);
+        success = false;
+#endif
+    }
+    return success;
+}
+
+std::string
+SocketTuning::GetMonitoringJson() const
+{
+    std::string retval = "{"
+        "\"enabled\":" + std::string(m_enabled ? "true" : "false") + ","
+        "\"congestion\":\"" + m_congestion + "\","
+        "\"samples\":" + std::to_string(m_samples.load(std::memory_order_relaxed)) + ","
+        "\"sockets_tuned\":" + std::to_string(m_sockets_tuned.load(std::memory_order_relaxed)) + ","
+        "\"sockopt_errors\":" + std::to_string(m_sockopt_errors.load(std::memory_order_relaxed)) + ","
+        "\"congestion_set\":" + std::to_string(m_congestion_set.load(std::memory_order_relaxed)) + ","
+        "\"congestion_errors\":" + std::to_string(m_congestion_errors.load(std::memory_order_relaxed)) + ","
+        "\"endpoints\":{";
+
+    std::shared_lock lock(m_mutex);
+    bool first = true;
+    for (const auto &entry : m_entries) {
+        if (!first) retval += ",";
+        first = false;
+        retval += "\"" + entry.first + "\":{"
+            "\"rtt\":" + std::to_string(entry.second.m_rtt) + ","
+            "\"rate\":" + std::to_string(entry.second.m_rate) + ","
+            "\"curl_buffer\":" + std::to_string(entry.second.m_params.m_curl_buffer) + ","
+            "\"socket_buffer\":" + std::to_string(entry.second.m_params.m_socket_buffer) +
+            "}";
+    }
+    retval += "}}";
+    return retval;
+}
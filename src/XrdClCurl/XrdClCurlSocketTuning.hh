@@ -0,0 +1,169 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_SOCKETTUNING_HH
+#define XRDCLCURL_SOCKETTUNING_HH
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+typedef void CURL;
+
+namespace XrdCl {
+    class Log;
+}
+
+namespace XrdClCurl {
+
+// Per-endpoint tuning of the libcurl receive buffer and the kernel socket
+// buffers.
+//
+// Each completed transfer contributes a round-trip time sample (the TCP
+// connect time of any new connection) and a throughput sample to a per-endpoint
+// exponential moving average.  From these, we estimate the bandwidth-delay
+// product (BDP) of the path and size the buffers so a single stream can
+// keep the pipe full on high-latency, high-bandwidth links.
+//
+// Until an endpoint has been measured, the defaults are used: a 32KB curl
+// buffer and kernel socket buffer autotuning.  Setting SO_RCVBUF / SO_SNDBUF
+// disables Linux's autotuning so we only do it once the estimated BDP exceeds
+// the configured floor.
+class SocketTuning {
+public:
+    // The tuned parameters for a given endpoint.
+    struct Params {
+        long m_curl_buffer{m_default_curl_buffer}; // Value for CURLOPT_BUFFERSIZE
+        int m_socket_buffer{0}; // Value for SO_RCVBUF / SO_SNDBUF; 0 means leave the kernel default.
+    };
+
+    // Return the global instance of the tuning table.
+    static SocketTuning &Instance();
+
+    // Configure the tuning behavior.
+    // - `enabled`: If false, `Get` always returns the defaults.
+    // - `min_socket_buffer`: The smallest socket buffer we will explicitly set; below
+    //   this, kernel autotuning is assumed to be sufficient.
+    // - `max_socket_buffer`: The largest socket buffer we will request (the kernel
+    //   additionally clamps to net.core.rmem_max / wmem_max).
+    // - `congestion`: If non-empty, the TCP congestion control algorithm (e.g., "bbr")
+    //   to select via TCP_CONGESTION on platforms that support it.
+    void Configure(bool enabled, int min_socket_buffer, int max_socket_buffer, const std::string &congestion);
+
+    // Returns the tuned parameters for the endpoint serving `url`; an endpoint not
+    // measured within the entry lifetime gets the defaults.
+    Params Get(const std::string &url, std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now()) const;
+
+    // Record the timing information of a completed transfer from the curl handle.
+    void RecordTransfer(CURL *curl);
+
+    // Record a single sample for the endpoint key (scheme://host:port).
+    // - `rtt`: Round-trip time estimate, in seconds; negative if unavailable.
+    // - `bytes`: Number of body bytes moved.
+    // - `xfer_time`: Duration of the body transfer, in seconds.
+    void Update(const std::string_view &key, double rtt, uint64_t bytes, double xfer_time,
+        std::chrono::steady_clock::time_point now=std::chrono::steady_clock::now());
+
+    // Apply the socket-level tuning to a newly-created socket.
+    //
+    // Returns false if any of the requested options failed; failures are not fatal
+    // to the transfer.
+    bool ApplySocketOptions(int fd, int socket_buffer, XrdCl::Log *log);
+
+    // Compute the tuned parameters given an RTT (seconds) and throughput (bytes/sec).
+    static Params ComputeParams(double rtt, double rate, int min_socket_buffer, int max_socket_buffer);
+
+    // Returns the largest buffer size libcurl will accept for CURLOPT_BUFFERSIZE.
+    static long GetMaxCurlBuffer();
+
+    // Returns the congestion control algorithm configured (empty if unset).
+    const std::string &GetCongestionControl() const {return m_congestion;}
+
+    // Returns true if socket tuning is enabled.
+    bool IsEnabled() const {return m_enabled;}
+
+    // Returns the tuning statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+    // Default values of the configuration knobs
+    static constexpr long m_default_curl_buffer{32 * 1024};
+    static constexpr int m_default_min_socket_buffer{4 * 1024 * 1024};
+    static constexpr int m_default_max_socket_buffer{64 * 1024 * 1024};
+
+    // Maximum number of endpoints tracked; beyond this, stale entries are pruned
+    // and then the least recently updated one is evicted before a new one is added.
+    static constexpr size_t m_max_entries{1024};
+
+private:
+    SocketTuning() = default;
+    SocketTuning(const SocketTuning &) = delete;
+
+    // Entries not updated in this long are eligible for pruning.
+    static constexpr std::chrono::steady_clock::duration m_entry_lifetime{std::chrono::hours(1)};
+
+    // Smoothing factors for the RTT and throughput moving averages.
+    static constexpr double m_rtt_alpha{0.25};
+    static constexpr double m_rate_alpha{0.3};
+
+    // Transfers smaller than this are dominated by latency and do not
+    // contribute a throughput sample.
+    static constexpr uint64_t m_min_sample_bytes{1024 * 1024};
+
+    struct Entry {
+        double m_rtt{-1}; // EMA of the round-trip time, in seconds
+        double m_rate{-1}; // EMA of the transfer rate, in bytes / sec
+        Params m_params;
+        std::chrono::steady_clock::time_point m_last_update;
+    };
+
+    template<typename ... Bases>
+    struct overload : Bases ...
+    {
+        using is_transparent = void;
+        using Bases::operator() ... ;
+    };
+    using transparent_string_hash = overload<
+        std::hash<std::string>,
+        std::hash<std::string_view>
+    >;
+
+    bool m_enabled{true};
+    int m_min_socket_buffer{m_default_min_socket_buffer};
+    int m_max_socket_buffer{m_default_max_socket_buffer};
+    std::string m_congestion;
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string, Entry, transparent_string_hash, std::equal_to<>> m_entries;
+
+    // Statistics for the monitoring output.
+    std::atomic<uint64_t> m_samples{0}; // Count of transfers recorded.
+    std::atomic<uint64_t> m_sockets_tuned{0}; // Count of sockets with explicit buffer sizes.
+    std::atomic<uint64_t> m_sockopt_errors{0}; // Count of failed socket buffer setsockopt calls.
+    std::atomic<uint64_t> m_congestion_set{0}; // Count of sockets where the congestion control was set.
+    std::atomic<uint64_t> m_congestion_errors{0}; // Count of failures setting the congestion control.
+    std::atomic<bool> m_congestion_warned{false}; // Set after the first congestion control warning is logged.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_SOCKETTUNING_HH
@@ -0,0 +1,207 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_TIMERWHEEL_HH
+#define XRDCLCURL_TIMERWHEEL_HH
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace XrdClCurl {
+
+// A hierarchical timer wheel mapping keys to deadlines.
+//
+// Time is divided into ticks of a fixed resolution.  The wheel has
+// `m_levels` levels of `m_slots` slots each; level 0 covers the next
+// `m_slots` ticks at single-tick granularity, level 1 the next
+// `m_slots^2` ticks at `m_slots`-tick granularity, and so on.  As time
+// advances, timers in the higher levels are cascaded down into the lower
+// levels, so scheduling, rescheduling, and cancelling a timer are all O(1)
+// and a timer is only touched once per level on its way to expiring.
+//
+// Deadlines are rounded up to the next tick, meaning a timer never fires
+// before its deadline and fires at most one tick (plus the caller's polling
+// interval) late.  Each key has at most one timer; scheduling an existing key
+// replaces its deadline.
+//
+// The wheel is not thread-safe; callers must provide their own locking.
+template<typename Key, typename Hash = std::hash<Key>>
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TimerWheel(Clock::duration resolution = std::chrono::milliseconds(10), Clock::time_point now = Clock::now()) :
+        m_resolution(resolution > Clock::duration::zero() ? resolution : Clock::duration(1)),
+        m_origin(now)
+    {}
+
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+
+    // Schedule `key` to expire at `deadline`, replacing any existing timer for the key.
+    //
+    // Deadlines in the past are returned by the next call to `Advance`.
+    void Schedule(const Key &key, Clock::time_point deadline) {
+        auto tick = ToTick(deadline);
+        auto iter = m_index.find(key);
+        if (iter == m_index.end()) {
+            auto &list = SlotFor(tick);
+            list.push_back({key, tick});
+            m_index.emplace(key, Location{&list, std::prev(list.end())});
+        } else {
+            auto &loc = iter->second;
+            loc.m_entry->m_tick = tick;
+            auto &list = SlotFor(tick);
+            list.splice(list.end(), *loc.m_list, loc.m_entry);
+            loc.m_list = &list;
+        }
+    }
+
+    // Cancel the timer for `key`; returns false if no timer was scheduled.
+    bool Cancel(const Key &key) {
+        auto iter = m_index.find(key);
+        if (iter == m_index.end()) {
+            return false;
+        }
+        iter->second.m_list->erase(iter->second.m_entry);
+        m_index.erase(iter);
+        return true;
+    }
+
+    // Returns true if a timer is scheduled for `key`.
+    bool Contains(const Key &key) const {return m_index.find(key) != m_index.end();}
+
+    // Advance the wheel to `now`, appending the keys of all expired timers to `expired`.
+    //
+    // Expired timers are removed from the wheel prior to being returned.
+    void Advance(Clock::time_point now, std::vector<Key> &expired) {
+        // Note the current tick has not fully elapsed until `now` is past its end.
+        auto now_tick = now < m_origin ? 0 : static_cast<uint64_t>((now - m_origin) / m_resolution);
+        if (m_index.empty()) {
+            m_current = std::max(m_current, now_tick);
+            return;
+        }
+        while (m_current < now_tick) {
+            m_current++;
+            // Cascade timers from the higher levels whose range now starts at the
+            // current tick down into the lower levels.
+            for (unsigned level = 1; level < m_levels; level++) {
+                auto shift = m_bits * level;
+                if (m_current & ((uint64_t(1) << shift) - 1)) {
+                    break;
+                }
+                auto &list = m_wheel[level][(m_current >> shift) & m_mask];
+                while (!list.empty()) {
+                    auto entry = list.begin();
+                    auto &dest = SlotFor(entry->m_tick);
+                    dest.splice(dest.end(), list, entry);
+                    m_index.find(entry->m_key)->second.m_list = &dest;
+                }
+            }
+            Expire(m_wheel[0][m_current & m_mask], expired);
+            if (m_index.empty()) {
+                m_current = now_tick;
+                break;
+            }
+        }
+        Expire(m_due, expired);
+    }
+
+    // Returns the number of scheduled timers.
+    size_t Size() const {return m_index.size();}
+
+    // Returns true if no timers are scheduled.
+    bool Empty() const {return m_index.empty();}
+
+    // Returns the tick resolution of the wheel.
+    Clock::duration GetResolution() const {return m_resolution;}
+
+private:
+    static constexpr unsigned m_bits{6};
+    static constexpr unsigned m_levels{4};
+    static constexpr uint64_t m_slots{uint64_t(1) << m_bits};
+    static constexpr uint64_t m_mask{m_slots - 1};
+    // Largest number of ticks into the future the wheel can represent; later
+    // timers are parked in the last slot of the top level and re-cascaded.
+    static constexpr uint64_t m_max_delta{(uint64_t(1) << (m_bits * m_levels)) - 1};
+
+    struct Entry {
+        Key m_key;
+        uint64_t m_tick;
+    };
+    using EntryList = std::list<Entry>;
+
+    struct Location {
+        EntryList *m_list;
+        typename EntryList::iterator m_entry;
+    };
+
+    // Convert a deadline into a tick, rounding up so timers never fire early.
+    uint64_t ToTick(Clock::time_point deadline) const {
+        if (deadline <= m_origin) {
+            return 0;
+        }
+        auto elapsed = deadline - m_origin;
+        auto ticks = elapsed / m_resolution;
+        if (elapsed % m_resolution != Clock::duration::zero()) {
+            ticks++;
+        }
+        return static_cast<uint64_t>(ticks);
+    }
+
+    // Returns the list that should hold a timer expiring at `tick`.
+    EntryList &SlotFor(uint64_t tick) {
+        if (tick <= m_current) {
+            return m_due;
+        }
+        auto delta = tick - m_current;
+        if (delta > m_max_delta) {
+            tick = m_current + m_max_delta;
+            delta = m_max_delta;
+        }
+        unsigned level = 0;
+        while (level < m_levels - 1 && delta >= (uint64_t(1) << (m_bits * (level + 1)))) {
+            level++;
+        }
+        return m_wheel[level][(tick >> (m_bits * level)) & m_mask];
+    }
+
+    void Expire(EntryList &list, std::vector<Key> &expired) {
+        for (auto &entry : list) {
+            expired.push_back(entry.m_key);
+            m_index.erase(entry.m_key);
+        }
+        list.clear();
+    }
+
+    const Clock::duration m_resolution;
+    const Clock::time_point m_origin;
+    uint64_t m_current{0}; // The last tick processed by `Advance`.
+    std::array<std::array<EntryList, m_slots>, m_levels> m_wheel;
+    EntryList m_due; // Timers whose deadline had already passed when scheduled.
+    std::unordered_map<Key, Location, Hash> m_index;
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_TIMERWHEEL_HH
@@ -0,0 +1,198 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlUploadChecksum.hh"
+
+#include <XrdOuc/XrdOucCRC.hh>
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <cctype>
+
+using namespace XrdClCurl;
+
+UploadChecksum::Algorithm
+UploadChecksum::ParseAlgorithm(const std::string &name)
+{
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) {return std::tolower(c);});
+    if (lower == "crc32c") {
+        return Algorithm::kCRC32C;
+    } else if (lower == "adler32") {
+        return Algorithm::kAdler32;
+    } else if (lower == "md5") {
+        return Algorithm::kMD5;
+    }
+    return Algorithm::kNone;
+}
+
+std::string
+UploadChecksum::GetAlgorithmName(Algorithm algorithm)
+{
+    switch (algorithm) {
+        case Algorithm::kCRC32C:
+            return "crc32c";
+        case Algorithm::kAdler32:
+            return "adler32";
+        case Algorithm::kMD5:
+            return "md5";
+        case Algorithm::kNone:
+            break;
+    }
+    return "";
+}
+
+UploadChecksum::UploadChecksum(Algorithm algorithm)
+    : m_algorithm(algorithm)
+{
+    if (m_algorithm == Algorithm::kMD5) {
+        m_md5 = EVP_MD_CTX_new();
+        if (m_md5 && !EVP_DigestInit_ex(m_md5, EVP_md5(), nullptr)) {
+            EVP_MD_CTX_free(m_md5);
+            m_md5 = nullptr;
+        }
+    }
+}
+
+UploadChecksum::~UploadChecksum()
+{
+    if (m_md5) {
+        EVP_MD_CTX_free(m_md5);
+    }
+}
+
+void
+UploadChecksum::Update(const char *data, size_t size)
+{
+    if (m_final || !size) return;
+    switch (m_algorithm) {
+        case Algorithm::kCRC32C:
+            m_crc32c = XrdOucCRC::Calc32C(data, size, m_crc32c);
+            break;
+        case Algorithm::kAdler32: {
+            // Defer the modulo as long as the sums can't overflow (as zlib does).
+            constexpr uint32_t base = 65521;
+            constexpr size_t max_block = 5552;
+            auto bytes = reinterpret_cast<const unsigned char *>(data);
+            while (size) {
+                auto block = std::min(size, max_block);
+                size -= block;
+                while (block--) {
+                    m_adler_a += *bytes++;
+                    m_adler_b += m_adler_a;
+                }
+                m_adler_a %= base;
+                m_adler_b %= base;
+            }
+            break;
+        }
+        case Algorithm::kMD5:
+            if (m_md5) EVP_DigestUpdate(m_md5, data, size);
+            break;
+        case Algorithm::kNone:
+            break;
+    }
+}
+
+void
+UploadChecksum::Final()
+{
+    if (m_final) return;
+    m_final = true;
+    auto set_uint32 = [&](uint32_t value) {
+        m_digest = {static_cast<unsigned char>(value >> 24), static_cast<unsigned char>(value >> 16),
+            static_cast<unsigned char>(value >> 8), static_cast<unsigned char>(value)};
+    };
+    switch (m_algorithm) {
+        case Algorithm::kCRC32C:
+            set_uint32(m_crc32c);
+            break;
+        case Algorithm::kAdler32:
+            set_uint32((m_adler_b << 16) | m_adler_a);
+            break;
+        case Algorithm::kMD5: {
+            if (!m_md5) break;
+            unsigned char digest[EVP_MAX_MD_SIZE];
+            unsigned int length = 0;
+            if (EVP_DigestFinal_ex(m_md5, digest, &length)) {
+                m_digest.assign(digest, digest + length);
+            }
+            break;
+        }
+        case Algorithm::kNone:
+            break;
+    }
+}
+
+std::string
+UploadChecksum::GetBase64() const
+{
+    std::string result(4 * ((m_digest.size() + 2) / 3) + 1, '\0');
+    auto length = EVP_EncodeBlock(reinterpret_cast<unsigned char *>(result.data()), m_digest.data(), m_digest.size());
+    result.resize(length);
+    return result;
+}
+
+std::string
+UploadChecksum::GetHex() const
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string result;
+    result.reserve(2 * m_digest.size());
+    for (auto byte : m_digest) {
+        result += digits[byte >> 4];
+        result += digits[byte & 0xf];
+    }
+    return result;
+}
+
+std::pair<std::string, std::string>
+UploadChecksum::GetHeader(Style style) const
+{
+    if (m_digest.empty()) return {};
+    if (style == Style::kS3) {
+        switch (m_algorithm) {
+            case Algorithm::kCRC32C:
+                return {"x-amz-checksum-crc32c", GetBase64()};
+            case Algorithm::kMD5:
+                return {"Content-MD5", GetBase64()};
+            default:
+                return {};
+        }
+    }
+    // Digest names and encodings as registered with IANA; see
+    // https://www.iana.org/assignments/http-dig-alg/http-dig-alg.xhtml
+    switch (m_algorithm) {
+        case Algorithm::kCRC32C:
+            return {"Digest", "crc32c=" + GetHex()};
+        case Algorithm::kAdler32:
+            return {"Digest", "adler32=" + GetHex()};
+        case Algorithm::kMD5:
+            return {"Digest", "md5=" + GetBase64()};
+        case Algorithm::kNone:
+            break;
+    }
+    return {};
+}
+
+std::string
+UploadChecksum::GetValue() const
+{
+    if (m_digest.empty()) return "";
+    return GetAlgorithmName(m_algorithm) + " " + GetHex();
+}
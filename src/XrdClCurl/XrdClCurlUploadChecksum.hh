@@ -0,0 +1,98 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_UPLOADCHECKSUM_HH
+#define XRDCLCURL_UPLOADCHECKSUM_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+
+namespace XrdClCurl {
+
+// Incremental checksum of the bytes sent by an upload.
+//
+// The checksum is updated as the PUT body is handed to libcurl, so the object
+// never has to be re-read to verify it.  The result is sent to the server as a
+// header (when the whole object is known before the request starts) or as a
+// trailer of a chunked upload, and is available to the caller after the upload.
+class UploadChecksum {
+public:
+    enum class Algorithm {
+        kNone,
+        kCRC32C,
+        kAdler32,
+        kMD5,
+    };
+
+    // How the checksum is presented to the server.
+    enum class Style {
+        kDigest, // RFC 3230 `Digest` header, as understood by XRootD and other WebDAV servers.
+        kS3,     // `x-amz-checksum-crc32c` or `Content-MD5`, as understood by S3.
+    };
+
+    // Parse a checksum name ("crc32c", "adler32", "md5"); returns kNone if unknown.
+    static Algorithm ParseAlgorithm(const std::string &name);
+
+    static std::string GetAlgorithmName(Algorithm algorithm);
+
+    explicit UploadChecksum(Algorithm algorithm);
+    ~UploadChecksum();
+    UploadChecksum(const UploadChecksum &) = delete;
+
+    Algorithm GetAlgorithm() const {return m_algorithm;}
+
+    // Add `size` bytes to the checksum; ignored once finalized.
+    void Update(const char *data, size_t size);
+
+    // Finish the computation; further updates are ignored.
+    void Final();
+
+    bool IsFinal() const {return m_final;}
+
+    // Returns the (name, value) of the header carrying the final checksum in the given
+    // style; the name is empty if the style has no representation for the algorithm.
+    std::pair<std::string, std::string> GetHeader(Style style) const;
+
+    // Returns the final checksum as "<algorithm> <hex value>", the format of XrdCl
+    // checksum queries; empty if not finalized.
+    std::string GetValue() const;
+
+private:
+    // Base64 encoding of the final digest.
+    std::string GetBase64() const;
+
+    // Hex encoding of the final digest.
+    std::string GetHex() const;
+
+    const Algorithm m_algorithm;
+    bool m_final{false};
+    uint32_t m_crc32c{0};
+    uint32_t m_adler_a{1};
+    uint32_t m_adler_b{0};
+    EVP_MD_CTX *m_md5{nullptr};
+    std::vector<unsigned char> m_digest; // The final digest, in network byte order.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_UPLOADCHECKSUM_HH
@@ -16,9 +16,13 @@
  *
  ***************************************************************/
 
+#include "../common/XrdClCurlCAStore.hh"
+#include "XrdClCurlAffinity.hh"
 #include "XrdClCurlFile.hh"
 #include "XrdClCurlOps.hh"
 #include "XrdClCurlOptionsCache.hh"
+#include "XrdClCurlRateLimiter.hh"
+#include "XrdClCurlSocketTuning.hh"
 #include "XrdClCurlUtil.hh"
 #include "XrdClCurlVersion.hh"
 #include "XrdClCurlWorker.hh"
@@ -45,6 +49,7 @@
 #endif
 #include <unistd.h>
 
+#include <algorithm>
 #include <charconv>
 #include <sstream>
 #include <stdexcept>
@@ -54,6 +59,7 @@ using namespace XrdClCurl;
 
 thread_local std::vector<CURL*> HandlerQueue::m_handles;
 std::atomic<unsigned> CurlWorker::m_maintenance_period = 5;
+std::atomic<bool> CurlWorker::m_speculative_options = true;
 std::vector<CurlWorker*> CurlWorker::m_workers;
 std::mutex CurlWorker::m_workers_mutex;
 
@@ -71,10 +77,14 @@ std::mutex CurlWorker::m_worker_stats_mutex;
 std::atomic<uint64_t> HandlerQueue::m_ops_consumed = 0; // Count of operations consumed from the queue.
 std::atomic<uint64_t> HandlerQueue::m_ops_produced = 0; // Count of operations added to the queue.
 std::atomic<uint64_t> HandlerQueue::m_ops_rejected = 0; // Count of operations rejected by the queue.
+std::atomic<uint64_t> HandlerQueue::m_ops_overflowed = 0; // Count of operations placed on an overflow list.
+std::atomic<uint64_t> HandlerQueue::m_ops_delayed = 0; // Count of operations added via ProduceAfter.
+std::atomic<uint64_t> HandlerQueue::m_overflow_depth = 0; // Count of operations currently on the overflow lists.
+std::atomic<std::chrono::steady_clock::duration::rep> HandlerQueue::m_full_duration = 0; // Total time queues have spent full.
 
 struct WaitingForBroker {
     CURL *curl{nullptr};
-    time_t expiry{0};
+    std::chrono::steady_clock::time_point expiry;
 };
 
 namespace {
@@ -164,6 +174,26 @@ std::pair<uint16_t, uint32_t> XrdClCurl::HTTPStatusConvert(unsigned status) {
     return std::make_pair(XrdCl::errUnknown, status);
 }
 
+bool XrdClCurl::HTTPStatusIsServerFault(unsigned status) {
+    return status == 502 || status == 503 || status == 504;
+}
+
+bool XrdClCurl::CurlCodeIsServerFault(int res) {
+    switch (res) {
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_PARTIAL_FILE:
+        case CURLE_OPERATION_TIMEDOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
 std::pair<uint16_t, uint32_t> CurlCodeConvert(CURLcode res) {
     switch (res) {
         case CURLE_OK:
@@ -611,27 +641,7 @@ XrdClCurl::GetHandle(bool verbose) {
     if (verbose)
         curl_easy_setopt(result, CURLOPT_VERBOSE, 1L);
 
-    auto env = XrdCl::DefaultEnv::GetEnv();
-    std::string ca_file;
-    if (!env->GetString("CurlCertFile", ca_file) || ca_file.empty()) {
-        char *x509_ca_file = getenv("X509_CERT_FILE");
-        if (x509_ca_file) {
-            ca_file = std::string(x509_ca_file);
-        }
-    }
-    if (!ca_file.empty()) {
-        curl_easy_setopt(result, CURLOPT_CAINFO, ca_file.c_str());
-    }
-    std::string ca_dir;
-    if (!env->GetString("CurlCertDir", ca_dir) || ca_dir.empty()) {
-        char *x509_ca_dir = getenv("X509_CERT_DIR");
-        if (x509_ca_dir) {
-            ca_dir = std::string(x509_ca_dir);
-        }
-    }
-    if (!ca_dir.empty()) {
-        curl_easy_setopt(result, CURLOPT_CAPATH, ca_dir.c_str());
-    }
+    CAStore::Instance().ConfigureHandle(result);
 
     curl_easy_setopt(result, CURLOPT_BUFFERSIZE, 32*1024);
 
@@ -657,27 +667,210 @@ HandlerQueue::RecycleHandle(CURL *curl) {
 void
 HandlerQueue::Expire()
 {
-    std::unique_lock<std::mutex> lk(m_mutex);
+    // Multiple workers call this on every loop iteration; only take the lock
+    // once per tick of the timer wheel.
     auto now = std::chrono::steady_clock::now();
+    auto next_expire = m_next_expire.load(std::memory_order_relaxed);
+    if (now.time_since_epoch().count() < next_expire ||
+        !m_next_expire.compare_exchange_strong(next_expire, (now + m_timers.GetResolution()).time_since_epoch().count(), std::memory_order_relaxed))
+    {
+        return;
+    }
 
-    // Iterate through the paused transfers, checking if they are done.
-    for (auto &op : m_ops) {
-        if (!op->IsPaused()) continue;
+    std::vector<std::shared_ptr<CurlOperation>> expired_ops, rejected_ops;
+    size_t admitted = 0;
+    {
+        std::unique_lock<std::mutex> lk(m_mutex);
+        m_expired.clear();
+        m_timers.Advance(now, m_expired);
+
+        for (auto handler : m_expired) {
+            // Delayed operations are due; they join the queue, behind any overflow,
+            // subject to the same admission mode as `Produce`.
+            auto delayed = m_delayed.find(handler);
+            if (delayed != m_delayed.end()) {
+                if (m_ops.size() < m_max_pending_ops && m_overflow.empty()) {
+                    Admit(std::move(delayed->second));
+                    m_delayed.erase(delayed);
+                    admitted++;
+                    continue;
+                }
+                switch (m_admission_mode) {
+                case AdmissionMode::Reject:
+                    rejected_ops.push_back(std::move(delayed->second));
+                    m_delayed.erase(delayed);
+                    break;
+                case AdmissionMode::Overflow:
+                    PushOverflow(std::move(delayed->second));
+                    m_delayed.erase(delayed);
+                    break;
+                case AdmissionMode::Block:
+                    // The worker can't wait for space; keep the operation delayed and
+                    // retry on the next tick until there's space or it expires.
+                    if (handler->GetOperationExpiry() < now) {
+                        expired_ops.push_back(std::move(delayed->second));
+                        m_delayed.erase(delayed);
+                    } else {
+                        m_timers.Schedule(handler, now + m_timers.GetResolution());
+                    }
+                    break;
+                }
+                continue;
+            }
+
+            // Paused transfers that have stalled are continued so the worker notices
+            // the stall and fails them with the appropriate error.
+            if (handler->IsPaused() && handler->TransferStalled(0, now)) {
+                handler->ContinueHandle();
+            }
 
-        if (op->TransferStalled(0, now)) {
-            op->ContinueHandle();
+            auto expiry = handler->GetOperationExpiry();
+            if (expiry >= now) {
+                m_timers.Schedule(handler, expiry);
+                continue;
+            }
+            if (auto op = Remove(handler)) {
+                expired_ops.push_back(std::move(op));
+            }
         }
+        if (!expired_ops.empty()) {
+            admitted += AdmitOverflow();
+        }
+        UpdateFullTime(now);
+    }
+    for (size_t idx = 0; idx < admitted; idx++) {
+        m_consumer_cv.notify_one();
+    }
+    if (!expired_ops.empty()) {
+        m_producer_cv.notify_all();
+    }
+
+    // Fail the operations outside the lock as the callbacks may produce new operations.
+    for (auto &op : expired_ops) {
+        op->Fail(XrdCl::errOperationExpired, 0, "Operation expired while in queue");
+    }
+    for (auto &op : rejected_ops) {
+        op->Fail(XrdCl::errRetry, EAGAIN, "Work queue is full; retry the operation later");
+        m_ops_rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void
+HandlerQueue::SetAdmissionMode(AdmissionMode mode)
+{
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_admission_mode = mode;
+    // Operations already on the overflow list are admitted as space frees up.
+}
+
+bool
+HandlerQueue::ParseAdmissionMode(const std::string &name, AdmissionMode &mode)
+{
+    if (name == "block") {
+        mode = AdmissionMode::Block;
+    } else if (name == "overflow") {
+        mode = AdmissionMode::Overflow;
+    } else if (name == "reject") {
+        mode = AdmissionMode::Reject;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void
+HandlerQueue::UpdateFullTime(std::chrono::steady_clock::time_point now)
+{
+    auto full = m_ops.size() >= m_max_pending_ops;
+    if (full && m_full_since == std::chrono::steady_clock::time_point{}) {
+        m_full_since = now;
+    } else if (!full && m_full_since != std::chrono::steady_clock::time_point{}) {
+        m_full_duration.fetch_add((now - m_full_since).count(), std::memory_order_relaxed);
+        m_full_since = {};
     }
+}
 
-    auto it = std::remove_if(m_ops.begin(), m_ops.end(),
-        [now](const std::shared_ptr<CurlOperation> &handler) {
-            auto expired = handler->GetOperationExpiry() < now;
-            if (expired) {
-                handler->Fail(XrdCl::errOperationExpired, 0, "Operation expired while in queue");
+void
+HandlerQueue::Admit(std::shared_ptr<CurlOperation> handler)
+{
+    Enqueue(std::move(handler));
+    SignalPipe(1);
+}
+
+void
+HandlerQueue::Enqueue(std::shared_ptr<CurlOperation> handler)
+{
+    m_timers.Schedule(handler.get(), handler->GetOperationExpiry());
+    auto key = handler.get();
+    m_ops.push_back(std::move(handler));
+    m_positions[key] = Position{&m_ops, std::prev(m_ops.end())};
+    m_ops_produced.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+HandlerQueue::PushOverflow(std::shared_ptr<CurlOperation> handler)
+{
+    m_timers.Schedule(handler.get(), handler->GetOperationExpiry());
+    auto key = handler.get();
+    m_overflow.push_back(std::move(handler));
+    m_positions[key] = Position{&m_overflow, std::prev(m_overflow.end())};
+    m_overflow_depth.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::shared_ptr<CurlOperation>
+HandlerQueue::PopFront()
+{
+    auto result = std::move(m_ops.front());
+    m_ops.pop_front();
+    m_positions.erase(result.get());
+    m_timers.Cancel(result.get());
+    return result;
+}
+
+std::shared_ptr<CurlOperation>
+HandlerQueue::Remove(CurlOperation *handler)
+{
+    auto iter = m_positions.find(handler);
+    if (iter == m_positions.end()) {
+        return nullptr;
+    }
+    auto &pos = iter->second;
+    auto result = std::move(*pos.m_entry);
+    if (pos.m_list == &m_overflow) {
+        m_overflow_depth.fetch_sub(1, std::memory_order_relaxed);
+    }
+    pos.m_list->erase(pos.m_entry);
+    m_positions.erase(iter);
+    m_timers.Cancel(handler);
+    return result;
+}
+
+void
+HandlerQueue::SignalPipe(size_t count)
+{
+    static const std::string ready(256, '1');
+    while (count) {
+        auto result = write(m_write_fd, ready.data(), std::min(count, ready.size()));
+        if (result == -1) {
+            if (errno == EINTR) {
+                continue;
             }
-            return expired;
-        });
-    m_ops.erase(it, m_ops.end());
+            throw std::runtime_error(strerror(errno));
+        }
+        count -= result;
+    }
+}
+
+size_t
+HandlerQueue::AdmitOverflow()
+{
+    size_t admitted = 0;
+    while (!m_overflow.empty() && m_ops.size() < m_max_pending_ops) {
+        auto handler = Remove(m_overflow.front().get());
+        Admit(std::move(handler));
+        admitted++;
+    }
+    return admitted;
 }
 
 void
@@ -685,10 +878,33 @@ HandlerQueue::Produce(std::shared_ptr<CurlOperation> handler)
 {
     auto handler_expiry = handler->GetOperationExpiry();
     std::unique_lock<std::mutex> lk{m_mutex};
-    m_producer_cv.wait_until(lk,
-        handler_expiry,
-        [&]{return m_ops.size() < m_max_pending_ops;}
-    );
+    // Preserve ordering: if anything is waiting in the overflow list, new
+    // operations must queue up behind it.
+    if (m_ops.size() >= m_max_pending_ops || !m_overflow.empty()) {
+        UpdateFullTime(std::chrono::steady_clock::now());
+        switch (m_admission_mode) {
+        case AdmissionMode::Reject:
+            lk.unlock();
+            handler->Fail(XrdCl::errRetry, EAGAIN, "Work queue is full; retry the operation later");
+            m_ops_rejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        case AdmissionMode::Overflow:
+            PushOverflow(std::move(handler));
+            m_ops_overflowed.fetch_add(1, std::memory_order_relaxed);
+            if (m_demand_callback) {
+                auto backlog = m_ops.size() + m_overflow.size();
+                lk.unlock();
+                m_demand_callback(backlog);
+            }
+            return;
+        case AdmissionMode::Block:
+            m_producer_cv.wait_until(lk,
+                handler_expiry,
+                [&]{return m_ops.size() < m_max_pending_ops;}
+            );
+            break;
+        }
+    }
     if (std::chrono::steady_clock::now() > handler_expiry) {
         lk.unlock();
         handler->Fail(XrdCl::errOperationExpired, 0, "Operation expired while waiting for worker");
@@ -696,22 +912,99 @@ HandlerQueue::Produce(std::shared_ptr<CurlOperation> handler)
         return;
     }
 
-    m_ops.push_back(handler);
-    char ready[] = "1";
-    while (true) {
-        auto result = write(m_write_fd, ready, 1);
-        if (result == -1) {
-            if (errno == EINTR) {
-                continue;
+    Admit(std::move(handler));
+    UpdateFullTime(std::chrono::steady_clock::now());
+    auto backlog = m_ops.size();
+
+    lk.unlock();
+    m_consumer_cv.notify_one();
+    if (m_demand_callback) {
+        m_demand_callback(backlog);
+    }
+}
+
+void
+HandlerQueue::ProduceBatch(std::span<std::shared_ptr<CurlOperation>> handlers)
+{
+    // Operations to fail once the lock is released.
+    std::vector<std::shared_ptr<CurlOperation>> rejected, expired;
+    size_t signaled = 0, pending = 0;
+    bool overflowed = false;
+
+    std::unique_lock<std::mutex> lk{m_mutex};
+    auto now = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < handlers.size(); idx++) {
+        auto &handler = handlers[idx];
+        if (!handler) continue;
+        auto handler_expiry = handler->GetOperationExpiry();
+        if (m_ops.size() >= m_max_pending_ops || !m_overflow.empty()) {
+            UpdateFullTime(now);
+            if (m_admission_mode == AdmissionMode::Reject) {
+                for (; idx < handlers.size(); idx++) {
+                    if (handlers[idx]) rejected.push_back(std::move(handlers[idx]));
+                }
+                break;
+            } else if (m_admission_mode == AdmissionMode::Overflow) {
+                for (; idx < handlers.size(); idx++) {
+                    if (!handlers[idx]) continue;
+                    PushOverflow(std::move(handlers[idx]));
+                    m_ops_overflowed.fetch_add(1, std::memory_order_relaxed);
+                }
+                overflowed = true;
+                break;
             }
-            throw std::runtime_error(strerror(errno));
+            // Let the workers start on the operations admitted so far before waiting for space.
+            if (pending) {
+                SignalPipe(pending);
+                for (size_t ctr = 0; ctr < pending; ctr++) {
+                    m_consumer_cv.notify_one();
+                }
+                signaled += pending;
+                pending = 0;
+            }
+            m_producer_cv.wait_until(lk,
+                handler_expiry,
+                [&]{return m_ops.size() < m_max_pending_ops;}
+            );
+            now = std::chrono::steady_clock::now();
         }
-        break;
+        if (now > handler_expiry) {
+            expired.push_back(std::move(handler));
+            continue;
+        }
+        Enqueue(std::move(handler));
+        pending++;
     }
-
+    if (pending) {
+        SignalPipe(pending);
+        UpdateFullTime(now);
+    }
+    auto backlog = m_ops.size() + m_overflow.size();
     lk.unlock();
-    m_consumer_cv.notify_one();
-    m_ops_produced.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t ctr = 0; ctr < pending; ctr++) {
+        m_consumer_cv.notify_one();
+    }
+    if (m_demand_callback && (signaled + pending || overflowed)) {
+        m_demand_callback(backlog);
+    }
+    for (auto &op : rejected) {
+        op->Fail(XrdCl::errRetry, EAGAIN, "Work queue is full; retry the operation later");
+        m_ops_rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (auto &op : expired) {
+        op->Fail(XrdCl::errOperationExpired, 0, "Operation expired while waiting for worker");
+        m_ops_rejected.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void
+HandlerQueue::ProduceAfter(std::shared_ptr<CurlOperation> handler, std::chrono::steady_clock::time_point when)
+{
+    std::unique_lock<std::mutex> lk{m_mutex};
+    m_timers.Schedule(handler.get(), when);
+    m_delayed[handler.get()] = std::move(handler);
+    m_ops_delayed.fetch_add(1, std::memory_order_relaxed);
 }
 
 std::shared_ptr<CurlOperation>
@@ -723,8 +1016,7 @@ HandlerQueue::Consume(std::chrono::steady_clock::duration dur)
         return {};
     }
 
-    std::shared_ptr<CurlOperation> result = m_ops.front();
-    m_ops.pop_front();
+    auto result = PopFront();
 
     char ready[1];
     while (true) {
@@ -738,8 +1030,15 @@ HandlerQueue::Consume(std::chrono::steady_clock::duration dur)
         break;
     }
 
+    auto admitted = AdmitOverflow();
+    UpdateFullTime(std::chrono::steady_clock::now());
+
     lk.unlock();
-    m_producer_cv.notify_one();
+    if (admitted) {
+        m_consumer_cv.notify_one();
+    } else {
+        m_producer_cv.notify_one();
+    }
     m_ops_consumed.fetch_add(1, std::memory_order_relaxed);
 
     return result;
@@ -754,7 +1053,11 @@ HandlerQueue::GetMonitoringJson()
             "\"produced\":" + std::to_string(produced) + ","
             "\"consumed\":" + std::to_string(consumed) + ","
             "\"pending\":" + std::to_string(produced - consumed) + ","
-            "\"rejected\":" + std::to_string(m_ops_rejected.load(std::memory_order_relaxed)) +
+            "\"rejected\":" + std::to_string(m_ops_rejected.load(std::memory_order_relaxed)) + ","
+            "\"overflowed\":" + std::to_string(m_ops_overflowed.load(std::memory_order_relaxed)) + ","
+            "\"delayed\":" + std::to_string(m_ops_delayed.load(std::memory_order_relaxed)) + ","
+            "\"overflow_depth\":" + std::to_string(m_overflow_depth.load(std::memory_order_relaxed)) + ","
+            "\"full_time\":" + std::to_string(std::chrono::duration<double>(std::chrono::steady_clock::duration(m_full_duration.load(std::memory_order_relaxed))).count()) +
         "}";
 }
 
@@ -767,8 +1070,7 @@ HandlerQueue::TryConsume()
         return result;
     }
 
-    std::shared_ptr<CurlOperation> result = m_ops.front();
-    m_ops.pop_front();
+    auto result = PopFront();
 
     char ready[1];
     while (true) {
@@ -782,8 +1084,15 @@ HandlerQueue::TryConsume()
         break;
     }
 
+    auto admitted = AdmitOverflow();
+    UpdateFullTime(std::chrono::steady_clock::now());
+
     lk.unlock();
-    m_producer_cv.notify_one();
+    if (admitted) {
+        m_consumer_cv.notify_one();
+    } else {
+        m_producer_cv.notify_one();
+    }
     m_ops_consumed.fetch_add(1, std::memory_order_relaxed);
 
     return result;
@@ -926,7 +1235,7 @@ CurlWorker::GetMonitoringJson()
 }
 
 void
-CurlWorker::OpRecord(XrdClCurl::CurlOperation &op, OpKind kind)
+CurlWorker::OpRecord(XrdClCurl::CurlOperation &op, OpKind kind, bool server_fault)
 {
     int sc = op.GetStatusCode();
     // - We encode everything pre-header as integer "401".  We include a 100-continue request as "pre-header".
@@ -969,6 +1278,64 @@ CurlWorker::OpRecord(XrdClCurl::CurlOperation &op, OpKind kind)
     case OpKind::Update:
         break;
     }
+
+    // Feed the per-endpoint scoreboard used to rank mirrors.  Time spent paused waiting
+    // on the client is not held against the server.
+    if (kind == OpKind::Start) {
+        return;
+    }
+    auto outcome = Scoreboard::Outcome::Progress;
+    switch (kind) {
+    case OpKind::Finish:
+        outcome = HTTPStatusIsServerFault(op.GetStatusCode()) ? Scoreboard::Outcome::Failure : Scoreboard::Outcome::Success;
+        break;
+    case OpKind::ConncallTimeout:
+    case OpKind::ServerTimeout:
+        outcome = Scoreboard::Outcome::Failure;
+        break;
+    case OpKind::Error:
+        // Internal errors and client-side aborts say nothing about the server.
+        outcome = server_fault ? Scoreboard::Outcome::Failure : Scoreboard::Outcome::Aborted;
+        break;
+    case OpKind::ClientTimeout:
+        outcome = Scoreboard::Outcome::Aborted;
+        break;
+    case OpKind::Start:
+    case OpKind::Update:
+        break;
+    }
+    auto active = post_headers > pause_duration ? post_headers - pause_duration : std::chrono::steady_clock::duration::zero();
+    Scoreboard::Instance().Record(op.GetScoreboardHost(), bytes, active, op.TakeTimeToFirstHeader(), outcome);
+}
+
+bool
+CurlWorker::StartOptions(const std::shared_ptr<CurlOptionsOp> &options_op, HandlerQueue &queue, CURLM *multi_handle, int &running_handles)
+{
+    auto curl = queue.GetHandle();
+    if (curl == nullptr) {
+        m_logger->Debug(kLogXrdClCurl, "Unable to allocate a curl handle for OPTIONS");
+        return false;
+    }
+    try {
+        if (!options_op->Setup(curl, *this)) {
+            m_logger->Debug(kLogXrdClCurl, "Unable to configure a curl handle for OPTIONS");
+            return false;
+        }
+    } catch (...) {
+        m_logger->Debug(kLogXrdClCurl, "Unable to setup the curl handle for the OPTIONS operation");
+        return false;
+    }
+    options_op->SetContinueQueue(m_continue_queue);
+    auto mres = curl_multi_add_handle(multi_handle, curl);
+    if (mres != CURLM_OK) {
+        m_logger->Debug(kLogXrdClCurl, "Unable to add OPTIONS operation to the curl multi-handle: %s", curl_multi_strerror(mres));
+        return false;
+    }
+    m_op_map[curl] = {options_op, std::chrono::system_clock::now()};
+    m_deadlines.Schedule(curl, options_op->GetNextDeadline());
+    OpRecord(*options_op, OpKind::Start);
+    running_handles += 1;
+    return true;
 }
 
 void
@@ -999,6 +1366,11 @@ CurlWorker::Run() {
     // those threads may be waiting on the condition variable; destroying a condition variable
     // while a thread is waiting on it is undefined behavior.
     auto queue_ref = m_queue;
+
+    // Pin the thread before anything below allocates; the curl handles, their buffers,
+    // and the thread-local handle pool are then first touched on the worker's node.
+    WorkerAffinity::Instance().Apply(m_stats_offset, *m_logger);
+
     int max_pending = 50;
     XrdCl::DefaultEnv::GetEnv()->GetInt("CurlMaxPendingOps", max_pending);
     m_continue_queue.reset(new HandlerQueue(max_pending));
@@ -1017,19 +1389,27 @@ CurlWorker::Run() {
     // Map from a file descriptor that has an outstanding broker request
     // to the corresponding CURL handle.
     std::unordered_map<int, WaitingForBroker> broker_reqs;
+    // Expiration times of the broker requests, keyed by socket.
+    TimerWheel<int> broker_timers;
+    std::vector<int> expired_brokers;
+    std::vector<CURL *> expired_ops;
     std::vector<struct curl_waitfd> waitfds;
+    auto next_stats_update = std::chrono::steady_clock::now();
 
     bool want_shutdown = false;
     while (!want_shutdown) {
         m_last_completed_cycle.store(std::chrono::system_clock::now().time_since_epoch().count());
-        auto oldest_op = std::chrono::system_clock::now();
-        for (const auto &entry : m_op_map) {
-            OpRecord(*entry.second.first, OpKind::Update);
-            if (entry.second.second < oldest_op) {
-                oldest_op = entry.second.second;
+        if (std::chrono::steady_clock::now() >= next_stats_update) {
+            next_stats_update = std::chrono::steady_clock::now() + m_stats_interval;
+            auto oldest_op = std::chrono::system_clock::now();
+            for (const auto &entry : m_op_map) {
+                OpRecord(*entry.second.first, OpKind::Update);
+                if (entry.second.second < oldest_op) {
+                    oldest_op = entry.second.second;
+                }
             }
+            m_oldest_op.store(oldest_op.time_since_epoch().count());
         }
-        m_oldest_op.store(oldest_op.time_since_epoch().count());
 
         // Try continuing any available handles that have more data
         while (true) {
@@ -1063,11 +1443,26 @@ CurlWorker::Run() {
             }
 		}
         // Consume from the shared new operation queue
+        auto &limiter = RateLimiter::Instance();
         while (running_handles < static_cast<int>(m_max_ops)) {
-            auto op = running_handles == 0 ? queue.Consume(std::chrono::seconds(1)) : queue.TryConsume();
+            std::chrono::steady_clock::duration idle_wait = std::chrono::seconds(1);
+            if (limiter.IsRequestLimited()) {
+                idle_wait = m_rate_limit_poll;
+            }
+            auto op = running_handles == 0 ? queue.Consume(idle_wait) : queue.TryConsume();
             if (!op) {
                 break;
             }
+            // Operations over the request rate limits go back to the queue until their
+            // reservation comes due; they are not charged a second time.
+            if (limiter.IsRequestLimited()) {
+                auto now = std::chrono::steady_clock::now();
+                auto wait = op->AdmitRequest(now);
+                if (wait > std::chrono::steady_clock::duration::zero()) {
+                    queue.ProduceAfter(std::move(op), now + wait);
+                    continue;
+                }
+            }
             auto curl = queue.GetHandle();
             if (curl == nullptr) {
                 m_logger->Debug(kLogXrdClCurl, "Unable to allocate a curl handle");
@@ -1091,16 +1486,36 @@ CurlWorker::Run() {
                 op->Fail(XrdCl::errInternal, ENOMEM, "Failed to setup the curl handle for the operation");
                 continue;
             }
+            // Requests to an endpoint whose circuit is open fail immediately instead of
+            // occupying a slot until the header timeout.
+            if (!Scoreboard::Instance().Admit(op->GetScoreboardHost())) {
+                m_logger->Debug(kLogXrdClCurl, "Failing request for URL %s; the endpoint is failing", op->GetUrl().c_str());
+                op->Fail(XrdCl::errRetry, EHOSTUNREACH, "Endpoint is failing; retry the operation later");
+                continue;
+            }
             op->SetContinueQueue(m_continue_queue);
 
             if (op->IsDone()) {
                 continue;
             }
             m_op_map[curl] = {op, std::chrono::system_clock::now()};
+            m_deadlines.Schedule(curl, op->GetNextDeadline());
 
             // If the operation requires the result of the OPTIONS verb to function, then
-            // we add that to the multi-handle instead, chaining the two calls together.
-            if (op->RequiresOptions()) {
+            // either start it with its most likely verb while OPTIONS is probed in parallel
+            // (for operations that can retry once the verbs are known) or add the OPTIONS
+            // request to the multi-handle instead, chaining the two calls together.
+            if (op->RequiresOptions() && op->CanSpeculateOptions() && m_speculative_options.load(std::memory_order_relaxed)) {
+                std::string modified_url;
+                std::string probe_url(VerbsCache::GetUrlKey(op->GetUrl(), modified_url));
+                if (m_cache.StartProbe(probe_url)) {
+                    std::shared_ptr<CurlOptionsOp> options_op(
+                        new CurlOptionsOp(probe_url, op->GetHeaderExpiry(), m_logger, op->GetConnCalloutFunc())
+                    );
+                    StartOptions(options_op, queue, multi_handle, running_handles);
+                }
+                OpRecord(*op, OpKind::Start);
+            } else if (op->RequiresOptions()) {
                 std::string modified_url;
                 std::shared_ptr<CurlOptionsOp> options_op(
                     new CurlOptionsOp(
@@ -1127,6 +1542,7 @@ CurlWorker::Run() {
                     continue;
                 }
                 m_op_map[curl] = {options_op, std::chrono::system_clock::now()};
+                m_deadlines.Schedule(curl, options_op->GetNextDeadline());
                 OpRecord(*options_op, OpKind::Start);
                 running_handles += 1;
             } else {
@@ -1144,39 +1560,77 @@ CurlWorker::Run() {
             running_handles += 1;
         }
 
-        // Maintain the periodic reporting of thread activity and fail any operations
-        // that have expired / timed out.
+        // Fail any queued operations that have expired; these are cheap when nothing
+        // is due so we check on every iteration.
+        m_queue->Expire();
+        m_continue_queue->Expire();
+
+        // Check the deadlines of the running operations that have come due.
+        auto steady_now = std::chrono::steady_clock::now();
+        expired_ops.clear();
+        m_deadlines.Advance(steady_now, expired_ops);
+        for (auto curl : expired_ops) {
+            // Timers are not cancelled when an operation finishes; ignore stale entries.
+            auto iter = m_op_map.find(curl);
+            if (iter == m_op_map.end() || iter->second.first->IsDone()) {
+                continue;
+            }
+            auto &op = iter->second.first;
+            // Transfers paused by the byte rate limits are resumed once the limits allow.
+            if (op->IsThrottled()) {
+                op->ResumeThrottled(steady_now);
+            }
+            if (!op->DeadlineExpired(steady_now)) {
+                m_deadlines.Schedule(curl, op->GetNextDeadline());
+                continue;
+            }
+            // The progress callback sees the same expired deadline and aborts the transfer,
+            // letting the usual completion logic fail the operation.  libcurl does not invoke
+            // the callback for a handle paused while waiting on the client, so continue it.
+            if (op->IsPaused()) {
+                m_logger->Debug(kLogXrdClCurl, "Continuing paused operation %p whose deadline expired", op.get());
+                op->ContinueHandle();
+            } else if (op->IsThrottled()) {
+                op->ResumeThrottled(steady_now, true);
+            }
+            m_deadlines.Schedule(curl, steady_now + std::chrono::seconds(1));
+        }
+
+        // Timeout all the pending broker requests.
+        expired_brokers.clear();
+        broker_timers.Advance(steady_now, expired_brokers);
+        for (auto fd : expired_brokers) {
+            auto req = broker_reqs.find(fd);
+            if (req == broker_reqs.end()) {
+                continue;
+            }
+            if (req->second.expiry > steady_now) {
+                broker_timers.Schedule(fd, req->second.expiry);
+                continue;
+            }
+            auto curl = req->second.curl;
+            auto iter = m_op_map.find(curl);
+            if (iter == m_op_map.end()) {
+                m_logger->Warning(kLogXrdClCurl, "Found an expired curl handle with no corresponding operation!");
+            } else {
+                iter->second.first->Fail(XrdCl::errConnectionError, 1, "Timeout: connection never provided for request");
+                iter->second.first->ReleaseHandle();
+                OpRecord(*(iter->second.first), OpKind::ConncallTimeout);
+                m_op_map.erase(curl);
+                curl_easy_cleanup(curl);
+                running_handles -= 1;
+            }
+            broker_reqs.erase(req);
+            m_conncall_timeout.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Maintain the periodic reporting of thread activity.
         time_t now = time(NULL);
         time_t next_maintenance = last_maintenance + m_maintenance_period.load(std::memory_order_relaxed);
         if (now >= next_maintenance) {
-            m_queue->Expire();
-            m_continue_queue->Expire();
             m_logger->Debug(kLogXrdClCurl, "Curl worker thread %d is running %d operations",
                 getthreadid(), running_handles);
             last_maintenance = now;
-
-            // Timeout all the pending broker requests.
-            std::vector<std::pair<int, CURL *>> expired_ops;
-            for (const auto &entry : broker_reqs) {
-                if (entry.second.expiry < now) {
-                    expired_ops.emplace_back(entry.first, entry.second.curl);
-                }
-            }
-            for (const auto &entry : expired_ops) {
-                auto iter = m_op_map.find(entry.second);
-                if (iter == m_op_map.end()) {
-                    m_logger->Warning(kLogXrdClCurl, "Found an expired curl handle with no corresponding operation!");
-                } else {
-                    iter->second.first->Fail(XrdCl::errConnectionError, 1, "Timeout: connection never provided for request");
-                    iter->second.first->ReleaseHandle();
-                    OpRecord(*(iter->second.first), OpKind::ConncallTimeout);
-                    m_op_map.erase(entry.second);
-                    curl_easy_cleanup(entry.second);
-                    running_handles -= 1;
-                }
-                broker_reqs.erase(entry.first);
-                m_conncall_timeout.fetch_add(1, std::memory_order_relaxed);
-            }
         }
 
         waitfds.clear();
@@ -1291,9 +1745,39 @@ CurlWorker::Run() {
                 auto res = msg->data.result;
                 bool keep_handle = false;
                 bool waiting_on_callout = false;
+
+                // No operation waits on a detached OPTIONS probe; it only populates the verbs cache.
+                auto probe = dynamic_cast<CurlOptionsOp*>(op.get());
+                if (probe && probe->IsDetached() && !(res == CURLE_COULDNT_CONNECT && op->UseConnectionCallout() && !op->GetTriedBoker())) {
+                    if (res == CURLE_OK) {
+                        OpRecord(*op, OpKind::Finish);
+                        auto sc = op->GetStatusCode();
+                        if (HTTPStatusIsError(sc)) {
+                            auto httpErr = HTTPStatusConvert(sc);
+                            op->Fail(httpErr.first, httpErr.second, op->GetStatusMessage());
+                        } else {
+                            op->Success();
+                        }
+                    } else {
+                        auto xrdCode = CurlCodeConvert(res);
+                        op->Fail(xrdCode.first, xrdCode.second, curl_easy_strerror(res));
+                        OpRecord(*op, OpKind::Error, CurlCodeIsServerFault(res));
+                    }
+                    op->ReleaseHandle();
+                    curl_multi_remove_handle(multi_handle, iter->first);
+                    if (res == CURLE_OK) {
+                        queue.RecycleHandle(iter->first);
+                    } else {
+                        curl_easy_cleanup(iter->first);
+                    }
+                    m_op_map.erase(iter);
+                    running_handles -= 1;
+                    continue;
+                }
                 if (res == CURLE_OK) {
                     auto sc = op->GetStatusCode();
                     OpRecord(*op, OpKind::Finish);
+                    SocketTuning::Instance().RecordTransfer(msg->easy_handle);
                     if (HTTPStatusIsError(sc)) {
                         auto httpErr = HTTPStatusConvert(sc);
                         op->Fail(httpErr.first, httpErr.second, op->GetStatusMessage());
@@ -1403,6 +1887,7 @@ CurlWorker::Run() {
                                     }
                                     new_op->SetContinueQueue(m_continue_queue);
                                     m_op_map[curl] = {new_op, std::chrono::system_clock::now()};
+                                    m_deadlines.Schedule(curl, new_op->GetNextDeadline());
                                     auto mres = curl_multi_add_handle(multi_handle, curl);
                                     if (mres != CURLM_OK) {
                                         m_logger->Debug(kLogXrdClCurl, "Unable to add OPTIONS operation to the curl multi-handle: %s", curl_multi_strerror(mres));
@@ -1419,14 +1904,41 @@ CurlWorker::Run() {
                             }
                             int callout_socket = op->WaitSocket();
                             if ((waiting_on_callout = callout_socket >= 0)) {
-                                auto expiry = time(nullptr) + 20;
+                                auto expiry = std::chrono::steady_clock::now() + m_broker_timeout;
                                 m_logger->Debug(kLogXrdClCurl, "Creating a callout wait request on socket %d", callout_socket);
                                 broker_reqs[callout_socket] = {iter->first, expiry};
+                                broker_timers.Schedule(callout_socket, expiry);
                                 m_conncall_req.fetch_add(1, std::memory_order_relaxed);
                             }
                         } else if (options_op) {
                             // In this case, the OPTIONS call happened before the parent operation was started.
                             curl_multi_add_handle(multi_handle, options_op->GetParentCurlHandle());
+                        } else {
+                            // The operation may have been started without waiting for the OPTIONS
+                            // response and now need a verb the response enables.
+                            std::string target;
+                            switch (op->RetryWithVerbs(target)) {
+                                case CurlOperation::VerbRetry::None:
+                                    break;
+                                case CurlOperation::VerbRetry::Reinvoke:
+                                    keep_handle = true;
+                                    OpRecord(*op, OpKind::Start);
+                                    break;
+                                case CurlOperation::VerbRetry::ReinvokeAfterAllow:
+                                {
+                                    std::string modified_url;
+                                    target = VerbsCache::GetUrlKey(target, modified_url);
+                                    std::shared_ptr<CurlOptionsOp> new_op(new CurlOptionsOp(iter->first, op, target, m_logger, op->GetConnCalloutFunc()));
+                                    if (!StartOptions(new_op, queue, multi_handle, running_handles)) {
+                                        // Without the OPTIONS response, the operation fails with the response it has.
+                                        break;
+                                    }
+                                    m_logger->Debug(kLogXrdClCurl, "Invoking the OPTIONS operation for %s before retrying", target.c_str());
+                                    // As with a redirect, the handle is re-added once the OPTIONS request is done.
+                                    options_op = new_op.get();
+                                    keep_handle = true;
+                                }
+                            }
                         }
                         if (keep_handle) {
                             curl_multi_remove_handle(multi_handle, iter->first);
@@ -1453,9 +1965,10 @@ CurlWorker::Run() {
                         keep_handle = false;
                     } else {
                         curl_multi_remove_handle(multi_handle, iter->first);
-                        auto expiry = time(nullptr) + 20;
+                        auto expiry = std::chrono::steady_clock::now() + m_broker_timeout;
                         m_logger->Debug(kLogXrdClCurl, "Curl operation requires a new TCP socket; waiting for callout to respond on socket %d", wait_socket);
                         broker_reqs[wait_socket] = {iter->first, expiry};
+                        broker_timers.Schedule(wait_socket, expiry);
                         m_conncall_req.fetch_add(1, std::memory_order_relaxed);
                     }
                 } else {
@@ -1469,7 +1982,7 @@ CurlWorker::Run() {
 #else
                             op->Fail(XrdCl::errOperationExpired, 0, "Origin did not respond within timeout");
 #endif
-                            OpRecord(*op, OpKind::Error);
+                            OpRecord(*op, OpKind::Error, true);
                             break;
                         case CurlOperation::OpError::ErrCallback: {
                             auto [ecode, emsg] = op->GetCallbackError();
@@ -1528,7 +2041,7 @@ CurlWorker::Run() {
                         auto xrdCode = CurlCodeConvert(res);
                         m_logger->Debug(kLogXrdClCurl, "Curl generated an error: %s (%d)", curl_easy_strerror(res), res);
                         op->Fail(xrdCode.first, xrdCode.second, curl_easy_strerror(res));
-                        OpRecord(*op, OpKind::Error);
+                        OpRecord(*op, OpKind::Error, CurlCodeIsServerFault(res));
                         CurlOptionsOp *options_op = nullptr;
                         if ((options_op = dynamic_cast<CurlOptionsOp*>(op.get())) != nullptr) {
                             auto parent_op = options_op->GetOperation();
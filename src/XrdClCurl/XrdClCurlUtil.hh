@@ -22,12 +22,16 @@
 #include "XrdClCurlChecksum.hh"
 #include "XrdClCurlOptionsCache.hh"
 #include "XrdClCurlResponseInfo.hh"
+#include "XrdClCurlTimerWheel.hh"
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
-#include <deque>
+#include <functional>
+#include <list>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -53,6 +57,16 @@ bool HTTPStatusIsError(unsigned status);
 
 std::pair<uint16_t, uint32_t> HTTPStatusConvert(unsigned status);
 
+// Returns true if the HTTP status indicates the server (or a gateway in front
+// of it) is unavailable: 502, 503, or 504.
+bool HTTPStatusIsServerFault(unsigned status);
+
+// Returns true if a transfer ending with the CURLcode `res` failed because of the
+// server or the network path to it (failure to connect, TLS handshake errors, a
+// dropped connection).  Client-side aborts, such as a callback returning an error,
+// are not server faults.
+bool CurlCodeIsServerFault(int res);
+
 // Trim the left side of a string_view for space
 std::string_view ltrim_view(const std::string_view &input_view);
 
@@ -155,7 +169,7 @@ private:
 };
 
 /**
- * HandlerQueue is a deque of curl operations that need
+ * HandlerQueue is a queue of curl operations that need
  * to be performed.  The object is thread safe and can
  * be waited on via poll().
  *
@@ -164,10 +178,38 @@ private:
  */
 class HandlerQueue {
 public:
+    // Behavior of `Produce` when the queue is at capacity.
+    enum class AdmissionMode {
+        Block,    // Block the calling thread until there is space or the operation expires.
+        Overflow, // Place the operation on an overflow list; it is admitted in order as space frees up.
+        Reject,   // Immediately fail the operation with a retryable error.
+    };
+
     HandlerQueue(unsigned max_pending_ops);
 
+    // Add an operation to the queue.
+    //
+    // If the queue is full, the behavior depends on the admission mode; only in
+    // `AdmissionMode::Block` will the caller's thread wait.
     void Produce(std::shared_ptr<CurlOperation> handler);
 
+    // Add a set of operations to the queue, taking the lock and signaling the workers once.
+    //
+    // Operations are admitted in order while there is space; the remainder are
+    // handled as `Produce` would handle a single operation under the admission mode
+    // (so, with `AdmissionMode::Reject`, a batch may be partially admitted).  The
+    // operations are moved out of `handlers`.
+    void ProduceBatch(std::span<std::shared_ptr<CurlOperation>> handlers);
+
+    // Add an operation to the queue once `when` has passed.
+    //
+    // Used to back off before retrying an operation.  The operation is held outside
+    // the queue (and does not count against its capacity) until the delay passes;
+    // the delay is only as precise as the workers' calls to `Expire`.  If the queue
+    // is full once the delay passes, the operation is handled per the admission mode;
+    // in `AdmissionMode::Block`, it stays delayed until there is space or it expires.
+    void ProduceAfter(std::shared_ptr<CurlOperation> handler, std::chrono::steady_clock::time_point when);
+
     std::shared_ptr<CurlOperation> Consume(std::chrono::steady_clock::duration);
     std::shared_ptr<CurlOperation> TryConsume();
 
@@ -176,14 +218,30 @@ public:
     CURL *GetHandle();
     void RecycleHandle(CURL *);
 
-    // Check all the operations in queue to see if any have expired.
+    // Fail any operations in the queue whose deadline has passed.
     //
     // Each curl operation has a header timeout; if no headers have been received
     // by the time the timeout expires, the operation is considered to have
-    // expired.  This function checks all operations in the queue and
-    // removes any that have expired.
+    // expired.  Paused operations waiting in the queue additionally have a stall
+    // timeout.  Deadlines are tracked in a timer wheel as operations are
+    // produced, so this only touches the operations whose deadline has passed;
+    // it is cheap enough to be invoked on every iteration of the worker loop.
     void Expire();
 
+    // Set the behavior of `Produce` when the queue is full.
+    void SetAdmissionMode(AdmissionMode mode);
+
+    // Set a callback invoked by `Produce`, outside the queue lock, with the number of
+    // operations waiting for a worker (including any on the overflow list).
+    //
+    // Used to start curl workers on demand as the backlog grows; must be set before
+    // the first operation is produced.
+    void SetDemandCallback(std::function<void(size_t)> callback) {m_demand_callback = std::move(callback);}
+
+    // Parse the admission mode from its configuration name ("block", "overflow", or "reject").
+    // Returns false if the name is not recognized.
+    static bool ParseAdmissionMode(const std::string &name, AdmissionMode &mode);
+
     void Shutdown();
     // Cleanup all idle handles in current thread.
     void ReleaseHandles();
@@ -195,15 +253,69 @@ public:
     static std::string GetMonitoringJson();
 
 private:
+    // Add the operation to the queue and wake up a consumer; m_mutex must be held.
+    void Admit(std::shared_ptr<CurlOperation> handler);
+
+    // Add the operation to the queue without signaling the consumers; m_mutex must be held.
+    void Enqueue(std::shared_ptr<CurlOperation> handler);
+
+    // Write one byte per newly-queued operation to the poll pipe; m_mutex must be held.
+    void SignalPipe(size_t count);
+
+    // Move operations from the overflow list into the queue while there is space;
+    // m_mutex must be held.  Returns the number of operations admitted.
+    size_t AdmitOverflow();
+
+    // Update the accounting of the time the queue has been full; m_mutex must be held.
+    void UpdateFullTime(std::chrono::steady_clock::time_point now);
+
+    // Add the operation to the end of the overflow list; m_mutex must be held.
+    void PushOverflow(std::shared_ptr<CurlOperation> handler);
+
+    // Remove and return the operation at the front of the queue; m_mutex must be
+    // held and the queue must be non-empty.
+    std::shared_ptr<CurlOperation> PopFront();
+
+    // Remove the operation from whichever list holds it; m_mutex must be held.
+    // Returns the operation or nullptr if it is in neither m_ops nor m_overflow.
+    std::shared_ptr<CurlOperation> Remove(CurlOperation *handler);
+
     bool m_shutdown{false};
-    std::deque<std::shared_ptr<CurlOperation>> m_ops;
+    AdmissionMode m_admission_mode{AdmissionMode::Block};
+    // Callback notified of the backlog as operations are produced; may be empty.
+    std::function<void(size_t)> m_demand_callback;
+    using OpList = std::list<std::shared_ptr<CurlOperation>>;
+    OpList m_ops;
+    // Operations waiting for space in m_ops (AdmissionMode::Overflow only).
+    OpList m_overflow;
+    // Position of each operation in m_ops or m_overflow, so an expired operation
+    // can be removed without searching the lists.
+    struct Position {
+        OpList *m_list;
+        OpList::iterator m_entry;
+    };
+    std::unordered_map<CurlOperation*, Position> m_positions;
+    // Operations waiting for their `ProduceAfter` delay to pass, keyed by operation.
+    std::unordered_map<CurlOperation*, std::shared_ptr<CurlOperation>> m_delayed;
+    // Time the queue last became full; unset if the queue is not full.
+    std::chrono::steady_clock::time_point m_full_since;
     static std::atomic<uint64_t> m_ops_consumed; // Count of operations consumed from the queue.
     static std::atomic<uint64_t> m_ops_produced; // Count of operations added to the queue.
     static std::atomic<uint64_t> m_ops_rejected; // Count of operations rejected by the queue.
+    static std::atomic<uint64_t> m_ops_overflowed; // Count of operations placed on an overflow list.
+    static std::atomic<uint64_t> m_ops_delayed; // Count of operations added via ProduceAfter.
+    static std::atomic<uint64_t> m_overflow_depth; // Count of operations currently on the overflow lists.
+    static std::atomic<std::chrono::steady_clock::duration::rep> m_full_duration; // Total time queues have spent full.
     thread_local static std::vector<CURL*> m_handles;
     std::condition_variable m_consumer_cv;
     std::condition_variable m_producer_cv;
     std::mutex m_mutex;
+    // Deadlines of the operations in m_ops and m_overflow; protected by m_mutex.
+    TimerWheel<CurlOperation*> m_timers;
+    // Scratch space for the expired timers; protected by m_mutex.
+    std::vector<CurlOperation*> m_expired;
+    // Earliest time (steady clock ticks) at which Expire() should next take the lock.
+    std::atomic<std::chrono::steady_clock::rep> m_next_expire{0};
     const static unsigned m_default_max_pending_ops{50};
     const unsigned m_max_pending_ops{50};
     int m_read_fd{-1};
@@ -20,6 +20,7 @@
 #define XRDCLCURLWORKER_HH
 
 #include "XrdClCurlOps.hh"
+#include "XrdClCurlTimerWheel.hh"
 
 #include <array>
 #include <atomic>
@@ -31,6 +32,7 @@
 #include <unordered_set>
 
 typedef void CURL;
+typedef void CURLM;
 
 namespace XrdCl {
 
@@ -58,15 +60,30 @@ public:
     // Returns the configured X509 client certificate and key file name
     std::tuple<std::string, std::string> ClientX509CertKeyFile() const;
 
-    // Change the period (in seconds) for queue maintenance.
+    // Change the period (in seconds) for the periodic worker maintenance.
     //
+    // Operation deadlines are tracked individually and do not depend on this period.
     // Defaults to 5 seconds; smaller values are convenient for unit tests.
     static void SetMaintenancePeriod(unsigned maint) {
         m_maintenance_period.store(maint, std::memory_order_relaxed);
     }
 
+    // Set whether operations needing the server's OPTIONS response that support it (opens)
+    // start immediately with their most likely verb, probing OPTIONS in parallel, instead
+    // of waiting for it.
+    static void SetSpeculativeOptions(bool enabled) {
+        m_speculative_options.store(enabled, std::memory_order_relaxed);
+    }
+
     static std::string GetMonitoringJson();
 
+    // Reschedule the deadline timer of a running curl handle.
+    //
+    // Must be called from the worker's own thread (e.g., from a libcurl callback).
+    void ScheduleDeadline(CURL *curl, std::chrono::steady_clock::time_point deadline) {
+        m_deadlines.Schedule(curl, deadline);
+    }
+
 private:
     // Invoked when the plugin is unloaded, triggers the shutdown of each of the worker threads.
     static void ShutdownAll() __attribute__((destructor));
@@ -74,6 +91,11 @@ private:
     // Invoked by ShutdownAll, kills off the current object's thread
     void Shutdown();
 
+    // Start an OPTIONS operation on a new curl handle of the multi-handle.
+    //
+    // Returns false if the operation could not be started.
+    bool StartOptions(const std::shared_ptr<CurlOptionsOp> &options_op, HandlerQueue &queue, CURLM *multi_handle, int &running_handles);
+
     // A list of all known worker threads -- used to shutdown the process
     static std::vector<CurlWorker*> m_workers;
     // Protects the data in m_workers
@@ -95,6 +117,20 @@ private:
 
     const static unsigned m_max_ops{20};
     static std::atomic<unsigned> m_maintenance_period;
+    static std::atomic<bool> m_speculative_options;
+
+    // Interval between the statistics updates of the running operations.
+    static constexpr std::chrono::steady_clock::duration m_stats_interval{std::chrono::seconds(1)};
+
+    // Longest time an idle worker blocks on the queue while request rate limits are active,
+    // bounding how late a delayed operation is admitted.
+    static constexpr std::chrono::steady_clock::duration m_rate_limit_poll{std::chrono::milliseconds(50)};
+
+    // Time allowed for the connection broker to provide a socket.
+    static constexpr std::chrono::steady_clock::duration m_broker_timeout{std::chrono::seconds(20)};
+
+    // Deadlines (header, operation, and stall timeouts) of the operations in m_op_map.
+    TimerWheel<CURL*> m_deadlines;
 
     // File descriptor pair indicating shutdown is requested.
     int m_shutdown_pipe_r{-1};
@@ -128,7 +164,9 @@ private:
         ServerTimeout,
         Update
     };
-    void OpRecord(XrdClCurl::CurlOperation &op, OpKind);
+    // Record the operation's statistics.  For OpKind::Error, `server_fault` indicates
+    // the failure is attributable to the server and counts against it in the scoreboard.
+    void OpRecord(XrdClCurl::CurlOperation &op, OpKind, bool server_fault=false);
 
     static std::atomic<uint64_t> m_conncall_errors;
     static std::atomic<uint64_t> m_conncall_req;
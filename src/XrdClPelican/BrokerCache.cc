@@ -18,18 +18,12 @@
 
 #include "BrokerCache.hh"
 
-#include <thread>
-
 using namespace Pelican;
 
 std::unique_ptr<BrokerCache> BrokerCache::m_cache{nullptr};
 std::chrono::steady_clock::duration BrokerCache::m_entry_lifetime{std::chrono::minutes(1) + std::chrono::seconds(10)};
 std::once_flag BrokerCache::m_cache_init;
-std::mutex BrokerCache::m_shutdown_lock;
-std::condition_variable BrokerCache::m_shutdown_requested_cv;
-bool BrokerCache::m_shutdown_requested = false;
-std::condition_variable BrokerCache::m_shutdown_complete_cv;
-bool BrokerCache::m_shutdown_complete = true; // Starts in "true" state as the thread hasn't started
+XrdClCurl::Scheduler::TaskId BrokerCache::m_expiry_task{0};
 
 BrokerCache::BrokerCache() {}
 
@@ -37,12 +31,7 @@ const BrokerCache &
 BrokerCache::GetCache() {
     std::call_once(m_cache_init, []{
         m_cache.reset(new BrokerCache());
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_complete = false;
-        }
-        std::thread t(BrokerCache::ExpireThread);
-        t.detach();
+        m_expiry_task = XrdClCurl::Scheduler::Instance().Schedule("broker_cache", std::chrono::seconds(30), BrokerCache::ExpireTask);
     });
     return *m_cache;
 }
@@ -82,26 +71,9 @@ BrokerCache::Expire(std::chrono::steady_clock::time_point now)
 }
 
 void
-BrokerCache::ExpireThread()
+BrokerCache::ExpireTask()
 {
-    while (true) {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_requested_cv.wait_for(
-                lock,
-                std::chrono::seconds(30),
-                []{return m_shutdown_requested;}
-            );
-            if (m_shutdown_requested) {
-                break;
-            }
-        }
-        auto now = std::chrono::steady_clock::now();
-        m_cache->Expire(now);
-    }
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_complete = true;
-    m_shutdown_complete_cv.notify_one();
+    m_cache->Expire(std::chrono::steady_clock::now());
 }
 
 void
@@ -140,9 +112,5 @@ BrokerCache::Get(const std::string &url, const std::chrono::steady_clock::time_p
 void
 BrokerCache::Shutdown()
 {
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_requested = true;
-    m_shutdown_requested_cv.notify_one();
-
-    m_shutdown_complete_cv.wait(lock, []{return m_shutdown_complete;});
+    XrdClCurl::Scheduler::Instance().Cancel(m_expiry_task);
 }
@@ -18,7 +18,8 @@
 
 #pragma once
 
-#include <condition_variable>
+#include "../common/XrdClCurlScheduler.hh"
+
 #include <chrono>
 #include <memory>
 #include <mutex>
@@ -61,8 +62,8 @@ private:
 
     static std::string_view GetUrlKey(const std::string &url, std::string &modified_url);
 
-    // Thread for periodically calling the cache expiration.
-    static void ExpireThread();
+    // Periodic task calling the cache expiration.
+    static void ExpireTask();
     static void Shutdown() __attribute__((destructor));
 
     // Lifetime of entries within the broker cache
@@ -80,16 +81,8 @@ private:
     // Singleton instance of the broker cache
     static std::unique_ptr<BrokerCache> m_cache;
 
-    // Mutex for managing the shutdown of the background thread
-    static std::mutex m_shutdown_lock;
-    // Condition variable managing the requested shutdown of the background thread.
-    static std::condition_variable m_shutdown_requested_cv;
-    // Flag indicating that a shutdown was requested.
-    static bool m_shutdown_requested;
-    // Condition variable for the background thread to indicate it has completed.
-    static std::condition_variable m_shutdown_complete_cv;
-    // Flag indicating that the shutdown has completed.
-    static bool m_shutdown_complete;
+    // Scheduler task periodically invoking `Expire` on the cache.
+    static XrdClCurl::Scheduler::TaskId m_expiry_task;
 };
 
 } // namespace Pelican
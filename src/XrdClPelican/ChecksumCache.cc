@@ -18,48 +18,20 @@
 
 #include "ChecksumCache.hh"
 
-#include <thread>
-
 Pelican::ChecksumCache Pelican::ChecksumCache::g_cache;
 std::once_flag Pelican::ChecksumCache::m_expiry_launch;
-std::mutex Pelican::ChecksumCache::m_shutdown_lock;
-std::condition_variable Pelican::ChecksumCache::m_shutdown_requested_cv;
-bool Pelican::ChecksumCache::m_shutdown_requested = false;
-std::condition_variable Pelican::ChecksumCache::m_shutdown_complete_cv;
-bool Pelican::ChecksumCache::m_shutdown_complete = true; // Starts in "true" state as the thread hasn't started
+XrdClCurl::Scheduler::TaskId Pelican::ChecksumCache::m_expiry_task{0};
 
 Pelican::ChecksumCache & Pelican::ChecksumCache::Instance() {
     std::call_once(m_expiry_launch, [] {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_complete = false;
-        }
-        std::thread t(ChecksumCache::ExpireThread);
-        t.detach();
+        m_expiry_task = XrdClCurl::Scheduler::Instance().Schedule("checksum_cache", std::chrono::seconds(5), ChecksumCache::ExpireTask);
     });
     return g_cache;
 }
 
-void Pelican::ChecksumCache::ExpireThread()
+void Pelican::ChecksumCache::ExpireTask()
 {
-    while (true) {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_requested_cv.wait_for(
-                lock,
-                std::chrono::seconds(5),
-                []{return m_shutdown_requested;}
-            );
-            if (m_shutdown_requested) {
-                break;
-            }
-        }
-        auto now = std::chrono::steady_clock::now();
-        g_cache.Expire(now);
-    }
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_complete = true;
-    m_shutdown_complete_cv.notify_one();
+    g_cache.Expire(std::chrono::steady_clock::now());
 }
 
 void Pelican::ChecksumCache::Expire(std::chrono::steady_clock::time_point now)
@@ -82,9 +54,5 @@ void Pelican::ChecksumCache::Expire(std::chrono::steady_clock::time_point now)
 void
 Pelican::ChecksumCache::Shutdown()
 {
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_requested = true;
-    m_shutdown_requested_cv.notify_one();
-
-    m_shutdown_complete_cv.wait(lock, []{return m_shutdown_complete;});
+    XrdClCurl::Scheduler::Instance().Cancel(m_expiry_task);
 }
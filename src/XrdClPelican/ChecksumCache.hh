@@ -19,14 +19,13 @@
 #pragma once
 
 #include "../common/XrdClCurlChecksum.hh"
+#include "../common/XrdClCurlScheduler.hh"
 
 #include <array>
 #include <chrono>
-#include <condition_variable>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
-#include <thread>
 #include <unordered_map>
 
 namespace Pelican {
@@ -166,8 +165,8 @@ private:
     ChecksumCache(const ChecksumCache &) = delete;
     ChecksumCache(ChecksumCache &&) = delete;
 
-    // Background thread periodically invoking `Expire` on the cache.
-    static void ExpireThread();
+    // Periodic task invoking `Expire` on the cache.
+    static void ExpireTask();
 
     static void Shutdown() __attribute__((destructor));
 
@@ -203,16 +202,8 @@ private:
     static std::once_flag m_expiry_launch;
     static ChecksumCache g_cache;
 
-    // Mutex for managing the shutdown of the background thread
-    static std::mutex m_shutdown_lock;
-    // Condition variable managing the requested shutdown of the background thread.
-    static std::condition_variable m_shutdown_requested_cv;
-    // Flag indicating that a shutdown was requested.
-    static bool m_shutdown_requested;
-    // Condition variable for the background thread to indicate it has completed.
-    static std::condition_variable m_shutdown_complete_cv;
-    // Flag indicating that the shutdown has completed.
-    static bool m_shutdown_complete;
+    // Scheduler task periodically invoking `Expire` on the cache.
+    static XrdClCurl::Scheduler::TaskId m_expiry_task;
 };
 
 } // namespace Pelican
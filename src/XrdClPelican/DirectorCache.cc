@@ -18,68 +18,38 @@
 
 #include "DirectorCache.hh"
 
-#include <thread>
 #include <vector>
 
 std::unordered_map<std::string, std::unique_ptr<Pelican::DirectorCache>> Pelican::DirectorCache::m_caches;
 std::shared_mutex Pelican::DirectorCache::m_caches_lock;
 std::once_flag Pelican::DirectorCache::m_expiry_launch;
-std::mutex Pelican::DirectorCache::m_shutdown_lock;
-std::condition_variable Pelican::DirectorCache::m_shutdown_requested_cv;
-bool Pelican::DirectorCache::m_shutdown_requested = false;
-std::condition_variable Pelican::DirectorCache::m_shutdown_complete_cv;
-bool Pelican::DirectorCache::m_shutdown_complete = true; // Starts in "true" state as the thread hasn't started
+XrdClCurl::Scheduler::TaskId Pelican::DirectorCache::m_expiry_task{0};
 
 Pelican::DirectorCache::DirectorCache(const std::chrono::steady_clock::time_point &now) :
     m_root{now}
 {
     std::call_once(m_expiry_launch, [] {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_complete = false;
-        }
-        std::thread t(DirectorCache::ExpireThread);
-        t.detach();
+        m_expiry_task = XrdClCurl::Scheduler::Instance().Schedule("director_cache", std::chrono::seconds(5), DirectorCache::ExpireTask);
     });
 }
 
-void Pelican::DirectorCache::ExpireThread()
+void Pelican::DirectorCache::ExpireTask()
 {
-    while (true) {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_requested_cv.wait_for(
-                lock,
-                std::chrono::seconds(5),
-                []{return m_shutdown_requested;}
-            );
-            if (m_shutdown_requested) {
-                break;
-            }
-        }
-        std::vector<DirectorCache*> dcache;
-        auto now = std::chrono::steady_clock::now();
-        {
-            std::unique_lock lock(m_caches_lock);
-            for (const auto &entry : m_caches) {
-                dcache.push_back(entry.second.get());
-            }
-        }
-        for (const auto &entry : dcache) {
-            entry->Expire(now);
+    std::vector<DirectorCache*> dcache;
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::unique_lock lock(m_caches_lock);
+        for (const auto &entry : m_caches) {
+            dcache.push_back(entry.second.get());
         }
     }
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_complete = true;
-    m_shutdown_complete_cv.notify_one();
+    for (const auto &entry : dcache) {
+        entry->Expire(now);
+    }
 }
 
 void
 Pelican::DirectorCache::Shutdown()
 {
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_requested = true;
-    m_shutdown_requested_cv.notify_one();
-
-    m_shutdown_complete_cv.wait(lock, []{return m_shutdown_complete;});
+    XrdClCurl::Scheduler::Instance().Cancel(m_expiry_task);
 }
@@ -18,19 +18,25 @@
 
 #pragma once
 
+#include "../common/XrdClCurlScheduler.hh"
+
 #include <algorithm>
 #include <chrono>
-#include <condition_variable>
 #include <mutex>
 #include <memory>
 #include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Pelican {
 
 class DirectorCache {
 public:
+    // A mirror URL from a director's Link header and its namespace depth.
+    using Mirror = std::pair<std::string, unsigned>;
+
     static const DirectorCache &GetCache(const std::string &director, const std::chrono::steady_clock::time_point &now=std::chrono::steady_clock::now()) {
         std::shared_lock guard(m_caches_lock);
         const auto iter = m_caches.find(director);
@@ -103,23 +109,66 @@ public:
 
         const std::unique_lock sentry(m_mutex);
 
-        m_root.Put(path_view, url_base, now);
+        m_root.Put(path_view, {std::string(url_base)}, now);
     }
 
+    // Record all the mirrors from a director response, in priority order.  The first
+    // mirror determines the namespace prefix being cached; mirrors that do not share
+    // the same prefix are ignored.
+    void Put(const std::vector<Mirror> &mirrors, const std::chrono::steady_clock::time_point &now=std::chrono::steady_clock::now()) const {
+        if (mirrors.empty()) {
+            return;
+        }
+        auto [path_view, url_base, ok] = ComputePathAndUrl(mirrors[0].first, mirrors[0].second);
+        if (!ok) {
+            return;
+        }
+        std::vector<std::string> bases{std::string(url_base)};
+        for (size_t idx = 1; idx < mirrors.size(); idx++) {
+            auto [mirror_path, mirror_base, mirror_ok] = ComputePathAndUrl(mirrors[idx].first, mirrors[idx].second);
+            if (mirror_ok && mirror_path == path_view) {
+                bases.emplace_back(mirror_base);
+            }
+        }
+
+        const std::unique_lock sentry(m_mutex);
+
+        m_root.Put(path_view, bases, now);
+    }
+
+    // Return the URL of the object at its preferred mirror, or an empty string if
+    // there is no cached mirror for the object.
     std::string Get(const std::string &url, const std::chrono::steady_clock::time_point &now=std::chrono::steady_clock::now()) const {
-        auto loc = url.find("://");
-        if (loc == std::string::npos) {
+        auto path = GetPath(url);
+        if (path.empty()) {
             return "";
         }
-        loc = url.find('/', loc + 3);
-        if (loc == std::string::npos) {
-            return "";
+
+        const std::shared_lock sentry(m_mutex);
+
+        std::string_view remainder;
+        auto entry = m_root.Lookup(path, now, remainder);
+        return entry ? entry->GetUrl(0, remainder) : "";
+    }
+
+    // Return the URLs of the object at each cached mirror, in priority order.
+    std::vector<std::string> GetMirrors(const std::string &url, const std::chrono::steady_clock::time_point &now=std::chrono::steady_clock::now()) const {
+        std::vector<std::string> result;
+        auto path = GetPath(url);
+        if (path.empty()) {
+            return result;
         }
-        auto path = std::string_view(url).substr(loc);
 
         const std::shared_lock sentry(m_mutex);
 
-        return m_root.Get(path, now);
+        std::string_view remainder;
+        auto entry = m_root.Lookup(path, now, remainder);
+        if (entry) {
+            for (size_t idx = 0; idx < entry->GetMirrorCount(); idx++) {
+                result.emplace_back(entry->GetUrl(idx, remainder));
+            }
+        }
+        return result;
     }
 
     void Expire(const std::chrono::steady_clock::time_point &now=std::chrono::steady_clock::now()) {
@@ -132,17 +181,30 @@ private:
 
     DirectorCache(const std::chrono::steady_clock::time_point &now);
 
+    // Return the path component of a URL; empty if there is none.
+    static std::string_view GetPath(const std::string &url) {
+        auto loc = url.find("://");
+        if (loc == std::string::npos) {
+            return "";
+        }
+        loc = url.find('/', loc + 3);
+        if (loc == std::string::npos) {
+            return "";
+        }
+        return std::string_view(url).substr(loc);
+    }
+
     class CacheEntry {
     public:
         CacheEntry(const std::chrono::steady_clock::time_point &now) :
             m_expiry(now + std::chrono::minutes(1))
         {}
 
-        void Put(std::string_view &path, const std::string_view &url, const std::chrono::steady_clock::time_point &now) {
+        void Put(std::string_view &path, const std::vector<std::string> &mirrors, const std::chrono::steady_clock::time_point &now) {
             auto loc = path.find_first_not_of('/');
             m_expiry = now + std::chrono::minutes(1);
             if (loc == std::string_view::npos) {
-                m_value = url;
+                m_mirrors = mirrors;
                 return;
             }
             auto end_loc = path.find_first_of('/', loc);
@@ -150,40 +212,44 @@ private:
             //std::cout << "First entry in put: " << first_entry << std::endl;
             auto [iter, inserted] = m_subdirs.emplace(first_entry, std::make_unique<CacheEntry>(now));
             auto next_path = end_loc == std::string_view::npos ? "" : path.substr(end_loc);
-            iter->second->Put(next_path, url, now);
+            iter->second->Put(next_path, mirrors, now);
         }
 
-        std::string Get(const std::string_view path, const std::chrono::steady_clock::time_point &now) {
-            //std::cout << "Get with path " << path << std::endl;
+        // Find the deepest unexpired entry with mirrors along `path`; on success,
+        // `remainder` is set to the portion of the path below that entry.
+        const CacheEntry *Lookup(const std::string_view path, const std::chrono::steady_clock::time_point &now, std::string_view &remainder) const {
             auto loc = path.find_first_not_of('/');
-            if (loc == std::string_view::npos) {
-                //std::cout << "Returning URL starting with base " << m_value << std::endl;
-                return m_value.empty() ? m_value : (m_value + std::string(path));
-            }
-            auto end_loc = path.find_first_of('/', loc);
-            auto first_entry = path.substr(loc, end_loc - loc);
-            auto iter = m_subdirs.find(std::string(first_entry));
-            if (iter == m_subdirs.end()) {
-                //std::cout << "Returning URL starting with base " << m_value << std::endl; 
-                return m_value.empty() ? m_value : (m_value + std::string(path));
+            if (loc != std::string_view::npos) {
+                auto end_loc = path.find_first_of('/', loc);
+                auto first_entry = path.substr(loc, end_loc - loc);
+                auto iter = m_subdirs.find(std::string(first_entry));
+                // We cannot erase an expired entry here as `Lookup` is called with the
+                // shared lock; it is left for `Expire`.
+                if (iter != m_subdirs.end() && !iter->second->IsExpired(now)) {
+                    auto next_path = end_loc == std::string_view::npos ? "" : path.substr(end_loc);
+                    auto result = iter->second->Lookup(next_path, now, remainder);
+                    if (result) {
+                        return result;
+                    }
+                }
             }
-            if (iter->second->IsExpired(now)) {
-                // We cannot erase the expired entry here as `Get` is called with the shared
-                // lock while we need the
-                return m_value.empty() ? m_value : (m_value + std::string(path));
+            if (m_mirrors.empty()) {
+                return nullptr;
             }
-            auto remainder = end_loc == std::string_view::npos ? "" : path.substr(end_loc);
-            auto result = iter->second->Get(remainder, now);
-            if (result.empty()) {
-                return m_value.empty() ? m_value : (m_value + std::string(path));
-            }
-            return result;
+            remainder = path;
+            return this;
+        }
+
+        size_t GetMirrorCount() const {return m_mirrors.size();}
+
+        std::string GetUrl(size_t idx, const std::string_view remainder) const {
+            return m_mirrors[idx] + std::string(remainder);
         }
 
         void Expire(const std::chrono::steady_clock::time_point &now) {
             std::erase_if(m_subdirs, [&](const auto & item) {return item.second->IsExpired(now);});
             if (IsExpired(now)) {
-                m_value = "";
+                m_mirrors.clear();
             }
         }
 
@@ -193,30 +259,24 @@ private:
 
     private:
         std::unordered_map<std::string, std::unique_ptr<CacheEntry>> m_subdirs;
-        std::string m_value;
+        // Base URLs of the mirrors for this prefix, in priority order.
+        std::vector<std::string> m_mirrors;
         std::chrono::time_point<std::chrono::steady_clock> m_expiry;
     };
 
-    // Invoked on the shutdown of the library, will trigger the background threads
-    // to wrap up and have a clean exit.
+    // Invoked on the shutdown of the library, will cancel the background expiry
+    // task and wait for any in-progress run to finish.
     static void Shutdown() __attribute__((destructor));
 
-    static void ExpireThread();
+    // Periodic task expiring the entries of all the caches.
+    static void ExpireTask();
 
     static std::unordered_map<std::string, std::unique_ptr<DirectorCache>> m_caches;
     static std::shared_mutex m_caches_lock;
     static std::once_flag m_expiry_launch;
 
-    // Mutex for managing the shutdown of the background thread
-    static std::mutex m_shutdown_lock;
-    // Condition variable managing the requested shutdown of the background thread.
-    static std::condition_variable m_shutdown_requested_cv;
-    // Flag indicating that a shutdown was requested.
-    static bool m_shutdown_requested;
-    // Condition variable for the background thread to indicate it has completed.
-    static std::condition_variable m_shutdown_complete_cv;
-    // Flag indicating that the shutdown has completed.
-    static bool m_shutdown_complete;
+    // Scheduler task periodically expiring the entries of all the caches.
+    static XrdClCurl::Scheduler::TaskId m_expiry_task;
 
     mutable CacheEntry m_root;
 
@@ -16,9 +16,11 @@
  *
  ***************************************************************/
 
+#include "../common/XrdClCurlDnsCache.hh"
 #include "../common/XrdClCurlResponses.hh"
 #include "DirectorCache.hh"
 #include "DirectorCacheResponseHandler.hh"
+#include "PelicanFile.hh"
 #include "PelicanFilesystem.hh"
 #include "PelicanHeaders.hh"
 
@@ -59,7 +61,14 @@ void DirectorCacheResponseHandler<ResponseObj, ResponseInfoObj>::HandleResponse(
             auto &value = iter->second[0];
             auto [entries, ok] = LinkEntry::FromHeaderValue(value);
             if (ok && !entries.empty()) {
-                m_dcache->Put(entries[0].GetLink(), entries[0].GetDepth(), now);
+                std::vector<DirectorCache::Mirror> mirrors;
+                mirrors.reserve(entries.size());
+                auto dns_cache = File::GetDnsCache();
+                for (const auto &entry : entries) {
+                    mirrors.emplace_back(entry.GetLink(), entry.GetDepth());
+                    if (dns_cache) dns_cache->Prefetch(entry.GetLink());
+                }
+                m_dcache->Put(mirrors, now);
             }
         }
     }
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include "../common/XrdClCurlPool.hh"
 #include "BrokerCache.hh"
 
 #include <XrdCl/XrdClXRootDResponses.hh>
@@ -33,7 +34,7 @@ namespace Pelican {
 class DirectorCache;
 
 template <class ResponseObj, class ResponseInfoObj>
-class DirectorCacheResponseHandler : public XrdCl::ResponseHandler {
+class DirectorCacheResponseHandler : public XrdCl::ResponseHandler, public XrdClCurl::Pooled {
 public:
     DirectorCacheResponseHandler(const DirectorCache *dcache, XrdCl::Log &log, XrdCl::ResponseHandler *handler)
       : m_bcache(BrokerCache::GetCache()),
@@ -17,17 +17,21 @@
  ***************************************************************/
 
 #include "FedInfo.hh"
+#include "PelicanFile.hh"
 #include "PelicanFilesystem.hh"
+#include "../common/XrdClCurlCAStore.hh"
+#include "../common/XrdClCurlDnsCache.hh"
 #include "XrdClCurl/XrdClCurlVersion.hh"
 
 #include <nlohmann/json.hpp>
 #include <curl/curl.h>
-#include <XrdCl/XrdClDefaultEnv.hh>
 #include <XrdCl/XrdClLog.hh>
 
-#include <thread>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace Pelican;
 
 namespace {
@@ -60,42 +64,45 @@ CURL *GetHandle(bool verbose) {
     if (verbose)
         curl_easy_setopt(result, CURLOPT_VERBOSE, 1L);
 
-    auto env = XrdCl::DefaultEnv::GetEnv();
-    std::string ca_file;
-    if (!env->GetString("CurlCertFile", ca_file) || ca_file.empty()) {
-        char *x509_ca_file = getenv("X509_CERT_FILE");
-        if (x509_ca_file) {
-            ca_file = std::string(x509_ca_file);
-        }
-    }
-    if (!ca_file.empty()) {
-        curl_easy_setopt(result, CURLOPT_CAINFO, ca_file.c_str());
-    }
-    std::string ca_dir;
-    if (!env->GetString("CurlCertDir", ca_dir) || ca_dir.empty()) {
-        char *x509_ca_dir = getenv("X509_CERT_DIR");
-        if (x509_ca_dir) {
-            ca_dir = std::string(x509_ca_dir);
-        }
-    }
-    if (!ca_dir.empty()) {
-        curl_easy_setopt(result, CURLOPT_CAPATH, ca_dir.c_str());
-    }
+    XrdClCurl::CAStore::Instance().ConfigureHandle(result);
     curl_easy_setopt(result, CURLOPT_NOSIGNAL, 1L);
 
     return result;
 }
 
+class SmallCurlBuffer {
+public:
+    SmallCurlBuffer() {}
+
+    static size_t WriteCallback(char *buffer, size_t size, size_t nitems, void *this_ptr) {
+        auto me = reinterpret_cast<SmallCurlBuffer*>(this_ptr);
+        if (size * nitems + me->m_buffer.size() > m_max_size) {
+            return 0;
+        }
+        me->m_buffer += std::string(buffer, size * nitems);
+        return size * nitems;
+    }
+
+    const std::string &Get() const {return m_buffer;}
+private:
+    static const size_t m_max_size = 1024 * 1024;
+    std::string m_buffer;
+};
+
 } // namespace
 
+struct FederationFactory::Lookup {
+    std::string m_federation;
+    bool m_expired{false}; // Set if the cache entry has expired; a failed refresh removes it.
+    CURL *m_handle{nullptr}; // Handle of an outstanding refresh download.
+    SmallCurlBuffer m_buffer;
+    char m_errbuf[CURL_ERROR_SIZE];
+};
+
 std::unique_ptr<FederationFactory> FederationFactory::m_singleton;
 std::once_flag FederationFactory::m_init_once;
 
-std::mutex FederationFactory::m_shutdown_lock;
-std::condition_variable FederationFactory::m_shutdown_requested_cv;
-bool FederationFactory::m_shutdown_requested = false;
-std::condition_variable FederationFactory::m_shutdown_complete_cv;
-bool FederationFactory::m_shutdown_complete = true;
+XrdClCurl::Scheduler::TaskId FederationFactory::m_refresh_task{0};
 
 FederationFactory &
 FederationFactory::GetInstance(XrdCl::Log &logger, const struct timespec &fed_timeout)
@@ -109,85 +116,125 @@ FederationFactory::GetInstance(XrdCl::Log &logger, const struct timespec &fed_ti
 FederationFactory::FederationFactory(XrdCl::Log &logger, const struct timespec &fed_timeout)
     : m_log(logger), m_fed_timeout(fed_timeout)
 {
-    {
-        std::unique_lock lock(m_shutdown_lock);
-        m_shutdown_complete = false;
-    }
-    std::thread refresh_thread(FederationFactory::RefreshThreadStatic, this);
-    refresh_thread.detach();
+    m_log.Debug(kLogXrdClPelican, "Starting background metadata refresh task");
+    m_refresh_task = XrdClCurl::Scheduler::Instance().Schedule("federation_refresh", std::chrono::seconds(60), [this]{RefreshTask();});
 }
 
-void
-FederationFactory::RefreshThreadStatic(FederationFactory *me)
+FederationFactory::~FederationFactory()
 {
-    me->RefreshThread();
+    XrdClCurl::Scheduler::Instance().Cancel(m_refresh_task);
+    StopRefresh();
 }
 
 void
-FederationFactory::RefreshThread()
+FederationFactory::RefreshTask()
 {
-    m_log.Debug(kLogXrdClPelican, "Starting background metadata refresh thread");
-    while (true)
+    // Let the downloads of the previous refresh finish first.
+    if (!m_pending_lookups.empty()) {
+        return;
+    }
+    m_log.Debug(kLogXrdClPelican, "Refreshing Pelican metadata");
+    std::time_t now = time(nullptr);
+
+    // Federations to look up and whether their entry has expired (and must be
+    // removed if the lookup fails).
+    std::vector<std::pair<std::string, bool>> lookups;
     {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_requested_cv.wait_for(
-                lock,
-                std::chrono::seconds(60),
-                []{return m_shutdown_requested;}
-            );
-            if (m_shutdown_requested) {
-                break;
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        for (auto iter = m_info_cache.begin(); iter != m_info_cache.end();) {
+            const auto &info = iter->second;
+            if (info->IsExpired(now)) {
+                // Remove negative cache entries and, instead of renewing them,
+                // entries that aren't frequently used.
+                if (!info->IsValid() || info->TimeSinceLastUse(now) > m_discard_unused_time) {
+                    iter = m_info_cache.erase(iter);
+                    continue;
+                }
+                // Final attempt to update expired entry; delete from cache on failure
+                lookups.emplace_back(iter->first, true);
+            } else if (info->Age(now) > m_stale_time) {
+                // Try to renew once the data is stale.
+                lookups.emplace_back(iter->first, false);
             }
+            ++iter;
         }
-        m_log.Debug(kLogXrdClPelican, "Refreshing Pelican metadata");
-        std::vector<std::pair<std::string, std::shared_ptr<FederationInfo>>> updates;
-        std::vector<std::string> deletions;
-        std::time_t now = time(nullptr);
+    }
+    if (lookups.empty()) {
+        return;
+    }
 
+    if (!m_refresh_multi && !(m_refresh_multi = curl_multi_init())) {
+        m_log.Warning(kLogXrdClPelican, "Failed to create a curl multi handle for refresh task; ignoring error");
+        return;
+    }
+    for (const auto &entry : lookups) {
         auto handle = GetHandle(false);
         if (!handle) {
-            m_log.Warning(kLogXrdClPelican, "Failed to create a curl handle for refresh thread; ignoring error");
-            continue;
+            m_log.Warning(kLogXrdClPelican, "Failed to create a curl handle for refresh task; ignoring error");
+            break;
         }
         curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, m_fed_timeout.tv_sec * 1'000 + m_fed_timeout.tv_nsec / 1'000'000);
         curl_easy_setopt(handle, CURLOPT_FAILONERROR, 1L);
 
-        for (const auto &entry : m_info_cache) {
-            if (entry.second->IsExpired(now) && entry.second->IsValid()) {
-                if (entry.second->TimeSinceLastUse(now) > m_discard_unused_time) {
-                    // If it's not frequently used, instead of renewing it, remove it.
-                    deletions.emplace_back(entry.first);
-                } else {
-                    // Final attempt to update expired entry; delete from cache on failure
-                    std::string err;
-                    auto new_info = LookupInfo(handle, entry.first, err);
-                    if (!new_info) {
-                        m_log.Warning(kLogXrdClPelican, "RefreshThread: Failed to update expired federation %s: %s; will delete the entry", entry.first.c_str(), err.c_str());
-                        deletions.emplace_back(entry.first);
-                    } else {
-                        m_log.Debug(kLogXrdClPelican, "Successfully updated federation metadata for %s", entry.first.c_str());
-                        updates.emplace_back(entry.first, new_info);
-                    }
-                }
-            } else if (entry.second->IsExpired(now) && !entry.second->IsValid()) {
-                // Remove negative cache entry
-                deletions.emplace_back(entry.first);
-            } else if (entry.second->Age(now) > m_stale_time) {
-                // Try to renew once the data is stale.
-                std::string err;
-                auto new_info = LookupInfo(handle, entry.first, err);
-                if (!new_info) {
-                    m_log.Warning(kLogXrdClPelican, "RefreshThread: Failed to update federation %s: %s; will keep the stale entry", entry.first.c_str(), err.c_str());
-                } else {
-                    m_log.Debug(kLogXrdClPelican, "Successfully updated federation metadata for %s", entry.first.c_str());
-                    updates.emplace_back(entry.first, new_info);
-                }
-            }
+        std::unique_ptr<Lookup> lookup(new Lookup());
+        lookup->m_federation = entry.first;
+        lookup->m_expired = entry.second;
+        lookup->m_handle = handle;
+        StartLookup(handle, *lookup);
+        curl_easy_setopt(handle, CURLOPT_PRIVATE, lookup.get());
+        if (curl_multi_add_handle(m_refresh_multi, handle) != CURLM_OK) {
+            m_log.Warning(kLogXrdClPelican, "RefreshTask: Failed to start update of federation %s", entry.first.c_str());
+            curl_easy_cleanup(handle);
+            continue;
         }
+        m_pending_lookups.emplace_back(std::move(lookup));
+    }
+    if (!m_pending_lookups.empty()) {
+        m_poll_task = XrdClCurl::Scheduler::Instance().Schedule("federation_refresh_poll", m_poll_interval, [this]{PollRefresh();});
+    }
+}
 
+void
+FederationFactory::PollRefresh()
+{
+    int running_handles = 0;
+    curl_multi_perform(m_refresh_multi, &running_handles);
+
+    std::vector<std::pair<std::string, std::shared_ptr<FederationInfo>>> updates;
+    std::vector<std::string> deletions;
+    CURLMsg *msg;
+    int msgs_left;
+    while ((msg = curl_multi_info_read(m_refresh_multi, &msgs_left))) {
+        if (msg->msg != CURLMSG_DONE) {
+            continue;
+        }
+        // The message does not survive the removal of its handle.
+        auto handle = msg->easy_handle;
+        auto code = msg->data.result;
+        char *lookup_ptr = nullptr;
+        curl_easy_getinfo(handle, CURLINFO_PRIVATE, &lookup_ptr);
+        auto iter = std::find_if(m_pending_lookups.begin(), m_pending_lookups.end(),
+            [&](const std::unique_ptr<Lookup> &lookup) {return lookup.get() == reinterpret_cast<Lookup *>(lookup_ptr);});
+        if (iter != m_pending_lookups.end()) {
+            auto &lookup = **iter;
+            std::string err;
+            auto new_info = FinishLookup(lookup, code, err);
+            if (new_info->IsValid()) {
+                m_log.Debug(kLogXrdClPelican, "Successfully updated federation metadata for %s", lookup.m_federation.c_str());
+                updates.emplace_back(lookup.m_federation, new_info);
+            } else if (lookup.m_expired) {
+                m_log.Warning(kLogXrdClPelican, "RefreshTask: Failed to update expired federation %s: %s; will delete the entry", lookup.m_federation.c_str(), err.c_str());
+                deletions.emplace_back(lookup.m_federation);
+            } else {
+                m_log.Warning(kLogXrdClPelican, "RefreshTask: Failed to update federation %s: %s; will keep the stale entry", lookup.m_federation.c_str(), err.c_str());
+            }
+            m_pending_lookups.erase(iter);
+        }
+        curl_multi_remove_handle(m_refresh_multi, handle);
         curl_easy_cleanup(handle);
+    }
 
+    if (!updates.empty() || !deletions.empty()) {
         // Bulk update all entries
         std::lock_guard<std::mutex> lock(m_cache_mutex);
         for (const auto &entry : updates) {
@@ -197,9 +244,25 @@ FederationFactory::RefreshThread()
             m_info_cache.erase(entry);
         }
     }
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_complete = true;
-    m_shutdown_complete_cv.notify_one();
+
+    if (m_pending_lookups.empty()) {
+        XrdClCurl::Scheduler::Instance().Cancel(m_poll_task.exchange(0));
+    }
+}
+
+void
+FederationFactory::StopRefresh()
+{
+    XrdClCurl::Scheduler::Instance().Cancel(m_poll_task.exchange(0));
+    for (const auto &lookup : m_pending_lookups) {
+        curl_multi_remove_handle(m_refresh_multi, lookup->m_handle);
+        curl_easy_cleanup(lookup->m_handle);
+    }
+    m_pending_lookups.clear();
+    if (m_refresh_multi) {
+        curl_multi_cleanup(m_refresh_multi);
+        m_refresh_multi = nullptr;
+    }
 }
 
 std::shared_ptr<FederationInfo>
@@ -238,64 +301,53 @@ FederationInfo::GetDirector() const
     return m_director;
 }
 
-namespace {
+std::shared_ptr<FederationInfo>
+FederationFactory::LookupInfo(CURL *handle, const std::string &federation, std::string &err)
+{
+    Lookup lookup;
+    lookup.m_federation = federation;
+    StartLookup(handle, lookup);
+    auto code = curl_easy_perform(handle);
+    return FinishLookup(lookup, code, err);
+}
 
-class SmallCurlBuffer {
-public:
-    SmallCurlBuffer() {}
+void
+FederationFactory::StartLookup(CURL *handle, Lookup &lookup)
+{
+    m_log.Info(kLogXrdClPelican, "Looking up federation metadata for URL %s", lookup.m_federation.c_str());
 
-    static size_t WriteCallback(char *buffer, size_t size, size_t nitems, void *this_ptr) {
-        auto me = reinterpret_cast<SmallCurlBuffer*>(this_ptr);
-        if (size * nitems + me->m_buffer.size() > m_max_size) {
-            return 0;
-        }
-        me->m_buffer += std::string(buffer, size * nitems);
-        return size * nitems;
-    }
+    std::string federation_url = "https://" + lookup.m_federation + "/.well-known/pelican-configuration";
+    curl_easy_setopt(handle, CURLOPT_URL, federation_url.c_str());
 
-    const std::string &Get() const {return m_buffer;}
-private:
-    static const size_t m_max_size = 1024 * 1024;
-    std::string m_buffer;
-};
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, SmallCurlBuffer::WriteCallback);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &lookup.m_buffer);
 
+    lookup.m_errbuf[0] = '\0';
+    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, lookup.m_errbuf);
 }
 
 std::shared_ptr<FederationInfo>
-FederationFactory::LookupInfo(CURL *handle, const std::string &federation, std::string &err)
+FederationFactory::FinishLookup(Lookup &lookup, int code, std::string &err)
 {
-    m_log.Info(kLogXrdClPelican, "Looking up federation metadata for URL %s", federation.c_str());
-
     auto now = time(nullptr);
     std::shared_ptr<FederationInfo> result(new FederationInfo(now));
 
-    std::string federation_url = "https://" + federation + "/.well-known/pelican-configuration";
-    curl_easy_setopt(handle, CURLOPT_URL, federation_url.c_str());
-
-    SmallCurlBuffer sbuff;
-    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, SmallCurlBuffer::WriteCallback);
-    curl_easy_setopt(handle, CURLOPT_WRITEDATA, &sbuff);
-
-    char errbuf[CURL_ERROR_SIZE];
-    curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, errbuf);
-
-    auto code = curl_easy_perform(handle);
     if (code != CURLE_OK) {
-        auto len = strlen(errbuf);
+        auto len = strlen(lookup.m_errbuf);
         if (len) {
-            err = errbuf;
+            err = lookup.m_errbuf;
         } else {
-            err = curl_easy_strerror(code);
+            err = curl_easy_strerror(static_cast<CURLcode>(code));
         }
         return result;
     }
-    auto results = sbuff.Get();
+    auto results = lookup.m_buffer.Get();
     if (!results.size()) {
         err = "Federation metadata discovery URL returned an empty response";
         return result;
     }
 
-    m_log.Debug(kLogXrdClPelican, "Federation %s metadata discovery lookup successful", federation.c_str());
+    m_log.Debug(kLogXrdClPelican, "Federation %s metadata discovery lookup successful", lookup.m_federation.c_str());
 
     nlohmann::json jobj;
     try {
@@ -311,6 +363,10 @@ FederationFactory::LookupInfo(CURL *handle, const std::string &federation, std::
     } catch (nlohmann::json::exception &jexc) {
         err = std::string("Error when fetching the director_endpoint string from metedata JSON: ") + jexc.what();
     }
+    // Keep the director's address warm; every uncached open starts there.
+    if (auto dns_cache = File::GetDnsCache(); dns_cache && !director.empty()) {
+        dns_cache->Prefetch(director);
+    }
     result.reset(new FederationInfo(director, now));
     return result;
 }
@@ -318,9 +374,8 @@ FederationFactory::LookupInfo(CURL *handle, const std::string &federation, std::
 void
 FederationFactory::Shutdown()
 {
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_requested = true;
-    m_shutdown_requested_cv.notify_one();
-
-    m_shutdown_complete_cv.wait(lock, []{return m_shutdown_complete;});
+    XrdClCurl::Scheduler::Instance().Cancel(m_refresh_task);
+    if (m_singleton) {
+        m_singleton->StopRefresh();
+    }
 }
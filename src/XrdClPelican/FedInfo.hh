@@ -19,22 +19,27 @@
 /**
  * The "FedInfo" classes return metadata about a Pelican federation.
  * The instances are heavily cached (and the caches periodically updated
- * in a separate thread), allowing efficient lookups for popular federations.
+ * by the background scheduler), allowing efficient lookups for popular federations.
 */
 
 #pragma once
+
+#include "../common/XrdClCurlScheduler.hh"
+
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // Forward dec'ls
 namespace XrdCl {
         class Log;
 }
 typedef void CURL;
+typedef void CURLM;
 
 namespace Pelican {
 
@@ -60,17 +65,36 @@ public:
     // Start attempting to renew once the data is at least this age.
     static const int m_stale_time = 15 * 60;
 
+    ~FederationFactory();
+
 private:
     FederationFactory(XrdCl::Log &logger, const struct timespec &fed_timeout);
 
-    // Background thread to periodically refresh the contents of the federation cache
-    void RefreshThread();
-    static void RefreshThreadStatic(FederationFactory *me);
+    // A single download of a federation's metadata.
+    struct Lookup;
+
+    // Periodic task refreshing the contents of the federation cache.
+    //
+    // Runs on the shared scheduler thread, so it never waits on the network: it
+    // drops the unused entries, starts the downloads of the stale ones on the
+    // refresh multi handle, and registers `PollRefresh` to drive them.
+    void RefreshTask();
+    // Scheduler task registered while refresh downloads are outstanding; advances
+    // them without blocking and applies the finished ones to the cache.
+    void PollRefresh();
+    // Cancels the refresh polling and abandons any outstanding downloads.
+    void StopRefresh();
     static void Shutdown() __attribute__((destructor));
 
     // Internal lookup function for a federation; no caching involved
     std::shared_ptr<FederationInfo> LookupInfo(CURL *, const std::string &federation, std::string &err);
 
+    // Prepare `handle` to download the metadata for the lookup's federation.
+    void StartLookup(CURL *handle, Lookup &lookup);
+    // Parse the result of a finished download; returns a negative cache entry
+    // (and sets `err`) on failure.
+    std::shared_ptr<FederationInfo> FinishLookup(Lookup &lookup, int code, std::string &err);
+
     XrdCl::Log &m_log;
 
     // Timeout for the federation metadata lookup operation
@@ -82,16 +106,18 @@ private:
     std::mutex m_cache_mutex;
     std::unordered_map<std::string, std::shared_ptr<FederationInfo>> m_info_cache;
 
-    // Mutex for managing the shutdown of the background thread
-    static std::mutex m_shutdown_lock;
-    // Condition variable managing the requested shutdown of the background thread.
-    static std::condition_variable m_shutdown_requested_cv;
-    // Flag indicating that a shutdown was requested.
-    static bool m_shutdown_requested;
-    // Condition variable for the background thread to indicate it has completed.
-    static std::condition_variable m_shutdown_complete_cv;
-    // Flag indicating that the shutdown has completed.
-    static bool m_shutdown_complete;
+    // Scheduler task periodically refreshing the federation cache.
+    static XrdClCurl::Scheduler::TaskId m_refresh_task;
+
+    // Interval at which outstanding refresh downloads are driven.
+    static constexpr std::chrono::milliseconds m_poll_interval{100};
+
+    // State of the in-progress refresh; only used from the scheduler thread
+    // (and by StopRefresh once the refresh tasks are cancelled).
+    CURLM *m_refresh_multi{nullptr};
+    std::vector<std::unique_ptr<Lookup>> m_pending_lookups;
+    // Scheduler task driving the outstanding downloads; zero if there are none.
+    std::atomic<XrdClCurl::Scheduler::TaskId> m_poll_task{0};
 };
 
 
@@ -26,7 +26,6 @@
 #include <XrdCl/XrdClPlugInInterface.hh>
 
 #include <fstream>
-#include <thread>
 
 XrdVERSIONINFO(XrdClGetPlugIn, XrdClGetPlugIn)
 
@@ -38,11 +37,8 @@ std::string PelicanFactory::m_token_contents;
 std::string PelicanFactory::m_token_file;
 std::mutex PelicanFactory::m_token_mutex;
 std::once_flag PelicanFactory::m_init_once;
-std::mutex PelicanFactory::m_shutdown_lock;
-std::condition_variable PelicanFactory::m_shutdown_requested_cv;
-bool PelicanFactory::m_shutdown_requested = false;
-std::condition_variable PelicanFactory::m_shutdown_complete_cv;
-bool PelicanFactory::m_shutdown_complete = true;
+XrdClCurl::Scheduler::TaskId PelicanFactory::m_token_task{0};
+std::once_flag PelicanFactory::m_token_task_once;
 
 namespace {
 
@@ -150,40 +146,12 @@ PelicanFactory::PelicanFactory() {
         env->GetString("PelicanCacheTokenLocation", m_token_file);
         if (!m_token_file.empty()) {
             RefreshToken();
-            {
-                std::unique_lock lock(m_shutdown_lock);
-                m_shutdown_complete = false;
-            }
-            std::thread t(PelicanFactory::CacheTokenThread);
-
-            t.detach();
         }
         m_initialized = true;
     });
 }
 
 
-void
-PelicanFactory::CacheTokenThread() {
-    while (true) {
-        {
-            std::unique_lock lock(m_shutdown_lock);
-            m_shutdown_requested_cv.wait_for(
-                lock,
-                std::chrono::seconds(15),
-                []{return m_shutdown_requested;}
-            );
-            if (m_shutdown_requested) {
-                break;
-            }
-        }
-        RefreshToken();
-    }
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_complete = true;
-    m_shutdown_complete_cv.notify_one();
-}
-
 void
 PelicanFactory::RefreshToken() {
     std::string token_contents, token_file;
@@ -259,24 +227,33 @@ PelicanFactory::SetupX509() {
 }
 
 void
-PelicanFactory::Shutdown()
+PelicanFactory::StartTokenTask()
 {
-    std::unique_lock lock(m_shutdown_lock);
-    m_shutdown_requested = true;
-    m_shutdown_requested_cv.notify_one();
+    std::call_once(m_token_task_once, [] {
+        std::unique_lock lock(m_token_mutex);
+        if (!m_token_file.empty()) {
+            m_token_task = XrdClCurl::Scheduler::Instance().Schedule("cache_token", std::chrono::seconds(15), PelicanFactory::RefreshToken);
+        }
+    });
+}
 
-    m_shutdown_complete_cv.wait(lock, []{return m_shutdown_complete;});
+void
+PelicanFactory::Shutdown()
+{
+    XrdClCurl::Scheduler::Instance().Cancel(m_token_task);
 }
 
 XrdCl::FilePlugIn *
 PelicanFactory::CreateFile(const std::string & /*url*/) {
     if (!m_initialized) {return nullptr;}
+    StartTokenTask();
     return new Pelican::File(m_log);
 }
 
 XrdCl::FileSystemPlugIn *
 PelicanFactory::CreateFileSystem(const std::string & url) {
     if (!m_initialized) {return nullptr;}
+    StartTokenTask();
     return new Pelican::Filesystem(url, m_log);
 }
 
@@ -17,9 +17,10 @@
  *
  ***************************************************************/
 
+#include "../common/XrdClCurlScheduler.hh"
+
 #include <XrdCl/XrdClPlugInInterface.hh>
 
-#include <condition_variable>
 #include <mutex>
 #include <utility>
 
@@ -51,8 +52,10 @@ private:
     // Read filename to fetch a new cache token
     static std::pair<bool, std::string> ReadCacheToken(const std::string &token_location, XrdCl::Log *log);
 
-    // Periodically read the cache token, update the in-memory token contents
-    static void CacheTokenThread();
+    // Start the periodic token reload; deferred until the first file or filesystem
+    // is created so loading the plugin does not start the background thread.
+    static void StartTokenTask();
+
     static void Shutdown() __attribute__((destructor));
 
     static bool m_initialized;
@@ -63,16 +66,9 @@ private:
     static std::string m_token_file; // Location of the cache token.
     static std::mutex m_token_mutex; // Mutex protecting the m_token_contents & m_token_file
 
-    // Mutex for managing the shutdown of the background thread
-    static std::mutex m_shutdown_lock;
-    // Condition variable managing the requested shutdown of the background thread.
-    static std::condition_variable m_shutdown_requested_cv;
-    // Flag indicating that a shutdown was requested.
-    static bool m_shutdown_requested;
-    // Condition variable for the background thread to indicate it has completed.
-    static std::condition_variable m_shutdown_complete_cv;
-    // Flag indicating that the shutdown has completed.
-    static bool m_shutdown_complete;
+    // Scheduler task periodically reloading the cache token.
+    static XrdClCurl::Scheduler::TaskId m_token_task;
+    static std::once_flag m_token_task_once;
 };
 
 }
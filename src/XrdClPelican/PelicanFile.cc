@@ -17,7 +17,10 @@
  ***************************************************************/
 
 #include "../common/XrdClCurlConnectionCallout.hh"
+#include "../common/XrdClCurlDnsCache.hh"
+#include "../common/XrdClCurlPool.hh"
 #include "../common/XrdClCurlResponses.hh"
+#include "../common/XrdClCurlScoreboard.hh"
 #include "ConnectionBroker.hh"
 #include "FedInfo.hh"
 #include "../common/XrdClCurlParseTimeout.hh"
@@ -40,10 +43,12 @@ using namespace Pelican;
 File *File::m_first = nullptr;
 std::mutex File::m_list_mutex;
 std::string File::m_query_params;
+std::atomic<XrdClCurl::Scoreboard *> File::m_scoreboard{nullptr};
+std::atomic<XrdClCurl::DnsCache *> File::m_dns_cache{nullptr};
 
 namespace {
 
-class OpenResponseHandler : public XrdCl::ResponseHandler {
+class OpenResponseHandler : public XrdCl::ResponseHandler, public XrdClCurl::Pooled {
 public:
     OpenResponseHandler(bool *is_opened, XrdCl::ResponseHandler *handler)
         : m_is_opened(is_opened),
@@ -72,6 +77,24 @@ private:
     XrdCl::ResponseHandler *m_handler;
 };
 
+// Load into `ptr` the address of an object the curl plugin publishes (in hex) as
+// the file property `name`, if not already loaded.
+template<typename T>
+void LoadCurlObject(XrdCl::File &file, const std::string &name, std::atomic<T *> &ptr)
+{
+    if (ptr.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::string value;
+    if (!file.GetProperty(name, value) || value.empty()) {
+        return;
+    }
+    try {
+        auto pointer = std::stoull(value, nullptr, 16);
+        ptr.store(reinterpret_cast<T *>(pointer), std::memory_order_release);
+    } catch (...) {}
+}
+
 } // namespace
 
 // Note: these values are typically overwritten by `PelicanFactory::PelicanFactory`;
@@ -201,7 +224,8 @@ File::Open(const std::string      &url,
 
     auto dcache = &DirectorCache::GetCache(ss.str());
 
-    if ((m_url = dcache->Get(url.c_str())).empty()) {
+    auto mirrors = dcache->GetMirrors(url);
+    if (mirrors.empty()) {
         m_logger->Debug(kLogXrdClPelican, "No cached origin URL available for %s", url.c_str());
         auto info = factory.GetInfo(ss.str(), err);
         if (!info) {
@@ -212,7 +236,18 @@ File::Open(const std::string      &url,
         }
         m_url = info->GetDirector() + "/api/v1.0/director/origin/" + pelican_url.GetPathWithParams();
     } else {
-        m_logger->Debug(kLogXrdClPelican, "Using cached origin URL %s", m_url.c_str());
+        m_url = mirrors[0];
+        // The scoreboard comes from the curl plugin, which is only loaded by the
+        // no-op open below; load it now so the first open ranks the mirrors too.
+        if (mirrors.size() > 1 && !m_scoreboard.load(std::memory_order_acquire)) {
+            m_wrapped_file->Open(m_url, XrdCl::OpenFlags::Compress, XrdCl::Access::None, nullptr, Pelican::File::timeout_t(0));
+            LoadCurlObject(*m_wrapped_file, "XrdClCurlScoreboard", m_scoreboard);
+        }
+        auto scoreboard = m_scoreboard.load(std::memory_order_acquire);
+        if (scoreboard && mirrors.size() > 1) {
+            m_url = mirrors[scoreboard->Rank(mirrors)[0]];
+        }
+        m_logger->Debug(kLogXrdClPelican, "Using cached origin URL %s (of %zu mirrors)", m_url.c_str(), mirrors.size());
         dcache = nullptr;
     }
 
@@ -227,6 +262,15 @@ File::Open(const std::string      &url,
     wrapped_handler.reset(new OpenResponseHandler(&m_is_opened, wrapped_handler.release()));
 
     auto status = m_wrapped_file->Open(m_url, XrdCl::OpenFlags::Compress, XrdCl::Access::None, nullptr, Pelican::File::timeout_t(0));
+    LoadCurlObject(*m_wrapped_file, "XrdClCurlScoreboard", m_scoreboard);
+    LoadCurlObject(*m_wrapped_file, "XrdClCurlDnsCache", m_dns_cache);
+    LoadCurlObject(*m_wrapped_file, "XrdClCurlFilePlugIn", m_direct_file);
+    // Warm up the addresses of the mirrors we did not pick, in case we fail over.
+    if (auto dns_cache = m_dns_cache.load(std::memory_order_acquire)) {
+        for (const auto &mirror : mirrors) {
+            dns_cache->Prefetch(mirror);
+        }
+    }
     XrdClCurl::CreateConnCalloutType callout = ConnectionBroker::CreateCallback;
     auto callout_loc = reinterpret_cast<long long>(callout);
     size_t buf_size = 12;
@@ -306,6 +350,9 @@ File::Read(uint64_t                offset,
            XrdCl::ResponseHandler *handler,
            timeout_t               timeout)
 {
+    if (auto direct_file = m_direct_file.load(std::memory_order_acquire)) {
+        return direct_file->Read(offset, size, buffer, handler, timeout);
+    }
     return m_wrapped_file->Read(offset, size, buffer, handler, timeout);
 }
 
@@ -315,6 +362,9 @@ File::VectorRead(const XrdCl::ChunkList &chunks,
                  XrdCl::ResponseHandler *handler,
                  timeout_t               timeout )
 {
+    if (auto direct_file = m_direct_file.load(std::memory_order_acquire)) {
+        return direct_file->VectorRead(chunks, buffer, handler, timeout);
+    }
     return m_wrapped_file->VectorRead(chunks, buffer, handler, timeout);
 }
 
@@ -325,6 +375,9 @@ File::Write(uint64_t                offset,
             XrdCl::ResponseHandler *handler,
             timeout_t               timeout)
 {
+    if (auto direct_file = m_direct_file.load(std::memory_order_acquire)) {
+        return direct_file->Write(offset, size, buffer, handler, timeout);
+    }
     return m_wrapped_file->Write(offset, size, buffer, handler, timeout);
 }
 
@@ -334,6 +387,9 @@ File::Write(uint64_t                offset,
             XrdCl::ResponseHandler *handler,
             timeout_t               timeout)
 {
+    if (auto direct_file = m_direct_file.load(std::memory_order_acquire)) {
+        return direct_file->Write(offset, std::move(buffer), handler, timeout);
+    }
     return m_wrapped_file->Write(offset, std::move(buffer), handler, timeout);
 }
 
@@ -344,6 +400,9 @@ File::PgRead(uint64_t                offset,
              XrdCl::ResponseHandler *handler,
              timeout_t               timeout)
 {
+    if (auto direct_file = m_direct_file.load(std::memory_order_acquire)) {
+        return direct_file->PgRead(offset, size, buffer, handler, timeout);
+    }
     return m_wrapped_file->PgRead(offset, size, buffer, handler, timeout);
 }
 
@@ -383,6 +442,11 @@ File::SetProperty(const std::string &name,
         PelicanFactory::RefreshToken();
         return true;
     }
+    // Local upload sources, download destinations and upload checksums are handled
+    // by the wrapped file.
+    if ((!name.compare(0, 15, "XrdClCurlUpload") || !name.compare(0, 17, "XrdClCurlDownload")) && m_wrapped_file) {
+        return m_wrapped_file->SetProperty(name, value);
+    }
     m_properties[name] = value;
     return true;
 }
@@ -391,8 +455,8 @@ bool
 File::GetProperty(const std::string &name,
                         std::string &value) const
 {
-    if (name == "LastURL" || name == "CurrentURL") {
-        return m_wrapped_file->GetProperty(name, value);
+    if (name == "LastURL" || name == "CurrentURL" || name == "XrdClCurlUploadChecksumValue") {
+        return m_wrapped_file && m_wrapped_file->GetProperty(name, value);
     }
     const auto p = m_properties.find(name);
     if (p == std::end(m_properties)) {
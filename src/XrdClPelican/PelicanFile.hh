@@ -21,6 +21,7 @@
 #include <XrdCl/XrdClFile.hh>
 #include <XrdCl/XrdClPlugInInterface.hh>
 
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 #include <string>
@@ -32,6 +33,13 @@ class Log;
 
 }
 
+namespace XrdClCurl {
+
+class DnsCache;
+class Scoreboard;
+
+}
+
 namespace Pelican {
 
 class DirectorCache;
@@ -132,6 +140,9 @@ public:
 
     // Set the cache token value
     static void SetCacheToken(const std::string &token);
+
+    // Returns the curl plugin's DNS cache; nullptr until the first file is opened.
+    static XrdClCurl::DnsCache *GetDnsCache() {return m_dns_cache.load(std::memory_order_acquire);}
 private:
     bool m_is_opened{false};
 
@@ -159,6 +170,9 @@ private:
 
     std::unique_ptr<XrdCl::File> m_wrapped_file;
 
+    // The curl plugin's handle inside m_wrapped_file, if it published one; data
+    // operations are issued on it directly, skipping the XrdCl::File layer.
+    std::atomic<XrdCl::FilePlugIn *> m_direct_file{nullptr};
 
     // Linked list for tracking live files.
     //
@@ -174,6 +188,14 @@ private:
     static std::mutex m_list_mutex;
     // Value of the query parameters
     static std::string m_query_params;
+
+    // The curl plugin's endpoint scoreboard, used to rank the director's mirrors.
+    // Obtained from the curl plugin on the first open; until then, the director's
+    // order is used.
+    static std::atomic<XrdClCurl::Scoreboard *> m_scoreboard;
+
+    // The curl plugin's DNS cache, used to pre-resolve the director and its mirrors.
+    static std::atomic<XrdClCurl::DnsCache *> m_dns_cache;
 };
 
 }
@@ -19,6 +19,7 @@
 #include "ChecksumCache.hh"
 #include "ConnectionBroker.hh"
 #include "../common/XrdClCurlConnectionCallout.hh"
+#include "../common/XrdClCurlDnsCache.hh"
 #include "../common/XrdClCurlResponses.hh"
 #include "DirectorCache.hh"
 #include "DirectorCacheResponseHandler.hh"
@@ -99,6 +100,91 @@ private:
     const std::string m_url;
 };
 
+// Respond to a locate request with the given object URLs, in priority order.
+void RespondWithLocations(XrdCl::ResponseHandler *handler, const std::vector<std::string> &urls)
+{
+    if (!handler) return;
+
+    auto locateInfo = std::make_unique<XrdCl::LocationInfo>();
+    for (const auto &url : urls) {
+        locateInfo->Add(XrdCl::LocationInfo::Location(url, XrdCl::LocationInfo::ServerOnline, XrdCl::LocationInfo::Read));
+    }
+    auto obj = std::make_unique<XrdCl::AnyObject>();
+    obj->Set(locateInfo.release());
+    handler->HandleResponse(new XrdCl::XRootDStatus(), obj.release());
+}
+
+// Converts the response of a stat against the director into a locate response
+// listing each mirror from the director's Link header, in priority order.  The
+// mirrors are also recorded in the director cache for subsequent operations.
+class LocateResponseHandler : public XrdCl::ResponseHandler {
+public:
+    LocateResponseHandler(const DirectorCache *dcache, XrdCl::ResponseHandler *handler, XrdCl::Log &log, const std::string &fallback)
+        : m_dcache(dcache),
+        m_handler(handler),
+        m_log(log),
+        m_fallback(fallback)
+    {}
+
+    virtual void HandleResponse(XrdCl::XRootDStatus *status_raw, XrdCl::AnyObject *response_raw) {
+        std::unique_ptr<LocateResponseHandler> owner(this);
+        std::unique_ptr<XrdCl::XRootDStatus> status(status_raw);
+        std::unique_ptr<XrdCl::AnyObject> response(response_raw);
+
+        if (!status || !status->IsOK()) {
+            if (m_handler) m_handler->HandleResponse(status.release(), nullptr);
+            return;
+        }
+        XrdCl::StatInfo *stat_info{nullptr};
+        if (response) response->Get(stat_info);
+
+        std::vector<std::string> urls;
+        if (stat_info) {
+            auto info = static_cast<XrdClCurl::StatResponse*>(stat_info)->GetResponseInfo();
+            const XrdClCurl::ResponseInfo::HeaderResponses empty;
+            auto &responses = info ? info->GetHeaderResponse() : empty;
+            if (!responses.empty()) {
+                auto &headers = responses[0];
+                auto iter = headers.find("Link");
+                if (iter != headers.end() && !iter->second.empty()) {
+                    auto [entries, ok] = LinkEntry::FromHeaderValue(iter->second[0]);
+                    if (ok) {
+                        std::vector<DirectorCache::Mirror> mirrors;
+                        auto dns_cache = File::GetDnsCache();
+                        for (const auto &entry : entries) {
+                            urls.emplace_back(entry.GetLink());
+                            mirrors.emplace_back(entry.GetLink(), entry.GetDepth());
+                            if (dns_cache) dns_cache->Prefetch(entry.GetLink());
+                        }
+                        if (m_dcache) m_dcache->Put(mirrors);
+                    }
+                }
+                // Without a Link header, the only known location is the redirect target.
+                iter = headers.find("Location");
+                if (urls.empty() && iter != headers.end() && !iter->second.empty()) {
+                    urls.emplace_back(iter->second[0]);
+                }
+            }
+        }
+        if (urls.empty()) {
+            m_log.Debug(kLogXrdClPelican, "Director did not return any mirrors for %s", m_fallback.c_str());
+            urls.emplace_back(m_fallback);
+        }
+        RespondWithLocations(m_handler, urls);
+    }
+
+private:
+    const DirectorCache *m_dcache;
+
+    // A reference to the handler we are wrapping.  Note we don't own the handler
+    // so this is not a unique_ptr.
+    XrdCl::ResponseHandler *m_handler;
+
+    XrdCl::Log &m_log;
+    // Location returned if the response has no information about the mirrors.
+    const std::string m_fallback;
+};
+
 } // namespace
 
 Filesystem::Filesystem(const std::string &url, XrdCl::Log *log) :
@@ -237,6 +323,15 @@ Filesystem::Locate(const std::string        &path,
                    XrdCl::ResponseHandler   *handler,
                    timeout_t                 timeout)
 {
+    // Answer from the director cache if it has the mirrors for this object.
+    auto director = m_url.GetHostName() + ":" + std::to_string(m_url.GetPort());
+    auto mirrors = DirectorCache::GetCache(director).GetMirrors(m_url.GetProtocol() + "://" + director + "/" + path);
+    if (!mirrors.empty()) {
+        m_logger->Debug(kLogXrdClPelican, "Filesystem::Locate using %zu cached mirrors for %s", mirrors.size(), path.c_str());
+        RespondWithLocations(handler, mirrors);
+        return XrdCl::XRootDStatus();
+    }
+
     const DirectorCache *dcache{nullptr};
     std::string full_path;
     XrdCl::FileSystem *http_fs{nullptr};
@@ -245,8 +340,18 @@ Filesystem::Locate(const std::string        &path,
     if (!st.IsOK()) {
         return st;
     }
+
+    // Query the director; the mirrors are in the Link header of its redirect response.
+    std::unique_ptr<XrdCl::ResponseHandler> wrapped_handler(
+        new LocateResponseHandler(dcache, handler, *m_logger, m_url.GetProtocol() + "://" + director + "/" + path)
+    );
+
     m_logger->Debug(kLogXrdClPelican, "Filesystem::Locate path %s", full_path.c_str());
-    return http_fs->Locate(full_path, flags, handler, ts.tv_sec);
+    st = http_fs->Stat(full_path, wrapped_handler.get(), ts.tv_sec);
+    if (st.IsOK()) {
+        wrapped_handler.release();
+    }
+    return st;
 }
 
 XrdCl::XRootDStatus
@@ -259,6 +259,8 @@ XrdClS3::DownloadUrl(const std::string &url, XrdClCurl::HeaderCallout *header_ca
         }
     }
     http_file->SetProperty("XrdClCurlFullDownload", "true");
+    // The downloads are XML listings, which compress well; allow a compressed transfer.
+    http_file->SetProperty("XrdClCurlAcceptEncoding", "true");
 
     auto http_file_raw = http_file.get();
     S3DownloadHandler *downloadHandler = new S3DownloadHandler(std::move(http_file), handler, timeout);
@@ -105,6 +105,11 @@ bool
 File::GetProperty(const std::string &name,
                   std::string &value) const
 {
+    // The checksum of an upload is computed by the wrapped file.
+    if (name == "XrdClCurlUploadChecksumValue") {
+        return m_wrapped_file && m_wrapped_file->GetProperty(name, value);
+    }
+
     std::unique_lock lock(m_properties_mutex);
     const auto p = m_properties.find(name);
     if (p == std::end(m_properties)) {
@@ -160,6 +165,21 @@ File::GetFileHandle(const std::string &s3_url) {
     if (!wrapped_file->SetProperty("XrdClCurlHeaderCallout", ss.str())) {
         return std::make_tuple(XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errInvalidAddr, 0, "Failed to setup header callout"), "", nullptr);
     }
+    // Upload checksums are sent in the headers S3 understands; the checksum type itself
+    // may be chosen by the caller on this handle.
+    wrapped_file->SetProperty("XrdClCurlUploadChecksumStyle", "s3");
+    std::string checksum;
+    if (GetProperty("XrdClCurlUploadChecksum", checksum)) {
+        wrapped_file->SetProperty("XrdClCurlUploadChecksum", checksum);
+    }
+    // Don't keep a pointer into a previously wrapped handle if this one isn't ours.
+    m_direct_file = nullptr;
+    std::string direct_file;
+    if (wrapped_file->GetProperty("XrdClCurlFilePlugIn", direct_file) && !direct_file.empty()) {
+        try {
+            m_direct_file = reinterpret_cast<XrdCl::FilePlugIn *>(std::stoull(direct_file, nullptr, 16));
+        } catch (...) {}
+    }
     m_wrapped_file.reset(wrapped_file.release());
 
     return std::make_tuple(XrdCl::XRootDStatus{}, https_url, m_wrapped_file.get());
@@ -192,6 +212,9 @@ File::PgRead(uint64_t                offset,
              XrdCl::ResponseHandler *handler,
              timeout_t               timeout)
 {
+    if (m_direct_file) {
+        return m_direct_file->PgRead(offset, size, buffer, handler, timeout);
+    }
     return m_wrapped_file->PgRead(offset, size, buffer, handler, timeout);
 }
 
@@ -202,7 +225,9 @@ File::Read(uint64_t                offset,
            XrdCl::ResponseHandler *handler,
            timeout_t               timeout)
 {
-
+    if (m_direct_file) {
+        return m_direct_file->Read(offset, size, buffer, handler, timeout);
+    }
     return m_wrapped_file->Read(offset, size, buffer, handler, timeout);
 }
 
@@ -210,6 +235,11 @@ bool
 File::SetProperty(const std::string &name,
                   const std::string &value)
 {
+    // Local upload sources, download destinations and upload checksums are handled
+    // by the wrapped file.
+    if ((!name.compare(0, 15, "XrdClCurlUpload") || !name.compare(0, 17, "XrdClCurlDownload")) && m_wrapped_file) {
+        return m_wrapped_file->SetProperty(name, value);
+    }
     std::unique_lock lock(m_properties_mutex);
     m_properties[name] = value;
     return true;
@@ -229,6 +259,9 @@ File::VectorRead(const XrdCl::ChunkList &chunks,
                  XrdCl::ResponseHandler *handler,
                  timeout_t               timeout )
 {
+    if (m_direct_file) {
+        return m_direct_file->VectorRead(chunks, buffer, handler, timeout);
+    }
     return m_wrapped_file->VectorRead(chunks, buffer, handler, timeout);
 }
 
@@ -239,6 +272,9 @@ File::Write(uint64_t            offset,
             XrdCl::ResponseHandler *handler,
             timeout_t               timeout)
 {
+    if (m_direct_file) {
+        return m_direct_file->Write(offset, size, buffer, handler, timeout);
+    }
     return m_wrapped_file->Write(offset, size, buffer, handler, timeout);
 }
 
@@ -248,6 +284,9 @@ File::Write(uint64_t             offset,
             XrdCl::ResponseHandler  *handler,
             timeout_t                timeout)
 {
+    if (m_direct_file) {
+        return m_direct_file->Write(offset, std::move(buffer), handler, timeout);
+    }
     return m_wrapped_file->Write(offset, std::move(buffer), handler, timeout);
 }
 
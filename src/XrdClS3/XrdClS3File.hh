@@ -105,6 +105,10 @@ private:
 
     std::unique_ptr<XrdCl::File> m_wrapped_file;
 
+    // The curl plugin's handle inside m_wrapped_file, if it published one; data
+    // operations are issued on it directly, skipping the XrdCl::File layer.
+    XrdCl::FilePlugIn *m_direct_file{nullptr};
+
     // Given a path, provide the corresponding HTTP file handle.
     std::tuple<XrdCl::XRootDStatus, std::string, XrdCl::File*> GetFileHandle(const std::string &url);
 
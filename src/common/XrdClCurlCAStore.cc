@@ -0,0 +1,322 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlCAStore.hh"
+
+#include <XrdCl/XrdClConstants.hh>
+#include <XrdCl/XrdClDefaultEnv.hh>
+#include <XrdCl/XrdClLog.hh>
+
+#include <curl/curl.h>
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Returns true if the filename is of the form used by OpenSSL's hashed
+// certificate directories (8 hex digits, a dot, and a sequence number).
+//
+// This mirrors the lookup semantics of CURLOPT_CAPATH; CRLs (`.r0`) and
+// other files in the directory are ignored.
+bool IsHashedCertName(const char *name) {
+    size_t idx = 0;
+    for (; idx < 8; idx++) {
+        if (!isxdigit(static_cast<unsigned char>(name[idx]))) return false;
+    }
+    if (name[idx++] != '.') return false;
+    if (!isdigit(static_cast<unsigned char>(name[idx]))) return false;
+    for (; name[idx]; idx++) {
+        if (!isdigit(static_cast<unsigned char>(name[idx]))) return false;
+    }
+    return true;
+}
+
+// Add all the PEM-encoded certificates in the file to the store.
+// Returns the number of certificates added.
+size_t AddCertsFromFile(X509_STORE *store, const std::string &fname) {
+    std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new_file(fname.c_str(), "r"), &BIO_free);
+    if (!bio) {
+        ERR_clear_error();
+        return 0;
+    }
+    size_t count = 0;
+    X509 *cert;
+    while ((cert = PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr))) {
+        // Duplicates (e.g., from symlinked hash names) are expected; ignore errors.
+        if (X509_STORE_add_cert(store, cert) == 1) {
+            count++;
+        }
+        X509_free(cert);
+    }
+    // Reading until EOF leaves a "no start line" error on the queue.
+    ERR_clear_error();
+    return count;
+}
+
+}
+
+CAStore::CAStore()
+{
+    ResolveLocations(m_ca_file, m_ca_dir);
+}
+
+void
+CAStore::ResolveLocations(std::string &ca_file, std::string &ca_dir)
+{
+    ca_file.clear();
+    ca_dir.clear();
+    auto env = XrdCl::DefaultEnv::GetEnv();
+    if (!env || !env->GetString("CurlCertFile", ca_file) || ca_file.empty()) {
+        char *x509_ca_file = getenv("X509_CERT_FILE");
+        ca_file = x509_ca_file ? x509_ca_file : "";
+    }
+    if (!env || !env->GetString("CurlCertDir", ca_dir) || ca_dir.empty()) {
+        char *x509_ca_dir = getenv("X509_CERT_DIR");
+        ca_dir = x509_ca_dir ? x509_ca_dir : "";
+    }
+}
+
+bool
+CAStore::UpdateLocations()
+{
+    if (m_explicit_locations) {
+        return false;
+    }
+    std::string ca_file, ca_dir;
+    ResolveLocations(ca_file, ca_dir);
+    if (ca_file == m_ca_file && ca_dir == m_ca_dir) {
+        return false;
+    }
+    m_ca_file = ca_file;
+    m_ca_dir = ca_dir;
+    // The previous store holds a different set of CAs; don't keep using it.
+    m_store.reset();
+    m_signature.clear();
+    m_load_failed = false;
+    m_next_check = {};
+    return true;
+}
+
+CAStore &
+CAStore::Instance()
+{
+    static CAStore store;
+    return store;
+}
+
+void
+CAStore::SetLocations(const std::string &ca_file, const std::string &ca_dir)
+{
+    std::unique_lock lock(m_mutex);
+    m_explicit_locations = true;
+    m_ca_file = ca_file;
+    m_ca_dir = ca_dir;
+    m_store.reset();
+    m_signature.clear();
+    m_load_failed = false;
+    m_next_check = {};
+}
+
+bool
+CAStore::CurlUsesOpenSSL()
+{
+    static const bool uses_openssl = [] {
+        auto info = curl_version_info(CURLVERSION_NOW);
+        return info && info->ssl_version && !strncmp(info->ssl_version, "OpenSSL", 7);
+    }();
+    return uses_openssl;
+}
+
+std::string
+CAStore::Signature(const std::string &ca_file, const std::string &ca_dir)
+{
+    std::string result = ca_file + ";" + ca_dir + ";";
+    struct stat st;
+    if (!ca_file.empty() && stat(ca_file.c_str(), &st) == 0) {
+        result += std::to_string(st.st_mtime) + ":" + std::to_string(st.st_ino) + ":" + std::to_string(st.st_size);
+    }
+    result += ";";
+    if (!ca_dir.empty() && stat(ca_dir.c_str(), &st) == 0) {
+        result += std::to_string(st.st_mtime) + ":" + std::to_string(st.st_ino);
+        // Replacing a certificate in place doesn't change the directory's mtime;
+        // include each certificate file's state as well.
+        std::unique_ptr<DIR, void(*)(DIR *)> dir(opendir(ca_dir.c_str()), [](DIR *dir) {if (dir) closedir(dir);});
+        struct dirent *ent;
+        while (dir && (ent = readdir(dir.get()))) {
+            if (!IsHashedCertName(ent->d_name)) continue;
+            if (stat((ca_dir + "/" + ent->d_name).c_str(), &st) == 0) {
+                result += std::string(",") + ent->d_name + ":" + std::to_string(st.st_mtime) + ":" + std::to_string(st.st_size);
+            }
+        }
+    }
+    return result;
+}
+
+std::shared_ptr<X509_STORE>
+CAStore::Load(const std::string &ca_file, const std::string &ca_dir, std::string &err)
+{
+    std::shared_ptr<X509_STORE> store(X509_STORE_new(), &X509_STORE_free);
+    if (!store) {
+        err = "Failed to allocate X509 store";
+        return nullptr;
+    }
+
+    size_t count = 0;
+    if (!ca_file.empty()) {
+        count += AddCertsFromFile(store.get(), ca_file);
+    }
+    if (!ca_dir.empty()) {
+        std::unique_ptr<DIR, void(*)(DIR *)> dir(opendir(ca_dir.c_str()), [](DIR *dir) {closedir(dir);});
+        if (!dir) {
+            err = "Failed to open CA directory " + ca_dir + ": " + strerror(errno);
+            return nullptr;
+        }
+        struct dirent *ent;
+        while ((ent = readdir(dir.get()))) {
+            if (!IsHashedCertName(ent->d_name)) continue;
+            count += AddCertsFromFile(store.get(), ca_dir + "/" + ent->d_name);
+        }
+    }
+    if (!count) {
+        err = "No CA certificates found";
+        return nullptr;
+    }
+    m_cert_count.store(count, std::memory_order_relaxed);
+    m_loads.fetch_add(1, std::memory_order_relaxed);
+    return store;
+}
+
+std::shared_ptr<X509_STORE>
+CAStore::Get()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::unique_lock lock(m_mutex);
+    // The configuration and environment may change after first use; a change
+    // of location forces a reload below.
+    UpdateLocations();
+    if (m_ca_file.empty() && m_ca_dir.empty()) {
+        return nullptr;
+    }
+    if ((m_store || m_load_failed) && now < m_next_check) {
+        return m_store;
+    }
+    m_next_check = now + m_reload_interval;
+
+    // The locations may change via SetLocations once the lock is dropped.
+    auto ca_file = m_ca_file;
+    auto ca_dir = m_ca_dir;
+    auto signature = Signature(ca_file, ca_dir);
+    if ((m_store || m_load_failed) && signature == m_signature) {
+        return m_store;
+    }
+
+    // Load without holding the lock so other threads can continue to use the
+    // previous store (if any) in the meantime.
+    lock.unlock();
+    std::string err;
+    auto store = Load(ca_file, ca_dir, err);
+    lock.lock();
+    if (ca_file != m_ca_file || ca_dir != m_ca_dir) {
+        // SetLocations ran during the load; the next call loads the new locations.
+        return m_store;
+    }
+
+    m_signature = signature;
+    if (!store) {
+        auto log = XrdCl::DefaultEnv::GetLog();
+        if (log) {
+            log->Warning(XrdCl::UtilityMsg, "Failed to load CA certificates (file '%s', directory '%s') into memory: %s",
+                ca_file.c_str(), ca_dir.c_str(), err.c_str());
+        }
+        m_load_failed = !m_store;
+        return m_store;
+    }
+    m_load_failed = false;
+    m_store = store;
+    return m_store;
+}
+
+int
+CAStore::SslCtxCallback(CURL *, void *ssl_ctx, void *userptr)
+{
+    auto me = static_cast<CAStore*>(userptr);
+    auto store = me->Get();
+    if (!store) {
+        // Leave the trust store configured by libcurl in place.
+        return CURLE_OK;
+    }
+    // SSL_CTX_set_cert_store takes ownership of one reference.
+    X509_STORE_up_ref(store.get());
+    SSL_CTX_set_cert_store(static_cast<SSL_CTX*>(ssl_ctx), store.get());
+    me->m_contexts.fetch_add(1, std::memory_order_relaxed);
+    return CURLE_OK;
+}
+
+void
+CAStore::ConfigurePaths(CURL *curl)
+{
+    // libcurl copies the strings, so they only need to outlive the calls.
+    std::unique_lock lock(m_mutex);
+    UpdateLocations();
+    if (!m_ca_file.empty()) {
+        curl_easy_setopt(curl, CURLOPT_CAINFO, m_ca_file.c_str());
+    }
+    if (!m_ca_dir.empty()) {
+        curl_easy_setopt(curl, CURLOPT_CAPATH, m_ca_dir.c_str());
+    }
+}
+
+bool
+CAStore::ConfigureHandle(CURL *curl)
+{
+    if (!CurlUsesOpenSSL() || !Get()) {
+        ConfigurePaths(curl);
+        return false;
+    }
+    if (curl_easy_setopt(curl, CURLOPT_SSL_CTX_FUNCTION, SslCtxCallback) != CURLE_OK) {
+        ConfigurePaths(curl);
+        return false;
+    }
+    curl_easy_setopt(curl, CURLOPT_SSL_CTX_DATA, this);
+    // Prevent libcurl from parsing its own copy of the trust store (either the
+    // configured locations or the compiled-in default bundle) for each new
+    // connection; the callback above replaces it.
+    curl_easy_setopt(curl, CURLOPT_CAINFO, nullptr);
+    curl_easy_setopt(curl, CURLOPT_CAPATH, nullptr);
+    return true;
+}
+
+std::string
+CAStore::GetMonitoringJson() const
+{
+    return "{"
+        "\"loads\":" + std::to_string(GetLoads()) + ","
+        "\"certificates\":" + std::to_string(GetCertificateCount()) + ","
+        "\"contexts\":" + std::to_string(GetContextsConfigured()) +
+        "}";
+}
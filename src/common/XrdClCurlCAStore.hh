@@ -0,0 +1,134 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_CASTORE_HH
+#define XRDCLCURL_CASTORE_HH
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+
+// Forward dec'ls
+typedef void CURL;
+typedef struct x509_store_st X509_STORE;
+
+namespace XrdClCurl {
+
+// A process-wide, in-memory copy of the trusted CA certificates.
+//
+// Setting CURLOPT_CAINFO / CURLOPT_CAPATH on each handle causes OpenSSL to
+// re-parse the trust store for every new SSL_CTX; with a large CA directory
+// (such as the IGTF bundle), this dominates the CPU cost of short-lived
+// connections.  Instead, the CAStore loads the CA file and the hashed
+// certificates in the CA directory once into a shared X509_STORE and
+// installs it into each SSL_CTX via CURLOPT_SSL_CTX_FUNCTION.
+//
+// The store is rebuilt when the CA locations change, or when the CA file, the
+// CA directory or any certificate in it changes (checked at most once per
+// reload interval).
+//
+// If libcurl is not using OpenSSL or the store fails to load, handles fall back
+// to setting CURLOPT_CAINFO / CURLOPT_CAPATH directly.
+class CAStore {
+public:
+    // Return the global instance of the CA store.
+    //
+    // The CA locations are determined from the `CurlCertFile` / `CurlCertDir`
+    // configuration or the `X509_CERT_FILE` / `X509_CERT_DIR` environment
+    // variables on first use and re-read each time a handle is configured.
+    static CAStore &Instance();
+
+    // Configure the curl handle to use the CA store.
+    //
+    // Returns true if the shared store is used; false if the handle was
+    // configured with the CA file and directory paths instead.
+    bool ConfigureHandle(CURL *curl);
+
+    // Returns the current store (taking a reference), reloading it if the
+    // underlying files have changed.  Returns nullptr if no store is available.
+    std::shared_ptr<X509_STORE> Get();
+
+    // Set the CA locations explicitly and drop any loaded store.  Once set, the
+    // configuration and environment are no longer consulted.
+    void SetLocations(const std::string &ca_file, const std::string &ca_dir);
+
+    // Set the minimum interval between checks of the CA files for changes.
+    void SetReloadInterval(std::chrono::steady_clock::duration interval) {std::unique_lock lock(m_mutex); m_reload_interval = interval;}
+
+    std::string GetCAFile() const {std::unique_lock lock(m_mutex); return m_ca_file;}
+    std::string GetCADir() const {std::unique_lock lock(m_mutex); return m_ca_dir;}
+
+    // Statistics about the store usage
+    uint64_t GetLoads() const {return m_loads.load(std::memory_order_relaxed);}
+    uint64_t GetCertificateCount() const {return m_cert_count.load(std::memory_order_relaxed);}
+    uint64_t GetContextsConfigured() const {return m_contexts.load(std::memory_order_relaxed);}
+
+    // Returns the store statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+private:
+    CAStore();
+    CAStore(const CAStore &) = delete;
+
+    // Callback from libcurl when a new SSL_CTX is created for a connection.
+    static int SslCtxCallback(CURL *curl, void *ssl_ctx, void *userptr);
+
+    // Set CURLOPT_CAINFO / CURLOPT_CAPATH on the handle
+    void ConfigurePaths(CURL *curl);
+
+    // Determine the CA locations from the `CurlCertFile` / `CurlCertDir` configuration,
+    // falling back to the `X509_CERT_FILE` / `X509_CERT_DIR` environment variables.
+    static void ResolveLocations(std::string &ca_file, std::string &ca_dir);
+
+    // Re-resolve the CA locations unless they were set explicitly; if they changed,
+    // drop the loaded store.  Returns true on change.  Requires m_mutex.
+    bool UpdateLocations();
+
+    // Load a fresh store from the given locations; returns nullptr on failure.
+    std::shared_ptr<X509_STORE> Load(const std::string &ca_file, const std::string &ca_dir, std::string &err);
+
+    // Returns a signature of the CA locations and the state of the CA file, the
+    // directory and each certificate in it; changes when the contents should be
+    // reloaded.
+    static std::string Signature(const std::string &ca_file, const std::string &ca_dir);
+
+    // Returns true if libcurl uses OpenSSL as its TLS backend.
+    static bool CurlUsesOpenSSL();
+
+    // Protects the CA locations, store, signature, and reload schedule.
+    mutable std::mutex m_mutex;
+    std::string m_ca_file;
+    std::string m_ca_dir;
+    bool m_explicit_locations{false}; // Set once SetLocations is called.
+    std::shared_ptr<X509_STORE> m_store;
+    std::string m_signature;
+    bool m_load_failed{false};
+    std::chrono::steady_clock::time_point m_next_check;
+    std::chrono::steady_clock::duration m_reload_interval{std::chrono::minutes(1)};
+
+    std::atomic<uint64_t> m_loads{0}; // Count of times the store was (re)loaded.
+    std::atomic<uint64_t> m_cert_count{0}; // Count of certificates in the current store.
+    std::atomic<uint64_t> m_contexts{0}; // Count of SSL contexts given the shared store.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_CASTORE_HH
@@ -0,0 +1,357 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlDnsCache.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Cached addresses are used for up to this many refresh intervals, covering a
+// few failed refreshes before the operations fall back to curl's resolver.
+constexpr int g_max_age_intervals = 3;
+
+// Hosts not used for this many refresh intervals are dropped.
+constexpr int g_idle_intervals = 10;
+
+// Delay before retrying a failed lookup.
+constexpr std::chrono::seconds g_retry_delay{5};
+
+// Maximum number of addresses kept per host.
+constexpr size_t g_max_addrs = 8;
+
+// The cache used by this library; set by the first call to Instance().
+std::atomic<DnsCache *> g_instance{nullptr};
+
+} // namespace
+
+DnsCache::DnsCache()
+    : m_resolver(SystemResolve)
+{}
+
+DnsCache &
+DnsCache::Instance()
+{
+    // Intentionally leaked, like the scheduler; the resolver thread is stopped by
+    // the library destructor and may outlive it.
+    //
+    // Both plugins are built with this source; the first to create the cache
+    // publishes its address in the XrdCl environment and the other adopts it.
+    static DnsCache *instance = [] {
+        auto env = XrdCl::DefaultEnv::GetEnv();
+        std::string value;
+        if (env && env->GetString(m_instance_key, value) && !value.empty()) {
+            try {
+                return reinterpret_cast<DnsCache *>(std::stoull(value, nullptr, 16));
+            } catch (...) {}
+        }
+        auto result = new DnsCache();
+        char buf[2 * sizeof(uintptr_t) + 1];
+        auto conv = std::to_chars(buf, buf + sizeof(buf), reinterpret_cast<uintptr_t>(result), 16);
+        if (env && conv.ec == std::errc{}) {
+            env->PutString(m_instance_key, std::string(buf, conv.ptr - buf));
+        }
+        return result;
+    }();
+    g_instance.store(instance, std::memory_order_release);
+    return *instance;
+}
+
+bool
+DnsCache::ParseHostPort(std::string_view url, std::string &host, std::string &port)
+{
+    auto loc = url.find("://");
+    if (loc == std::string_view::npos || loc == 0) {
+        return false;
+    }
+    auto scheme = url.substr(0, loc);
+    auto authority = url.substr(loc + 3);
+    authority = authority.substr(0, authority.find_first_of("/?#"));
+    auto at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority = authority.substr(at + 1);
+    }
+    // Bracketed IPv6 literals need no resolution.
+    if (authority.empty() || authority[0] == '[') {
+        return false;
+    }
+    auto colon = authority.rfind(':');
+    if (colon == std::string_view::npos) {
+        if (scheme == "https" || scheme == "davs" || scheme == "s3") {
+            port = "443";
+        } else if (scheme == "http" || scheme == "dav") {
+            port = "80";
+        } else {
+            return false;
+        }
+        host = authority;
+    } else {
+        host = authority.substr(0, colon);
+        port = authority.substr(colon + 1);
+        if (host.empty() || port.empty()) {
+            return false;
+        }
+    }
+    struct in_addr addr;
+    if (inet_pton(AF_INET, host.c_str(), &addr) == 1) {
+        return false;
+    }
+    std::transform(host.begin(), host.end(), host.begin(), [](unsigned char c) {return std::tolower(c);});
+    return true;
+}
+
+bool
+DnsCache::SystemResolve(const std::string &host, std::vector<std::string> &addrs)
+{
+    struct addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0) {
+        return false;
+    }
+    addrs.clear();
+    for (auto ai = result; ai && addrs.size() < g_max_addrs; ai = ai->ai_next) {
+        char buf[INET6_ADDRSTRLEN];
+        if (getnameinfo(ai->ai_addr, ai->ai_addrlen, buf, sizeof(buf), nullptr, 0, NI_NUMERICHOST) != 0) {
+            continue;
+        }
+        auto addr = (ai->ai_family == AF_INET6) ? "[" + std::string(buf) + "]" : std::string(buf);
+        if (std::find(addrs.begin(), addrs.end(), addr) == addrs.end()) {
+            addrs.emplace_back(std::move(addr));
+        }
+    }
+    freeaddrinfo(result);
+    return !addrs.empty();
+}
+
+void
+DnsCache::Touch(const std::string &host, Clock::time_point now)
+{
+    auto iter = m_hosts.find(host);
+    if (iter != m_hosts.end()) {
+        iter->second.m_used = now;
+        return;
+    }
+    Entry entry;
+    entry.m_used = now;
+    m_hosts.emplace(host, std::move(entry));
+    m_pending = true;
+    // The resolver thread starts with the first host so that merely loading the
+    // plugin does not create it.
+    if (!m_thread.joinable() && !m_shutdown) {
+        m_running = true;
+        m_thread = std::thread([this]{Run();});
+    }
+    m_cv.notify_all();
+}
+
+void
+DnsCache::Prefetch(const std::string &url)
+{
+    std::string host, port;
+    if (!ParseHostPort(url, host, port)) {
+        return;
+    }
+    std::unique_lock lock(m_mutex);
+    if (m_refresh == Clock::duration::zero()) {
+        return;
+    }
+    Touch(host, Clock::now());
+}
+
+bool
+DnsCache::GetResolveEntry(const std::string &url, std::string &entry)
+{
+    std::string host, port;
+    if (!ParseHostPort(url, host, port)) {
+        return false;
+    }
+    auto now = Clock::now();
+    std::unique_lock lock(m_mutex);
+    if (m_refresh == Clock::duration::zero()) {
+        return false;
+    }
+    Touch(host, now);
+    const auto &info = m_hosts[host];
+    if (info.m_addrs.empty()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (now - info.m_resolved > g_max_age_intervals * m_refresh) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        entry = "-" + host + ":" + port;
+        return true;
+    }
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    entry = host + ":" + port + ":" + info.m_addrs;
+    return true;
+}
+
+void
+DnsCache::Configure(Clock::duration refresh)
+{
+    std::unique_lock lock(m_mutex);
+    m_refresh = refresh;
+    if (m_refresh == Clock::duration::zero()) {
+        m_hosts.clear();
+    }
+}
+
+void
+DnsCache::SetResolver(ResolveFunc resolver)
+{
+    std::unique_lock lock(m_mutex);
+    m_resolver = resolver ? std::move(resolver) : ResolveFunc(SystemResolve);
+}
+
+DnsCache::Clock::time_point
+DnsCache::Refresh(Clock::time_point now)
+{
+    std::vector<std::string> due;
+    ResolveFunc resolver;
+    Clock::duration refresh;
+    {
+        std::unique_lock lock(m_mutex);
+        refresh = m_refresh;
+        if (refresh == Clock::duration::zero()) {
+            return now + std::chrono::minutes(1);
+        }
+        for (auto iter = m_hosts.begin(); iter != m_hosts.end();) {
+            if (now - iter->second.m_used > g_idle_intervals * refresh) {
+                iter = m_hosts.erase(iter);
+                continue;
+            }
+            if (iter->second.m_next <= now) {
+                due.push_back(iter->first);
+                // Not due again while this lookup is in progress.
+                iter->second.m_next = now + refresh;
+            }
+            ++iter;
+        }
+        resolver = m_resolver;
+    }
+
+    // The lookups may block for a while; do them without the lock.
+    std::vector<std::pair<std::string, std::string>> results;
+    for (const auto &host : due) {
+        std::vector<std::string> addrs;
+        m_lookups.fetch_add(1, std::memory_order_relaxed);
+        std::string joined;
+        if (resolver(host, addrs)) {
+            for (const auto &addr : addrs) {
+                if (!joined.empty()) joined += ",";
+                joined += addr;
+            }
+        } else {
+            m_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        results.emplace_back(host, std::move(joined));
+    }
+
+    std::unique_lock lock(m_mutex);
+    for (auto &[host, addrs] : results) {
+        auto iter = m_hosts.find(host);
+        if (iter == m_hosts.end()) {
+            continue;
+        }
+        if (addrs.empty()) {
+            // Keep the previous addresses until they are too old; retry soon.
+            iter->second.m_next = now + std::min<Clock::duration>(g_retry_delay, refresh);
+        } else {
+            iter->second.m_addrs = std::move(addrs);
+            iter->second.m_resolved = now;
+        }
+    }
+    auto next = now + refresh;
+    for (const auto &entry : m_hosts) {
+        next = std::min(next, entry.second.m_next);
+    }
+    return next;
+}
+
+void
+DnsCache::Run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_shutdown) {
+        m_pending = false;
+        lock.unlock();
+        auto next = Refresh(Clock::now());
+        lock.lock();
+        m_cv.wait_until(lock, next, [&]{return m_shutdown || m_pending;});
+    }
+    m_running = false;
+    lock.unlock();
+    m_cv.notify_all();
+}
+
+void
+DnsCache::Shutdown()
+{
+    // Don't create a cache (or touch the environment) while unloading.
+    auto instance = g_instance.load(std::memory_order_acquire);
+    if (!instance) {
+        return;
+    }
+    auto &me = *instance;
+    std::unique_lock lock(me.m_mutex);
+    me.m_shutdown = true;
+    lock.unlock();
+    me.m_cv.notify_all();
+    if (!me.m_thread.joinable()) {
+        return;
+    }
+    lock.lock();
+    if (me.m_thread.get_id() == std::this_thread::get_id() ||
+        !me.m_cv.wait_for(lock, m_shutdown_wait, [&]{return !me.m_running;}))
+    {
+        // The cache is never destroyed, so the thread may safely finish on its own.
+        me.m_thread.detach();
+        return;
+    }
+    lock.unlock();
+    me.m_thread.join();
+}
+
+std::string
+DnsCache::GetMonitoringJson() const
+{
+    size_t hosts;
+    {
+        std::unique_lock lock(m_mutex);
+        hosts = m_hosts.size();
+    }
+    return "{"
+        "\"hosts\":" + std::to_string(hosts) + ","
+        "\"lookups\":" + std::to_string(m_lookups.load(std::memory_order_relaxed)) + ","
+        "\"failures\":" + std::to_string(m_failures.load(std::memory_order_relaxed)) + ","
+        "\"hits\":" + std::to_string(m_hits.load(std::memory_order_relaxed)) + ","
+        "\"misses\":" + std::to_string(m_misses.load(std::memory_order_relaxed)) +
+        "}";
+}
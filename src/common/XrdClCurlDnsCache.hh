@@ -0,0 +1,138 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_DNSCACHE_HH
+#define XRDCLCURL_DNSCACHE_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace XrdClCurl {
+
+// Process-wide cache of resolved host addresses, kept warm by a background
+// resolver thread.
+//
+// Hosts are registered as operations are set up (and, for Pelican, as the
+// director advertises mirrors); the resolver thread looks them up and
+// re-resolves them periodically while they are in use.  Operations inject the
+// cached addresses into curl through CURLOPT_RESOLVE, so only the first
+// request to a host ever waits on the system resolver.
+//
+// As with the scoreboard, the Pelican plugin obtains the curl plugin's instance
+// through the "XrdClCurlDnsCache" file property.  The source is built into both
+// plugins; like the scheduler, the first to create the cache publishes it in
+// the XrdCl environment so the process runs a single resolver thread.
+class DnsCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Resolve `host` into a list of numeric addresses (IPv6 addresses in brackets).
+    using ResolveFunc = std::function<bool(const std::string &host, std::vector<std::string> &addrs)>;
+
+    static DnsCache &Instance();
+
+    // Register the host of `url` for background resolution; never blocks on the resolver.
+    void Prefetch(const std::string &url);
+
+    // Set `entry` to the CURLOPT_RESOLVE entry ("host:port:addr[,addr...]") for the
+    // endpoint of `url` and register the host for background resolution.
+    //
+    // Returns false if there is nothing to inject: the cache is disabled, the URL has
+    // a literal address, or the host has not been resolved yet.  If the cached
+    // addresses are too old to use, `entry` is a removal ("-host:port") so curl
+    // falls back to its own resolver.
+    bool GetResolveEntry(const std::string &url, std::string &entry);
+
+    // Set the interval at which hosts in use are re-resolved; zero disables the
+    // cache.  The resolver thread is started when the first host is registered.
+    void Configure(Clock::duration refresh);
+
+    // Replace the resolver (nullptr restores the system resolver); used by the unit tests.
+    void SetResolver(ResolveFunc resolver);
+
+    // Resolve the hosts that are due and drop those no longer in use.  Returns the
+    // time the next host is due.  Run by the resolver thread; public for the tests.
+    Clock::time_point Refresh(Clock::time_point now);
+
+    // Split the URL into its host and port; returns false for literal addresses
+    // and unparseable URLs.
+    static bool ParseHostPort(std::string_view url, std::string &host, std::string &port);
+
+    // Returns the cache statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+private:
+    DnsCache();
+    DnsCache(const DnsCache &) = delete;
+
+    // Register `host`, marking it as used at `now` and starting the resolver
+    // thread if needed; m_mutex must be held.
+    void Touch(const std::string &host, Clock::time_point now);
+
+    // Main loop of the resolver thread.
+    void Run();
+
+    // Key in the XrdCl environment holding the address of the process's cache.
+    static constexpr const char *m_instance_key = "XrdClCurlDnsCache";
+
+    // Invoked when the library is unloaded; stops the resolver thread.
+    //
+    // A lookup may be stuck in getaddrinfo, so the thread is only waited on for
+    // `m_shutdown_wait` before it is detached.
+    static void Shutdown() __attribute__((destructor));
+    static constexpr std::chrono::seconds m_shutdown_wait{2};
+
+    // Resolve a host with getaddrinfo.
+    static bool SystemResolve(const std::string &host, std::vector<std::string> &addrs);
+
+    struct Entry {
+        std::string m_addrs;            // Comma-separated addresses; empty until resolved.
+        Clock::time_point m_resolved{}; // When m_addrs was last resolved.
+        Clock::time_point m_used{};     // When an operation last used the host.
+        Clock::time_point m_next{};     // When the host is next due for resolution.
+    };
+
+    mutable std::mutex m_mutex;
+    // Signals the resolver thread that a new host was registered or shutdown was requested.
+    std::condition_variable m_cv;
+    std::unordered_map<std::string, Entry> m_hosts;
+    ResolveFunc m_resolver;
+    Clock::duration m_refresh{0}; // Zero if the cache is disabled.
+    bool m_pending{false}; // Set when a host needs resolution before the next scheduled wakeup.
+    bool m_shutdown{false};
+    bool m_running{false}; // Set while the resolver thread is running.
+    std::thread m_thread;
+
+    std::atomic<uint64_t> m_lookups{0};  // Count of background lookups.
+    std::atomic<uint64_t> m_failures{0}; // Count of failed background lookups.
+    std::atomic<uint64_t> m_hits{0};     // Count of operations given fresh addresses.
+    std::atomic<uint64_t> m_misses{0};   // Count of operations left to curl's resolver.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_DNSCACHE_HH
@@ -0,0 +1,170 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlPool.hh"
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+using namespace XrdClCurl;
+
+std::atomic<uint64_t> BlockPool::m_heap_allocs{0};
+std::atomic<uint64_t> BlockPool::m_reuses{0};
+
+namespace {
+
+// Set when the thread's cache is destroyed; later frees on the thread go to the heap.
+thread_local bool g_cache_destroyed{false};
+
+}
+
+struct BlockPool::ThreadCache {
+    std::array<FreeList, m_classes> m_lists;
+
+    // Hand the remaining blocks to the depot so short-lived threads don't leak
+    // their free lists back to the heap.
+    ~ThreadCache() {
+        g_cache_destroyed = true;
+        for (size_t idx = 0; idx < m_classes; idx++) {
+            BlockPool::Donate(m_lists[idx], idx);
+        }
+    }
+};
+
+struct BlockPool::Depot {
+    std::mutex m_mutex;
+    std::vector<FreeList> m_batches;
+};
+
+BlockPool::ThreadCache *
+BlockPool::GetThreadCache()
+{
+    if (g_cache_destroyed) return nullptr;
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+BlockPool::Depot &
+BlockPool::GetDepot(size_t size_class)
+{
+    // Never destroyed: blocks may be freed by threads exiting after static destruction.
+    static auto depots = new std::array<Depot, m_classes>();
+    return (*depots)[size_class];
+}
+
+void
+BlockPool::Release(FreeList &list, size_t size_class) noexcept
+{
+    while (list.m_head) {
+        auto block = list.m_head;
+        list.m_head = block->m_next;
+        ::operator delete(block, (size_class + 1) * m_granularity);
+    }
+    list.m_count = 0;
+}
+
+void *
+BlockPool::Allocate(size_t size)
+{
+    if (size == 0 || size > m_max_block) {
+        m_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+    // The block may be freed on a thread that still has a cache and reused for
+    // any request in its size class, so it must always span the whole class.
+    auto size_class = (size - 1) / m_granularity;
+    auto cache = GetThreadCache();
+    if (!cache) {
+        m_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new((size_class + 1) * m_granularity);
+    }
+    auto &list = cache->m_lists[size_class];
+    if (!list.m_head) {
+        auto &depot = GetDepot(size_class);
+        std::unique_lock lock(depot.m_mutex);
+        if (!depot.m_batches.empty()) {
+            list = depot.m_batches.back();
+            depot.m_batches.pop_back();
+        }
+    }
+    if (list.m_head) {
+        auto block = list.m_head;
+        list.m_head = block->m_next;
+        list.m_count--;
+        m_reuses.fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+    m_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new((size_class + 1) * m_granularity);
+}
+
+void
+BlockPool::Deallocate(void *ptr, size_t size) noexcept
+{
+    if (!ptr) return;
+    auto size_class = (size - 1) / m_granularity;
+    auto cache = (size == 0 || size > m_max_block) ? nullptr : GetThreadCache();
+    if (!cache) {
+        if (size == 0 || size > m_max_block) {
+            ::operator delete(ptr, size);
+        } else {
+            ::operator delete(ptr, (size_class + 1) * m_granularity);
+        }
+        return;
+    }
+    auto &list = cache->m_lists[size_class];
+    auto block = static_cast<Block *>(ptr);
+    block->m_next = list.m_head;
+    list.m_head = block;
+    list.m_count++;
+    if (list.m_count < m_thread_limit) {
+        return;
+    }
+
+    // Split off a batch for the depot; the most recently freed blocks stay local.
+    FreeList batch;
+    auto last = list.m_head;
+    for (size_t idx = 1; idx < m_batch_size; idx++) {
+        last = last->m_next;
+    }
+    batch.m_head = last->m_next;
+    batch.m_count = list.m_count - m_batch_size;
+    last->m_next = nullptr;
+    list.m_count = m_batch_size;
+
+    Donate(batch, size_class);
+}
+
+void
+BlockPool::Donate(FreeList &list, size_t size_class) noexcept
+{
+    if (!list.m_head) return;
+    auto &depot = GetDepot(size_class);
+    {
+        std::unique_lock lock(depot.m_mutex);
+        if (depot.m_batches.size() < m_depot_limit) {
+            try {
+                depot.m_batches.push_back(list);
+                list = FreeList();
+                return;
+            } catch (...) {}
+        }
+    }
+    Release(list, size_class);
+}
@@ -0,0 +1,123 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_POOL_HH
+#define XRDCLCURL_POOL_HH
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace XrdClCurl {
+
+// Recycles the memory of the small objects allocated for every operation (the
+// operations themselves, their shared_ptr control blocks, and response handlers).
+//
+// Freed blocks are kept in a per-thread free list for each size class.  Operations
+// are typically created by the caller's thread and destroyed by a worker thread, so
+// a thread with too many free blocks hands a batch to a shared depot, from which
+// threads with an empty list take theirs; only the depot is locked, once per batch.
+// Requests larger than `m_max_block` go directly to the heap.
+class BlockPool {
+public:
+    static constexpr size_t m_granularity{64};
+    static constexpr size_t m_max_block{4096};
+
+    static void *Allocate(size_t size);
+    static void Deallocate(void *ptr, size_t size) noexcept;
+
+    // Number of blocks taken from the heap (including those larger than `m_max_block`).
+    static uint64_t GetHeapAllocations() {return m_heap_allocs.load(std::memory_order_relaxed);}
+    // Number of allocations served from a recycled block.
+    static uint64_t GetReuses() {return m_reuses.load(std::memory_order_relaxed);}
+
+private:
+    static constexpr size_t m_classes{m_max_block / m_granularity};
+    // Number of blocks moved between a thread and the depot at once.
+    static constexpr size_t m_batch_size{32};
+    // Free blocks a thread keeps per size class before returning a batch to the depot.
+    static constexpr size_t m_thread_limit{2 * m_batch_size};
+    // Batches the depot keeps per size class; beyond that, blocks are freed.
+    static constexpr size_t m_depot_limit{64};
+
+    struct Block {
+        Block *m_next;
+    };
+    struct FreeList {
+        Block *m_head{nullptr};
+        size_t m_count{0};
+    };
+    struct ThreadCache;
+    struct Depot;
+
+    // Returns the calling thread's cache, or nullptr once it was destroyed at thread exit.
+    static ThreadCache *GetThreadCache();
+    static Depot &GetDepot(size_t size_class);
+
+    // Move `list` to the depot of size class `size_class`, freeing it if the depot is full.
+    static void Donate(FreeList &list, size_t size_class) noexcept;
+    // Free the blocks of `list` of size class `size_class`.
+    static void Release(FreeList &list, size_t size_class) noexcept;
+
+    static std::atomic<uint64_t> m_heap_allocs;
+    static std::atomic<uint64_t> m_reuses;
+};
+
+// Base class routing `new` and `delete` of the derived class through the BlockPool.
+class Pooled {
+public:
+    static void *operator new(size_t size) {return BlockPool::Allocate(size);}
+    static void operator delete(void *ptr, size_t size) noexcept {BlockPool::Deallocate(ptr, size);}
+};
+
+// Allocator drawing from the BlockPool, for use with std::allocate_shared.
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U> &) {}
+
+    T *allocate(size_t count) {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Type is over-aligned for the block pool");
+        return static_cast<T *>(BlockPool::Allocate(count * sizeof(T)));
+    }
+    void deallocate(T *ptr, size_t count) noexcept {
+        BlockPool::Deallocate(ptr, count * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U> &) const {return true;}
+    template<typename U>
+    bool operator!=(const PoolAllocator<U> &) const {return false;}
+};
+
+// Create a shared object with the object and its control block in a single pooled block.
+template<typename T, typename... Args>
+std::shared_ptr<T> MakePooled(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_POOL_HH
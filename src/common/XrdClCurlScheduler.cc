@@ -0,0 +1,188 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlScheduler.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+
+#include <charconv>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// The scheduler used by this library; set by the first call to Instance().
+std::atomic<Scheduler *> g_instance{nullptr};
+
+}
+
+Scheduler &
+Scheduler::Instance()
+{
+    // Intentionally leaked; the subsystems cancel their tasks from their own
+    // library destructors, which may run after ours.
+    //
+    // This source is built into both the curl and the Pelican plugins.  The
+    // first library to create the scheduler publishes its address in the XrdCl
+    // environment (which both share) and the other adopts it, so the process
+    // runs a single scheduler thread.  The environment is used rather than a
+    // file property as the Pelican plugin registers tasks before it has loaded
+    // the curl plugin.
+    static Scheduler *instance = [] {
+        auto env = XrdCl::DefaultEnv::GetEnv();
+        std::string value;
+        if (env && env->GetString(m_instance_key, value) && !value.empty()) {
+            try {
+                return reinterpret_cast<Scheduler *>(std::stoull(value, nullptr, 16));
+            } catch (...) {}
+        }
+        auto result = new Scheduler();
+        char buf[2 * sizeof(uintptr_t) + 1];
+        auto conv = std::to_chars(buf, buf + sizeof(buf), reinterpret_cast<uintptr_t>(result), 16);
+        if (env && conv.ec == std::errc{}) {
+            env->PutString(m_instance_key, std::string(buf, conv.ptr - buf));
+        }
+        return result;
+    }();
+    g_instance.store(instance, std::memory_order_release);
+    return *instance;
+}
+
+Scheduler::TaskId
+Scheduler::Schedule(const std::string &name, Clock::duration period, std::function<void()> task)
+{
+    std::unique_lock lock(m_mutex);
+    auto id = m_next_id++;
+    auto next = Clock::now() + period;
+    m_tasks.emplace(id, Task{name, period, std::move(task), next});
+    m_queue.emplace(next, id);
+    if (!m_thread.joinable() && !m_shutdown) {
+        m_thread = std::thread([this]{Run();});
+    }
+    lock.unlock();
+    m_cv.notify_one();
+    return id;
+}
+
+void
+Scheduler::Cancel(TaskId id)
+{
+    if (!id) {
+        return;
+    }
+    std::unique_lock lock(m_mutex);
+    if (std::this_thread::get_id() != m_thread.get_id()) {
+        m_idle_cv.wait(lock, [&]{return m_running != id;});
+    }
+    auto iter = m_tasks.find(id);
+    if (iter == m_tasks.end()) {
+        return;
+    }
+    m_queue.erase({iter->second.m_next, id});
+    m_tasks.erase(iter);
+}
+
+size_t
+Scheduler::GetTaskCount() const
+{
+    std::unique_lock lock(m_mutex);
+    return m_tasks.size();
+}
+
+void
+Scheduler::Run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_shutdown) {
+        if (m_queue.empty()) {
+            m_cv.wait(lock, [&]{return m_shutdown || !m_queue.empty();});
+            continue;
+        }
+        auto next = m_queue.begin()->first;
+        if (Clock::now() < next) {
+            // Re-evaluate after any wakeup; a new task may now be the earliest.
+            m_cv.wait_until(lock, next);
+            m_wakeups.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        auto id = m_queue.begin()->second;
+        m_queue.erase(m_queue.begin());
+        auto iter = m_tasks.find(id);
+        if (iter == m_tasks.end()) {
+            continue;
+        }
+        // Copy the function so a task may cancel itself while it runs.
+        auto func = iter->second.m_func;
+        m_running = id;
+        lock.unlock();
+
+        try {
+            func();
+        } catch (...) {}
+        m_runs.fetch_add(1, std::memory_order_relaxed);
+
+        lock.lock();
+        m_running = 0;
+        iter = m_tasks.find(id);
+        if (iter != m_tasks.end()) {
+            iter->second.m_runs++;
+            iter->second.m_next = Clock::now() + iter->second.m_period;
+            m_queue.emplace(iter->second.m_next, id);
+        }
+        m_idle_cv.notify_all();
+    }
+}
+
+void
+Scheduler::Shutdown()
+{
+    // Don't create a scheduler (or touch the environment) while unloading.
+    auto instance = g_instance.load(std::memory_order_acquire);
+    if (!instance) {
+        return;
+    }
+    auto &me = *instance;
+    std::unique_lock lock(me.m_mutex);
+    me.m_shutdown = true;
+    lock.unlock();
+    me.m_cv.notify_one();
+    if (me.m_thread.joinable() && me.m_thread.get_id() != std::this_thread::get_id()) {
+        me.m_thread.join();
+    }
+}
+
+std::string
+Scheduler::GetMonitoringJson() const
+{
+    std::string retval = "{"
+        "\"wakeups\":" + std::to_string(m_wakeups.load(std::memory_order_relaxed)) + ","
+        "\"runs\":" + std::to_string(m_runs.load(std::memory_order_relaxed)) + ","
+        "\"tasks\":{";
+    std::unique_lock lock(m_mutex);
+    bool first = true;
+    for (const auto &entry : m_tasks) {
+        if (!first) retval += ",";
+        first = false;
+        retval += "\"" + entry.second.m_name + "\":{"
+            "\"period\":" + std::to_string(std::chrono::duration<double>(entry.second.m_period).count()) + ","
+            "\"runs\":" + std::to_string(entry.second.m_runs) +
+            "}";
+    }
+    retval += "}}";
+    return retval;
+}
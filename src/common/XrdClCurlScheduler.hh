@@ -0,0 +1,112 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_SCHEDULER_HH
+#define XRDCLCURL_SCHEDULER_HH
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace XrdClCurl {
+
+// A single background thread running the periodic housekeeping of the plugin
+// (cache expiry, metadata refresh, token reload, statistics reporting).
+//
+// Subsystems register a task and a period; the thread sleeps until the
+// earliest task is due, so an idle process wakes only as often as its most
+// frequent task instead of once per subsystem.  The thread is started when
+// the first task is registered.
+//
+// Tasks run one at a time on the scheduler thread and should not block for
+// long; a task that takes longer than its period simply runs late.
+//
+// The curl and Pelican plugins share a single instance; see `Instance`.
+class Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TaskId = uint64_t;
+
+    // Return the global instance of the scheduler.
+    static Scheduler &Instance();
+
+    // Register `task` to run every `period`, with the first run one period from now.
+    //
+    // Returns an identifier to pass to `Cancel`; never zero.
+    TaskId Schedule(const std::string &name, Clock::duration period, std::function<void()> task);
+
+    // Remove a task; an `id` of zero is ignored.  If the task is running on another
+    // thread, waits for the run to finish so the caller may safely tear down the
+    // task's state.
+    void Cancel(TaskId id);
+
+    // Returns the number of registered tasks.
+    size_t GetTaskCount() const;
+
+    // Returns the scheduler statistics as a JSON object.
+    std::string GetMonitoringJson() const;
+
+private:
+    Scheduler() = default;
+    Scheduler(const Scheduler &) = delete;
+
+    // Main loop of the scheduler thread.
+    void Run();
+
+    // Key in the XrdCl environment holding the address of the process's scheduler.
+    static constexpr const char *m_instance_key = "XrdClCurlScheduler";
+
+    // Invoked when the library is unloaded; stops the scheduler thread.
+    static void Shutdown() __attribute__((destructor));
+
+    struct Task {
+        std::string m_name;
+        Clock::duration m_period;
+        std::function<void()> m_func;
+        Clock::time_point m_next;
+        uint64_t m_runs{0};
+    };
+
+    mutable std::mutex m_mutex;
+    // Signals the scheduler thread that a task was added or shutdown was requested.
+    std::condition_variable m_cv;
+    // Signals waiters in Cancel that the running task has finished.
+    std::condition_variable m_idle_cv;
+
+    std::map<TaskId, Task> m_tasks;
+    // Due times of the registered tasks, ordered by time.
+    std::set<std::pair<Clock::time_point, TaskId>> m_queue;
+    TaskId m_next_id{1};
+    TaskId m_running{0}; // Task currently running; zero if none.
+    bool m_shutdown{false};
+    std::thread m_thread;
+
+    std::atomic<uint64_t> m_wakeups{0}; // Count of times the thread woke up.
+    std::atomic<uint64_t> m_runs{0}; // Count of task runs.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_SCHEDULER_HH
@@ -0,0 +1,356 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurlScoreboard.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Seconds added to the cost of an endpoint for each unit of error rate.
+constexpr double g_failure_penalty = 10.0;
+
+// Measurements below this (in operations or seconds of transfer) are considered
+// to have decayed away.
+constexpr double g_idle_threshold = 0.01;
+
+std::mt19937 &GetGenerator() {
+    thread_local std::mt19937 generator{std::random_device{}()};
+    return generator;
+}
+
+// Escape a string for use inside a JSON string literal.
+std::string JsonEscape(const std::string_view str) {
+    std::string result;
+    result.reserve(str.size());
+    for (auto chr : str) {
+        switch (chr) {
+        case '"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\b': result += "\\b"; break;
+        case '\f': result += "\\f"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(chr) < 0x20) {
+                char buf[7];
+                snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(chr));
+                result += buf;
+            } else {
+                result += chr;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+void
+Scoreboard::Host::Decay(Clock::time_point now)
+{
+    if (m_last_update != Clock::time_point{} && now > m_last_update) {
+        auto factor = std::exp(-std::chrono::duration<double>(now - m_last_update).count() /
+            std::chrono::duration<double>(m_decay).count());
+        m_bytes *= factor;
+        m_seconds *= factor;
+        m_ttfb_sum *= factor;
+        m_ttfb_count *= factor;
+        m_failures *= factor;
+        m_completed *= factor;
+    }
+    if (now > m_last_update) {
+        m_last_update = now;
+    }
+}
+
+bool
+Scoreboard::Host::IsIdle(Clock::time_point now)
+{
+    std::unique_lock lock(m_mutex);
+    Decay(now);
+    return m_circuit == Circuit::Closed && m_completed < g_idle_threshold &&
+        m_seconds < g_idle_threshold && m_ttfb_count < g_idle_threshold;
+}
+
+double
+Scoreboard::Host::GetCost(Clock::time_point now)
+{
+    std::unique_lock lock(m_mutex);
+    Decay(now);
+    // Require the equivalent of about one operation or one second of transfer
+    // before trusting the measurements.
+    if (m_completed < 0.5 && m_seconds < 0.5) {
+        return -1;
+    }
+    auto ttfb = m_ttfb_count > 0 ? m_ttfb_sum / m_ttfb_count : 0;
+    auto transfer = (m_seconds > 0 && m_bytes > 0) ? m_reference_bytes / (m_bytes / m_seconds) : 0;
+    auto error_rate = m_completed > 0 ? std::min(m_failures / m_completed, 0.95) : 0;
+    return (ttfb + transfer) / (1 - error_rate) + error_rate * g_failure_penalty;
+}
+
+Scoreboard::Circuit
+Scoreboard::Host::GetCircuit()
+{
+    std::unique_lock lock(m_mutex);
+    return m_circuit;
+}
+
+bool
+Scoreboard::Host::IsAvailable(Clock::time_point now)
+{
+    std::unique_lock lock(m_mutex);
+    return m_circuit == Circuit::Closed || now >= m_retry_after;
+}
+
+Scoreboard &
+Scoreboard::Instance()
+{
+    static Scoreboard instance;
+    return instance;
+}
+
+std::string
+Scoreboard::GetHostKey(const std::string_view url)
+{
+    auto loc = url.find("://");
+    if (loc == std::string_view::npos || loc == 0) {
+        return "";
+    }
+    auto scheme = url.substr(0, loc);
+    auto authority = url.substr(loc + 3);
+    authority = authority.substr(0, authority.find_first_of("/?#"));
+    auto at = authority.rfind('@');
+    if (at != std::string_view::npos) {
+        authority = authority.substr(at + 1);
+    }
+    if (authority.empty()) {
+        return "";
+    }
+    std::string key;
+    key.reserve(url.size());
+    key.append(scheme).append("://").append(authority);
+    // Add the default port so "https://host" and "https://host:443" are the same endpoint.
+    auto bracket = authority.rfind(']');
+    auto colon = authority.rfind(':');
+    if (colon == std::string_view::npos || (bracket != std::string_view::npos && colon < bracket)) {
+        if (scheme == "https" || scheme == "davs" || scheme == "s3") {
+            key += ":443";
+        } else if (scheme == "http" || scheme == "dav") {
+            key += ":80";
+        }
+    }
+    return key;
+}
+
+std::shared_ptr<Scoreboard::Host>
+Scoreboard::GetHost(const std::string &url, Clock::time_point now)
+{
+    auto key = GetHostKey(url);
+    if (key.empty()) {
+        return nullptr;
+    }
+    {
+        std::shared_lock lock(m_mutex);
+        auto iter = m_hosts.find(key);
+        if (iter != m_hosts.end()) {
+            return iter->second;
+        }
+    }
+    std::unique_lock lock(m_mutex);
+    auto iter = m_hosts.find(key);
+    if (iter != m_hosts.end()) {
+        return iter->second;
+    }
+    if (now - m_last_prune >= m_prune_interval) {
+        Prune(now);
+    }
+    auto host = std::make_shared<Host>();
+    m_hosts.emplace(key, host);
+    return host;
+}
+
+void
+Scoreboard::Prune(Clock::time_point now)
+{
+    m_last_prune = now;
+    for (auto iter = m_hosts.begin(); iter != m_hosts.end();) {
+        // An operation holding the host may still record to it; keep it so its
+        // measurements aren't lost.
+        if (iter->second.use_count() == 1 && iter->second->IsIdle(now)) {
+            iter = m_hosts.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+void
+Scoreboard::Record(const std::shared_ptr<Host> &host, uint64_t bytes, Clock::duration active, Clock::duration ttfb, Outcome outcome, Clock::time_point now)
+{
+    if (!host) {
+        return;
+    }
+    std::unique_lock lock(host->m_mutex);
+    host->Decay(now);
+    if (bytes && active > Clock::duration::zero()) {
+        host->m_bytes += bytes;
+        host->m_seconds += std::chrono::duration<double>(active).count();
+    }
+    if (ttfb > Clock::duration::zero()) {
+        host->m_ttfb_sum += std::chrono::duration<double>(ttfb).count();
+        host->m_ttfb_count += 1;
+    }
+    if (outcome == Outcome::Success || outcome == Outcome::Failure) {
+        host->m_completed += 1;
+        if (outcome == Outcome::Failure) {
+            host->m_failures += 1;
+        }
+    }
+
+    if (outcome == Outcome::Failure) {
+        host->m_consecutive_failures++;
+        // Failures of requests started before the circuit opened do not extend the cooldown.
+        if (host->m_circuit == Circuit::HalfOpen || (host->m_circuit == Circuit::Closed &&
+            m_circuit_failures && host->m_consecutive_failures >= m_circuit_failures))
+        {
+            host->m_circuit = Circuit::Open;
+            host->m_retry_after = now + m_circuit_cooldown;
+        }
+    } else if (outcome == Outcome::Success || bytes || ttfb > Clock::duration::zero()) {
+        // Any sign of life from the server closes the circuit.
+        host->m_consecutive_failures = 0;
+        host->m_circuit = Circuit::Closed;
+    } else if (outcome == Outcome::Aborted && host->m_circuit == Circuit::HalfOpen) {
+        // The probe said nothing about the server; let the next request probe instead.
+        host->m_circuit = Circuit::Open;
+        host->m_retry_after = now;
+    }
+}
+
+bool
+Scoreboard::Admit(const std::shared_ptr<Host> &host, Clock::time_point now)
+{
+    if (!host || !m_circuit_failures) {
+        return true;
+    }
+    std::unique_lock lock(host->m_mutex);
+    if (host->m_circuit == Circuit::Closed) {
+        return true;
+    }
+    // After the cooldown (or if the previous probe appears to have been lost), let
+    // a single request through to probe the endpoint.
+    if (now >= host->m_retry_after) {
+        host->m_circuit = Circuit::HalfOpen;
+        host->m_retry_after = now + m_circuit_cooldown;
+        return true;
+    }
+    host->m_fast_fails++;
+    return false;
+}
+
+std::vector<size_t>
+Scoreboard::Rank(const std::vector<std::string> &urls, Clock::time_point now)
+{
+    std::vector<std::pair<double, size_t>> measured;
+    std::vector<size_t> unmeasured, unavailable;
+    for (size_t idx = 0; idx < urls.size(); idx++) {
+        auto key = GetHostKey(urls[idx]);
+        double cost = -1;
+        bool available = true;
+        if (!key.empty()) {
+            std::shared_lock lock(m_mutex);
+            auto iter = m_hosts.find(key);
+            if (iter != m_hosts.end()) {
+                cost = iter->second->GetCost(now);
+                available = !m_circuit_failures || iter->second->IsAvailable(now);
+            }
+        }
+        if (!available) {
+            unavailable.push_back(idx);
+        } else if (cost < 0) {
+            unmeasured.push_back(idx);
+        } else {
+            measured.emplace_back(cost, idx);
+        }
+    }
+    std::stable_sort(measured.begin(), measured.end(), [](const auto &left, const auto &right) {return left.first < right.first;});
+
+    std::vector<size_t> result;
+    result.reserve(urls.size());
+    for (const auto &entry : measured) {
+        result.push_back(entry.second);
+    }
+    result.insert(result.end(), unmeasured.begin(), unmeasured.end());
+    auto candidates = result.size();
+    result.insert(result.end(), unavailable.begin(), unavailable.end());
+    if (measured.empty() || candidates < 2) {
+        return result;
+    }
+
+    auto &generator = GetGenerator();
+    if (std::uniform_real_distribution<double>(0, 1)(generator) < m_explore_fraction.load(std::memory_order_relaxed)) {
+        size_t pick;
+        if (!unmeasured.empty()) {
+            pick = measured.size() + std::uniform_int_distribution<size_t>(0, unmeasured.size() - 1)(generator);
+        } else {
+            pick = std::uniform_int_distribution<size_t>(1, candidates - 1)(generator);
+        }
+        std::rotate(result.begin(), result.begin() + pick, result.begin() + pick + 1);
+    }
+    return result;
+}
+
+std::string
+Scoreboard::GetMonitoringJson() const
+{
+    auto now = Clock::now();
+    std::string retval = "{";
+    std::shared_lock lock(m_mutex);
+    bool first = true;
+    for (const auto &entry : m_hosts) {
+        auto &host = *entry.second;
+        auto cost = host.GetCost(now);
+        std::unique_lock host_lock(host.m_mutex);
+        const char *circuit = "closed";
+        if (host.m_circuit == Circuit::Open) {
+            circuit = "open";
+        } else if (host.m_circuit == Circuit::HalfOpen) {
+            circuit = "half-open";
+        }
+        if (!first) retval += ",";
+        first = false;
+        retval += "\"" + JsonEscape(entry.first) + "\":{"
+            "\"rate\":" + std::to_string(host.m_seconds > 0 ? host.m_bytes / host.m_seconds : 0) + ","
+            "\"ttfb\":" + std::to_string(host.m_ttfb_count > 0 ? host.m_ttfb_sum / host.m_ttfb_count : 0) + ","
+            "\"error_rate\":" + std::to_string(host.m_completed > 0 ? host.m_failures / host.m_completed : 0) + ","
+            "\"ops\":" + std::to_string(host.m_completed) + ","
+            "\"cost\":" + std::to_string(cost) + ","
+            "\"circuit\":\"" + circuit + "\","
+            "\"fast_fails\":" + std::to_string(host.m_fast_fails) +
+            "}";
+    }
+    retval += "}";
+    return retval;
+}
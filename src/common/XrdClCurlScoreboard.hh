@@ -0,0 +1,182 @@
+/***************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#ifndef XRDCLCURL_SCOREBOARD_HH
+#define XRDCLCURL_SCOREBOARD_HH
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace XrdClCurl {
+
+// Client-side record of the performance of each endpoint (scheme, host, and port)
+// the client has talked to: throughput, time to first header, and error rate.
+// Each measurement decays exponentially with time, so the scoreboard reflects
+// roughly the last hour of activity.
+//
+// Each endpoint also has a circuit breaker: after several consecutive failures
+// (connection errors, timeouts, gateway-class 5xx responses), the circuit opens and new requests
+// to the endpoint fail immediately.  Once the cooldown expires, a single probe
+// request is admitted; its success closes the circuit, its failure re-opens it.
+//
+// The scoreboard is fed by the curl workers and used by the Pelican plugin to
+// re-rank the mirrors returned by the director.  As the two plugins are
+// separate libraries, the Pelican plugin obtains the curl plugin's instance
+// through the "XrdClCurlScoreboard" file property.
+class Scoreboard {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Outcome of the operation reported to `Record`.
+    enum class Outcome {
+        Progress, // The operation is still running
+        Success,  // The operation completed; the server responded normally
+        Failure,  // The operation failed due to the server (connection error, timeout, 502/503/504)
+        Aborted,  // The operation ended for a reason unrelated to the server (client abort, internal error)
+    };
+
+    // State of an endpoint's circuit breaker.
+    enum class Circuit {
+        Closed,   // Requests flow normally
+        Open,     // Requests fail immediately until the cooldown expires
+        HalfOpen, // A single probe request is outstanding
+    };
+
+    // The per-endpoint scores.  An endpoint whose measurements have decayed away is
+    // dropped from the scoreboard once no operation holds a reference to it.
+    class Host {
+    public:
+        // Expected time, in seconds, to fetch a reference-sized object from this
+        // endpoint, inflated by its error rate; lower is better.  Negative if the
+        // endpoint has not been measured.
+        double GetCost(Clock::time_point now);
+
+        // Returns the current state of the circuit breaker.
+        Circuit GetCircuit();
+
+        // Returns true if a request to the endpoint would be admitted at `now`.
+        // Unlike `Scoreboard::Admit`, this does not start a probe.
+        bool IsAvailable(Clock::time_point now);
+
+    private:
+        friend class Scoreboard;
+
+        // Decay the accumulated values to `now`; m_mutex must be held.
+        void Decay(Clock::time_point now);
+
+        // Returns true if the measurements have decayed to nothing and the circuit
+        // is closed, so the host is indistinguishable from a new one.
+        bool IsIdle(Clock::time_point now);
+
+        std::mutex m_mutex;
+        Clock::time_point m_last_update{};
+        double m_bytes{0};      // Decayed sum of bytes transferred.
+        double m_seconds{0};    // Decayed sum of time spent transferring, in seconds.
+        double m_ttfb_sum{0};   // Decayed sum of the time to first header, in seconds.
+        double m_ttfb_count{0}; // Decayed count of time-to-first-header samples.
+        double m_failures{0};   // Decayed count of failed operations.
+        double m_completed{0};  // Decayed count of completed operations (including failures).
+
+        Circuit m_circuit{Circuit::Closed};
+        unsigned m_consecutive_failures{0}; // Failures since the last success.
+        Clock::time_point m_retry_after{};  // When open, the end of the cooldown; when half-open, when the probe is presumed lost.
+        uint64_t m_fast_fails{0};           // Count of requests rejected while the circuit was open.
+    };
+
+    static Scoreboard &Instance();
+
+    // Return the scores for the endpoint of `url`, creating them if necessary.
+    // Returns nullptr if the URL cannot be parsed.
+    std::shared_ptr<Host> GetHost(const std::string &url, Clock::time_point now=Clock::now());
+
+    // Record a measurement for an operation:
+    // - bytes: bytes transferred since the last record.
+    // - active: time spent transferring since the last record (excluding pauses).
+    // - ttfb: time from the request to the first header; zero if not yet received
+    //   or already reported.
+    void Record(const std::shared_ptr<Host> &host, uint64_t bytes, Clock::duration active, Clock::duration ttfb, Outcome outcome, Clock::time_point now=Clock::now());
+
+    // Returns true if a new request to `host` may proceed.  Returns false (and
+    // counts a fast failure) if its circuit is open; if the cooldown has expired,
+    // the caller's request becomes the probe.
+    bool Admit(const std::shared_ptr<Host> &host, Clock::time_point now=Clock::now());
+
+    // Given candidate URLs in the director's preference order, return the order in
+    // which they should be tried (as indexes into `urls`).
+    //
+    // Measured endpoints are sorted by cost; unmeasured endpoints follow in the
+    // director's order.  With a small probability, a random candidate --
+    // preferring an unmeasured one -- is moved to the front so new or previously
+    // slow endpoints continue to be sampled.  Endpoints with an open circuit are
+    // placed last.
+    std::vector<size_t> Rank(const std::vector<std::string> &urls, Clock::time_point now=Clock::now());
+
+    // Set the probability that `Rank` explores instead of picking the best candidate.
+    void SetExploreFraction(double fraction) {m_explore_fraction.store(fraction, std::memory_order_relaxed);}
+
+    // Set the number of consecutive failures that open an endpoint's circuit (0
+    // disables the circuit breaker) and how long the circuit stays open before a
+    // probe is allowed.
+    void SetCircuitParams(unsigned failures, Clock::duration cooldown) {
+        m_circuit_failures = failures;
+        m_circuit_cooldown = cooldown;
+    }
+
+    // Return the endpoint key ("scheme://host:port") of a URL; empty on failure.
+    static std::string GetHostKey(const std::string_view url);
+
+    // Returns the scoreboard as a JSON object.
+    std::string GetMonitoringJson() const;
+
+    // Time constant of the exponential decay of the measurements.
+    static constexpr Clock::duration m_decay{std::chrono::minutes(60)};
+
+    // Object size used to combine the time to first byte and the throughput into a cost.
+    static constexpr double m_reference_bytes{64.0 * 1024 * 1024};
+
+    // Minimum time between scans for idle endpoints to drop.
+    static constexpr Clock::duration m_prune_interval{std::chrono::minutes(5)};
+
+private:
+    Scoreboard() = default;
+    Scoreboard(const Scoreboard &) = delete;
+
+    // Drop the idle endpoints no operation references; m_mutex must be held exclusively.
+    void Prune(Clock::time_point now);
+
+    // Updated by the configuration while selections read it.
+    std::atomic<double> m_explore_fraction{0.05};
+    unsigned m_circuit_failures{5};
+    Clock::duration m_circuit_cooldown{std::chrono::seconds(30)};
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::string, std::shared_ptr<Host>> m_hosts;
+    Clock::time_point m_last_prune{}; // Time of the last scan for idle endpoints; protected by m_mutex.
+};
+
+} // namespace XrdClCurl
+
+#endif // XRDCLCURL_SCOREBOARD_HH
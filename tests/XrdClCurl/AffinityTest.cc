@@ -0,0 +1,112 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlAffinity.hh"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Builds a fake sysfs tree describing a two-node host with a NIC on node 1.
+class AffinityTest : public testing::Test {
+protected:
+    void SetUp() override {
+        char tmpl[] = "/tmp/xrdclcurl_affinity.XXXXXX";
+        ASSERT_NE(mkdtemp(tmpl), nullptr);
+        m_root = tmpl;
+        Write("devices/system/node/node0/cpulist", "0-3\n");
+        Write("devices/system/node/node1/cpulist", "4-7\n");
+        Write("devices/system/node/possible", "0-1\n");
+        Write("class/net/eth0/device/numa_node", "1\n");
+        std::filesystem::create_directories(m_root + "/class/net/lo");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(m_root);
+    }
+
+    void Write(const std::string &path, const std::string &contents) {
+        auto full = std::filesystem::path(m_root) / path;
+        std::filesystem::create_directories(full.parent_path());
+        std::ofstream(full) << contents;
+    }
+
+    std::string m_root;
+};
+
+}
+
+TEST(CpuTopology, ParseCpuList) {
+    std::vector<unsigned> cpus;
+    ASSERT_TRUE(CpuTopology::ParseCpuList("0-2,8,10-11\n", cpus));
+    EXPECT_EQ(cpus, (std::vector<unsigned>{0, 1, 2, 8, 10, 11}));
+    ASSERT_TRUE(CpuTopology::ParseCpuList("", cpus));
+    EXPECT_TRUE(cpus.empty());
+    EXPECT_FALSE(CpuTopology::ParseCpuList("3-1", cpus));
+    EXPECT_FALSE(CpuTopology::ParseCpuList("a", cpus));
+}
+
+TEST_F(AffinityTest, LoadTopology) {
+    auto topology = CpuTopology::Load(m_root, {});
+    ASSERT_EQ(topology.GetNodes().size(), 2U);
+    EXPECT_EQ(topology.GetCpuCount(), 8U);
+    EXPECT_EQ(topology.GetNodeOfCpu(5), 1);
+
+    // CPUs outside the process's allowed set are dropped, as are empty nodes.
+    topology = CpuTopology::Load(m_root, {0, 1});
+    ASSERT_EQ(topology.GetNodes().size(), 1U);
+    EXPECT_EQ(topology.GetNodes()[0].m_cpus, (std::vector<unsigned>{0, 1}));
+
+    std::string nic;
+    EXPECT_EQ(CpuTopology::GetNicNode(m_root, nic), 1);
+    EXPECT_EQ(nic, "eth0");
+    nic = "lo";
+    EXPECT_EQ(CpuTopology::GetNicNode(m_root, nic), -1);
+}
+
+TEST_F(AffinityTest, Placement) {
+    auto topology = CpuTopology::Load(m_root, {});
+    using Policy = WorkerAffinity::Policy;
+
+    EXPECT_TRUE(WorkerAffinity::ComputePlacement(Policy::None, topology, 1, 0).m_cpus.empty());
+
+    // Compact fills node 0 before moving to node 1.
+    auto placement = WorkerAffinity::ComputePlacement(Policy::Compact, topology, 1, 3);
+    EXPECT_EQ(placement.m_cpus, std::vector<unsigned>{3});
+    EXPECT_EQ(placement.m_node, 0);
+    placement = WorkerAffinity::ComputePlacement(Policy::Compact, topology, 1, 4);
+    EXPECT_EQ(placement.m_cpus, std::vector<unsigned>{4});
+    EXPECT_EQ(placement.m_node, 1);
+
+    // Spread alternates between the nodes.
+    placement = WorkerAffinity::ComputePlacement(Policy::Spread, topology, 1, 1);
+    EXPECT_EQ(placement.m_cpus, std::vector<unsigned>{4});
+    placement = WorkerAffinity::ComputePlacement(Policy::Spread, topology, 1, 2);
+    EXPECT_EQ(placement.m_cpus, std::vector<unsigned>{1});
+
+    // NIC-local allows every CPU on the NIC's node.
+    placement = WorkerAffinity::ComputePlacement(Policy::NicLocal, topology, 1, 7);
+    EXPECT_EQ(placement.m_cpus, (std::vector<unsigned>{4, 5, 6, 7}));
+    EXPECT_EQ(placement.m_node, 1);
+    EXPECT_TRUE(WorkerAffinity::ComputePlacement(Policy::NicLocal, topology, -1, 0).m_cpus.empty());
+}
@@ -0,0 +1,101 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlCompletionExecutor.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+#include <gtest/gtest.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Records the order in which the completions for a single key are delivered.
+class OrderedHandler : public XrdCl::ResponseHandler {
+public:
+    OrderedHandler(std::vector<int> &order, std::mutex &mutex, std::condition_variable &cv, int value) :
+        m_order(order), m_mutex(mutex), m_cv(cv), m_value(value)
+    {}
+
+    void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) override {
+        delete status;
+        delete response;
+        std::unique_lock lock(m_mutex);
+        m_order.push_back(m_value);
+        m_cv.notify_all();
+        lock.unlock();
+        delete this;
+    }
+
+private:
+    std::vector<int> &m_order;
+    std::mutex &m_mutex;
+    std::condition_variable &m_cv;
+    int m_value;
+};
+
+}
+
+TEST(CompletionExecutor, PreservesPerKeyOrder) {
+    auto &executor = CompletionExecutor::Instance();
+    executor.Start(4);
+    ASSERT_TRUE(executor.IsEnabled());
+
+    static const int producers = 4;
+    static const int per_producer = 1000;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::vector<int>> orders(producers);
+
+    // Each producer dispatches to its own key; completions for a key must arrive
+    // in the order they were dispatched, even though keys share executor threads.
+    std::vector<std::thread> threads;
+    for (int idx = 0; idx < producers; idx++) {
+        threads.emplace_back([&, idx] {
+            for (int value = 0; value < per_producer; value++) {
+                executor.Dispatch(idx, new OrderedHandler(orders[idx], mutex, cv, value),
+                    new XrdCl::XRootDStatus(), nullptr);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::unique_lock lock(mutex);
+    auto done = cv.wait_for(lock, std::chrono::seconds(10), [&] {
+        for (const auto &order : orders) {
+            if (order.size() != per_producer) return false;
+        }
+        return true;
+    });
+    ASSERT_TRUE(done);
+    for (const auto &order : orders) {
+        for (int value = 0; value < per_producer; value++) {
+            ASSERT_EQ(order[value], value);
+        }
+    }
+
+    auto json = executor.GetMonitoringJson();
+    EXPECT_NE(json.find("\"handoff_max\""), std::string::npos);
+}
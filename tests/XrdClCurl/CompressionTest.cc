@@ -0,0 +1,122 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlOps.hh"
+#include "XrdClCurl/XrdClCurlOptionsCache.hh"
+#include "XrdClCurl/XrdClCurlUtil.hh"
+#include "XrdClCurl/XrdClCurlWorker.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+#include <curl/curl.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+namespace {
+
+class CompressionFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_logger = XrdCl::DefaultEnv::GetLog();
+        m_queue = std::make_shared<HandlerQueue>(16);
+        m_worker.reset(new CurlWorker(m_queue, VerbsCache::Instance(), m_logger));
+        m_curl = curl_easy_init();
+        ASSERT_NE(m_curl, nullptr);
+        CurlOperation::SetMetadataCompression(true);
+    }
+
+    void TearDown() override {
+        if (m_curl) curl_easy_cleanup(m_curl);
+        CurlOperation::SetMetadataCompression(true);
+    }
+
+    XrdCl::Log *m_logger{nullptr};
+    std::shared_ptr<HandlerQueue> m_queue;
+    std::unique_ptr<CurlWorker> m_worker;
+    CURL *m_curl{nullptr};
+};
+
+}
+
+TEST_F(CompressionFixture, Listing) {
+    CurlListdirOp op(nullptr, "https://compress-list.example.com/dir", "", false, {10, 0}, m_logger, nullptr, nullptr);
+    ASSERT_TRUE(op.Setup(m_curl, *m_worker));
+    EXPECT_TRUE(op.IsCompressed());
+    op.ReleaseHandle();
+    EXPECT_FALSE(op.IsCompressed());
+
+    // Disabled by the configuration.
+    CurlOperation::SetMetadataCompression(false);
+    CurlListdirOp disabled(nullptr, "https://compress-list.example.com/dir", "", false, {10, 0}, m_logger, nullptr, nullptr);
+    ASSERT_TRUE(disabled.Setup(m_curl, *m_worker));
+    EXPECT_FALSE(disabled.IsCompressed());
+    disabled.ReleaseHandle();
+}
+
+TEST_F(CompressionFixture, DataRead) {
+    char buffer[1024];
+
+    // Ranged data reads are never compressed, even from the start of the object.
+    CurlReadOp read(nullptr, nullptr, "https://compress-read.example.com/obj", {10, 0}, {0, sizeof(buffer)}, buffer, sizeof(buffer), m_logger, nullptr, nullptr);
+    ASSERT_TRUE(read.Setup(m_curl, *m_worker));
+    EXPECT_FALSE(read.IsCompressed());
+    read.ReleaseHandle();
+
+    // A listing fetched with a plain GET may be.
+    CurlReadOp listing(nullptr, nullptr, "https://compress-read.example.com/dir", {10, 0}, {0, sizeof(buffer)}, buffer, sizeof(buffer), m_logger, nullptr, nullptr);
+    listing.SetAcceptEncoding();
+    ASSERT_TRUE(listing.Setup(m_curl, *m_worker));
+    EXPECT_TRUE(listing.IsCompressed());
+    listing.ReleaseHandle();
+
+    // But not when it starts mid-object.
+    CurlReadOp offset(nullptr, nullptr, "https://compress-read.example.com/dir", {10, 0}, {512, 512}, buffer, 512, m_logger, nullptr, nullptr);
+    offset.SetAcceptEncoding();
+    ASSERT_TRUE(offset.Setup(m_curl, *m_worker));
+    EXPECT_FALSE(offset.IsCompressed());
+    offset.ReleaseHandle();
+}
+
+TEST_F(CompressionFixture, Stat) {
+    auto &cache = VerbsCache::Instance();
+
+    // A stat of an endpoint without PROPFIND is a HEAD request.
+    cache.Put("https://compress-head.example.com", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kUnknown));
+    CurlStatOp head(nullptr, "https://compress-head.example.com/obj", {10, 0}, m_logger, false, nullptr, nullptr);
+    ASSERT_TRUE(head.Setup(m_curl, *m_worker));
+    EXPECT_FALSE(head.IsCompressed());
+    head.ReleaseHandle();
+
+    // A PROPFIND is compressed.
+    cache.Put("https://compress-propfind.example.com", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kPROPFIND));
+    CurlStatOp propfind(nullptr, "https://compress-propfind.example.com/obj", {10, 0}, m_logger, false, nullptr, nullptr);
+    ASSERT_TRUE(propfind.Setup(m_curl, *m_worker));
+    EXPECT_TRUE(propfind.IsCompressed());
+    EXPECT_EQ(propfind.GetVerb(), CurlOperation::HttpVerb::PROPFIND);
+
+    // If the verbs are no longer known to include PROPFIND once OPTIONS completes,
+    // the stat falls back to HEAD and stops advertising compressed encodings.
+    cache.Put("https://compress-propfind.example.com", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kPROPFIND), std::chrono::steady_clock::now() - 7h);
+    propfind.OptionsDone();
+    EXPECT_FALSE(propfind.IsCompressed());
+    EXPECT_EQ(propfind.GetVerb(), CurlOperation::HttpVerb::HEAD);
+    propfind.ReleaseHandle();
+}
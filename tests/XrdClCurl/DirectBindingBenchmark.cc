@@ -0,0 +1,98 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Benchmark comparing the per-operation cost of 4KB reads issued through an
+// XrdCl::File (as the Pelican and S3 plugins did for every operation) with reads
+// issued directly on the curl plugin's handle published as `XrdClCurlFilePlugIn`.
+
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClFile.hh>
+#include <XrdCl/XrdClPlugInInterface.hh>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+class DirectBindingBenchmark : public TransferFixture {
+protected:
+    // Issue `count` sequential 4KB reads with `read` and return the mean time per read in microseconds.
+    template<typename ReadFunc>
+    double TimeReads(ReadFunc read, int count) {
+        std::vector<char> buffer(m_read_size);
+        auto start = std::chrono::steady_clock::now();
+        for (int idx = 0; idx < count; idx++) {
+            SyncResponseHandler handler;
+            uint64_t offset = (static_cast<uint64_t>(idx) * m_read_size) % m_object_size;
+            auto rv = read(offset, buffer.data(), &handler);
+            EXPECT_TRUE(rv.IsOK()) << rv.ToString();
+            if (!rv.IsOK()) return 0;
+            handler.Wait();
+            auto [status, obj] = handler.Status();
+            EXPECT_TRUE(status->IsOK()) << status->ToString();
+        }
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        return elapsed / count;
+    }
+
+    static constexpr uint32_t m_read_size{4 * 1024};
+    static constexpr uint64_t m_object_size{16 * 1024 * 1024};
+};
+
+TEST_F(DirectBindingBenchmark, FileVsPlugIn)
+{
+    auto name = GetOriginURL() + "/test/direct_binding_benchmark";
+    ASSERT_NO_FATAL_FAILURE(WritePattern(name, m_object_size, 'a', 1024 * 1024));
+    auto url = name + "?authz=" + GetReadToken();
+
+    XrdCl::File fh;
+    auto rv = fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, static_cast<XrdClCurl::File::timeout_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    std::string pointer_str;
+    ASSERT_TRUE(fh.GetProperty("XrdClCurlFilePlugIn", pointer_str));
+    auto plugin = reinterpret_cast<XrdCl::FilePlugIn *>(std::stoull(pointer_str, nullptr, 16));
+    ASSERT_NE(plugin, nullptr);
+
+    auto file_read = [&](uint64_t offset, char *buffer, XrdCl::ResponseHandler *handler) {
+        return fh.Read(offset, m_read_size, buffer, handler, static_cast<XrdClCurl::File::timeout_t>(10));
+    };
+    auto direct_read = [&](uint64_t offset, char *buffer, XrdCl::ResponseHandler *handler) {
+        return plugin->Read(offset, m_read_size, buffer, handler, static_cast<XrdClCurl::File::timeout_t>(10));
+    };
+
+    // Warm up the connection before timing; alternate the two paths so neither
+    // benefits from running second.
+    const int count = 1000;
+    TimeReads(file_read, 50);
+    double file_us = 0, direct_us = 0;
+    for (int round = 0; round < 2; round++) {
+        file_us += TimeReads(file_read, count) / 2;
+        direct_us += TimeReads(direct_read, count) / 2;
+    }
+    ASSERT_TRUE(fh.Close().IsOK());
+
+    std::cout << "Mean 4KB read latency through XrdCl::File (us): " << file_us << std::endl;
+    std::cout << "Mean 4KB read latency through the plugin handle (us): " << direct_us << std::endl;
+    std::cout << "Per-operation overhead of the XrdCl::File layer (us): " << file_us - direct_us << std::endl;
+    RecordProperty("file_read_us", std::to_string(file_us));
+    RecordProperty("direct_read_us", std::to_string(direct_us));
+}
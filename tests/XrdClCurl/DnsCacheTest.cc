@@ -0,0 +1,81 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "common/XrdClCurlDnsCache.hh"
+
+#include <gtest/gtest.h>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+TEST(DnsCache, ParseHostPort) {
+    std::string host, port;
+    ASSERT_TRUE(DnsCache::ParseHostPort("https://Cache.Example.com/foo?bar", host, port));
+    EXPECT_EQ(host, "cache.example.com");
+    EXPECT_EQ(port, "443");
+    ASSERT_TRUE(DnsCache::ParseHostPort("http://user@cache.example.com:8000/foo", host, port));
+    EXPECT_EQ(host, "cache.example.com");
+    EXPECT_EQ(port, "8000");
+    ASSERT_TRUE(DnsCache::ParseHostPort("http://cache.example.com", host, port));
+    EXPECT_EQ(port, "80");
+
+    // Literal addresses and unknown schemes are left alone.
+    EXPECT_FALSE(DnsCache::ParseHostPort("https://192.0.2.1/foo", host, port));
+    EXPECT_FALSE(DnsCache::ParseHostPort("https://[2001:db8::1]:8443/foo", host, port));
+    EXPECT_FALSE(DnsCache::ParseHostPort("pelican://cache.example.com/foo", host, port));
+    EXPECT_FALSE(DnsCache::ParseHostPort("/foo", host, port));
+}
+
+TEST(DnsCache, ResolveEntry) {
+    auto &cache = DnsCache::Instance();
+    static std::atomic<bool> fail{false};
+    cache.SetResolver([](const std::string &host, std::vector<std::string> &addrs) {
+        if (fail || host != "dns-test.example.com") {
+            return false;
+        }
+        addrs = {"192.0.2.1", "[2001:db8::1]"};
+        return true;
+    });
+    cache.Configure(60s);
+
+    // The first lookup only registers the host; curl resolves it itself.
+    std::string entry;
+    EXPECT_FALSE(cache.GetResolveEntry("https://dns-test.example.com/foo", entry));
+
+    cache.Refresh(DnsCache::Clock::now());
+    ASSERT_TRUE(cache.GetResolveEntry("https://dns-test.example.com:8443/foo", entry));
+    EXPECT_EQ(entry, "dns-test.example.com:8443:192.0.2.1,[2001:db8::1]");
+
+    // A failed refresh keeps the previous addresses.
+    fail = true;
+    cache.Refresh(DnsCache::Clock::now() + 61s);
+    ASSERT_TRUE(cache.GetResolveEntry("https://dns-test.example.com/foo", entry));
+    EXPECT_EQ(entry, "dns-test.example.com:443:192.0.2.1,[2001:db8::1]");
+
+    // Hosts left unused are eventually dropped.
+    cache.Refresh(DnsCache::Clock::now() + 1h);
+    EXPECT_FALSE(cache.GetResolveEntry("https://dns-test.example.com/foo", entry));
+
+    auto json = cache.GetMonitoringJson();
+    EXPECT_NE(json.find("\"hits\":"), std::string::npos);
+
+    // Disabling the cache leaves all resolution to curl.
+    cache.Configure(0s);
+    EXPECT_FALSE(cache.GetResolveEntry("https://dns-test.example.com/foo", entry));
+    cache.SetResolver(nullptr);
+}
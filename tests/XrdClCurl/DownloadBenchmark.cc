@@ -0,0 +1,126 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Benchmark comparing the download rate of an object copied to a local file
+// through a sequence of File::Read calls (as done by xrdcp) with the rate when
+// the destination file is handed to the plugin through `XrdClCurlDownloadPath`.
+//
+// The benchmark only runs when XRDCLCURL_DOWNLOAD_BENCHMARK_MB is set to the
+// object size, in MB; DownloadTest covers the functionality.
+
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClFile.hh>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+double ElapsedSec(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+class DownloadBenchmark : public TransferFixture {
+protected:
+    void SetUp() override {
+        TransferFixture::SetUp();
+
+        auto env = getenv("XRDCLCURL_DOWNLOAD_BENCHMARK_MB");
+        uint64_t size_mb = env ? std::strtoull(env, nullptr, 10) : 0;
+        if (!size_mb) {
+            GTEST_SKIP() << "Set XRDCLCURL_DOWNLOAD_BENCHMARK_MB to run the download benchmark";
+        }
+        m_size = size_mb * 1024 * 1024;
+
+        char fname[] = "/tmp/xrdclcurl_download_benchmark.XXXXXX";
+        auto fd = mkstemp(fname);
+        ASSERT_NE(fd, -1);
+        close(fd);
+        m_fname = fname;
+    }
+
+    void TearDown() override {
+        if (!m_fname.empty()) unlink(m_fname.c_str());
+    }
+
+    static constexpr size_t m_chunk_size{8 * 1024 * 1024};
+    uint64_t m_size{0};
+    std::string m_fname;
+};
+
+TEST_F(DownloadBenchmark, ReadVsLocalFile)
+{
+    auto name = GetOriginURL() + "/test/download_benchmark";
+    ASSERT_NO_FATAL_FAILURE(WritePattern(name, m_size, 'a', m_chunk_size));
+    auto url = name + "?authz=" + GetReadToken();
+
+    // Download through a read-then-write loop, as a copy to a local file would.
+    auto start = std::chrono::steady_clock::now();
+    {
+        XrdCl::File fh;
+        auto rv = fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, static_cast<XrdClCurl::File::timeout_t>(10));
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+        auto fd = open(m_fname.c_str(), O_WRONLY | O_TRUNC);
+        ASSERT_NE(fd, -1);
+        std::vector<char> buffer(m_chunk_size);
+        uint64_t offset = 0;
+        while (offset < m_size) {
+            uint32_t bytes_read = 0;
+            rv = fh.Read(offset, buffer.size(), buffer.data(), bytes_read, static_cast<XrdClCurl::File::timeout_t>(60));
+            ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+            ASSERT_GT(bytes_read, 0u);
+            ASSERT_EQ(pwrite(fd, buffer.data(), bytes_read, offset), static_cast<ssize_t>(bytes_read));
+            offset += bytes_read;
+        }
+        close(fd);
+        ASSERT_TRUE(fh.Close().IsOK());
+    }
+    auto read_rate = m_size / ElapsedSec(start) / 1e9;
+
+    // Download by handing the destination file to the plugin.
+    start = std::chrono::steady_clock::now();
+    {
+        XrdCl::File fh;
+        auto rv = fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, static_cast<XrdClCurl::File::timeout_t>(10));
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+        ASSERT_TRUE(fh.SetProperty("XrdClCurlDownloadPath", m_fname));
+        rv = fh.Close(static_cast<XrdClCurl::File::timeout_t>(60));
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    }
+    auto direct_rate = m_size / ElapsedSec(start) / 1e9;
+
+    struct stat buf;
+    ASSERT_EQ(stat(m_fname.c_str(), &buf), 0);
+    EXPECT_EQ(static_cast<uint64_t>(buf.st_size), m_size);
+
+    std::cout << "Download rate with File::Read (GB/s): " << read_rate << std::endl;
+    std::cout << "Download rate to a local file (GB/s): " << direct_rate << std::endl;
+    RecordProperty("read_download_gbps", std::to_string(read_rate));
+    RecordProperty("direct_download_gbps", std::to_string(direct_rate));
+}
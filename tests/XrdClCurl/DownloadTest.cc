@@ -0,0 +1,181 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Functional tests of downloads into a local file through the
+// `XrdClCurlDownloadPath` and `XrdClCurlDownloadFd` properties.
+
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClFile.hh>
+#include <XrdCl/XrdClFileSystem.hh>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <string>
+#include <vector>
+
+class DownloadFixture : public TransferFixture {
+protected:
+    void SetUp() override {
+        TransferFixture::SetUp();
+        ASSERT_NO_FATAL_FAILURE(CreateLocalFile());
+    }
+
+    // Upload an object with the `WritePattern` contents and return its URL for reading.
+    std::string Upload(const std::string &name, off_t size) {
+        auto url = GetOriginURL() + "/test/" + name;
+        WritePattern(url, size, 'a', m_local_chunk_size);
+        return url + "?authz=" + GetReadToken();
+    }
+
+    // Download `url` by setting `property` to `value` on the handle before closing it.
+    XrdCl::XRootDStatus Download(const std::string &url, const std::string &property, const std::string &value,
+        const std::vector<std::pair<std::string, std::string>> &extra = {})
+    {
+        XrdCl::File fh;
+        auto rv = fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, static_cast<XrdClCurl::File::timeout_t>(10));
+        if (!rv.IsOK()) return rv;
+        for (const auto &[name, setting] : extra) {
+            EXPECT_TRUE(fh.SetProperty(name, setting));
+        }
+        EXPECT_TRUE(fh.SetProperty(property, value));
+        return fh.Close(static_cast<XrdClCurl::File::timeout_t>(30));
+    }
+
+    // Fill the local file with `size` bytes of unrelated data.
+    void FillLocalJunk(off_t size) {
+        auto fd = open(GetLocalFile().c_str(), O_WRONLY | O_TRUNC);
+        ASSERT_NE(fd, -1);
+        std::string junk(size, 'z');
+        ASSERT_EQ(write(fd, junk.data(), junk.size()), static_cast<ssize_t>(junk.size()));
+        close(fd);
+    }
+};
+
+TEST_F(DownloadFixture, ToPath)
+{
+    off_t size = 1'000'123;
+    auto url = Upload("download_path", size);
+
+    auto rv = Download(url, "XrdClCurlDownloadPath", GetLocalFile());
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    ASSERT_NO_FATAL_FAILURE(VerifyLocalPattern(size));
+
+    // Without preallocation, the contents are the same.
+    FillLocalJunk(3 * size);
+    rv = Download(url, "XrdClCurlDownloadPath", GetLocalFile(), {{"XrdClCurlDownloadPreallocate", "false"}, {"XrdClCurlDownloadSync", "true"}});
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    ASSERT_NO_FATAL_FAILURE(VerifyLocalPattern(size));
+}
+
+TEST_F(DownloadFixture, ToFd)
+{
+    off_t size = 700'001;
+    auto url = Upload("download_fd", size);
+
+    // A caller-provided file larger than the object is truncated to it, whether or
+    // not the space was preallocated, and is left open.
+    for (auto preallocate : {"true", "false"}) {
+        FillLocalJunk(3 * size);
+        auto fd = open(GetLocalFile().c_str(), O_RDWR);
+        ASSERT_NE(fd, -1);
+        auto rv = Download(url, "XrdClCurlDownloadFd", std::to_string(fd), {{"XrdClCurlDownloadPreallocate", preallocate}});
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+        EXPECT_NE(fcntl(fd, F_GETFD), -1);
+        close(fd);
+        ASSERT_NO_FATAL_FAILURE(VerifyLocalPattern(size));
+    }
+}
+
+// With O_DIRECT, the body is staged in an aligned buffer; an object larger than the
+// staging buffer and not a multiple of the block size exercises both the full-stage
+// flushes and the unaligned tail.
+TEST_F(DownloadFixture, Direct)
+{
+#ifndef O_DIRECT
+    GTEST_SKIP() << "O_DIRECT is not available on this platform";
+#else
+    auto probe = open(GetLocalFile().c_str(), O_WRONLY | O_DIRECT);
+    if (probe == -1 && errno == EINVAL) {
+        GTEST_SKIP() << "The working directory does not support O_DIRECT";
+    }
+    ASSERT_NE(probe, -1);
+    close(probe);
+
+    off_t size = 9 * 1024 * 1024 + 4096 * 3 + 1234;
+    auto url = Upload("download_direct", size);
+    auto rv = Download(url, "XrdClCurlDownloadPath", GetLocalFile(), {{"XrdClCurlDownloadDirect", "true"}});
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    ASSERT_NO_FATAL_FAILURE(VerifyLocalPattern(size));
+
+    // A body smaller than a block is entirely tail.
+    size = 1000;
+    url = Upload("download_direct_small", size);
+    rv = Download(url, "XrdClCurlDownloadPath", GetLocalFile(), {{"XrdClCurlDownloadDirect", "true"}});
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    ASSERT_NO_FATAL_FAILURE(VerifyLocalPattern(size));
+
+    // Writing the tail of a caller's O_DIRECT descriptor leaves its flags unchanged.
+    auto fd = open(GetLocalFile().c_str(), O_WRONLY | O_DIRECT);
+    ASSERT_NE(fd, -1);
+    rv = Download(url, "XrdClCurlDownloadFd", std::to_string(fd));
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    auto flags = fcntl(fd, F_GETFL);
+    close(fd);
+    ASSERT_NE(flags, -1);
+    EXPECT_TRUE(flags & O_DIRECT);
+    ASSERT_NO_FATAL_FAILURE(VerifyLocalPattern(size));
+#endif
+}
+
+TEST_F(DownloadFixture, Errors)
+{
+    auto url = Upload("download_errors", 10'000);
+
+    // Invalid destinations are reported by Close.
+    auto rv = Download(url, "XrdClCurlDownloadFd", "not-a-descriptor");
+    EXPECT_FALSE(rv.IsOK());
+    EXPECT_EQ(rv.code, XrdCl::errInvalidArgs);
+
+    rv = Download(url, "XrdClCurlDownloadPath", "nonexistent-directory/" + GetLocalFile());
+    EXPECT_FALSE(rv.IsOK());
+    EXPECT_EQ(rv.code, XrdCl::errOSError);
+
+    // A descriptor that can't be written fails the transfer.
+    auto fd = open(GetLocalFile().c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+    rv = Download(url, "XrdClCurlDownloadFd", std::to_string(fd));
+    close(fd);
+    EXPECT_FALSE(rv.IsOK());
+
+    // An object removed after the open fails the GET.
+    XrdCl::File fh;
+    rv = fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, static_cast<XrdClCurl::File::timeout_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    XrdCl::FileSystem fs(GetOriginURL());
+    rv = fs.Rm("/test/download_errors?authz=" + GetWriteToken(), 10);
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    ASSERT_TRUE(fh.SetProperty("XrdClCurlDownloadPath", GetLocalFile()));
+    rv = fh.Close(static_cast<XrdClCurl::File::timeout_t>(30));
+    EXPECT_FALSE(rv.IsOK());
+    EXPECT_EQ(rv.errNo, kXR_NotFound);
+}
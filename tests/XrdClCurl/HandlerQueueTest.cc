@@ -0,0 +1,217 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlOps.hh"
+#include "XrdClCurl/XrdClCurlUtil.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+#include <XrdCl/XrdClXRootDResponses.hh>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Records the status an operation failed with.
+class StatusHandler : public XrdCl::ResponseHandler {
+public:
+    void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) override {
+        delete response;
+        std::unique_lock lock(m_mutex);
+        m_status.reset(status);
+        m_cv.notify_all();
+    }
+
+    // Wait for the operation to fail; returns nullptr on timeout.
+    const XrdCl::XRootDStatus *Wait() {
+        std::unique_lock lock(m_mutex);
+        m_cv.wait_for(lock, 10s, [&]{return m_status != nullptr;});
+        return m_status.get();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::unique_ptr<XrdCl::XRootDStatus> m_status;
+};
+
+class HandlerQueueFixture : public ::testing::Test {
+protected:
+    // Create an operation that is never started.
+    std::shared_ptr<CurlOperation> MakeOp(XrdCl::ResponseHandler *handler = nullptr, timespec timeout = {10, 0}) {
+        return std::make_shared<CurlReadOp>(
+            handler, nullptr, "https://example.com/foo", timeout,
+            std::make_pair(uint64_t(0), uint64_t(sizeof(m_buffer))), m_buffer, sizeof(m_buffer),
+            XrdCl::DefaultEnv::GetLog(), nullptr, nullptr);
+    }
+
+    // Fill the queue to its capacity; returns the operations produced.
+    std::vector<std::shared_ptr<CurlOperation>> Fill(HandlerQueue &queue, size_t count) {
+        std::vector<std::shared_ptr<CurlOperation>> ops;
+        for (size_t idx = 0; idx < count; idx++) {
+            ops.push_back(MakeOp());
+            queue.Produce(ops.back());
+        }
+        return ops;
+    }
+
+    char m_buffer[16];
+};
+
+}
+
+TEST_F(HandlerQueueFixture, ParseAdmissionMode) {
+    HandlerQueue::AdmissionMode mode;
+    ASSERT_TRUE(HandlerQueue::ParseAdmissionMode("block", mode));
+    EXPECT_EQ(mode, HandlerQueue::AdmissionMode::Block);
+    ASSERT_TRUE(HandlerQueue::ParseAdmissionMode("overflow", mode));
+    EXPECT_EQ(mode, HandlerQueue::AdmissionMode::Overflow);
+    ASSERT_TRUE(HandlerQueue::ParseAdmissionMode("reject", mode));
+    EXPECT_EQ(mode, HandlerQueue::AdmissionMode::Reject);
+    EXPECT_FALSE(HandlerQueue::ParseAdmissionMode("unbounded", mode));
+}
+
+// A full queue blocks the producer by default until a worker takes an operation.
+TEST_F(HandlerQueueFixture, Block) {
+    HandlerQueue queue(2);
+    auto ops = Fill(queue, 2);
+
+    auto op = MakeOp();
+    std::atomic<bool> produced{false};
+    std::thread producer([&]{
+        queue.Produce(op);
+        produced = true;
+    });
+    std::this_thread::sleep_for(100ms);
+    EXPECT_FALSE(produced);
+
+    EXPECT_EQ(queue.TryConsume().get(), ops[0].get());
+    producer.join();
+    EXPECT_TRUE(produced);
+    EXPECT_EQ(queue.TryConsume().get(), ops[1].get());
+    EXPECT_EQ(queue.TryConsume().get(), op.get());
+    EXPECT_FALSE(op->IsDone());
+}
+
+// A blocked producer gives up once the operation expires.
+TEST_F(HandlerQueueFixture, BlockExpiry) {
+    HandlerQueue queue(1);
+    queue.SetAdmissionMode(HandlerQueue::AdmissionMode::Block);
+    auto ops = Fill(queue, 1);
+
+    StatusHandler handler;
+    auto op = MakeOp(&handler, {0, 200'000'000});
+    auto start = std::chrono::steady_clock::now();
+    queue.Produce(op);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 150ms);
+
+    auto status = handler.Wait();
+    ASSERT_NE(status, nullptr);
+    EXPECT_EQ(status->code, XrdCl::errOperationExpired);
+    EXPECT_EQ(queue.TryConsume().get(), ops[0].get());
+    EXPECT_FALSE(queue.TryConsume());
+}
+
+// A full queue immediately fails new operations with a retryable error.
+TEST_F(HandlerQueueFixture, Reject) {
+    HandlerQueue queue(2);
+    queue.SetAdmissionMode(HandlerQueue::AdmissionMode::Reject);
+    auto ops = Fill(queue, 2);
+
+    StatusHandler handler;
+    auto op = MakeOp(&handler);
+    queue.Produce(op);
+    EXPECT_TRUE(op->IsDone());
+    auto status = handler.Wait();
+    ASSERT_NE(status, nullptr);
+    EXPECT_EQ(status->code, XrdCl::errRetry);
+    EXPECT_EQ(status->errNo, static_cast<uint32_t>(EAGAIN));
+
+    // Once there is space, operations are accepted again.
+    EXPECT_EQ(queue.TryConsume().get(), ops[0].get());
+    auto next = MakeOp();
+    queue.Produce(next);
+    EXPECT_FALSE(next->IsDone());
+    EXPECT_EQ(queue.TryConsume().get(), ops[1].get());
+    EXPECT_EQ(queue.TryConsume().get(), next.get());
+}
+
+// A full queue keeps new operations on the overflow list and admits them in order.
+TEST_F(HandlerQueueFixture, Overflow) {
+    HandlerQueue queue(2);
+    queue.SetAdmissionMode(HandlerQueue::AdmissionMode::Overflow);
+    auto ops = Fill(queue, 5);
+
+    for (const auto &op : ops) {
+        auto consumed = queue.TryConsume();
+        ASSERT_TRUE(consumed);
+        EXPECT_EQ(consumed.get(), op.get());
+        EXPECT_FALSE(op->IsDone());
+    }
+    EXPECT_FALSE(queue.TryConsume());
+}
+
+// A delayed operation due while the queue is full is rejected in reject mode.
+TEST_F(HandlerQueueFixture, DelayedReject) {
+    HandlerQueue queue(1);
+    queue.SetAdmissionMode(HandlerQueue::AdmissionMode::Reject);
+    auto ops = Fill(queue, 1);
+
+    StatusHandler handler;
+    auto op = MakeOp(&handler);
+    queue.ProduceAfter(op, std::chrono::steady_clock::now());
+    std::this_thread::sleep_for(50ms);
+    queue.Expire();
+
+    auto status = handler.Wait();
+    ASSERT_NE(status, nullptr);
+    EXPECT_EQ(status->code, XrdCl::errRetry);
+    EXPECT_EQ(queue.TryConsume().get(), ops[0].get());
+    EXPECT_FALSE(queue.TryConsume());
+}
+
+// A delayed operation due while the queue is full waits for space in block mode.
+TEST_F(HandlerQueueFixture, DelayedBlock) {
+    HandlerQueue queue(1);
+    queue.SetAdmissionMode(HandlerQueue::AdmissionMode::Block);
+    auto ops = Fill(queue, 1);
+
+    auto op = MakeOp();
+    queue.ProduceAfter(op, std::chrono::steady_clock::now());
+    std::this_thread::sleep_for(50ms);
+    queue.Expire();
+    EXPECT_FALSE(op->IsDone());
+
+    // The operation is not placed on the overflow list; it joins the queue once
+    // a later call to Expire finds space.
+    EXPECT_EQ(queue.TryConsume().get(), ops[0].get());
+    EXPECT_FALSE(queue.TryConsume());
+    std::this_thread::sleep_for(50ms);
+    queue.Expire();
+    EXPECT_EQ(queue.TryConsume().get(), op.get());
+    EXPECT_FALSE(op->IsDone());
+}
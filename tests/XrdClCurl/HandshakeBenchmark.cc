@@ -0,0 +1,88 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Benchmark comparing the rate of TLS handshakes when each connection loads the
+// CA trust store from disk (CURLOPT_CAINFO) versus using the shared in-memory
+// store from XrdClCurl::CAStore.
+
+#include "common/XrdClCurlCAStore.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <curl/curl.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+size_t NullWrite(char *, size_t size, size_t nitems, void *) {
+    return size * nitems;
+}
+
+// Perform `count` requests against `url`, each on a fresh handle and connection.
+// Returns the number of handshakes per second.
+double RunHandshakes(const std::string &url, const std::string &ca_file, bool use_store, int count) {
+    auto start = std::chrono::steady_clock::now();
+    for (int idx = 0; idx < count; idx++) {
+        auto curl = curl_easy_init();
+        EXPECT_NE(curl, nullptr);
+        if (!curl) return 0;
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+        curl_easy_setopt(curl, CURLOPT_FORBID_REUSE, 1L);
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, NullWrite);
+        if (use_store) {
+            XrdClCurl::CAStore::Instance().ConfigureHandle(curl);
+        } else {
+            curl_easy_setopt(curl, CURLOPT_CAINFO, ca_file.c_str());
+        }
+        auto rv = curl_easy_perform(curl);
+        EXPECT_EQ(rv, CURLE_OK) << "Request failed: " << curl_easy_strerror(rv);
+        curl_easy_cleanup(curl);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return count / elapsed;
+}
+
+}
+
+class HandshakeBenchmark : public TransferFixture {};
+
+TEST_F(HandshakeBenchmark, CAStoreVsCAInfo)
+{
+    auto ca_file = GetEnv("X509_CA_FILE");
+    ASSERT_FALSE(ca_file.empty());
+    XrdClCurl::CAStore::Instance().SetLocations(ca_file, "");
+
+    auto url = GetOriginURL() + "/test/handshake_benchmark";
+    const int count = 200;
+
+    // Warm up the server side and the store before timing.
+    RunHandshakes(url, ca_file, true, 5);
+
+    auto cainfo_rate = RunHandshakes(url, ca_file, false, count);
+    auto store_rate = RunHandshakes(url, ca_file, true, count);
+    std::cout << "Handshakes per second with CURLOPT_CAINFO: " << cainfo_rate << std::endl;
+    std::cout << "Handshakes per second with shared CA store: " << store_rate << std::endl;
+    RecordProperty("cainfo_handshakes_per_sec", std::to_string(cainfo_rate));
+    RecordProperty("castore_handshakes_per_sec", std::to_string(store_rate));
+
+    EXPECT_GE(XrdClCurl::CAStore::Instance().GetContextsConfigured(), static_cast<uint64_t>(count));
+}
@@ -0,0 +1,180 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlFactory.hh"
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "XrdClCurl/XrdClCurlObjectCache.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::shared_ptr<const ObjectCache::Object> MakeObject(const std::string &etag, size_t size) {
+    auto object = std::make_shared<ObjectCache::Object>();
+    object->m_etag = etag;
+    object->m_data.assign(size, 'x');
+    return object;
+}
+
+}
+
+TEST(ObjectCache, TTLAndETag) {
+    auto &cache = ObjectCache::Instance();
+    cache.Configure(16 * 1024 * 1024, 1024, 60s);
+    EXPECT_TRUE(cache.IsCacheable(1024));
+    EXPECT_FALSE(cache.IsCacheable(1025));
+
+    auto now = ObjectCache::Clock::now();
+    const std::string url = "https://example.com/ttl.cfg";
+    EXPECT_EQ(cache.Get(url, now), nullptr);
+    cache.Put(url, MakeObject("\"v1\"", 100), now);
+    auto object = cache.Get(url, now + 30s);
+    ASSERT_NE(object, nullptr);
+    EXPECT_EQ(object->m_data.size(), 100u);
+
+    // Past the TTL, the object is only used once the server confirms its ETag.
+    EXPECT_EQ(cache.Get(url, now + 61s), nullptr);
+    ASSERT_NE(cache.Revalidate(url, "\"v1\"", now + 61s), nullptr);
+    EXPECT_NE(cache.Get(url, now + 90s), nullptr);
+
+    // A changed object is dropped.
+    EXPECT_EQ(cache.Revalidate(url, "\"v2\"", now + 90s), nullptr);
+    EXPECT_EQ(cache.Revalidate(url, "\"v1\"", now + 90s), nullptr);
+
+    // Objects too large for the cache are ignored.
+    cache.Put(url, MakeObject("\"v3\"", 2048), now);
+    EXPECT_EQ(cache.Get(url, now), nullptr);
+}
+
+TEST(ObjectCache, Eviction) {
+    auto &cache = ObjectCache::Instance();
+    // 16 shards of 1KB each; every object fills half a shard.
+    cache.Configure(16 * 1024, 512, 60s);
+    auto now = ObjectCache::Clock::now();
+    std::vector<std::string> urls;
+    for (int idx = 0; idx < 64; idx++) {
+        urls.push_back("https://example.com/evict/" + std::to_string(idx));
+        cache.Put(urls.back(), MakeObject("", 512), now);
+    }
+    size_t present = 0;
+    for (const auto &url : urls) {
+        if (cache.Get(url, now)) present++;
+    }
+    EXPECT_LE(present, 32u);
+    EXPECT_GT(present, 0u);
+    // The most recent insert is never evicted by older ones.
+    EXPECT_NE(cache.Get(urls.back(), now), nullptr);
+
+    auto json = cache.GetMonitoringJson();
+    EXPECT_EQ(json.find("\"evictions\":0,"), std::string::npos);
+}
+
+TEST(ObjectCache, SingleFlight) {
+    auto &cache = ObjectCache::Instance();
+    cache.Configure(16 * 1024 * 1024, 1024 * 1024, 60s);
+    const std::string url = "https://example.com/fill.cfg";
+
+    std::vector<std::shared_ptr<const ObjectCache::Object>> results;
+    auto callback = [&](std::shared_ptr<const ObjectCache::Object> object) {results.push_back(object);};
+    EXPECT_TRUE(cache.StartFill(url, callback));
+    EXPECT_FALSE(cache.StartFill(url, callback));
+    EXPECT_FALSE(cache.StartFill(url, callback));
+    EXPECT_TRUE(results.empty());
+
+    cache.FinishFill(url, MakeObject("\"fill\"", 10));
+    ASSERT_EQ(results.size(), 3u);
+    for (const auto &object : results) {
+        ASSERT_NE(object, nullptr);
+        EXPECT_EQ(object->m_etag, "\"fill\"");
+    }
+    EXPECT_NE(cache.Get(url), nullptr);
+
+    // A failed fill wakes up the waiters without caching anything.
+    results.clear();
+    const std::string failed = "https://example.com/failed.cfg";
+    EXPECT_TRUE(cache.StartFill(failed, callback));
+    EXPECT_FALSE(cache.StartFill(failed, callback));
+    cache.FinishFill(failed, nullptr);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0], nullptr);
+    EXPECT_EQ(cache.Get(failed), nullptr);
+
+    // Once finished, the next fill starts anew.
+    EXPECT_TRUE(cache.StartFill(failed, callback));
+    cache.FinishFill(failed, nullptr);
+    cache.Configure(0, 1024 * 1024, 60s);
+}
+
+class ObjectCacheFixture : public TransferFixture {};
+
+// A handle opened from the object cache supports every operation of a handle
+// opened from the server.
+TEST_F(ObjectCacheFixture, OpenFromCache) {
+    std::unique_ptr<Factory> factory(new Factory());
+    auto name = GetOriginURL() + "/test/object_cache_open";
+    ASSERT_NO_FATAL_FAILURE(WritePattern(name, 4 * 1024, 'a', 1024));
+    auto url = name + "?authz=" + GetReadToken();
+
+    std::unique_ptr<XrdCl::FilePlugIn> fh(factory->CreateFile(url));
+    auto &cache = ObjectCache::Instance();
+    cache.Configure(1024 * 1024, 64 * 1024, 60s);
+    auto object = std::make_shared<ObjectCache::Object>();
+    object->m_data.assign(4 * 1024, 'x');
+    cache.Put(url, object);
+
+    SyncResponseHandler open_handler;
+    auto rv = fh->Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, &open_handler, static_cast<File::timeout_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    open_handler.Wait();
+    auto [open_status, open_obj] = open_handler.Status();
+    ASSERT_TRUE(open_status->IsOK()) << open_status->ToString();
+
+    std::string value;
+    ASSERT_TRUE(fh->GetProperty("IsPrefetching", value));
+    EXPECT_EQ(value, "false");
+
+    std::vector<char> buffer(1024);
+    SyncResponseHandler read_handler;
+    rv = fh->PgRead(1024, buffer.size(), buffer.data(), &read_handler, static_cast<File::timeout_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    read_handler.Wait();
+    auto [read_status, read_obj] = read_handler.Status();
+    ASSERT_TRUE(read_status->IsOK()) << read_status->ToString();
+    XrdCl::PageInfo *page_info = nullptr;
+    ASSERT_TRUE(read_obj);
+    read_obj->Get(page_info);
+    ASSERT_NE(page_info, nullptr);
+    EXPECT_EQ(page_info->GetLength(), 1024u);
+    // The handle was opened from the cache, so the read is served from the cached
+    // contents rather than the server's.
+    EXPECT_EQ(std::string(buffer.data(), buffer.size()), std::string(1024, 'x'));
+
+    SyncResponseHandler close_handler;
+    ASSERT_TRUE(fh->Close(&close_handler, static_cast<File::timeout_t>(10)).IsOK());
+    close_handler.Wait();
+    cache.Configure(0, 1024 * 1024, 60s);
+}
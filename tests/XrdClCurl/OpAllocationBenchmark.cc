@@ -0,0 +1,99 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Benchmark comparing the cost of allocating read operations individually on the
+// heap with allocating them from the block pool.  As in the client, operations are
+// created on one thread and destroyed on another (the curl worker).
+
+#include "common/XrdClCurlPool.hh"
+#include "XrdClCurl/XrdClCurlOps.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Create `count` read operations with `create` on one thread, in batches destroyed
+// by a second thread; returns the mean time per operation in nanoseconds.
+template<typename CreateFunc>
+double TimeOps(CreateFunc create, size_t count) {
+    const size_t batch_size = 256;
+    std::vector<std::shared_ptr<XrdClCurl::CurlOperation>> batch;
+    batch.reserve(batch_size);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t idx = 0; idx < count; idx += batch_size) {
+        for (size_t op = 0; op < batch_size; op++) {
+            batch.emplace_back(create());
+        }
+        std::thread consumer([&] {batch.clear();});
+        consumer.join();
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / count;
+}
+
+}
+
+TEST(OpAllocationBenchmark, HeapVsPool)
+{
+    auto logger = XrdCl::DefaultEnv::GetLog();
+    char buffer[16];
+    auto heap_op = [&] {
+        return std::shared_ptr<XrdClCurl::CurlReadOp>(new XrdClCurl::CurlReadOp(
+            nullptr, nullptr, "https://example.com/foo", {10, 0}, {0, sizeof(buffer)},
+            buffer, sizeof(buffer), logger, nullptr, nullptr));
+    };
+    auto pooled_op = [&] {
+        return XrdClCurl::MakePooled<XrdClCurl::CurlReadOp>(
+            nullptr, nullptr, "https://example.com/foo", timespec{10, 0}, std::make_pair(uint64_t(0), uint64_t(sizeof(buffer))),
+            buffer, sizeof(buffer), logger, nullptr, nullptr);
+    };
+
+    // The operation and its control block must fit in a pooled block to benefit.
+    ASSERT_LT(sizeof(XrdClCurl::CurlReadOp) + 64, XrdClCurl::BlockPool::m_max_block);
+
+    const size_t count = 256 * 1024;
+    TimeOps(pooled_op, count / 16);
+    auto heap_start = XrdClCurl::BlockPool::GetHeapAllocations();
+    auto reuse_start = XrdClCurl::BlockPool::GetReuses();
+    double heap_ns = 0, pooled_ns = 0;
+    for (int round = 0; round < 2; round++) {
+        heap_ns += TimeOps(heap_op, count) / 2;
+        pooled_ns += TimeOps(pooled_op, count) / 2;
+    }
+    auto pool_heap_allocs = XrdClCurl::BlockPool::GetHeapAllocations() - heap_start;
+    auto pool_reuses = XrdClCurl::BlockPool::GetReuses() - reuse_start;
+    auto allocs_per_op = static_cast<double>(pool_heap_allocs) / (2 * count);
+
+    std::cout << "Mean read operation lifecycle with heap allocation (ns): " << heap_ns << std::endl;
+    std::cout << "Mean read operation lifecycle with pooled allocation (ns): " << pooled_ns << std::endl;
+    std::cout << "Pool blocks taken from the heap per operation: " << allocs_per_op
+              << " (" << pool_reuses << " reused)" << std::endl;
+    RecordProperty("heap_op_ns", std::to_string(heap_ns));
+    RecordProperty("pooled_op_ns", std::to_string(pooled_ns));
+    RecordProperty("pool_heap_allocs_per_op", std::to_string(allocs_per_op));
+
+    // In steady state, nearly every operation should reuse a recycled block.
+    EXPECT_LT(allocs_per_op, 0.1);
+}
@@ -0,0 +1,160 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "common/XrdClCurlPool.hh"
+
+#include <gtest/gtest.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace XrdClCurl;
+
+namespace {
+
+class PooledObject : public Pooled {
+public:
+    PooledObject(int value) : m_value(value) {}
+    virtual ~PooledObject() {}
+
+    int m_value;
+    char m_padding[200];
+};
+
+// Allocates a block when destroyed.  A thread_local instance constructed before
+// the thread's first use of the pool is destroyed after the pool's thread cache.
+struct LateAllocator {
+    ~LateAllocator() {
+        if (m_size) *m_result = BlockPool::Allocate(m_size);
+    }
+
+    size_t m_size{0};
+    void **m_result{nullptr};
+};
+
+}
+
+TEST(BlockPool, Reuse) {
+    auto ptr = BlockPool::Allocate(100);
+    ASSERT_NE(ptr, nullptr);
+    BlockPool::Deallocate(ptr, 100);
+
+    // A request in the same size class is served from the freed block.
+    auto reuses = BlockPool::GetReuses();
+    auto heap = BlockPool::GetHeapAllocations();
+    auto ptr2 = BlockPool::Allocate(120);
+    EXPECT_EQ(ptr2, ptr);
+    EXPECT_EQ(BlockPool::GetReuses(), reuses + 1);
+    EXPECT_EQ(BlockPool::GetHeapAllocations(), heap);
+    BlockPool::Deallocate(ptr2, 120);
+}
+
+TEST(BlockPool, LargeBlocks) {
+    auto heap = BlockPool::GetHeapAllocations();
+    auto ptr = BlockPool::Allocate(BlockPool::m_max_block + 1);
+    ASSERT_NE(ptr, nullptr);
+    BlockPool::Deallocate(ptr, BlockPool::m_max_block + 1);
+    ptr = BlockPool::Allocate(BlockPool::m_max_block + 1);
+    BlockPool::Deallocate(ptr, BlockPool::m_max_block + 1);
+    EXPECT_EQ(BlockPool::GetHeapAllocations(), heap + 2);
+}
+
+TEST(BlockPool, CrossThread) {
+    // Blocks allocated on one thread and freed on another return to the
+    // allocating thread through the depot instead of the heap.
+    const size_t count = 1024;
+    const size_t size = 500;
+    for (int round = 0; round < 4; round++) {
+        std::vector<void *> blocks;
+        std::thread producer([&] {
+            for (size_t idx = 0; idx < count; idx++) {
+                blocks.push_back(BlockPool::Allocate(size));
+            }
+        });
+        producer.join();
+        std::thread consumer([&] {
+            for (auto block : blocks) {
+                BlockPool::Deallocate(block, size);
+            }
+        });
+        consumer.join();
+    }
+
+    auto heap = BlockPool::GetHeapAllocations();
+    std::vector<void *> blocks;
+    for (size_t idx = 0; idx < count / 2; idx++) {
+        blocks.push_back(BlockPool::Allocate(size));
+    }
+    EXPECT_EQ(BlockPool::GetHeapAllocations(), heap);
+    for (auto block : blocks) {
+        BlockPool::Deallocate(block, size);
+    }
+}
+
+TEST(BlockPool, Pooled) {
+    auto obj = new PooledObject(1);
+    delete obj;
+
+    auto heap = BlockPool::GetHeapAllocations();
+    obj = new PooledObject(2);
+    EXPECT_EQ(obj->m_value, 2);
+    delete obj;
+    EXPECT_EQ(BlockPool::GetHeapAllocations(), heap);
+}
+
+TEST(BlockPool, MakePooled) {
+    MakePooled<PooledObject>(1).reset();
+
+    auto heap = BlockPool::GetHeapAllocations();
+    auto obj = MakePooled<PooledObject>(3);
+    std::weak_ptr<PooledObject> weak = obj;
+    EXPECT_EQ(obj->m_value, 3);
+    obj.reset();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(BlockPool::GetHeapAllocations(), heap);
+}
+
+TEST(BlockPool, AfterCacheDestroyed) {
+    const size_t size = 100;
+    void *block = nullptr;
+    std::thread thread([&] {
+        thread_local LateAllocator late;
+        late.m_size = size;
+        late.m_result = &block;
+        BlockPool::Deallocate(BlockPool::Allocate(size), size);
+    });
+    thread.join();
+    ASSERT_NE(block, nullptr);
+
+    // The block is freed into this thread's cache and handed out for the
+    // largest request in its size class.
+    const size_t class_size = ((size - 1) / BlockPool::m_granularity + 1) * BlockPool::m_granularity;
+#ifdef __GLIBC__
+    EXPECT_GE(malloc_usable_size(block), class_size);
+#endif
+    BlockPool::Deallocate(block, size);
+    auto ptr = BlockPool::Allocate(class_size);
+    EXPECT_EQ(ptr, block);
+    memset(ptr, '\0', class_size);
+    BlockPool::Deallocate(ptr, class_size);
+}
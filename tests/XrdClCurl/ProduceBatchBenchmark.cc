@@ -0,0 +1,136 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Benchmark comparing the cost of enqueuing operations one at a time with
+// `HandlerQueue::Produce` to enqueuing them in batches with `ProduceBatch`.
+
+#include "XrdClCurl/XrdClCurlOps.hh"
+#include "XrdClCurl/XrdClCurlUtil.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+class ProduceBatchFixture : public ::testing::Test {
+protected:
+    // Create `count` operations that are never started.
+    std::vector<std::shared_ptr<XrdClCurl::CurlOperation>> MakeOps(size_t count) {
+        std::vector<std::shared_ptr<XrdClCurl::CurlOperation>> ops;
+        ops.reserve(count);
+        for (size_t idx = 0; idx < count; idx++) {
+            ops.emplace_back(std::make_shared<XrdClCurl::CurlReadOp>(
+                nullptr, nullptr, "https://example.com/foo", timespec{10, 0},
+                std::make_pair(uint64_t(0), uint64_t(sizeof(m_buffer))), m_buffer, sizeof(m_buffer),
+                XrdCl::DefaultEnv::GetLog(), nullptr, nullptr));
+        }
+        return ops;
+    }
+
+    // Remove all operations from the queue; returns the number removed.
+    size_t Drain(XrdClCurl::HandlerQueue &queue) {
+        size_t count = 0;
+        while (queue.TryConsume()) count++;
+        return count;
+    }
+
+    char m_buffer[16];
+};
+
+}
+
+TEST_F(ProduceBatchFixture, PartialAdmission)
+{
+    XrdClCurl::HandlerQueue queue(10);
+    queue.SetAdmissionMode(XrdClCurl::HandlerQueue::AdmissionMode::Reject);
+    auto ops = MakeOps(16);
+    std::vector<XrdClCurl::CurlOperation *> raw;
+    for (const auto &op : ops) raw.push_back(op.get());
+
+    // The first ops are admitted in order; the remainder are rejected.
+    queue.ProduceBatch(ops);
+    for (size_t idx = 0; idx < 10; idx++) {
+        auto op = queue.TryConsume();
+        ASSERT_TRUE(op);
+        EXPECT_EQ(op.get(), raw[idx]);
+    }
+    EXPECT_FALSE(queue.TryConsume());
+    for (size_t idx = 10; idx < ops.size(); idx++) {
+        EXPECT_TRUE(raw[idx]->IsDone());
+    }
+
+    // With the overflow mode, the remainder is admitted as space frees up.
+    queue.SetAdmissionMode(XrdClCurl::HandlerQueue::AdmissionMode::Overflow);
+    ops = MakeOps(16);
+    raw.clear();
+    for (const auto &op : ops) raw.push_back(op.get());
+    queue.ProduceBatch(ops);
+    for (size_t idx = 0; idx < ops.size(); idx++) {
+        auto op = queue.TryConsume();
+        ASSERT_TRUE(op);
+        EXPECT_EQ(op.get(), raw[idx]);
+    }
+    EXPECT_FALSE(queue.TryConsume());
+}
+
+TEST_F(ProduceBatchFixture, EnqueueCost)
+{
+    // Enough capacity that no operation waits; the poll pipe holds one byte per
+    // queued operation, so keep each round well under its capacity.
+    const size_t ops_per_round = 1024;
+    const int rounds = 64;
+    XrdClCurl::HandlerQueue queue(ops_per_round);
+
+    auto time_round = [&](size_t batch_size) {
+        auto ops = MakeOps(ops_per_round);
+        auto start = std::chrono::steady_clock::now();
+        if (batch_size == 0) {
+            for (auto &op : ops) queue.Produce(std::move(op));
+        } else {
+            for (size_t idx = 0; idx < ops.size(); idx += batch_size) {
+                queue.ProduceBatch(std::span(ops).subspan(idx, std::min(batch_size, ops.size() - idx)));
+            }
+        }
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_EQ(Drain(queue), ops_per_round);
+        return elapsed / ops_per_round;
+    };
+
+    auto time_batches = [&](size_t batch_size) {
+        time_round(batch_size);
+        double total = 0;
+        for (int round = 0; round < rounds; round++) {
+            total += time_round(batch_size);
+        }
+        return total / rounds;
+    };
+
+    auto produce_ns = time_batches(0);
+    std::cout << "Enqueue cost with Produce (ns/op): " << produce_ns << std::endl;
+    RecordProperty("produce_ns", std::to_string(produce_ns));
+    for (size_t batch_size = 1; batch_size <= ops_per_round; batch_size *= 4) {
+        auto batch_ns = time_batches(batch_size);
+        std::cout << "Enqueue cost with ProduceBatch of " << batch_size << " (ns/op): " << batch_ns << std::endl;
+        RecordProperty("produce_batch_" + std::to_string(batch_size) + "_ns", std::to_string(batch_ns));
+    }
+}
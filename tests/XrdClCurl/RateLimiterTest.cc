@@ -0,0 +1,97 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlRateLimiter.hh"
+
+#include <gtest/gtest.h>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+TEST(TokenBucket, BurstThenRate) {
+    TokenBucket bucket(100, 100);
+    auto now = std::chrono::steady_clock::now();
+
+    // The full burst is available immediately.
+    EXPECT_EQ(bucket.Reserve(100, now), std::chrono::steady_clock::duration::zero());
+
+    // Beyond the burst, reservations are granted but must wait for the refill.
+    auto wait = bucket.Reserve(50, now);
+    EXPECT_NEAR(std::chrono::duration<double>(wait).count(), 0.5, 0.001);
+    wait = bucket.Reserve(50, now);
+    EXPECT_NEAR(std::chrono::duration<double>(wait).count(), 1.0, 0.001);
+
+    // Once the debt has been paid off and the bucket refilled, there is no wait.
+    EXPECT_EQ(bucket.Reserve(100, now + 2s), std::chrono::steady_clock::duration::zero());
+    EXPECT_GT(bucket.Reserve(1, now + 2s), std::chrono::steady_clock::duration::zero());
+}
+
+TEST(RateLimiter, HostLimits) {
+    auto &limiter = RateLimiter::Instance();
+    limiter.Configure(0, 0, 0, 10);
+    EXPECT_FALSE(limiter.IsBytesLimited());
+    ASSERT_TRUE(limiter.IsRequestLimited());
+
+    // Requests to the same endpoint share a bucket; other endpoints are unaffected.
+    auto host = limiter.GetHost("https://example.com:8443/foo");
+    ASSERT_NE(host, nullptr);
+    EXPECT_EQ(host, limiter.GetHost("https://example.com:8443/bar?baz=1"));
+    auto other = limiter.GetHost("https://example.org/foo");
+    EXPECT_NE(host, other);
+
+    auto now = std::chrono::steady_clock::now();
+    for (int idx = 0; idx < 10; idx++) {
+        EXPECT_EQ(limiter.AcquireRequest(host, now), std::chrono::steady_clock::duration::zero());
+    }
+    EXPECT_GT(limiter.AcquireRequest(host, now), std::chrono::steady_clock::duration::zero());
+    EXPECT_EQ(limiter.AcquireRequest(other, now), std::chrono::steady_clock::duration::zero());
+
+    auto json = limiter.GetMonitoringJson();
+    EXPECT_NE(json.find("\"requests_delayed\":1,"), std::string::npos);
+
+    limiter.Configure(0, 0, 0, 0);
+    EXPECT_FALSE(limiter.IsRequestLimited());
+    EXPECT_EQ(limiter.GetHost("https://example.com:8443/foo"), nullptr);
+}
+
+TEST(RateLimiter, Prune) {
+    auto &limiter = RateLimiter::Instance();
+    limiter.Configure(0, 0, 100, 10);
+    auto now = std::chrono::steady_clock::now();
+
+    auto held = limiter.GetHost("https://prune-held.example.com/foo", now);
+    auto idle = limiter.GetHost("https://prune-idle.example.com/foo", now);
+    auto indebted = limiter.GetHost("https://prune-indebted.example.com/foo", now);
+    EXPECT_EQ(limiter.AcquireRequest(held, now), std::chrono::steady_clock::duration::zero());
+    EXPECT_EQ(limiter.AcquireRequest(idle, now), std::chrono::steady_clock::duration::zero());
+    EXPECT_GT(limiter.ChargeBytes(indebted, 100 * 300, now), std::chrono::steady_clock::duration::zero());
+    idle.reset();
+    indebted.reset();
+
+    // Adding a host drops the unreferenced ones whose buckets have refilled; a
+    // host still paying off its debt keeps its bucket.
+    auto later = now + RateLimiter::m_prune_interval + std::chrono::seconds(1);
+    auto added = limiter.GetHost("https://prune-new.example.com/foo", later);
+    auto json = limiter.GetMonitoringJson();
+    EXPECT_NE(json.find("\"hosts\":3,"), std::string::npos) << json;
+    EXPECT_GT(limiter.ChargeBytes(limiter.GetHost("https://prune-indebted.example.com/foo", later), 1, later),
+        std::chrono::steady_clock::duration::zero());
+    EXPECT_EQ(held, limiter.GetHost("https://prune-held.example.com/foo", later));
+
+    limiter.Configure(0, 0, 0, 0);
+}
@@ -0,0 +1,139 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlReadCoalescer.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace XrdClCurl;
+
+namespace {
+
+// Records the result of a read; owned by the test.
+class RecordingHandler : public XrdCl::ResponseHandler {
+public:
+    RecordingHandler(std::vector<std::string> &order, const std::string &name) :
+        m_order(order), m_name(name)
+    {}
+
+    void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) override {
+        m_order.push_back(m_name);
+        m_status.reset(status);
+        m_response.reset(response);
+        if (m_response) {
+            m_response->Get(m_chunk);
+        }
+    }
+
+    std::vector<std::string> &m_order;
+    std::string m_name;
+    std::unique_ptr<XrdCl::XRootDStatus> m_status;
+    std::unique_ptr<XrdCl::AnyObject> m_response;
+    XrdCl::ChunkInfo *m_chunk{nullptr};
+};
+
+// Complete a leader read of `data` at `offset`.
+void Complete(XrdCl::ResponseHandler *leader, uint64_t offset, std::string &data) {
+    auto obj = new XrdCl::AnyObject();
+    obj->Set(new XrdCl::ChunkInfo(offset, data.size(), data.data()));
+    leader->HandleResponse(new XrdCl::XRootDStatus(), obj);
+}
+
+}
+
+TEST(ReadCoalescer, Followers) {
+    auto &coalescer = ReadCoalescer::Instance();
+    auto key = ReadCoalescer::GetKey("https://example.com/calib.db", "abc");
+    std::vector<std::string> order;
+
+    char leader_buf[100], same_buf[100], inner_buf[10], outer_buf[200];
+    RecordingHandler leader(order, "leader"), same(order, "same"), inner(order, "inner"), outer(order, "outer"), other(order, "other");
+    auto wrapped = coalescer.Submit(key, 1000, 100, leader_buf, &leader);
+    ASSERT_NE(wrapped, nullptr);
+    ASSERT_NE(wrapped, &leader);
+
+    // Reads within the in-flight range attach; reads beyond it or of another version don't.
+    EXPECT_EQ(coalescer.Submit(key, 1000, 100, same_buf, &same), nullptr);
+    EXPECT_EQ(coalescer.Submit(key, 1050, 10, inner_buf, &inner), nullptr);
+    auto outer_leader = coalescer.Submit(key, 950, 200, outer_buf, &outer);
+    ASSERT_NE(outer_leader, nullptr);
+    auto other_leader = coalescer.Submit(ReadCoalescer::GetKey("https://example.com/calib.db", "def"), 1000, 100, same_buf, &other);
+    ASSERT_NE(other_leader, nullptr);
+    coalescer.Abandon(outer_leader);
+    coalescer.Abandon(other_leader);
+
+    // The leader hits the end of the object after 55 bytes.
+    std::string data(55, '\0');
+    for (size_t idx = 0; idx < data.size(); idx++) data[idx] = static_cast<char>(idx);
+    memcpy(leader_buf, data.data(), data.size());
+    Complete(wrapped, 1000, data);
+
+    // Followers are served before the leader.
+    ASSERT_EQ(order.size(), 3u);
+    EXPECT_EQ(order[0], "same");
+    EXPECT_EQ(order[1], "inner");
+    EXPECT_EQ(order[2], "leader");
+
+    ASSERT_TRUE(same.m_status && same.m_status->IsOK());
+    ASSERT_NE(same.m_chunk, nullptr);
+    EXPECT_EQ(same.m_chunk->offset, 1000u);
+    EXPECT_EQ(same.m_chunk->length, 55u);
+    EXPECT_EQ(same.m_chunk->buffer, same_buf);
+    EXPECT_EQ(memcmp(same_buf, data.data(), 55), 0);
+
+    ASSERT_NE(inner.m_chunk, nullptr);
+    EXPECT_EQ(inner.m_chunk->offset, 1050u);
+    EXPECT_EQ(inner.m_chunk->length, 5u);
+    EXPECT_EQ(memcmp(inner_buf, data.data() + 50, 5), 0);
+
+    // Once completed, the read is no longer in flight.
+    auto again = coalescer.Submit(key, 1000, 100, same_buf, &same);
+    ASSERT_NE(again, nullptr);
+    coalescer.Abandon(again);
+
+    auto json = coalescer.GetMonitoringJson();
+    EXPECT_NE(json.find("\"hits\":2"), std::string::npos);
+    EXPECT_NE(json.find("\"bytes_saved\":60"), std::string::npos);
+}
+
+TEST(ReadCoalescer, Failure) {
+    auto &coalescer = ReadCoalescer::Instance();
+    auto key = ReadCoalescer::GetKey("https://example.com/failure.db", "");
+    std::vector<std::string> order;
+
+    char buf[10];
+    RecordingHandler leader(order, "leader"), follower(order, "follower");
+    auto wrapped = coalescer.Submit(key, 0, 10, buf, &leader);
+    ASSERT_NE(wrapped, nullptr);
+    EXPECT_EQ(coalescer.Submit(key, 0, 10, buf, &follower), nullptr);
+
+    wrapped->HandleResponse(new XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errErrorResponse, 500, "Server error"), nullptr);
+    ASSERT_EQ(order.size(), 2u);
+    ASSERT_TRUE(follower.m_status);
+    EXPECT_FALSE(follower.m_status->IsOK());
+    EXPECT_EQ(follower.m_status->code, XrdCl::errErrorResponse);
+    EXPECT_EQ(follower.m_response, nullptr);
+    ASSERT_TRUE(leader.m_status);
+    EXPECT_EQ(leader.m_status->code, XrdCl::errErrorResponse);
+}
@@ -0,0 +1,260 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlReadWindow.hh"
+
+#include <XrdCl/XrdClXRootDResponses.hh>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Records the result of a read; owned by the test.
+class RecordingHandler : public XrdCl::ResponseHandler {
+public:
+    void HandleResponse(XrdCl::XRootDStatus *status, XrdCl::AnyObject *response) override {
+        m_status.reset(status);
+        m_response.reset(response);
+        if (m_response) {
+            m_response->Get(m_chunk);
+        }
+        m_done = true;
+    }
+
+    std::atomic<bool> m_done{false};
+    std::unique_ptr<XrdCl::XRootDStatus> m_status;
+    std::unique_ptr<XrdCl::AnyObject> m_response;
+    XrdCl::ChunkInfo *m_chunk{nullptr};
+};
+
+// A request started by the window.
+struct Request {
+    uint64_t m_offset;
+    uint32_t m_size;
+    char *m_buffer;
+    XrdCl::ResponseHandler *m_handler;
+};
+
+class ReadWindowFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_saved_window = ReadWindow::GetWindow();
+        m_saved_gap = ReadWindow::GetMaxGap();
+        ReadWindow::SetWindow(1h);
+        ReadWindow::SetMaxGap(100);
+        m_window = std::make_shared<ReadWindow>([&](uint64_t offset, uint32_t size, char *buffer, XrdCl::ResponseHandler *handler, time_t) {
+            std::unique_lock lock(m_mutex);
+            m_requests.push_back({offset, size, buffer, handler});
+            return XrdCl::XRootDStatus();
+        });
+    }
+
+    void TearDown() override {
+        m_window->Shutdown();
+        if (m_leader.m_handler && !m_leader_handler.m_done) {
+            Complete(m_leader, sizeof(m_leader_buffer));
+        }
+        ReadWindow::SetWindow(m_saved_window);
+        ReadWindow::SetMaxGap(m_saved_gap);
+    }
+
+    // Start a read far from the others that stays in flight so later reads are held.
+    void StartLeader() {
+        ASSERT_TRUE(m_window->Submit(1'000'000, sizeof(m_leader_buffer), m_leader_buffer, &m_leader_handler, 0));
+        std::unique_lock lock(m_mutex);
+        ASSERT_EQ(m_requests.size(), 1u);
+        m_leader = m_requests[0];
+        m_requests.clear();
+    }
+
+    // Complete a request with bytes derived from their offset in the object.
+    void Complete(const Request &request, uint32_t length) {
+        for (uint32_t idx = 0; idx < length; idx++) {
+            request.m_buffer[idx] = static_cast<char>((request.m_offset + idx) % 251);
+        }
+        auto obj = new XrdCl::AnyObject();
+        obj->Set(new XrdCl::ChunkInfo(request.m_offset, length, request.m_buffer));
+        request.m_handler->HandleResponse(new XrdCl::XRootDStatus(), obj);
+    }
+
+    std::chrono::microseconds m_saved_window;
+    uint32_t m_saved_gap;
+    std::mutex m_mutex;
+    std::vector<Request> m_requests;
+    std::shared_ptr<ReadWindow> m_window;
+
+    char m_leader_buffer[10];
+    RecordingHandler m_leader_handler;
+    Request m_leader{};
+};
+
+}
+
+TEST_F(ReadWindowFixture, Merge) {
+    char buf1[50], buf2[50], buf3[10], buf4[50];
+    RecordingHandler h1, h2, h3, h4;
+    ASSERT_NO_FATAL_FAILURE(StartLeader());
+
+    // Submitted out of order; the first three are within the gap of each other.
+    ASSERT_TRUE(m_window->Submit(1100, 50, buf2, &h2, 0));
+    ASSERT_TRUE(m_window->Submit(1000, 50, buf1, &h1, 0));
+    ASSERT_TRUE(m_window->Submit(1120, 10, buf3, &h3, 0));
+    ASSERT_TRUE(m_window->Submit(5000, 50, buf4, &h4, 0));
+    EXPECT_TRUE(m_requests.empty());
+
+    m_window->Flush();
+    ASSERT_EQ(m_requests.size(), 2u);
+    EXPECT_EQ(m_requests[0].m_offset, 1000u);
+    EXPECT_EQ(m_requests[0].m_size, 150u);
+    EXPECT_NE(m_requests[0].m_handler, &h1);
+    // A read without neighbors is issued as-is.
+    EXPECT_EQ(m_requests[1].m_offset, 5000u);
+    EXPECT_EQ(m_requests[1].m_buffer, buf4);
+
+    Complete(m_requests[0], 150);
+    for (auto [handler, buffer, offset, size] : {
+        std::make_tuple(&h1, buf1, 1000, 50), std::make_tuple(&h2, buf2, 1100, 50), std::make_tuple(&h3, buf3, 1120, 10)})
+    {
+        ASSERT_TRUE(handler->m_done);
+        ASSERT_TRUE(handler->m_status->IsOK());
+        ASSERT_NE(handler->m_chunk, nullptr);
+        EXPECT_EQ(handler->m_chunk->offset, static_cast<uint64_t>(offset));
+        EXPECT_EQ(handler->m_chunk->length, static_cast<uint32_t>(size));
+        EXPECT_EQ(handler->m_chunk->buffer, buffer);
+        for (int idx = 0; idx < size; idx++) {
+            ASSERT_EQ(buffer[idx], static_cast<char>((offset + idx) % 251));
+        }
+    }
+    EXPECT_FALSE(h4.m_done);
+    Complete(m_requests[1], 50);
+    EXPECT_TRUE(h4.m_done);
+}
+
+TEST_F(ReadWindowFixture, ShortRead) {
+    char buf1[50], buf2[50];
+    RecordingHandler h1, h2;
+    ASSERT_NO_FATAL_FAILURE(StartLeader());
+    ASSERT_TRUE(m_window->Submit(0, 50, buf1, &h1, 0));
+    ASSERT_TRUE(m_window->Submit(60, 50, buf2, &h2, 0));
+    m_window->Flush();
+    ASSERT_EQ(m_requests.size(), 1u);
+
+    // The object ends within the second read.
+    Complete(m_requests[0], 80);
+    ASSERT_TRUE(h1.m_done && h2.m_done);
+    EXPECT_EQ(h1.m_chunk->length, 50u);
+    EXPECT_EQ(h2.m_chunk->length, 20u);
+}
+
+TEST_F(ReadWindowFixture, Failure) {
+    char buf1[50], buf2[50];
+    RecordingHandler h1, h2;
+    ASSERT_NO_FATAL_FAILURE(StartLeader());
+    ASSERT_TRUE(m_window->Submit(0, 50, buf1, &h1, 0));
+    ASSERT_TRUE(m_window->Submit(50, 50, buf2, &h2, 0));
+    m_window->Flush();
+    ASSERT_EQ(m_requests.size(), 1u);
+
+    m_requests[0].m_handler->HandleResponse(new XrdCl::XRootDStatus(XrdCl::stError, XrdCl::errErrorResponse, 404), nullptr);
+    ASSERT_TRUE(h1.m_done && h2.m_done);
+    EXPECT_EQ(h1.m_status->code, XrdCl::errErrorResponse);
+    EXPECT_EQ(h2.m_status->errNo, 404u);
+}
+
+TEST_F(ReadWindowFixture, Bypass) {
+    char buf[10];
+    RecordingHandler handler;
+
+    // Synchronous and large reads are not held.
+    EXPECT_FALSE(m_window->Submit(0, 10, buf, nullptr, 0));
+    EXPECT_FALSE(m_window->Submit(0, ReadWindow::m_max_read_size, buf, &handler, 0));
+
+    // Nor is anything once the window is disabled or shut down.
+    ReadWindow::SetWindow(0us);
+    EXPECT_FALSE(m_window->Submit(0, 10, buf, &handler, 0));
+    ReadWindow::SetWindow(1h);
+    m_window->Shutdown();
+    EXPECT_FALSE(m_window->Submit(0, 10, buf, &handler, 0));
+}
+
+TEST_F(ReadWindowFixture, FullWindow) {
+    std::vector<char> buffer(ReadWindow::m_max_pending * 10);
+    std::vector<RecordingHandler> handlers(ReadWindow::m_max_pending);
+    ASSERT_NO_FATAL_FAILURE(StartLeader());
+    for (size_t idx = 0; idx < ReadWindow::m_max_pending; idx++) {
+        ASSERT_TRUE(m_window->Submit(idx * 10, 10, buffer.data() + idx * 10, &handlers[idx], 0));
+    }
+    // The last read fills the window, which is sent without waiting for the deadline.
+    ASSERT_EQ(m_requests.size(), 1u);
+    EXPECT_EQ(m_requests[0].m_size, ReadWindow::m_max_pending * 10);
+    Complete(m_requests[0], m_requests[0].m_size);
+}
+
+TEST_F(ReadWindowFixture, Deadline) {
+    ReadWindow::SetWindow(50ms);
+    char buf1[10], buf2[10];
+    RecordingHandler h1, h2;
+    ASSERT_NO_FATAL_FAILURE(StartLeader());
+    ASSERT_TRUE(m_window->Submit(0, 10, buf1, &h1, 0));
+    ASSERT_TRUE(m_window->Submit(10, 10, buf2, &h2, 0));
+
+    for (int idx = 0; idx < 5000; idx++) {
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_requests.empty()) break;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    std::unique_lock lock(m_mutex);
+    ASSERT_EQ(m_requests.size(), 1u);
+    EXPECT_EQ(m_requests[0].m_size, 20u);
+    Complete(m_requests[0], 20);
+    EXPECT_TRUE(h1.m_done && h2.m_done);
+}
+
+TEST_F(ReadWindowFixture, LoneRead) {
+    char buf1[10], buf2[10];
+    RecordingHandler h1, h2;
+
+    // With nothing else outstanding (as for a synchronous read), the read is not held.
+    ASSERT_TRUE(m_window->Submit(0, 10, buf1, &h1, 0));
+    ASSERT_EQ(m_requests.size(), 1u);
+    EXPECT_EQ(m_requests[0].m_buffer, buf1);
+    Complete(m_requests[0], 10);
+    ASSERT_TRUE(h1.m_done);
+    EXPECT_EQ(h1.m_chunk->length, 10u);
+
+    // Nor is the next one once the first has completed.
+    ASSERT_TRUE(m_window->Submit(10, 10, buf2, &h2, 0));
+    ASSERT_EQ(m_requests.size(), 2u);
+    EXPECT_EQ(m_requests[1].m_offset, 10u);
+    Complete(m_requests[1], 10);
+    EXPECT_TRUE(h2.m_done);
+}
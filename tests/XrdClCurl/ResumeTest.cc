@@ -0,0 +1,169 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Tests resuming a full-download GET that failed partway through the object.
+
+#include "XrdClCurl/XrdClCurlFactory.hh"
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClPlugInInterface.hh>
+#include <XrdCl/XrdClXRootDResponses.hh>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace XrdClCurl;
+
+class ResumeFixture : public TransferFixture {
+protected:
+    // Open `name` in full-download mode with a short stall timeout.
+    //
+    // Returns false on failure or if the server gave no strong ETag, in which case
+    // downloads are never resumed.
+    bool OpenFullDownload(const std::string &name) {
+        m_factory.reset(new Factory());
+        auto url = name + "?authz=" + GetReadToken();
+        m_fh.reset(m_factory->CreateFile(url));
+        EXPECT_TRUE(m_fh->SetProperty("XrdClCurlFullDownload", "true"));
+
+        SyncResponseHandler open_handler;
+        auto rv = m_fh->Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, &open_handler, static_cast<File::timeout_t>(10));
+        EXPECT_TRUE(rv.IsOK()) << rv.ToString();
+        if (!rv.IsOK()) return false;
+        open_handler.Wait();
+        auto [status, obj] = open_handler.Status();
+        EXPECT_TRUE(status && status->IsOK()) << (status ? status->ToString() : "no status");
+        if (!status || !status->IsOK()) return false;
+
+        std::string etag;
+        if (!m_fh->GetProperty("ETag", etag) || etag.empty() || !etag.compare(0, 2, "W/")) {
+            return false;
+        }
+        m_fh->SetProperty("XrdClCurlMaintenancePeriod", "1");
+        m_fh->SetProperty("XrdClCurlStallTimeout", "500ms");
+        return true;
+    }
+
+    // Read the chunk at `offset`; on success, check it is filled with `expected`.
+    std::unique_ptr<XrdCl::XRootDStatus> ReadChunk(off_t offset, unsigned char expected) {
+        std::string buffer(m_chunk_size, '\0');
+        SyncResponseHandler handler;
+        auto rv = m_fh->Read(offset, buffer.size(), buffer.data(), &handler, static_cast<File::timeout_t>(30));
+        if (!rv.IsOK()) {
+            return std::make_unique<XrdCl::XRootDStatus>(rv);
+        }
+        handler.Wait();
+        auto [status, obj] = handler.Status();
+        if (!status || !status->IsOK()) {
+            return std::move(status);
+        }
+        XrdCl::ChunkInfo *ci = nullptr;
+        EXPECT_TRUE(obj);
+        if (obj) obj->Get(ci);
+        EXPECT_NE(ci, nullptr);
+        if (ci) {
+            EXPECT_EQ(ci->GetOffset(), static_cast<uint64_t>(offset));
+            EXPECT_EQ(ci->GetLength(), m_chunk_size);
+        }
+        EXPECT_EQ(buffer, std::string(m_chunk_size, expected)) << "Unexpected contents at offset " << offset;
+        return std::move(status);
+    }
+
+    void Close() {
+        SyncResponseHandler handler;
+        if (m_fh->Close(&handler, static_cast<File::timeout_t>(10)).IsOK()) {
+            handler.Wait();
+        }
+        m_fh.reset();
+    }
+
+    static constexpr size_t m_chunk_size{100'000};
+    static constexpr off_t m_size{10 * m_chunk_size};
+    std::unique_ptr<Factory> m_factory;
+    std::unique_ptr<XrdCl::FilePlugIn> m_fh;
+};
+
+// The GET stalls while the reader pauses partway through the object; the next
+// read resumes it with a ranged, conditional request and the rest of the object
+// arrives intact.
+TEST_F(ResumeFixture, StalledDownload)
+{
+    auto name = GetOriginURL() + "/test/resume_stall";
+    ASSERT_NO_FATAL_FAILURE(WritePattern(name, m_size, 'a', m_chunk_size));
+    if (!OpenFullDownload(name)) {
+        if (!HasFailure()) GTEST_SKIP() << "Server did not provide a strong ETag; downloads are not resumable";
+        return;
+    }
+
+    off_t offset = 0;
+    unsigned char expected = 'a';
+    for (; offset < 3 * static_cast<off_t>(m_chunk_size); offset += m_chunk_size, expected++) {
+        auto status = ReadChunk(offset, expected);
+        ASSERT_TRUE(status && status->IsOK()) << (status ? status->ToString() : "no status");
+    }
+
+    // Long enough for the stall timeout to fail the paused GET.
+    std::this_thread::sleep_for(std::chrono::seconds(3));
+
+    for (; offset < m_size; offset += m_chunk_size, expected++) {
+        auto status = ReadChunk(offset, expected);
+        ASSERT_TRUE(status && status->IsOK()) << (status ? status->ToString() : "no status");
+    }
+    Close();
+}
+
+// If the object is replaced while the GET is stalled, the resumed request no longer
+// matches its ETag; the read must fail instead of splicing the two versions.
+TEST_F(ResumeFixture, ChangedETag)
+{
+    auto name = GetOriginURL() + "/test/resume_etag";
+    ASSERT_NO_FATAL_FAILURE(WritePattern(name, m_size, 'a', m_chunk_size));
+    if (!OpenFullDownload(name)) {
+        if (!HasFailure()) GTEST_SKIP() << "Server did not provide a strong ETag; downloads are not resumable";
+        return;
+    }
+
+    off_t offset = 0;
+    unsigned char expected = 'a';
+    for (; offset < 3 * static_cast<off_t>(m_chunk_size); offset += m_chunk_size, expected++) {
+        auto status = ReadChunk(offset, expected);
+        ASSERT_TRUE(status && status->IsOK()) << (status ? status->ToString() : "no status");
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    // Same size, different contents.
+    ASSERT_NO_FATAL_FAILURE(WritePattern(name, m_size, 'A', m_chunk_size));
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    std::string buffer(m_chunk_size, '\0');
+    SyncResponseHandler handler;
+    auto rv = m_fh->Read(offset, buffer.size(), buffer.data(), &handler, static_cast<File::timeout_t>(30));
+    if (rv.IsOK()) {
+        handler.Wait();
+        auto [status, obj] = handler.Status();
+        ASSERT_TRUE(status);
+        EXPECT_FALSE(status->IsOK()) << "Read after the object changed should have failed";
+    }
+    // No byte of the new version was delivered.
+    EXPECT_EQ(buffer.find('A' + 3), std::string::npos);
+    Close();
+}
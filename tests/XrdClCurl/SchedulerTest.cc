@@ -0,0 +1,65 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "common/XrdClCurlScheduler.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+TEST(Scheduler, PeriodicAndCancel) {
+    auto &scheduler = Scheduler::Instance();
+    auto base = scheduler.GetTaskCount();
+
+    std::atomic<int> fast{0}, slow{0};
+    auto fast_id = scheduler.Schedule("fast", 10ms, [&]{fast++;});
+    auto slow_id = scheduler.Schedule("slow", 1h, [&]{slow++;});
+    EXPECT_NE(fast_id, 0u);
+    EXPECT_NE(fast_id, slow_id);
+    EXPECT_EQ(scheduler.GetTaskCount(), base + 2);
+
+    std::this_thread::sleep_for(200ms);
+    EXPECT_GE(fast.load(), 5);
+    EXPECT_EQ(slow.load(), 0);
+    EXPECT_NE(scheduler.GetMonitoringJson().find("\"fast\":{"), std::string::npos);
+
+    // After cancellation returns, the task never runs again.
+    scheduler.Cancel(fast_id);
+    auto runs = fast.load();
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(fast.load(), runs);
+
+    scheduler.Cancel(slow_id);
+    scheduler.Cancel(0);
+    scheduler.Cancel(fast_id);
+    EXPECT_EQ(scheduler.GetTaskCount(), base);
+}
+
+// The instance is published in the XrdCl environment for the other plugin to adopt.
+TEST(Scheduler, SharedInstance) {
+    auto &scheduler = Scheduler::Instance();
+    std::string value;
+    ASSERT_TRUE(XrdCl::DefaultEnv::GetEnv()->GetString("XrdClCurlScheduler", value));
+    EXPECT_EQ(reinterpret_cast<Scheduler *>(std::stoull(value, nullptr, 16)), &scheduler);
+}
@@ -0,0 +1,229 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "common/XrdClCurlScoreboard.hh"
+#include "XrdClCurl/XrdClCurlUtil.hh"
+
+#include <curl/curl.h>
+#include <gtest/gtest.h>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+TEST(Scoreboard, HostKey) {
+    EXPECT_EQ(Scoreboard::GetHostKey("https://cache.example.com/foo/bar"), "https://cache.example.com:443");
+    EXPECT_EQ(Scoreboard::GetHostKey("https://cache.example.com:443?authz=foo"), "https://cache.example.com:443");
+    EXPECT_EQ(Scoreboard::GetHostKey("http://user@cache.example.com/foo"), "http://cache.example.com:80");
+    EXPECT_EQ(Scoreboard::GetHostKey("https://cache.example.com:8443/foo"), "https://cache.example.com:8443");
+    EXPECT_EQ(Scoreboard::GetHostKey("https://[::1]/foo"), "https://[::1]:443");
+    EXPECT_EQ(Scoreboard::GetHostKey("https://[::1]:8443/foo"), "https://[::1]:8443");
+    EXPECT_EQ(Scoreboard::GetHostKey("/foo"), "");
+    EXPECT_EQ(Scoreboard::GetHostKey("https:///foo"), "");
+}
+
+TEST(Scoreboard, Rank) {
+    auto &scoreboard = Scoreboard::Instance();
+    scoreboard.SetExploreFraction(0);
+    // Keep the flaky endpoint's circuit closed; only its cost is tested here.
+    scoreboard.SetCircuitParams(0, 30s);
+    auto now = Scoreboard::Clock::now();
+
+    std::vector<std::string> urls = {
+        "https://rank-slow.example.com/foo",
+        "https://rank-new.example.com/foo",
+        "https://rank-fast.example.com/foo",
+        "https://rank-flaky.example.com/foo",
+    };
+
+    // Nothing is measured; the director's order is kept.
+    EXPECT_EQ(scoreboard.Rank(urls, now), std::vector<size_t>({0, 1, 2, 3}));
+
+    scoreboard.Record(scoreboard.GetHost(urls[0]), 10'000'000, 1s, 100ms, Scoreboard::Outcome::Success, now);
+    scoreboard.Record(scoreboard.GetHost(urls[2]), 100'000'000, 1s, 100ms, Scoreboard::Outcome::Success, now);
+    scoreboard.Record(scoreboard.GetHost(urls[3]), 100'000'000, 1s, 100ms, Scoreboard::Outcome::Success, now);
+    for (int idx = 0; idx < 10; idx++) {
+        scoreboard.Record(scoreboard.GetHost(urls[3]), 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    }
+
+    // Measured endpoints are sorted by cost; the unmeasured one follows.
+    EXPECT_EQ(scoreboard.Rank(urls, now), std::vector<size_t>({2, 0, 3, 1}));
+
+    // Progress reports alone (with no completed operation) count as a measurement
+    // once enough transfer time has accumulated.
+    scoreboard.Record(scoreboard.GetHost(urls[1]), 1'000'000'000, 1s, 0s, Scoreboard::Outcome::Progress, now);
+    EXPECT_EQ(scoreboard.Rank(urls, now)[0], 1u);
+
+    scoreboard.SetCircuitParams(5, 30s);
+    scoreboard.SetExploreFraction(0.05);
+}
+
+TEST(Scoreboard, Decay) {
+    auto &scoreboard = Scoreboard::Instance();
+    auto now = Scoreboard::Clock::now();
+    auto host = scoreboard.GetHost("https://decay.example.com");
+    ASSERT_NE(host, nullptr);
+    EXPECT_EQ(host, scoreboard.GetHost("https://decay.example.com:443/other"));
+    EXPECT_LT(host->GetCost(now), 0);
+
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    EXPECT_GT(host->GetCost(now), 0);
+
+    // After many time constants, the measurement is forgotten.
+    EXPECT_LT(host->GetCost(now + 10 * Scoreboard::m_decay), 0);
+}
+
+TEST(Scoreboard, Explore) {
+    auto &scoreboard = Scoreboard::Instance();
+    scoreboard.SetExploreFraction(1);
+    auto now = Scoreboard::Clock::now();
+
+    std::vector<std::string> urls = {
+        "https://explore-known.example.com/foo",
+        "https://explore-new.example.com/foo",
+    };
+    scoreboard.Record(scoreboard.GetHost(urls[0]), 100'000'000, 1s, 100ms, Scoreboard::Outcome::Success, now);
+
+    // When exploring, the unmeasured endpoint is always tried first.
+    for (int idx = 0; idx < 10; idx++) {
+        EXPECT_EQ(scoreboard.Rank(urls, now), std::vector<size_t>({1, 0}));
+    }
+    scoreboard.SetExploreFraction(0.05);
+
+    auto json = scoreboard.GetMonitoringJson();
+    EXPECT_NE(json.find("\"https://explore-known.example.com:443\":{\"rate\":"), std::string::npos);
+}
+
+TEST(Scoreboard, Circuit) {
+    auto &scoreboard = Scoreboard::Instance();
+    scoreboard.SetCircuitParams(3, 30s);
+    scoreboard.SetExploreFraction(0);
+    auto now = Scoreboard::Clock::now();
+    auto host = scoreboard.GetHost("https://circuit.example.com");
+    ASSERT_NE(host, nullptr);
+
+    // A success in between resets the count of consecutive failures.
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    scoreboard.Record(host, 0, 0s, 100ms, Scoreboard::Outcome::Success, now);
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::Closed);
+    EXPECT_TRUE(scoreboard.Admit(host, now));
+
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::Open);
+    EXPECT_FALSE(scoreboard.Admit(host, now + 10s));
+    EXPECT_FALSE(host->IsAvailable(now + 10s));
+
+    // Open endpoints are ranked last, even if otherwise preferred.
+    std::vector<std::string> urls = {"https://circuit.example.com/foo", "https://circuit-other.example.com/foo"};
+    EXPECT_EQ(scoreboard.Rank(urls, now + 10s), std::vector<size_t>({1, 0}));
+
+    // After the cooldown, a single probe is admitted.
+    EXPECT_TRUE(host->IsAvailable(now + 31s));
+    EXPECT_TRUE(scoreboard.Admit(host, now + 31s));
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::HalfOpen);
+    EXPECT_FALSE(scoreboard.Admit(host, now + 32s));
+
+    // A failed probe re-opens the circuit for another cooldown.
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now + 33s);
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::Open);
+    EXPECT_FALSE(scoreboard.Admit(host, now + 62s));
+    EXPECT_TRUE(scoreboard.Admit(host, now + 64s));
+
+    // A response to the probe closes it.
+    scoreboard.Record(host, 0, 0s, 50ms, Scoreboard::Outcome::Progress, now + 65s);
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::Closed);
+    EXPECT_TRUE(scoreboard.Admit(host, now + 65s));
+
+    auto json = scoreboard.GetMonitoringJson();
+    EXPECT_NE(json.find("\"circuit\":\"closed\",\"fast_fails\":3"), std::string::npos);
+
+    scoreboard.SetCircuitParams(5, 30s);
+    scoreboard.SetExploreFraction(0.05);
+}
+
+TEST(Scoreboard, ClientAbort) {
+    // Only connection-level failures and gateway errors are held against the server.
+    EXPECT_FALSE(CurlCodeIsServerFault(CURLE_ABORTED_BY_CALLBACK));
+    EXPECT_FALSE(CurlCodeIsServerFault(CURLE_WRITE_ERROR));
+    EXPECT_FALSE(CurlCodeIsServerFault(CURLE_READ_ERROR));
+    EXPECT_TRUE(CurlCodeIsServerFault(CURLE_COULDNT_CONNECT));
+    EXPECT_TRUE(CurlCodeIsServerFault(CURLE_SSL_CONNECT_ERROR));
+    EXPECT_TRUE(CurlCodeIsServerFault(CURLE_RECV_ERROR));
+    EXPECT_FALSE(HTTPStatusIsServerFault(500));
+    EXPECT_FALSE(HTTPStatusIsServerFault(404));
+    EXPECT_TRUE(HTTPStatusIsServerFault(503));
+
+    auto &scoreboard = Scoreboard::Instance();
+    scoreboard.SetCircuitParams(3, 30s);
+    auto now = Scoreboard::Clock::now();
+    auto host = scoreboard.GetHost("https://client-abort.example.com");
+    ASSERT_NE(host, nullptr);
+
+    // Aborts by the client do not open the circuit or count as failures.
+    for (int idx = 0; idx < 5; idx++) {
+        scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Aborted, now);
+    }
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::Closed);
+    EXPECT_TRUE(scoreboard.Admit(host, now));
+    EXPECT_LT(host->GetCost(now), 0);
+
+    // Nor do they interrupt a run of consecutive failures.
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Aborted, now);
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::Open);
+
+    // An aborted probe leaves the circuit open but lets the next request probe.
+    EXPECT_TRUE(scoreboard.Admit(host, now + 31s));
+    EXPECT_FALSE(scoreboard.Admit(host, now + 31s));
+    scoreboard.Record(host, 0, 0s, 0s, Scoreboard::Outcome::Aborted, now + 32s);
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::Open);
+    EXPECT_TRUE(scoreboard.Admit(host, now + 32s));
+    EXPECT_EQ(host->GetCircuit(), Scoreboard::Circuit::HalfOpen);
+
+    scoreboard.SetCircuitParams(5, 30s);
+}
+
+TEST(Scoreboard, JsonEscape) {
+    auto &scoreboard = Scoreboard::Instance();
+    auto host = scoreboard.GetHost("https://we\"ird\\.example.com/foo");
+    ASSERT_NE(host, nullptr);
+    auto json = scoreboard.GetMonitoringJson();
+    EXPECT_NE(json.find("\"https://we\\\"ird\\\\.example.com:443\":{"), std::string::npos) << json;
+}
+
+TEST(Scoreboard, Prune) {
+    auto &scoreboard = Scoreboard::Instance();
+    auto now = Scoreboard::Clock::now();
+    auto held = scoreboard.GetHost("https://prune-held.example.com", now);
+    scoreboard.Record(held, 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    scoreboard.Record(scoreboard.GetHost("https://prune.example.com", now), 0, 0s, 0s, Scoreboard::Outcome::Failure, now);
+    EXPECT_NE(scoreboard.GetMonitoringJson().find("\"https://prune.example.com:443\""), std::string::npos);
+
+    // Once the measurements have decayed, adding an endpoint drops the ones no
+    // operation references.
+    auto later = now + 10 * Scoreboard::m_decay;
+    scoreboard.GetHost("https://prune-new.example.com", later);
+    auto json = scoreboard.GetMonitoringJson();
+    EXPECT_EQ(json.find("\"https://prune.example.com:443\""), std::string::npos) << json;
+    EXPECT_NE(json.find("\"https://prune-held.example.com:443\""), std::string::npos) << json;
+    EXPECT_EQ(held, scoreboard.GetHost("https://prune-held.example.com", later));
+}
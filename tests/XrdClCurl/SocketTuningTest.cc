@@ -0,0 +1,78 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlSocketTuning.hh"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+using namespace XrdClCurl;
+
+TEST(SocketTuning, Unmeasured) {
+    auto params = SocketTuning::ComputeParams(-1, -1, 4 * 1024 * 1024, 64 * 1024 * 1024);
+    EXPECT_EQ(params.m_curl_buffer, SocketTuning::m_default_curl_buffer);
+    EXPECT_EQ(params.m_socket_buffer, 0);
+}
+
+TEST(SocketTuning, LowBDP) {
+    // 1ms RTT at 100MB/s is a 100KB BDP; kernel autotuning is sufficient.
+    auto params = SocketTuning::ComputeParams(0.001, 100e6, 4 * 1024 * 1024, 64 * 1024 * 1024);
+    EXPECT_EQ(params.m_curl_buffer, SocketTuning::m_default_curl_buffer);
+    EXPECT_EQ(params.m_socket_buffer, 0);
+}
+
+TEST(SocketTuning, HighBDP) {
+    // 80ms RTT at 100MB/s is an 8MB BDP.
+    auto params = SocketTuning::ComputeParams(0.08, 100e6, 4 * 1024 * 1024, 64 * 1024 * 1024);
+    EXPECT_EQ(params.m_socket_buffer, 16 * 1024 * 1024);
+    EXPECT_EQ(params.m_curl_buffer, 512 * 1024);
+}
+
+TEST(SocketTuning, Clamped) {
+    // 80ms RTT at 12.5GB/s (100Gbps) is a 1GB BDP; everything is clamped to the maximums.
+    auto params = SocketTuning::ComputeParams(0.08, 12.5e9, 4 * 1024 * 1024, 64 * 1024 * 1024);
+    EXPECT_EQ(params.m_socket_buffer, 64 * 1024 * 1024);
+    EXPECT_EQ(params.m_curl_buffer, SocketTuning::GetMaxCurlBuffer());
+}
+
+TEST(SocketTuning, Bounded) {
+    auto &tuning = SocketTuning::Instance();
+    tuning.Configure(true, SocketTuning::m_default_min_socket_buffer, SocketTuning::m_default_max_socket_buffer, "");
+    auto now = std::chrono::steady_clock::now();
+
+    // 80ms RTT at 100MB/s; large enough to move off the defaults.
+    tuning.Update("https://host0.example.com", 0.08, 100'000'000, 1.0, now);
+    EXPECT_EQ(tuning.Get("https://host0.example.com/foo", now).m_curl_buffer, 512 * 1024);
+
+    // An endpoint not measured within the lifetime falls back to the defaults.
+    EXPECT_EQ(tuning.Get("https://host0.example.com/foo", now + std::chrono::hours(2)).m_curl_buffer, SocketTuning::m_default_curl_buffer);
+
+    // Once the table is full, the least recently updated endpoint makes room for a new one.
+    for (size_t idx = 1; idx <= SocketTuning::m_max_entries; idx++) {
+        tuning.Update("https://host" + std::to_string(idx) + ".example.com", 0.08, 100'000'000, 1.0, now + std::chrono::seconds(idx));
+    }
+    auto later = now + std::chrono::seconds(SocketTuning::m_max_entries);
+    EXPECT_EQ(tuning.Get("https://host0.example.com/foo", later).m_curl_buffer, SocketTuning::m_default_curl_buffer);
+    EXPECT_EQ(tuning.Get("https://host1.example.com/foo", later).m_curl_buffer, 512 * 1024);
+    auto last = "https://host" + std::to_string(SocketTuning::m_max_entries) + ".example.com/foo";
+    EXPECT_EQ(tuning.Get(last, later).m_curl_buffer, 512 * 1024);
+
+    tuning.Configure(true, SocketTuning::m_default_min_socket_buffer, SocketTuning::m_default_max_socket_buffer, "");
+}
@@ -0,0 +1,164 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Benchmark of the client startup cost: the time to load and initialize the
+// plugin, the latency of the first and second operations, the number of
+// threads started, and the time from process start to the first byte read.
+// Each test runs in a fresh process under ctest; run against builds before and
+// after a change to compare.
+
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+#include <XrdCl/XrdClFileSystem.hh>
+#include <XrdCl/XrdClPlugInManager.hh>
+
+#include <dirent.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// Returns the number of threads in the current process.
+int CountThreads() {
+    auto dir = opendir("/proc/self/task");
+    if (!dir) return -1;
+    int count = 0;
+    struct dirent *ent;
+    while ((ent = readdir(dir))) {
+        if (ent->d_name[0] != '.') count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Returns the time since the process started, in milliseconds, or a negative value on failure.
+double MsSinceProcessStart() {
+    std::ifstream stat_file("/proc/self/stat");
+    std::string stat;
+    std::getline(stat_file, stat);
+    // The command name may contain spaces; fields are counted from after its closing paren.
+    auto pos = stat.rfind(')');
+    if (pos == std::string::npos) return -1;
+    std::istringstream fields(stat.substr(pos + 2));
+    std::string field;
+    // The start time is field 22 of the file; the first field after the name is field 3.
+    for (int idx = 3; idx < 22; idx++) {
+        fields >> field;
+    }
+    unsigned long long start_ticks = 0;
+    if (!(fields >> start_ticks)) return -1;
+
+    std::ifstream uptime_file("/proc/uptime");
+    double uptime = 0;
+    if (!(uptime_file >> uptime)) return -1;
+    return (uptime - static_cast<double>(start_ticks) / sysconf(_SC_CLK_TCK)) * 1000;
+}
+
+}
+
+class StartupBenchmark : public TransferFixture {
+protected:
+    // Time from process start to the first byte of a file, as for a process that
+    // is started to copy a single file.  The process start time has the clock-tick
+    // resolution of /proc (typically 10ms).
+    void RunFirstByte(bool lazy);
+};
+
+TEST_F(StartupBenchmark, FirstOperation)
+{
+    // Use a file created by the test setup so this is the first operation of the process.
+    auto url = GetOriginURL() + "/test/hello_world.txt?authz=" + GetReadToken();
+
+    auto threads_before = CountThreads();
+
+    auto start = std::chrono::steady_clock::now();
+    auto factory = XrdCl::DefaultEnv::GetPlugInManager()->GetFactory(url);
+    auto load_ms = ElapsedMs(start);
+    ASSERT_NE(factory, nullptr);
+
+    XrdCl::File fh;
+    start = std::chrono::steady_clock::now();
+    auto rv = fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::Mode(0755), static_cast<XrdClCurl::File::timeout_t>(10));
+    auto first_ms = ElapsedMs(start);
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+
+    XrdCl::StatInfo *info{nullptr};
+    start = std::chrono::steady_clock::now();
+    rv = fh.Stat(true, info, static_cast<XrdClCurl::File::timeout_t>(10));
+    auto second_ms = ElapsedMs(start);
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    delete info;
+    ASSERT_TRUE(fh.Close().IsOK());
+
+    auto threads_after = CountThreads();
+
+    std::cout << "Plugin load time (ms): " << load_ms << std::endl;
+    std::cout << "First operation latency (ms): " << first_ms << std::endl;
+    std::cout << "Second operation latency (ms): " << second_ms << std::endl;
+    std::cout << "Threads started by the client: " << (threads_after - threads_before) << std::endl;
+    RecordProperty("plugin_load_ms", std::to_string(load_ms));
+    RecordProperty("first_op_ms", std::to_string(first_ms));
+    RecordProperty("second_op_ms", std::to_string(second_ms));
+    RecordProperty("client_threads", std::to_string(threads_after - threads_before));
+}
+
+void
+StartupBenchmark::RunFirstByte(bool lazy)
+{
+    setenv("XRD_CURLLAZYWORKERS", lazy ? "1" : "0", 1);
+    auto url = GetOriginURL() + "/test/hello_world.txt?authz=" + GetReadToken();
+
+    XrdCl::File fh;
+    auto rv = fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::Mode(0755), static_cast<XrdClCurl::File::timeout_t>(10));
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    char buf[1];
+    uint32_t bytes_read = 0;
+    rv = fh.Read(0, 1, buf, bytes_read, static_cast<XrdClCurl::File::timeout_t>(10));
+    auto first_byte_ms = MsSinceProcessStart();
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    ASSERT_EQ(bytes_read, 1u);
+    ASSERT_EQ(buf[0], 'H');
+    auto threads = CountThreads();
+    ASSERT_TRUE(fh.Close().IsOK());
+
+    std::cout << "Process start to first byte with " << (lazy ? "lazy" : "eager") << " workers (ms): " << first_byte_ms << std::endl;
+    std::cout << "Threads in process: " << threads << std::endl;
+    RecordProperty("first_byte_ms", std::to_string(first_byte_ms));
+    RecordProperty("threads", std::to_string(threads));
+}
+
+TEST_F(StartupBenchmark, FirstByteEager)
+{
+    RunFirstByte(false);
+}
+
+TEST_F(StartupBenchmark, FirstByteLazy)
+{
+    RunFirstByte(true);
+}
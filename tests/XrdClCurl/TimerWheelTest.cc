@@ -0,0 +1,108 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlTimerWheel.hh"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+TEST(TimerWheel, FiresAtDeadline) {
+    auto start = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel(10ms, start);
+    wheel.Schedule(1, start + 25ms);
+    wheel.Schedule(2, start + 5s);
+
+    std::vector<int> expired;
+    wheel.Advance(start + 20ms, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.Advance(start + 30ms, expired);
+    ASSERT_EQ(expired.size(), 1U);
+    EXPECT_EQ(expired[0], 1);
+    EXPECT_EQ(wheel.Size(), 1U);
+
+    expired.clear();
+    wheel.Advance(start + 4990ms, expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.Advance(start + 5010ms, expired);
+    ASSERT_EQ(expired.size(), 1U);
+    EXPECT_EQ(expired[0], 2);
+    EXPECT_TRUE(wheel.Empty());
+}
+
+TEST(TimerWheel, RescheduleAndCancel) {
+    auto start = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel(10ms, start);
+    wheel.Schedule(1, start + 100ms);
+    wheel.Schedule(2, start + 100ms);
+    wheel.Schedule(1, start + 2s);
+    EXPECT_TRUE(wheel.Cancel(2));
+    EXPECT_FALSE(wheel.Cancel(3));
+
+    std::vector<int> expired;
+    wheel.Advance(start + 1s, expired);
+    EXPECT_TRUE(expired.empty());
+    EXPECT_TRUE(wheel.Contains(1));
+    wheel.Advance(start + 3s, expired);
+    ASSERT_EQ(expired.size(), 1U);
+    EXPECT_EQ(expired[0], 1);
+}
+
+TEST(TimerWheel, PastDeadline) {
+    auto start = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel(10ms, start);
+    std::vector<int> expired;
+    wheel.Advance(start + 1s, expired);
+    wheel.Schedule(1, start);
+    wheel.Advance(start + 1s, expired);
+    ASSERT_EQ(expired.size(), 1U);
+    EXPECT_EQ(expired[0], 1);
+}
+
+// Timers spread across all levels of the wheel must each fire within one
+// tick after their deadline, and never before.
+TEST(TimerWheel, Cascade) {
+    auto start = std::chrono::steady_clock::now();
+    TimerWheel<int> wheel(1ms, start);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(1, 20'000'000);
+    std::vector<std::chrono::steady_clock::time_point> deadlines;
+    for (int idx = 0; idx < 2000; idx++) {
+        deadlines.push_back(start + std::chrono::milliseconds(dist(gen)));
+        wheel.Schedule(idx, deadlines.back());
+    }
+
+    std::vector<int> expired;
+    size_t fired = 0;
+    auto now = start;
+    while (!wheel.Empty()) {
+        now += 997ms;
+        expired.clear();
+        wheel.Advance(now, expired);
+        for (auto idx : expired) {
+            EXPECT_LE(deadlines[idx], now);
+            EXPECT_GT(deadlines[idx] + 1ms, now - 997ms);
+        }
+        fired += expired.size();
+    }
+    EXPECT_EQ(fired, deadlines.size());
+}
@@ -0,0 +1,140 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Benchmark comparing the upload rate of a local file sent through a sequence of
+// File::Write calls (as done by xrdcp) with the rate when the file is handed to
+// the plugin through the `XrdClCurlUploadPath` property.
+//
+// The benchmark only runs when XRDCLCURL_UPLOAD_BENCHMARK_MB is set to the
+// object size, in MB (e.g., 10240); UploadTest covers the functionality.
+
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClFile.hh>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+double ElapsedSec(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+class UploadBenchmark : public TransferFixture {
+protected:
+    void SetUp() override {
+        TransferFixture::SetUp();
+
+        auto env = getenv("XRDCLCURL_UPLOAD_BENCHMARK_MB");
+        uint64_t size_mb = env ? std::strtoull(env, nullptr, 10) : 0;
+        if (!size_mb) {
+            GTEST_SKIP() << "Set XRDCLCURL_UPLOAD_BENCHMARK_MB to run the upload benchmark";
+        }
+        m_size = size_mb * 1024 * 1024;
+
+        char fname[] = "/tmp/xrdclcurl_upload_benchmark.XXXXXX";
+        m_fd = mkstemp(fname);
+        ASSERT_NE(m_fd, -1);
+        m_fname = fname;
+        std::vector<char> buffer(m_chunk_size);
+        for (size_t idx = 0; idx < buffer.size(); idx++) {
+            buffer[idx] = 'a' + (idx % 26);
+        }
+        for (uint64_t offset = 0; offset < m_size; offset += buffer.size()) {
+            ASSERT_EQ(pwrite(m_fd, buffer.data(), buffer.size(), offset), static_cast<ssize_t>(buffer.size()));
+        }
+    }
+
+    void TearDown() override {
+        if (m_fd >= 0) close(m_fd);
+        if (!m_fname.empty()) unlink(m_fname.c_str());
+    }
+
+    // Check the uploaded object has the expected size.
+    void VerifySize(const std::string &url) {
+        XrdCl::File fh;
+        ASSERT_TRUE(fh.Open(url, XrdCl::OpenFlags::Read, XrdCl::Access::None, static_cast<XrdClCurl::File::timeout_t>(10)).IsOK());
+        XrdCl::StatInfo *info{nullptr};
+        ASSERT_TRUE(fh.Stat(true, info, static_cast<XrdClCurl::File::timeout_t>(10)).IsOK());
+        ASSERT_NE(info, nullptr);
+        EXPECT_EQ(info->GetSize(), m_size);
+        delete info;
+        ASSERT_TRUE(fh.Close().IsOK());
+    }
+
+    static constexpr size_t m_chunk_size{8 * 1024 * 1024};
+    uint64_t m_size{0};
+    int m_fd{-1};
+    std::string m_fname;
+};
+
+TEST_F(UploadBenchmark, WriteVsLocalFile)
+{
+    auto write_url = GetOriginURL() + "/test/upload_benchmark_write?authz=" + GetWriteToken();
+    auto source_url = GetOriginURL() + "/test/upload_benchmark_source?authz=" + GetWriteToken();
+
+    // Upload through a read-then-write loop, as a copy of a local file would.
+    auto start = std::chrono::steady_clock::now();
+    {
+        XrdCl::File fh;
+        auto rv = fh.Open(write_url, XrdCl::OpenFlags::Write, XrdCl::Access::Mode(0755), static_cast<XrdClCurl::File::timeout_t>(10));
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+        std::vector<char> buffer(m_chunk_size);
+        for (uint64_t offset = 0; offset < m_size; offset += buffer.size()) {
+            ASSERT_EQ(pread(m_fd, buffer.data(), buffer.size(), offset), static_cast<ssize_t>(buffer.size()));
+            rv = fh.Write(offset, buffer.size(), buffer.data(), static_cast<XrdClCurl::File::timeout_t>(60));
+            ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+        }
+        rv = fh.Close(static_cast<XrdClCurl::File::timeout_t>(60));
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    }
+    auto write_rate = m_size / ElapsedSec(start) / 1e9;
+
+    // Upload by handing the local file to the plugin.
+    start = std::chrono::steady_clock::now();
+    {
+        XrdCl::File fh;
+        auto rv = fh.Open(source_url, XrdCl::OpenFlags::Write, XrdCl::Access::Mode(0755), static_cast<XrdClCurl::File::timeout_t>(10));
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+        ASSERT_TRUE(fh.SetProperty("XrdClCurlUploadPath", m_fname));
+        // Writes are refused once the upload source is set.
+        char byte = 'a';
+        ASSERT_FALSE(fh.Write(0, 1, &byte, static_cast<XrdClCurl::File::timeout_t>(10)).IsOK());
+        rv = fh.Close(static_cast<XrdClCurl::File::timeout_t>(60));
+        ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    }
+    auto source_rate = m_size / ElapsedSec(start) / 1e9;
+
+    ASSERT_NO_FATAL_FAILURE(VerifySize(write_url));
+    ASSERT_NO_FATAL_FAILURE(VerifySize(source_url));
+
+    std::cout << "Upload rate with File::Write (GB/s): " << write_rate << std::endl;
+    std::cout << "Upload rate from a local file (GB/s): " << source_rate << std::endl;
+    RecordProperty("write_upload_gbps", std::to_string(write_rate));
+    RecordProperty("source_upload_gbps", std::to_string(source_rate));
+}
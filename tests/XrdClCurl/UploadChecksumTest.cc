@@ -0,0 +1,87 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlUploadChecksum.hh"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace XrdClCurl;
+
+namespace {
+
+std::string Checksum(UploadChecksum::Algorithm algorithm, const std::string &data, size_t piece) {
+    UploadChecksum checksum(algorithm);
+    for (size_t offset = 0; offset < data.size(); offset += piece) {
+        checksum.Update(data.data() + offset, std::min(piece, data.size() - offset));
+    }
+    checksum.Final();
+    return checksum.GetValue();
+}
+
+}
+
+TEST(UploadChecksum, Parse) {
+    EXPECT_EQ(UploadChecksum::ParseAlgorithm("CRC32C"), UploadChecksum::Algorithm::kCRC32C);
+    EXPECT_EQ(UploadChecksum::ParseAlgorithm("adler32"), UploadChecksum::Algorithm::kAdler32);
+    EXPECT_EQ(UploadChecksum::ParseAlgorithm("md5"), UploadChecksum::Algorithm::kMD5);
+    EXPECT_EQ(UploadChecksum::ParseAlgorithm("sha1"), UploadChecksum::Algorithm::kNone);
+    EXPECT_EQ(UploadChecksum::ParseAlgorithm(""), UploadChecksum::Algorithm::kNone);
+}
+
+TEST(UploadChecksum, KnownValues) {
+    UploadChecksum crc32c(UploadChecksum::Algorithm::kCRC32C);
+    crc32c.Update("123456789", 9);
+    crc32c.Final();
+    EXPECT_EQ(crc32c.GetValue(), "crc32c e3069283");
+    EXPECT_EQ(crc32c.GetHeader(UploadChecksum::Style::kDigest), std::make_pair(std::string("Digest"), std::string("crc32c=e3069283")));
+    EXPECT_EQ(crc32c.GetHeader(UploadChecksum::Style::kS3), std::make_pair(std::string("x-amz-checksum-crc32c"), std::string("4waSgw==")));
+
+    UploadChecksum adler32(UploadChecksum::Algorithm::kAdler32);
+    adler32.Update("Wikipedia", 9);
+    adler32.Final();
+    EXPECT_EQ(adler32.GetValue(), "adler32 11e60398");
+    EXPECT_EQ(adler32.GetHeader(UploadChecksum::Style::kDigest).second, "adler32=11e60398");
+    // S3 has no Adler32 checksum header.
+    EXPECT_TRUE(adler32.GetHeader(UploadChecksum::Style::kS3).first.empty());
+
+    UploadChecksum md5(UploadChecksum::Algorithm::kMD5);
+    md5.Final();
+    EXPECT_EQ(md5.GetValue(), "md5 d41d8cd98f00b204e9800998ecf8427e");
+    EXPECT_EQ(md5.GetHeader(UploadChecksum::Style::kDigest).second, "md5=1B2M2Y8AsgTpgAmY7PhCfg==");
+    EXPECT_EQ(md5.GetHeader(UploadChecksum::Style::kS3), std::make_pair(std::string("Content-MD5"), std::string("1B2M2Y8AsgTpgAmY7PhCfg==")));
+
+    // No updates are accepted once finalized.
+    md5.Update("abc", 3);
+    EXPECT_EQ(md5.GetValue(), "md5 d41d8cd98f00b204e9800998ecf8427e");
+}
+
+TEST(UploadChecksum, Incremental) {
+    // Large enough to cross the Adler32 block boundary several times.
+    std::string data;
+    for (int idx = 0; idx < 100000; idx++) {
+        data += static_cast<char>(idx * 31 + 7);
+    }
+    for (auto algorithm : {UploadChecksum::Algorithm::kCRC32C, UploadChecksum::Algorithm::kAdler32, UploadChecksum::Algorithm::kMD5}) {
+        auto whole = Checksum(algorithm, data, data.size());
+        EXPECT_FALSE(whole.empty());
+        EXPECT_EQ(Checksum(algorithm, data, 1), whole);
+        EXPECT_EQ(Checksum(algorithm, data, 4099), whole);
+    }
+}
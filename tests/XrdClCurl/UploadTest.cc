@@ -0,0 +1,123 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+// Functional tests of uploads from a local file through the
+// `XrdClCurlUploadPath` and `XrdClCurlUploadFd` properties.
+
+#include "XrdClCurl/XrdClCurlFile.hh"
+#include "../XrdClCurlCommon/TransferTest.hh"
+
+#include <XrdCl/XrdClFile.hh>
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+class UploadFixture : public TransferFixture {
+protected:
+    void SetUp() override {
+        TransferFixture::SetUp();
+        ASSERT_NO_FATAL_FAILURE(CreateLocalFile());
+    }
+
+    // Upload to `name` by setting `property` to `value` on the handle before closing it.
+    XrdCl::XRootDStatus Upload(const std::string &name, const std::string &property, const std::string &value,
+        const std::vector<std::pair<std::string, std::string>> &extra = {}, std::string *checksum = nullptr)
+    {
+        XrdCl::File fh;
+        auto url = name + "?authz=" + GetWriteToken();
+        auto rv = fh.Open(url, XrdCl::OpenFlags::Write, XrdCl::Access::Mode(0755), static_cast<XrdClCurl::File::timeout_t>(10));
+        if (!rv.IsOK()) return rv;
+        for (const auto &[setting, setting_value] : extra) {
+            EXPECT_TRUE(fh.SetProperty(setting, setting_value));
+        }
+        EXPECT_TRUE(fh.SetProperty(property, value));
+        // Writes are refused once the upload source is set.
+        char byte = 'a';
+        EXPECT_FALSE(fh.Write(0, 1, &byte, static_cast<XrdClCurl::File::timeout_t>(10)).IsOK());
+        rv = fh.Close(static_cast<XrdClCurl::File::timeout_t>(30));
+        if (rv.IsOK() && checksum) {
+            EXPECT_TRUE(fh.GetProperty("XrdClCurlUploadChecksumValue", *checksum));
+        }
+        return rv;
+    }
+};
+
+TEST_F(UploadFixture, FromPath)
+{
+    off_t size = 1'000'123;
+    ASSERT_NO_FATAL_FAILURE(FillLocalPattern(size));
+    auto name = GetOriginURL() + "/test/upload_path";
+    auto rv = Upload(name, "XrdClCurlUploadPath", GetLocalFile());
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    VerifyContents(name, size, 'a', m_local_chunk_size);
+
+    // An empty file creates an empty object.
+    ASSERT_NO_FATAL_FAILURE(FillLocalPattern(0));
+    name = GetOriginURL() + "/test/upload_path_empty";
+    rv = Upload(name, "XrdClCurlUploadPath", GetLocalFile());
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    VerifyContents(name, 0, 'a', m_local_chunk_size);
+}
+
+TEST_F(UploadFixture, FromFd)
+{
+    off_t size = 700'001;
+    ASSERT_NO_FATAL_FAILURE(FillLocalPattern(size));
+    auto fd = open(GetLocalFile().c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+
+    // The descriptor is read from its start regardless of its offset and is left open.
+    ASSERT_EQ(lseek(fd, 1000, SEEK_SET), 1000);
+    auto name = GetOriginURL() + "/test/upload_fd";
+    auto rv = Upload(name, "XrdClCurlUploadFd", std::to_string(fd));
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    EXPECT_NE(fcntl(fd, F_GETFD), -1);
+    VerifyContents(name, size, 'a', m_local_chunk_size);
+
+    // With a checksum and trailers enabled, the body is sent chunked with the checksum as a trailer.
+    std::string checksum;
+    name = GetOriginURL() + "/test/upload_fd_checksum";
+    rv = Upload(name, "XrdClCurlUploadFd", std::to_string(fd),
+        {{"XrdClCurlUploadChecksum", "crc32c"}, {"XrdClCurlUploadChecksumTrailer", "true"}}, &checksum);
+    ASSERT_TRUE(rv.IsOK()) << rv.ToString();
+    EXPECT_EQ(checksum.substr(0, 7), "crc32c ");
+    VerifyContents(name, size, 'a', m_local_chunk_size);
+    close(fd);
+}
+
+TEST_F(UploadFixture, Errors)
+{
+    auto name = GetOriginURL() + "/test/upload_errors";
+
+    auto rv = Upload(name, "XrdClCurlUploadFd", "not-a-descriptor");
+    EXPECT_FALSE(rv.IsOK());
+    EXPECT_EQ(rv.code, XrdCl::errInvalidArgs);
+
+    rv = Upload(name, "XrdClCurlUploadPath", GetLocalFile() + ".nonexistent");
+    EXPECT_FALSE(rv.IsOK());
+    EXPECT_EQ(rv.code, XrdCl::errOSError);
+
+    // Only regular files can be uploaded.
+    rv = Upload(name, "XrdClCurlUploadPath", "/tmp");
+    EXPECT_FALSE(rv.IsOK());
+    EXPECT_EQ(rv.code, XrdCl::errOSError);
+}
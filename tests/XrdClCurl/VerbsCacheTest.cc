@@ -0,0 +1,126 @@
+/****************************************************************
+ *
+ * Copyright (C) 2025, Pelican Project, Morgridge Institute for Research
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you
+ * may not use this file except in compliance with the License.  You may
+ * obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************/
+
+#include "XrdClCurl/XrdClCurlOps.hh"
+#include "XrdClCurl/XrdClCurlOptionsCache.hh"
+
+#include <XrdCl/XrdClDefaultEnv.hh>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace XrdClCurl;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string ReadFile(const std::string &path) {
+    std::ifstream fh(path);
+    std::stringstream ss;
+    ss << fh.rdbuf();
+    return ss.str();
+}
+
+}
+
+TEST(VerbsCache, StartProbe) {
+    auto &cache = VerbsCache::Instance();
+    auto now = std::chrono::steady_clock::now();
+
+    // Only the first operation to a new endpoint probes it.
+    EXPECT_TRUE(cache.StartProbe("https://probe.example.com/foo", now));
+    EXPECT_FALSE(cache.StartProbe("https://probe.example.com/bar", now));
+    EXPECT_TRUE(cache.StartProbe("https://probe-other.example.com/foo", now));
+
+    // A probe that never reports is assumed lost.
+    EXPECT_TRUE(cache.StartProbe("https://probe.example.com/foo", now + 2min));
+
+    // The result ends the probe; the endpoint is probed again when it expires from the cache.
+    cache.Put("https://probe.example.com", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kPROPFIND), now);
+    EXPECT_TRUE(cache.StartProbe("https://probe.example.com/foo", now));
+}
+
+TEST(VerbsCache, Persist) {
+    char fname[] = "/tmp/xrdclcurl_verbs_cache.XXXXXX";
+    auto fd = mkstemp(fname);
+    ASSERT_NE(fd, -1);
+    close(fd);
+
+    auto &cache = VerbsCache::Instance();
+    cache.Put("https://persist-known.example.com/foo", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kPROPFIND));
+    cache.Put("https://persist-unknown.example.com/foo", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kUnknown));
+    ASSERT_TRUE(cache.Save(fname));
+
+    // Only endpoints with known verbs are shared.
+    auto contents = ReadFile(fname);
+    EXPECT_NE(contents.find("https://persist-known.example.com 2 "), std::string::npos) << contents;
+    EXPECT_EQ(contents.find("persist-unknown"), std::string::npos) << contents;
+
+    // Entries saved by another process are loaded (unless expired) and kept on the next save.
+    auto now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    {
+        std::ofstream fh(fname, std::ios::app);
+        fh << "https://persist-other.example.com 2 " << now + 3600 << "\n";
+        fh << "https://persist-expired.example.com 2 " << now - 60 << "\n";
+        fh << "malformed line\n";
+    }
+    ASSERT_TRUE(cache.Load(fname));
+    EXPECT_TRUE(cache.Get("https://persist-other.example.com/bar").IsSet(VerbsCache::HttpVerb::kPROPFIND));
+    EXPECT_TRUE(cache.Get("https://persist-expired.example.com/bar").IsSet(VerbsCache::HttpVerb::kUnset));
+
+    ASSERT_TRUE(cache.Save(fname));
+    contents = ReadFile(fname);
+    EXPECT_NE(contents.find("https://persist-known.example.com 2 "), std::string::npos) << contents;
+    EXPECT_NE(contents.find("https://persist-other.example.com 2 "), std::string::npos) << contents;
+    EXPECT_EQ(contents.find("persist-expired"), std::string::npos) << contents;
+
+    EXPECT_FALSE(cache.Load("/nonexistent/xrdclcurl_verbs_cache"));
+    unlink(fname);
+}
+
+TEST(VerbsCache, StatRetry) {
+    auto logger = XrdCl::DefaultEnv::GetLog();
+    auto &cache = VerbsCache::Instance();
+    std::string target;
+
+    // A plain stat is never started before the verbs are known.
+    CurlStatOp unknown(nullptr, "https://retry-unknown.example.com/dir", {10, 0}, logger, false, nullptr, nullptr);
+    EXPECT_TRUE(unknown.RequiresOptions());
+    EXPECT_FALSE(unknown.CanSpeculateOptions());
+
+    // A HEAD response without a size to an endpoint with unknown verbs is retried
+    // after OPTIONS, and only once.
+    EXPECT_EQ(unknown.RetryWithVerbs(target), CurlOperation::VerbRetry::ReinvokeAfterAllow);
+    EXPECT_EQ(target, "https://retry-unknown.example.com/dir");
+    EXPECT_EQ(unknown.RetryWithVerbs(target), CurlOperation::VerbRetry::None);
+
+    // With PROPFIND known to be supported, the retry is immediate and uses PROPFIND.
+    cache.Put("https://retry-propfind.example.com", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kPROPFIND));
+    CurlStatOp propfind(nullptr, "https://retry-propfind.example.com/dir", {10, 0}, logger, false, nullptr, nullptr);
+    EXPECT_EQ(propfind.RetryWithVerbs(target), CurlOperation::VerbRetry::Reinvoke);
+    EXPECT_EQ(propfind.GetVerb(), CurlOperation::HttpVerb::PROPFIND);
+    EXPECT_EQ(propfind.RetryWithVerbs(target), CurlOperation::VerbRetry::None);
+
+    // Without PROPFIND support, the HEAD response stands.
+    cache.Put("https://retry-head.example.com", VerbsCache::HttpVerbs(VerbsCache::HttpVerb::kUnknown));
+    CurlStatOp head(nullptr, "https://retry-head.example.com/dir", {10, 0}, logger, false, nullptr, nullptr);
+    EXPECT_EQ(head.RetryWithVerbs(target), CurlOperation::VerbRetry::None);
+    EXPECT_EQ(head.GetVerb(), CurlOperation::HttpVerb::HEAD);
+}
@@ -94,3 +94,69 @@ TEST_F(CurlWriteFixture, PutTimeoutTest)
     rv = fh.Close();
     ASSERT_TRUE(rv.IsOK());
 }
+
+// Upload an object of known size in several writes with a checksum and trailers
+// enabled; the upload is sent chunked with the checksum in a trailer and must still
+// complete intact.
+TEST_F(CurlWriteFixture, ChecksumTrailerTest)
+{
+    XrdCl::File fh;
+    auto name = GetOriginURL() + "/test/write_checksum_trailer";
+    const off_t writeSize = 100'000;
+    const size_t chunkSize = 30'000;
+    auto url = name + "?authz=" + GetWriteToken() + "&oss.asize=" + std::to_string(writeSize);
+    auto rv = fh.Open(url, XrdCl::OpenFlags::Write, XrdCl::Access::Mode(0755), static_cast<XrdClCurl::File::timeout_t>(0));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to open " << name << " for write: " << rv.ToString();
+    ASSERT_TRUE(fh.SetProperty("XrdClCurlUploadChecksum", "crc32c"));
+    ASSERT_TRUE(fh.SetProperty("XrdClCurlUploadChecksumTrailer", "true"));
+
+    off_t offset = 0;
+    unsigned char chunkByte = 'a';
+    while (offset < writeSize) {
+        auto sizeToWrite = std::min<size_t>(chunkSize, writeSize - offset);
+        std::string writeBuffer(sizeToWrite, chunkByte++);
+        rv = fh.Write(offset, sizeToWrite, writeBuffer.data(), static_cast<XrdClCurl::File::timeout_t>(10));
+        ASSERT_TRUE(rv.IsOK()) << "Failed to write " << name << ": " << rv.ToString();
+        offset += sizeToWrite;
+    }
+    rv = fh.Close();
+    ASSERT_TRUE(rv.IsOK()) << "Failed to close " << name << ": " << rv.ToString();
+
+    std::string checksum;
+    ASSERT_TRUE(fh.GetProperty("XrdClCurlUploadChecksumValue", checksum));
+    EXPECT_EQ(checksum.substr(0, 7), "crc32c ");
+    EXPECT_EQ(checksum.size(), 15u);
+
+    VerifyContents(name, writeSize, 'a', chunkSize);
+}
+
+// Without trailers enabled, a multi-write upload of known size keeps its Content-Length;
+// its checksum has nowhere to go and is not computed.
+TEST_F(CurlWriteFixture, ChecksumNoTrailerTest)
+{
+    XrdCl::File fh;
+    auto name = GetOriginURL() + "/test/write_checksum_no_trailer";
+    const off_t writeSize = 100'000;
+    const size_t chunkSize = 30'000;
+    auto url = name + "?authz=" + GetWriteToken() + "&oss.asize=" + std::to_string(writeSize);
+    auto rv = fh.Open(url, XrdCl::OpenFlags::Write, XrdCl::Access::Mode(0755), static_cast<XrdClCurl::File::timeout_t>(0));
+    ASSERT_TRUE(rv.IsOK()) << "Failed to open " << name << " for write: " << rv.ToString();
+    ASSERT_TRUE(fh.SetProperty("XrdClCurlUploadChecksum", "crc32c"));
+
+    off_t offset = 0;
+    unsigned char chunkByte = 'a';
+    while (offset < writeSize) {
+        auto sizeToWrite = std::min<size_t>(chunkSize, writeSize - offset);
+        std::string writeBuffer(sizeToWrite, chunkByte++);
+        rv = fh.Write(offset, sizeToWrite, writeBuffer.data(), static_cast<XrdClCurl::File::timeout_t>(10));
+        ASSERT_TRUE(rv.IsOK()) << "Failed to write " << name << ": " << rv.ToString();
+        offset += sizeToWrite;
+    }
+    rv = fh.Close();
+    ASSERT_TRUE(rv.IsOK()) << "Failed to close " << name << ": " << rv.ToString();
+
+    std::string checksum;
+    EXPECT_FALSE(fh.GetProperty("XrdClCurlUploadChecksumValue", checksum));
+
+    VerifyContents(name, writeSize, 'a', chunkSize);
+}
@@ -25,7 +25,12 @@
 #include <XrdCl/XrdClDefaultEnv.hh>
 #include <XrdCl/XrdClLog.hh>
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <fstream>
+#include <vector>
 
 std::once_flag TransferFixture::m_init;
 bool TransferFixture::m_initialized = false;
@@ -95,6 +100,59 @@ void TransferFixture::SetUp() {
     ASSERT_TRUE(m_initialized) << "Environment initialization failed";
 }
 
+void
+TransferFixture::TearDown() {
+    if (!m_local_file.empty()) {
+        unlink(m_local_file.c_str());
+        m_local_file.clear();
+    }
+}
+
+void
+TransferFixture::CreateLocalFile() {
+    char fname[] = "xrdclcurl_transfer_test.XXXXXX";
+    auto fd = mkstemp(fname);
+    ASSERT_NE(fd, -1) << "Failed to create local test file: " << strerror(errno);
+    close(fd);
+    m_local_file = fname;
+}
+
+void
+TransferFixture::FillLocalPattern(off_t size) {
+    auto fd = open(m_local_file.c_str(), O_WRONLY | O_TRUNC);
+    ASSERT_NE(fd, -1);
+    std::string contents;
+    contents.reserve(size);
+    for (off_t idx = 0; idx < size; idx++) {
+        contents += static_cast<char>('a' + idx / m_local_chunk_size);
+    }
+    auto rc = write(fd, contents.data(), contents.size());
+    close(fd);
+    ASSERT_EQ(rc, static_cast<ssize_t>(contents.size()));
+}
+
+void
+TransferFixture::VerifyLocalPattern(off_t size) {
+    struct stat buf;
+    ASSERT_EQ(stat(m_local_file.c_str(), &buf), 0);
+    ASSERT_EQ(buf.st_size, size);
+
+    auto fd = open(m_local_file.c_str(), O_RDONLY);
+    ASSERT_NE(fd, -1);
+    std::vector<unsigned char> contents(size);
+    off_t offset = 0;
+    while (offset < size) {
+        auto rc = pread(fd, contents.data() + offset, size - offset, offset);
+        if (rc <= 0) break;
+        offset += rc;
+    }
+    close(fd);
+    ASSERT_EQ(offset, size);
+    for (off_t idx = 0; idx < size; idx++) {
+        ASSERT_EQ(contents[idx], static_cast<unsigned char>('a' + idx / m_local_chunk_size)) << "Mismatch at offset " << idx;
+    }
+}
+
 void
 TransferFixture::WritePattern(const std::string &name, const off_t writeSize,
                               const unsigned char chunkByte, const size_t chunkSize)
@@ -45,6 +45,9 @@ class TransferFixture : public testing::Test {
         TransferFixture();
     
         void SetUp() override;
+
+        // Removes the local file created by `CreateLocalFile`, if any.
+        void TearDown() override;
     
         // Helper function to write a file with a given pattern of contents.
         //
@@ -72,6 +75,26 @@ class TransferFixture : public testing::Test {
         void VerifyContents(XrdCl::File &fh, const off_t writeSize,
                             const unsigned char chunkByte, const size_t chunkSize);
     
+        // Create an empty local file for tests that transfer to or from the
+        // filesystem; it is removed in `TearDown`.
+        //
+        // The file is created in the working directory rather than /tmp, which
+        // may be a tmpfs without O_DIRECT support.
+        void CreateLocalFile();
+
+        // Replace the contents of the local file with `size` bytes of the
+        // pattern written by `WritePattern`, starting at 'a' and using chunks
+        // of `m_local_chunk_size` bytes.
+        void FillLocalPattern(off_t size);
+
+        // Verify the local file holds exactly the `size` bytes written by `FillLocalPattern`.
+        void VerifyLocalPattern(off_t size);
+
+        const std::string &GetLocalFile() const {return m_local_file;}
+
+        // Chunk size of the pattern used by the local file helpers.
+        static constexpr size_t m_local_chunk_size{100'000};
+
         const std::string &GetCacheURL() const {return m_cache_url;}
         const std::string &GetOriginURL() const {return m_origin_url;}
         const std::string &GetReadToken() const {return m_read_token;}
@@ -106,6 +129,9 @@ class TransferFixture : public testing::Test {
 
     private:
         void ReadTokenFromFile(const std::string &fname, std::string &token);
+
+        // Name of the file created by `CreateLocalFile`
+        std::string m_local_file;
     
         // Function to reinitialize the fixture after fork() has been called
         static void ForkChild();
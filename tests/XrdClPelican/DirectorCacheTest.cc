@@ -80,6 +80,29 @@ TEST(DirectorCache, ExpiredPutGet) {
     EXPECT_EQ(url, "https://example2.com:8443/obj1/obj2/obj3");
 }
 
+TEST(DirectorCache, Mirrors) {
+    auto now = std::chrono::steady_clock::now();
+
+    auto &cache = Pelican::DirectorCache::GetCache("mirrors.example.com", now);
+
+    cache.Put({
+        {"https://cache1.com:8443/ns/obj1", 1},
+        {"https://cache2.com/ns/obj1", 1},
+        {"https://cache3.com/other/obj1", 1}, // Different namespace prefix; ignored
+        {"https://cache4.com/ns/obj1", 1},
+    }, now);
+    auto mirrors = cache.GetMirrors("https://director.com/ns/obj2", now);
+    ASSERT_EQ(mirrors.size(), 3);
+    EXPECT_EQ(mirrors[0], "https://cache1.com:8443/ns/obj2");
+    EXPECT_EQ(mirrors[1], "https://cache2.com/ns/obj2");
+    EXPECT_EQ(mirrors[2], "https://cache4.com/ns/obj2");
+    EXPECT_EQ(cache.Get("https://director.com/ns/obj2", now), "https://cache1.com:8443/ns/obj2");
+
+    EXPECT_TRUE(cache.GetMirrors("https://director.com/other/obj2", now).empty());
+    now += std::chrono::minutes(2);
+    EXPECT_TRUE(cache.GetMirrors("https://director.com/ns/obj2", now).empty());
+}
+
 TEST(DirectorCache, ComputePathAndUrl) {
     std::string test_url = "https://example.com:8443/first/namespace";
     auto [path, url, ok] = Pelican::DirectorCache::ComputePathAndUrl(test_url, 3);